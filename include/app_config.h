@@ -9,6 +9,26 @@
 #define FTP_PASS "tes12345"
 
 #define MASTER_BLACKLIST_DURATION_MS 5000
+#define MASTER_MAX_TRACKED_DEVICES 32
+#define MASTER_STATE_JOURNAL_COMPACT_BYTES 8192
+#define MASTER_HISTORY_MAX_SERIES 16
+#define MASTER_HISTORY_BLOCKS_PER_SERIES 8
+#define MASTER_HISTORY_FLUSH_MS 300000
+#define MASTER_HISTORY_SEGMENT_BYTES 32768
+#define MASTER_BATCH_FRAMES 1
+#define MASTER_BATCH_PLAIN_HELLO_EVERY 5
+#define MASTER_CAMERA_RATE_CONTROL 1
+#define MASTER_CAMERA_RATE_WINDOW_MS 4000
+#define MASTER_CAMERA_TARGET_COMPLETION_PCT 95
+#define MASTER_CAMERA_MAX_FPS 15
+#define MASTER_RECORDER_RING_BYTES 262144
+#define MASTER_RECORDER_SEGMENT_BYTES 262144
+#define MASTER_RECORDER_MAX_BYTES 2097152
+#define MASTER_CAMERA_FRAME_SLOTS 8
+#define MASTER_CAMERA_HTTP_PORT 8080
+#define MASTER_CAMERA_HTTP_MAX_CLIENTS 3
+#define MASTER_CAPTURE_RING_BYTES 131072
+#define MASTER_CAPTURE_AT_BOOT 0
 #define MASTER_WEATHER_STALE_MS 120000
 #define MASTER_WEATHER_SYNC_RETRY_MS 30000
 
@@ -17,4 +37,34 @@
 #define MASTER_UI_FOCUS_MAX_HOME 2
 #define MASTER_UI_FOCUS_MAX_DEVICE_LIST 2
 #define MASTER_UI_FOCUS_MAX_ESPNOW_CONTROL 2
-#define MASTER_UI_FOCUS_MAX_SETTINGS 2
\ No newline at end of file
+#define MASTER_UI_FOCUS_MAX_SETTINGS 2
+
+#define MASTER_UI_TEXT_CACHE 1
+#define MASTER_UI_TEXT_CACHE_BENCH 0
+#define MASTER_UI_TEXT_CACHE_BENCH_ITERATIONS 20
+
+#define MASTER_DISPLAY_PROFILER 1
+#define MASTER_DISPLAY_PROFILER_OVERLAY 0
+#define MASTER_DISPLAY_PROFILER_LOG_MS 10000
+
+#define MASTER_TELEMETRY_PERIOD_MS 2000
+#define MASTER_TELEMETRY_LOG_MS 30000
+#define MASTER_TELEMETRY_STACK_ALERT_BYTES 512
+#define MASTER_TELEMETRY_IDLE_ALERT_PCT 10
+#define MASTER_TELEMETRY_HEAP_ALERT_BYTES 24576
+#define MASTER_TELEMETRY_BLOCK_ALERT_BYTES 8192
+#define MASTER_TELEMETRY_PSRAM_ALERT_BYTES 524288
+
+#define MASTER_TASK_TOPOLOGY 1
+
+#define MASTER_NETWORK_STATS_LOG_MS 60000
+
+#define MASTER_FTP_AT_BOOT 1
+#define MASTER_FTP_POLL_MS 10
+#define MASTER_FS_LOCK_WAIT_MS 20
+
+#define MASTER_TIME_ZONE "WIB-7"
+#define MASTER_NTP_POLL_MS 900000
+#define MASTER_NTP_RETRY_MS 15000
+#define MASTER_NTP_ROUND_TIMEOUT_MS 2000
+#define MASTER_NTP_STEP_THRESHOLD_MS 1000
\ No newline at end of file
@@ -2,10 +2,22 @@
 #include <Preferences.h>
 #include <LittleFS.h>
 #include <esp_wifi.h>
+#include <algorithm>
 
 namespace {
 
 static constexpr uint8_t ESP_NOW_SYNC_RETRIES = 5;
+static constexpr unsigned long RECONNECT_INTERVAL_MS = 10000;
+static constexpr unsigned long CONNECT_TIMEOUT_MS = 20000;
+static constexpr unsigned long SCAN_TIMEOUT_MS = 15000;
+static constexpr unsigned long ROAM_CHECK_INTERVAL_MS = 30000;
+static constexpr uint32_t SCAN_MS_PER_CHANNEL = 120;
+static constexpr int32_t ROAM_RSSI_THRESHOLD = -72;
+static constexpr int32_t ROAM_HYSTERESIS_DB = 8;
+// With a pinned channel, every Nth reconnect scan still sweeps all channels.
+static constexpr uint8_t FULL_SCAN_EVERY = 4;
+static constexpr uint32_t ACTIVE_POLL_MS = 100;
+static constexpr uint32_t IDLE_POLL_MS = 1000;
 
 uint8_t getCurrentChannel() {
     uint8_t primary = WiFi.channel();
@@ -55,9 +67,19 @@ void syncEspNowChannelToSta() {
 
 } // namespace
 
+volatile bool WifiManager::scanDone = false;
+
 WifiManager::WifiManager()
-        : apMode(false),
-            lastReconnectAttempt(0),
+        : state(State::Idle),
+            apMode(false),
+            bootAttempt(false),
+            channelPinned(false),
+            roamScan(false),
+            scanAttempts(0),
+            stateSinceMs(0),
+            nextAttemptMs(0),
+            lastRoamCheckMs(0),
+            nextCandidate(0),
             deviceName("pio-master"),
             wifiHostname("pio-master") {}
 
@@ -83,14 +105,10 @@ bool WifiManager::init() {
 void WifiManager::begin() {
     ESP_LOGI("WIFI", "Starting WiFi connection process");
 
-    // Try to connect to any available saved network
-    if (connectToAvailableNetwork()) {
-        ESP_LOGI("WIFI", "Connected to WiFi successfully");
-        return;
-    }
-
-    ESP_LOGW("WIFI", "No saved networks available or connection failed, starting hotspot");
-    startHotspot();
+    bootAttempt = true;
+    state = State::Idle;
+    nextAttemptMs = millis();
+    handle();
 }
 
 void WifiManager::setIdentity(const String& name, const String& hostname) {
@@ -123,41 +141,24 @@ String WifiManager::getIPAddress() {
 }
 
 std::vector<String> WifiManager::scanNetworks() {
-    ESP_LOGI("WIFI", "Starting WiFi scan...");
-    // Ensure we're in STA mode and disconnected for clean scan
-    WiFi.mode(WIFI_STA);
-    delay(100);
-    std::vector<String> networks;
-    int numNetworks = WiFi.scanNetworks();
-    ESP_LOGI("WIFI", "Scan completed, found %d networks", numNetworks);
-    for (int i = 0; i < numNetworks; i++) {
-        String ssid = WiFi.SSID(i);
-        ESP_LOGI("WIFI", "Network %d: %s", i, ssid.c_str());
-        networks.push_back(ssid);
-    }
-    return networks;
+    return lastScan;
 }
 
 bool WifiManager::connect(const String& ssid, const String& password) {
+    if (ssid.length() == 0 || state == State::Scanning) {
+        return false;
+    }
+
     WiFi.softAPdisconnect();
     WiFi.mode(WIFI_STA);
+    ESP_LOGI("WIFI", "Connecting to: %s", ssid.c_str());
     WiFi.begin(ssid.c_str(), password.c_str());
 
-    int attempts = 0;
-    wl_status_t event;
-    do{
-        event = WiFi.status();
-        delay(1000);
-        ESP_LOGI("WIFI", "Connecting to: %s; attempt: %d", ssid.c_str(), ++attempts);
-    }
-    while (event != WL_CONNECTED && attempts < 20);
-    
-    const bool connected = WiFi.status() == WL_CONNECTED;
-    if (connected) {
-        syncEspNowChannelToSta();
-    }
-
-    return connected;
+    candidates.clear();
+    nextCandidate = 0;
+    state = State::Connecting;
+    stateSinceMs = millis();
+    return true;
 }
 
 bool WifiManager::addNetwork(const String& ssid, const String& password) noexcept  {
@@ -165,7 +166,6 @@ bool WifiManager::addNetwork(const String& ssid, const String& password) noexcep
     
     std::vector<String> savedNetworks = getSavedNetworks();
     Preferences preferences;
-    delay(100);
     if (!preferences.begin("wifi", false)) {
         ESP_LOGE("WIFI", "Failed to open wifi preferences");
         return false;
@@ -295,48 +295,148 @@ std::vector<String> WifiManager::getSavedNetworks() {
 
 bool WifiManager::connectToAvailableNetwork() {
     if (WiFi.status() == WL_CONNECTED) return true;
+    if (state == State::Scanning || state == State::Connecting) return true;
 
-    ESP_LOGI("WIFI", "Scanning for available networks");
-    delay(2000);
-    // Get available networks
-    std::vector<String> availableNetworks = scanNetworks();
-    ESP_LOGI("WIFI", "Found %d available networks", availableNetworks.size());
-    
-    ESP_LOGI("WIFI", "Retrieving saved networks");
-    std::vector<String> savedNetworks = getSavedNetworks();
-    
-    if (availableNetworks.empty() || savedNetworks.empty()) {
-        ESP_LOGW("WIFI", "No available or saved networks");
+    return startScan(false, millis());
+}
+
+void WifiManager::setChannelPinned(bool pinned) {
+    channelPinned = pinned;
+}
+
+bool WifiManager::startScan(bool roam, unsigned long now) {
+    const uint8_t current = getCurrentChannel();
+    if (!roam) {
+        scanAttempts++;
+    }
+    const bool pinnedScan = channelPinned && current != 0 && (roam || scanAttempts % FULL_SCAN_EVERY != 0);
+    const uint8_t channel = pinnedScan ? current : 0;
+
+    scanDone = false;
+    const int16_t result = WiFi.scanNetworks(true, false, false, SCAN_MS_PER_CHANNEL, channel);
+    if (result != WIFI_SCAN_RUNNING) {
+        ESP_LOGW("WIFI", "Failed to start scan (%d)", result);
+        if (!roam) {
+            attemptFailed(now);
+        }
         return false;
     }
-    
-    // Try to connect to any saved network that's available
-    for (const auto& savedNetwork : savedNetworks) {
-        for (const auto& availableNetwork : availableNetworks) {
-            if (savedNetwork == availableNetwork) {
-                ESP_LOGI("WIFI", "Found saved network: %s", savedNetwork.c_str());
-                
-                // Get password for this network
-                Preferences preferences;
-                if (!preferences.begin("wifi", true)){
-                    continue;
-                }
-                String pwdKey = "pwd_" + savedNetwork;
-                String password = preferences.getString(pwdKey.c_str(), "");
-                preferences.end();
-                
-                if (password.length() > 0 && connect(savedNetwork, password)) {
-                    ESP_LOGI("WIFI", "Successfully connected to: %s", savedNetwork.c_str());
-                    return true;
-                }
-                break;
+
+    if (channel != 0) {
+        ESP_LOGI("WIFI", "%s scan on channel %u", roam ? "Roaming" : "Reconnect", channel);
+    } else {
+        ESP_LOGI("WIFI", "%s scan on all channels", roam ? "Roaming" : "Reconnect");
+    }
+    roamScan = roam;
+    state = State::Scanning;
+    stateSinceMs = now;
+    return true;
+}
+
+void WifiManager::handleScanResults(int16_t count, unsigned long now) {
+    const bool roam = roamScan;
+    roamScan = false;
+
+    if (count < 0) {
+        ESP_LOGW("WIFI", "Scan failed (%d)", count);
+        WiFi.scanDelete();
+        if (roam) {
+            state = State::Connected;
+        } else {
+            attemptFailed(now);
+        }
+        return;
+    }
+
+    const std::vector<String> savedNetworks = getSavedNetworks();
+    lastScan.clear();
+    candidates.clear();
+    nextCandidate = 0;
+    for (int16_t i = 0; i < count; i++) {
+        const String ssid = WiFi.SSID(i);
+        lastScan.push_back(ssid);
+        if (std::find(savedNetworks.begin(), savedNetworks.end(), ssid) == savedNetworks.end()) {
+            continue;
+        }
+
+        Candidate candidate;
+        candidate.ssid = ssid;
+        memcpy(candidate.bssid, WiFi.BSSID(i), sizeof(candidate.bssid));
+        candidate.channel = static_cast<uint8_t>(WiFi.channel(i));
+        candidate.rssi = WiFi.RSSI(i);
+        candidates.push_back(candidate);
+    }
+    WiFi.scanDelete();
+    ESP_LOGI("WIFI", "Scan completed, found %d networks, %u saved", count, static_cast<unsigned>(candidates.size()));
+
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        return a.rssi > b.rssi;
+    });
+
+    if (roam) {
+        state = State::Connected;
+        const int32_t currentRssi = WiFi.RSSI();
+        const uint8_t* currentBssid = WiFi.BSSID();
+        for (const auto& candidate : candidates) {
+            if (currentBssid != nullptr && memcmp(candidate.bssid, currentBssid, sizeof(candidate.bssid)) == 0) {
+                continue;
+            }
+            if (candidate.rssi >= currentRssi + ROAM_HYSTERESIS_DB) {
+                ESP_LOGI("WIFI", "Roaming from %d dBm to %s at %d dBm", currentRssi, candidate.ssid.c_str(), candidate.rssi);
+                const Candidate target = candidate;
+                candidates.assign(1, target);
+                connectNextCandidate(now);
             }
+            break;
         }
+        return;
+    }
+
+    if (!connectNextCandidate(now)) {
+        ESP_LOGW("WIFI", "No available or saved networks");
+        attemptFailed(now);
+    }
+}
+
+bool WifiManager::connectNextCandidate(unsigned long now) {
+    while (nextCandidate < candidates.size()) {
+        const Candidate& candidate = candidates[nextCandidate++];
+        const String password = getPassword(candidate.ssid);
+        if (password.length() == 0) {
+            continue;
+        }
+
+        ESP_LOGI("WIFI", "Connecting to: %s (channel %u, %d dBm)", candidate.ssid.c_str(), candidate.channel, candidate.rssi);
+        WiFi.begin(candidate.ssid.c_str(), password.c_str(), candidate.channel, candidate.bssid);
+        state = State::Connecting;
+        stateSinceMs = now;
+        return true;
     }
-    
     return false;
 }
 
+void WifiManager::attemptFailed(unsigned long now) {
+    state = State::Idle;
+    nextAttemptMs = now + RECONNECT_INTERVAL_MS;
+
+    if (bootAttempt) {
+        bootAttempt = false;
+        ESP_LOGW("WIFI", "No saved networks available or connection failed, starting hotspot");
+        startHotspot();
+    }
+}
+
+String WifiManager::getPassword(const String& ssid) {
+    Preferences preferences;
+    if (!preferences.begin("wifi", true)) {
+        return "";
+    }
+    String pwdKey = "pwd_" + ssid;
+    String password = preferences.getString(pwdKey.c_str(), "");
+    preferences.end();
+    return password;
+}
+
 void WifiManager::startHotspot() {
     if (apMode) return;
 
@@ -358,15 +458,63 @@ void WifiManager::stopHotspot() {
     apMode = false;
 }
 
-void WifiManager::handle() {
-    if (!apMode && !isConnected()) {
-        unsigned long now = millis();
-        if (now - lastReconnectAttempt > 10000) {
-            ESP_LOGI("WIFI", "Attempting to reconnect...");
-            connectToAvailableNetwork();
-            lastReconnectAttempt = now;
-        }
+uint32_t WifiManager::handle() {
+    const unsigned long now = millis();
+
+    switch (state) {
+        case State::Idle:
+            if (isConnected()) {
+                state = State::Connected;
+                lastRoamCheckMs = now;
+            } else if (!apMode && static_cast<long>(now - nextAttemptMs) >= 0) {
+                ESP_LOGI("WIFI", "Attempting to reconnect...");
+                startScan(false, now);
+            }
+            break;
+
+        case State::Scanning:
+            // Set by the scan-done event; the timeout covers a lost event.
+            if (scanDone || now - stateSinceMs >= SCAN_TIMEOUT_MS) {
+                const int16_t result = WiFi.scanComplete();
+                if (result != WIFI_SCAN_RUNNING) {
+                    scanDone = false;
+                    handleScanResults(result, now);
+                } else if (now - stateSinceMs >= SCAN_TIMEOUT_MS) {
+                    scanDone = false;
+                    handleScanResults(WIFI_SCAN_FAILED, now);
+                }
+            }
+            break;
+
+        case State::Connecting:
+            if (isConnected()) {
+                ESP_LOGI("WIFI", "Connected to WiFi successfully (%d dBm)", WiFi.RSSI());
+                state = State::Connected;
+                bootAttempt = false;
+                scanAttempts = 0;
+                lastRoamCheckMs = now;
+            } else if (now - stateSinceMs >= CONNECT_TIMEOUT_MS) {
+                ESP_LOGW("WIFI", "Connection attempt timed out");
+                if (!connectNextCandidate(now)) {
+                    attemptFailed(now);
+                }
+            }
+            break;
+
+        case State::Connected:
+            if (!isConnected()) {
+                state = State::Idle;
+                nextAttemptMs = now;
+            } else if (now - lastRoamCheckMs >= ROAM_CHECK_INTERVAL_MS) {
+                lastRoamCheckMs = now;
+                if (WiFi.RSSI() < ROAM_RSSI_THRESHOLD) {
+                    startScan(true, now);
+                }
+            }
+            break;
     }
+
+    return (state == State::Scanning || state == State::Connecting) ? ACTIVE_POLL_MS : IDLE_POLL_MS;
 }
 
 
@@ -382,6 +530,9 @@ void WifiManager::onWiFiEvent(WiFiEvent_t event) {
         case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
             ESP_LOGW("WIFI", "Disconnected from AP");
             break;
+        case ARDUINO_EVENT_WIFI_SCAN_DONE:
+            scanDone = true;
+            break;
         case ARDUINO_EVENT_WIFI_AP_START:
             ESP_LOGI("WIFI", "AP started");
             break;
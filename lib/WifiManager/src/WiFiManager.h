@@ -22,7 +22,8 @@ public:
 
     /**
      * Start WiFi connection process
-     * Attempts to connect to any saved network, starts AP if none available
+     * Scans and connects to the strongest saved network from handle();
+     * starts AP if that first attempt fails. Returns immediately.
      */
     void begin();
 
@@ -48,16 +49,17 @@ public:
     String getIPAddress();
 
     /**
-     * Scan for available WiFi networks
+     * SSIDs seen by the last completed scan
+     * Scans run asynchronously from handle(); this never starts or waits for one.
      * @return vector of network SSIDs
      */
     std::vector<String> scanNetworks();
 
     /**
-     * Connect to specific network
+     * Start connecting to specific network
      * @param ssid Network SSID
      * @param password Network password
-     * @return true if connection successful
+     * @return true if the attempt was started (false while a scan is running)
      */
     bool connect(const String& ssid, const String& password);
 
@@ -83,11 +85,19 @@ public:
     std::vector<String> getSavedNetworks();
 
     /**
-     * Try to connect to any available saved network
-     * @return true if connected to any network
+     * Start a scan-and-connect attempt for any available saved network
+     * @return true if connected or an attempt is in progress
      */
     bool connectToAvailableNetwork();
 
+    /**
+     * Keep scans on the current radio channel, e.g. while ESP-NOW peers
+     * depend on it. Roaming scans stay on it; reconnect scans still sweep
+     * every channel every few attempts so an AP that moved is found.
+     * @param pinned true to restrict scans to the current channel
+     */
+    void setChannelPinned(bool pinned);
+
     /**
      * Start AP hotspot for configuration
      */
@@ -99,19 +109,52 @@ public:
     void stopHotspot();
 
     /**
-     * Handle periodic tasks (reconnect)
+     * Advance the scan/connect/roam state machine. Never blocks.
      * Call this in main loop
+     * @return ms until handle() needs to run again
      */
-    void handle();
+    uint32_t handle();
 
 private:
+    enum class State : uint8_t {
+        Idle,
+        Scanning,
+        Connecting,
+        Connected,
+    };
+
+    struct Candidate {
+        String ssid;
+        uint8_t bssid[6];
+        uint8_t channel;
+        int32_t rssi;
+    };
+
+    State state;
     bool apMode;
-    unsigned long lastReconnectAttempt;
+    bool bootAttempt;   // first attempt after begin(); falls back to the hotspot
+    bool channelPinned;
+    bool roamScan;      // running scan looks for a better AP while connected
+    uint8_t scanAttempts;
+    unsigned long stateSinceMs;
+    unsigned long nextAttemptMs;
+    unsigned long lastRoamCheckMs;
+    std::vector<String> lastScan;
+    std::vector<Candidate> candidates; // strongest first
+    size_t nextCandidate;
     String deviceName;
     String wifiHostname;
     
     static const int MAX_SAVED_NETWORKS = 5; // Maximum number of saved networks
 
+    static volatile bool scanDone;
+
+    bool startScan(bool roam, unsigned long now);
+    void handleScanResults(int16_t count, unsigned long now);
+    bool connectNextCandidate(unsigned long now);
+    void attemptFailed(unsigned long now);
+    String getPassword(const String& ssid);
+
     // WiFi event handlers
     static void onWiFiEvent(WiFiEvent_t event);
 };
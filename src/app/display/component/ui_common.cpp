@@ -1,8 +1,22 @@
 #include "ui_common.h"
 
+#include "../display_profiler.h"
+
 namespace app::display::ui_component {
 
-TFT_eSPI tft = TFT_eSPI();
+ProfiledTft tft;
+
+void ProfiledTft::setWindow(int32_t xs, int32_t ys, int32_t xe, int32_t ye) {
+  if (xe >= xs && ye >= ys) {
+    profiler::addSpiBytes(static_cast<uint32_t>(xe - xs + 1) * static_cast<uint32_t>(ye - ys + 1) * 2U);
+  }
+  TFT_eSPI::setWindow(xs, ys, xe, ye);
+}
+
+void ProfiledTft::drawPixel(int32_t x, int32_t y, uint32_t color) {
+  profiler::addSpiBytes(2);
+  TFT_eSPI::drawPixel(x, y, color);
+}
 
 uint16_t colorTileBlue() {
   return tft.color565(0, 120, 215);
@@ -4,7 +4,17 @@
 
 namespace app::display::ui_component {
 
-extern TFT_eSPI tft;
+// Counts the pixel bytes of every address window opened on the panel so the
+// display profiler can attribute SPI traffic to the screen being rendered.
+class ProfiledTft : public TFT_eSPI {
+ public:
+  using TFT_eSPI::drawPixel;
+
+  void setWindow(int32_t xs, int32_t ys, int32_t xe, int32_t ye) override;
+  void drawPixel(int32_t x, int32_t y, uint32_t color) override;
+};
+
+extern ProfiledTft tft;
 
 uint16_t colorTileBlue();
 uint16_t colorTileCyan();
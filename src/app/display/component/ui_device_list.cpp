@@ -3,70 +3,186 @@
 #include "ui_common.h"
 #include "app/espnow/master.h"
 
+#include <cstdio>
+#include <cstring>
+
 namespace app::display::ui_component {
+namespace {
 
-void renderDeviceList(DisplayStateData& state, uint8_t focusIndex) {
-  (void)state;
+static constexpr size_t VISIBLE_CARDS = 3;
+static constexpr int MARGIN = 12;
+static constexpr int CARD_H = 56;
+static constexpr int GAP = 10;
+static constexpr int START_Y = 12;
+static constexpr int SCROLLBAR_W = 4;
+
+struct CardSlot {
+  bool valid = false;
+  uint8_t mac[6] = {0};
+  uint32_t generation = 0;
+  bool focused = false;
+};
+
+CardSlot slots[VISIBLE_CARDS];
+size_t windowStart = 0;
+size_t lastTotal = 0;
+size_t lastScrollWindowStart = SIZE_MAX;
+size_t lastScrollTotal = 0;
+uint32_t lastRegistryGeneration = UINT32_MAX;
+bool showingEmpty = false;
+
+int cardY(size_t slot) {
+  return START_Y + static_cast<int>(slot) * (CARD_H + GAP);
+}
+
+int cardWidth() {
+  return tft.width() - (MARGIN * 2) - (SCROLLBAR_W + 4);
+}
+
+void invalidateSlots() {
+  for (auto& slot : slots) {
+    slot = CardSlot{};
+  }
+  lastScrollWindowStart = SIZE_MAX;
+}
 
+void drawEmptyState() {
   tft.fillScreen(colorBackground());
+  tft.setTextDatum(MC_DATUM);
+  tft.setTextColor(tft.color565(180, 180, 180), colorBackground());
+  tft.drawString("No slave connected", tft.width() / 2, tft.height() / 2, 2);
+  tft.drawString("Waiting for identity/features", tft.width() / 2, (tft.height() / 2) + 20, 2);
+}
+
+void clearCard(size_t slot) {
+  tft.fillRect(MARGIN, cardY(slot), cardWidth(), CARD_H, colorBackground());
+}
+
+void drawCard(size_t slot, const app::espnow::TrackedDeviceRow& row, bool focused) {
+  const int y = cardY(slot);
+  const uint16_t cardColor = focused ? tft.color565(23, 86, 163) : tft.color565(33, 33, 33);
+  tft.fillRect(MARGIN, y, cardWidth(), CARD_H, colorBackground());
+  tft.fillRoundRect(MARGIN, y, cardWidth(), CARD_H, 10, cardColor);
+
+  tft.setTextDatum(TL_DATUM);
+  tft.setTextColor(TFT_WHITE, cardColor);
 
-  const int margin = 12;
-  const int cardW = tft.width() - (margin * 2);
-  const int cardH = 56;
-  const int gap = 10;
-  const int startY = 12;
+  char id[24] = {0};
+  if (row.deviceId[0] != '\0') {
+    strlcpy(id, row.deviceId, sizeof(id));
+  } else {
+    snprintf(id,
+             sizeof(id),
+             "%02X:%02X:%02X:%02X:%02X:%02X",
+             row.mac[0],
+             row.mac[1],
+             row.mac[2],
+             row.mac[3],
+             row.mac[4],
+             row.mac[5]);
+  }
+
+  const char* status = row.status;
+  if (status[0] == '\0') {
+    status = row.verified ? "online" : "pending identity";
+  }
 
-  app::espnow::TrackedDeviceSnapshot snapshots[32];
-  const size_t totalDevices = app::espnow::getTrackedDeviceSnapshots(snapshots, 32);
+  char detail[64] = {0};
+  snprintf(detail, sizeof(detail), "%s | %s", row.kind, status);
+
+  tft.drawString(id, MARGIN + 12, y + 8, 2);
+  tft.drawString(detail, MARGIN + 12, y + 30, 2);
+}
+
+void drawScrollbar(size_t total) {
+  const int x = tft.width() - MARGIN - SCROLLBAR_W;
+  const int trackH = cardY(VISIBLE_CARDS) - GAP - START_Y;
+  tft.fillRect(x, START_Y, SCROLLBAR_W, trackH, tft.color565(24, 24, 24));
+  if (total <= VISIBLE_CARDS) {
+    return;
+  }
+
+  const int thumbH = (trackH * static_cast<int>(VISIBLE_CARDS)) / static_cast<int>(total);
+  const int thumbY = START_Y + (trackH * static_cast<int>(windowStart)) / static_cast<int>(total);
+  tft.fillRect(x, thumbY, SCROLLBAR_W, thumbH < 6 ? 6 : thumbH, tft.color565(120, 120, 130));
+}
+
+// Slides the visible window just enough to keep the focused row on screen.
+void updateWindow(size_t focus, size_t total) {
+  if (focus < windowStart) {
+    windowStart = focus;
+  } else if (focus >= windowStart + VISIBLE_CARDS) {
+    windowStart = focus - (VISIBLE_CARDS - 1);
+  }
+
+  const size_t maxStart = total > VISIBLE_CARDS ? (total - VISIBLE_CARDS) : 0;
+  if (windowStart > maxStart) {
+    windowStart = maxStart;
+  }
+}
+
+}  // namespace
+
+void renderDeviceList(DisplayStateData& state, uint8_t focusIndex) {
+  const uint32_t registryGeneration = app::espnow::getTrackedDeviceRegistryGeneration();
+  if (registryGeneration != lastRegistryGeneration) {
+    lastRegistryGeneration = registryGeneration;
+    lastTotal = app::espnow::getTrackedDeviceSnapshotCount();
+  }
+  const size_t totalDevices = lastTotal;
 
   if (totalDevices == 0) {
-    tft.setTextDatum(MC_DATUM);
-    tft.setTextColor(tft.color565(180, 180, 180), colorBackground());
-    tft.drawString("No slave connected", tft.width() / 2, tft.height() / 2, 2);
-    tft.drawString("Waiting for identity/features", tft.width() / 2, (tft.height() / 2) + 20, 2);
+    if (!showingEmpty || state.uiFullRedraw) {
+      drawEmptyState();
+      showingEmpty = true;
+    }
+    invalidateSlots();
     return;
   }
 
+  if (showingEmpty || state.uiFullRedraw) {
+    tft.fillScreen(colorBackground());
+    invalidateSlots();
+    showingEmpty = false;
+  }
+
   const size_t clampedFocus = (focusIndex >= totalDevices) ? (totalDevices - 1) : focusIndex;
-  const size_t pageStart = (clampedFocus / 3) * 3;
+  updateWindow(clampedFocus, totalDevices);
 
-  for (int i = 0; i < 3; ++i) {
-    const size_t deviceIndex = pageStart + static_cast<size_t>(i);
-    if (deviceIndex >= totalDevices) {
-      break;
-    }
+  app::espnow::TrackedDeviceRow rows[VISIBLE_CARDS];
+  const size_t visible = app::espnow::getTrackedDeviceRows(windowStart, rows, VISIBLE_CARDS);
 
-    const auto& device = snapshots[deviceIndex];
-    const int y = startY + (i * (cardH + gap));
-    const bool focused = deviceIndex == clampedFocus;
-    const uint16_t cardColor = focused ? tft.color565(23, 86, 163) : tft.color565(33, 33, 33);
-    tft.fillRoundRect(margin, y, cardW, cardH, 10, cardColor);
-
-    tft.setTextDatum(TL_DATUM);
-    tft.setTextColor(TFT_WHITE, cardColor);
-
-    String id = device.deviceId;
-    if (id.isEmpty()) {
-      char macText[18] = {0};
-      snprintf(macText,
-               sizeof(macText),
-               "%02X:%02X:%02X:%02X:%02X:%02X",
-               device.mac[0],
-               device.mac[1],
-               device.mac[2],
-               device.mac[3],
-               device.mac[4],
-               device.mac[5]);
-      id = String(macText);
+  for (size_t i = 0; i < VISIBLE_CARDS; ++i) {
+    CardSlot& slot = slots[i];
+    if (i >= visible) {
+      if (slot.valid) {
+        clearCard(i);
+        slot = CardSlot{};
+      }
+      continue;
     }
 
-    String status = device.status;
-    if (status.isEmpty()) {
-      status = device.verified ? "online" : "pending identity";
+    const auto& row = rows[i];
+    const bool focused = (windowStart + i) == clampedFocus;
+    const bool unchanged = slot.valid
+                        && slot.generation == row.generation
+                        && slot.focused == focused
+                        && memcmp(slot.mac, row.mac, sizeof(slot.mac)) == 0;
+    if (unchanged) {
+      continue;
     }
 
-    tft.drawString(id, margin + 12, y + 8, 2);
-    tft.drawString(device.kind + " | " + status, margin + 12, y + 30, 2);
+    drawCard(i, row, focused);
+    slot.valid = true;
+    slot.generation = row.generation;
+    slot.focused = focused;
+    memcpy(slot.mac, row.mac, sizeof(slot.mac));
+  }
+
+  if (lastScrollWindowStart != windowStart || lastScrollTotal != totalDevices) {
+    drawScrollbar(totalDevices);
+    lastScrollWindowStart = windowStart;
+    lastScrollTotal = totalDevices;
   }
 }
 
@@ -0,0 +1,157 @@
+#include "ui_screens.h"
+
+#include "ui_common.h"
+#include "ui_text_cache.h"
+
+#include <app_config.h>
+#include <cstdio>
+
+namespace app::display::ui_component {
+namespace {
+
+static constexpr int MARGIN = 10;
+static constexpr int RADIUS = 10;
+static constexpr int SUMMARY_Y = MARGIN + 34;
+static constexpr int SUMMARY_H = 58;
+static constexpr int HEADER_Y = SUMMARY_Y + SUMMARY_H + 6;
+static constexpr int ROWS_Y = HEADER_Y + 12;
+static constexpr int ROW_H = 12;
+static constexpr int HINT_H = 12;
+
+void formatBytes(char* out, size_t size, uint32_t bytes) {
+  if (bytes >= 1024UL * 1024UL) {
+    snprintf(out, size, "%lu.%luM",
+             static_cast<unsigned long>(bytes / (1024UL * 1024UL)),
+             static_cast<unsigned long>((bytes % (1024UL * 1024UL)) * 10 / (1024UL * 1024UL)));
+  } else {
+    snprintf(out, size, "%luK", static_cast<unsigned long>(bytes / 1024));
+  }
+}
+
+void drawIdleBar(const char* label, int y, uint16_t permille, bool available, uint16_t panelColor) {
+  const int width = tft.width();
+  const int barX = MARGIN + 58;
+  const int barW = width - barX - 60;
+  const int barH = 10;
+
+  tft.setTextDatum(TL_DATUM);
+  drawCachedString(label, MARGIN + 10, y - 1, 2, TFT_WHITE, panelColor);
+
+  tft.fillRoundRect(barX, y, barW, barH, 5, tft.color565(12, 28, 43));
+  const bool low = available && permille < MASTER_TELEMETRY_IDLE_ALERT_PCT * 10;
+  const int fill = available ? static_cast<int>((static_cast<uint32_t>(barW - 4) * permille) / 1000) : 0;
+  if (fill > 0) {
+    tft.fillRect(barX + 2, y + 2, fill, barH - 4, low ? TFT_RED : tft.color565(80, 220, 120));
+  }
+
+  char value[12] = {0};
+  if (available) {
+    snprintf(value, sizeof(value), "%u.%u%%", permille / 10, permille % 10);
+  } else {
+    snprintf(value, sizeof(value), "n/a");
+  }
+  tft.setTextDatum(MR_DATUM);
+  tft.setTextColor(low ? TFT_RED : TFT_WHITE, panelColor);
+  tft.drawString(value, width - MARGIN - 8, y + (barH / 2), 2);
+}
+
+}  // namespace
+
+uint8_t diagnosticsRowsPerPage() {
+  const int rows = (tft.height() - HINT_H - ROWS_Y) / ROW_H;
+  return rows > 0 ? static_cast<uint8_t>(rows) : 1;
+}
+
+void renderDiagnostics(const core::telemetry::Snapshot& snapshot, bool available, uint8_t page) {
+  using namespace core::telemetry;
+
+  tft.fillScreen(colorBackground());
+
+  const int width = tft.width();
+  const uint8_t rowsPerPage = diagnosticsRowsPerPage();
+  const uint8_t pages = snapshot.taskCount == 0 ? 1 : static_cast<uint8_t>((snapshot.taskCount + rowsPerPage - 1) / rowsPerPage);
+  const uint8_t currentPage = page < pages ? page : 0;
+
+  const uint16_t titleColor = snapshot.alerts != 0 ? tft.color565(110, 30, 30) : tft.color565(34, 34, 44);
+  tft.fillRoundRect(MARGIN, MARGIN, width - (MARGIN * 2), 28, RADIUS, titleColor);
+  tft.setTextDatum(ML_DATUM);
+  drawCachedString("DIAGNOSTICS", MARGIN + 10, MARGIN + 14, 2, TFT_WHITE, titleColor);
+
+  char line[48] = {0};
+  snprintf(line, sizeof(line), "%u/%u", currentPage + 1, pages);
+  tft.setTextDatum(MR_DATUM);
+  tft.setTextColor(TFT_WHITE, titleColor);
+  tft.drawString(line, width - MARGIN - 10, MARGIN + 14, 2);
+
+  if (!available) {
+    tft.setTextDatum(MC_DATUM);
+    tft.setTextColor(tft.color565(180, 180, 180), colorBackground());
+    tft.drawString("Waiting for telemetry", width / 2, tft.height() / 2, 2);
+    return;
+  }
+
+  const uint16_t panelColor = tft.color565(20, 45, 66);
+  tft.fillRoundRect(MARGIN, SUMMARY_Y, width - (MARGIN * 2), SUMMARY_H, RADIUS, panelColor);
+  drawIdleBar("IDLE0", SUMMARY_Y + 6, snapshot.idlePermille[0], snapshot.runtimeStats, panelColor);
+  drawIdleBar("IDLE1", SUMMARY_Y + 22, snapshot.idlePermille[1], snapshot.runtimeStats, panelColor);
+
+  char heapFree[12] = {0};
+  char heapBlock[12] = {0};
+  char psramFree[12] = {0};
+  formatBytes(heapFree, sizeof(heapFree), snapshot.internal.freeBytes);
+  formatBytes(heapBlock, sizeof(heapBlock), snapshot.internal.largestBlockBytes);
+  formatBytes(psramFree, sizeof(psramFree), snapshot.psram.freeBytes);
+  snprintf(line, sizeof(line), "HEAP %s blk %s  PSRAM %s", heapFree, heapBlock, psramFree);
+  const bool heapAlert = (snapshot.alerts & (AlertHeap | AlertHeapBlock | AlertPsram)) != 0;
+  tft.setTextDatum(TL_DATUM);
+  tft.setTextColor(heapAlert ? TFT_RED : TFT_WHITE, panelColor);
+  tft.drawString(line, MARGIN + 10, SUMMARY_Y + 42, 1);
+
+  const uint16_t headerColor = tft.color565(160, 160, 160);
+  const int coreX = width - MARGIN - 120;
+  const int prioX = width - MARGIN - 92;
+  const int cpuX = width - MARGIN - 44;
+  const int stackX = width - MARGIN - 4;
+  tft.setTextDatum(TL_DATUM);
+  drawCachedString("TASK", MARGIN + 4, HEADER_Y, 1, headerColor, colorBackground());
+  drawCachedString("CORE", coreX, HEADER_Y, 1, headerColor, colorBackground());
+  drawCachedString("PRI", prioX, HEADER_Y, 1, headerColor, colorBackground());
+  tft.setTextDatum(TR_DATUM);
+  drawCachedString("CPU%", cpuX, HEADER_Y, 1, headerColor, colorBackground());
+  drawCachedString("STACK", stackX, HEADER_Y, 1, headerColor, colorBackground());
+
+  const size_t first = static_cast<size_t>(currentPage) * rowsPerPage;
+  for (size_t row = 0; row < rowsPerPage && first + row < snapshot.taskCount; ++row) {
+    const TaskSample& task = snapshot.tasks[first + row];
+    const int y = ROWS_Y + static_cast<int>(row) * ROW_H;
+    const uint16_t rowColor = (row % 2) == 0 ? colorBackground() : tft.color565(28, 28, 34);
+    tft.fillRect(MARGIN, y - 2, width - (MARGIN * 2), ROW_H, rowColor);
+
+    tft.setTextDatum(TL_DATUM);
+    tft.setTextColor(TFT_WHITE, rowColor);
+    tft.drawString(task.name, MARGIN + 4, y, 1);
+    tft.drawString(task.core == kAnyCore ? "-" : String(task.core), coreX, y, 1);
+    tft.drawString(String(task.priority), prioX, y, 1);
+
+    tft.setTextDatum(TR_DATUM);
+    if (snapshot.runtimeStats) {
+      snprintf(line, sizeof(line), "%u.%u", task.cpuPermille / 10, task.cpuPermille % 10);
+    } else {
+      snprintf(line, sizeof(line), "-");
+    }
+    tft.drawString(line, cpuX, y, 1);
+    tft.setTextColor(task.stackAlert ? TFT_RED : TFT_WHITE, rowColor);
+    tft.drawString(String(task.stackFreeBytes), stackX, y, 1);
+  }
+
+  tft.setTextDatum(MC_DATUM);
+  tft.setTextColor(tft.color565(160, 160, 160), colorBackground());
+  if (snapshot.taskTotal > snapshot.taskCount) {
+    snprintf(line, sizeof(line), "SELECT next page (%u of %u tasks)", snapshot.taskCount, snapshot.taskTotal);
+    tft.drawString(line, width / 2, 232, 1);
+  } else {
+    tft.drawString("SELECT next page, BACK to home", width / 2, 232, 1);
+  }
+}
+
+}  // namespace app::display::ui_component
@@ -1,8 +1,10 @@
 #include "ui_screens.h"
 
 #include "ui_common.h"
+#include "ui_text_cache.h"
 #include "app/espnow/state_binary.h"
 #include "app/espnow/camera_stream_buffer.h"
+#include "app/espnow/camera_recorder.h"
 
 namespace app::display::ui_component {
 
@@ -74,8 +76,11 @@ void renderEspNowControl(DisplayStateData& state, uint8_t focusIndex) {
       const int16_t drawY = previewY + ((previewH - sourceH) / 2);
       // Use setWindow then push pixels per-pixel with pushColor to test
       // endianness / channel ordering differences in the driver path.
-      tft.setWindow(drawX, drawY, drawX + sourceW - 1, drawY + sourceH - 1);
-      tft.pushColors(const_cast<uint16_t*>(previewPixels), static_cast<uint32_t>(sourceW) * sourceH);
+      {
+        profiler::PushScope pushScope;
+        tft.setWindow(drawX, drawY, drawX + sourceW - 1, drawY + sourceH - 1);
+        tft.pushColors(const_cast<uint16_t*>(previewPixels), static_cast<uint32_t>(sourceW) * sourceH);
+      }
 
       tft.setTextDatum(TR_DATUM);
       tft.setTextColor(tft.color565(150, 200, 160), previewBg);
@@ -98,8 +103,8 @@ void renderEspNowControl(DisplayStateData& state, uint8_t focusIndex) {
         actions[2] = "";
       } else {
         actions[0] = "OPEN CAM";
-        actions[1] = "BACK TO LIST";
-        actions[2] = "";
+        actions[1] = app::espnow::camera_recorder::isRecording(state.selectedDeviceMac) ? "STOP REC" : "RECORD";
+        actions[2] = "BACK TO LIST";
       }
     } else if (isWeatherSelection) {
       actions[0] = "VIEW WEATHER";
@@ -116,8 +121,7 @@ void renderEspNowControl(DisplayStateData& state, uint8_t focusIndex) {
     const uint16_t actionColor = focused ? tft.color565(0, 120, 215) : tft.color565(60, 60, 80);
     tft.fillRoundRect(margin + 12, y, panelW - 24, 32, 8, actionColor);
     tft.setTextDatum(MC_DATUM);
-    tft.setTextColor(TFT_WHITE, actionColor);
-    tft.drawString(actions[i], tft.width() / 2, y + 16, 2);
+    drawCachedString(actions[i], tft.width() / 2, y + 16, 2, TFT_WHITE, actionColor);
   }
 }
 
@@ -1,6 +1,8 @@
 #include "ui_screens.h"
 
 #include "ui_common.h"
+#include "ui_sparkline.h"
+#include "ui_text_cache.h"
 #include "ui_weather_icon.h"
 
 namespace app::display::ui_component {
@@ -43,10 +45,11 @@ void renderHomeWeather(DisplayStateData& state, uint8_t focusIndex) {
   tft.setTextColor(TFT_WHITE, heroColor);
   tft.setTextDatum(TL_DATUM);
   tft.setTextSize(1);
-  tft.drawString("WEATHER", heroX + 14, heroY + 12, 2);
+  drawCachedString("WEATHER", heroX + 14, heroY + 12, 2, TFT_WHITE, heroColor);
   tft.drawString(state.clockDmyHi, heroX + 14, heroY + 30, 2);
 
   if (ensureWeatherIconLoaded(state) && state.weatherIconPixels != nullptr) {
+    profiler::PushScope pushScope;
     for (int y = 0; y < iconSize; ++y) {
       const uint16_t* srcRow = state.weatherIconPixels + (y * 32);
       tft.pushImage(iconX, iconY + y, iconSize, 1, srcRow);
@@ -75,26 +78,31 @@ void renderHomeWeather(DisplayStateData& state, uint8_t focusIndex) {
     tft.drawString(weatherLine2, heroX + 14, heroY + 84, 2);
   }
 
+  drawTemperatureTrend(heroX + 14, heroY + 106, heroW - 28, 22, tft.color565(200, 225, 255), heroColor);
+
   tft.setTextDatum(TL_DATUM);
   const uint16_t valueHighlight = tft.color565(255, 255, 220);
-  tft.setTextColor((focusIndex % 3 == 0) ? valueHighlight : TFT_WHITE, tempColor);
-  tft.drawString("TEMP", tempX + 12, metricsY + 10, 2);
+  const uint16_t tempTextColor = (focusIndex % 3 == 0) ? valueHighlight : TFT_WHITE;
+  drawCachedString("TEMP", tempX + 12, metricsY + 10, 2, tempTextColor, tempColor);
+  tft.setTextColor(tempTextColor, tempColor);
 
   String tempValue = state.sensorTemp + "C";
   tft.setTextDatum(MC_DATUM);
   tft.drawString(tempValue, tempX + (metricsW / 2), metricsY + (metricsH / 2) + 8, 2);
 
   tft.setTextDatum(TL_DATUM);
-  tft.setTextColor((focusIndex % 3 == 1) ? valueHighlight : TFT_WHITE, humColor);
-  tft.drawString("HUM", humX + 12, metricsY + 10, 2);
+  const uint16_t humTextColor = (focusIndex % 3 == 1) ? valueHighlight : TFT_WHITE;
+  drawCachedString("HUM", humX + 12, metricsY + 10, 2, humTextColor, humColor);
+  tft.setTextColor(humTextColor, humColor);
 
   String humValue = state.sensorHum + "%";
   tft.setTextDatum(MC_DATUM);
   tft.drawString(humValue, humX + (metricsW / 2), metricsY + (metricsH / 2) + 8, 2);
 
   tft.setTextDatum(TL_DATUM);
-  tft.setTextColor((focusIndex % 3 == 2) ? valueHighlight : TFT_WHITE, battColor);
-  tft.drawString("BATT", battX + 12, metricsY + 10, 2);
+  const uint16_t battTextColor = (focusIndex % 3 == 2) ? valueHighlight : TFT_WHITE;
+  drawCachedString("BATT", battX + 12, metricsY + 10, 2, battTextColor, battColor);
+  tft.setTextColor(battTextColor, battColor);
 
   String battValue = state.sensorBattery;
   if (battValue != "--") {
@@ -0,0 +1,46 @@
+#include "ui_screens.h"
+
+#include "ui_common.h"
+
+#include <cstdio>
+
+namespace app::display::ui_component {
+
+void renderProfilerOverlay(const profiler::FrameSample& last, const profiler::ScreenSummary& summary, uint32_t budgetUs) {
+  const int width = tft.width();
+  const int height = 12;
+  const int y = tft.height() - height;
+
+  uint16_t budgetColor = TFT_GREEN;
+  if (last.cpuUs > budgetUs) {
+    budgetColor = TFT_RED;
+  } else if (last.cpuUs > (budgetUs * 3) / 4) {
+    budgetColor = TFT_ORANGE;
+  }
+
+  const uint16_t overlayBg = tft.color565(12, 12, 16);
+  tft.fillRect(0, y, width, height, overlayBg);
+
+  const int barW = budgetUs == 0 ? 0 : static_cast<int>((static_cast<uint64_t>(last.cpuUs) * 40) / budgetUs);
+  tft.fillRect(3, y + 3, barW > 40 ? 40 : barW, height - 6, budgetColor);
+  tft.drawRect(2, y + 2, 42, height - 4, TFT_DARKGREY);
+
+  char line[64] = {0};
+  snprintf(line,
+           sizeof(line),
+           "%lu.%lu/%lu.%lums spi %luK push %lu.%lu skip %lu",
+           static_cast<unsigned long>(last.cpuUs / 1000),
+           static_cast<unsigned long>((last.cpuUs / 100) % 10),
+           static_cast<unsigned long>(summary.cpuP95Us / 1000),
+           static_cast<unsigned long>((summary.cpuP95Us / 100) % 10),
+           static_cast<unsigned long>(last.spiBytes / 1024),
+           static_cast<unsigned long>(last.pushUs / 1000),
+           static_cast<unsigned long>((last.pushUs / 100) % 10),
+           static_cast<unsigned long>(summary.skipped));
+
+  tft.setTextDatum(ML_DATUM);
+  tft.setTextColor(TFT_WHITE, overlayBg);
+  tft.drawString(line, 48, y + (height / 2), 1);
+}
+
+}  // namespace app::display::ui_component
@@ -1,13 +1,18 @@
 #pragma once
 
+#include "../display_profiler.h"
 #include "../display_state.h"
+#include "core/task_telemetry.h"
 
 namespace app::display::ui_component {
 
-void renderBootAnimation(uint32_t durationMs);
+void renderBootFrame(uint32_t elapsedMs, bool fullRedraw);
 void renderHomeWeather(DisplayStateData& state, uint8_t focusIndex);
 void renderDeviceList(DisplayStateData& state, uint8_t focusIndex);
 void renderEspNowControl(DisplayStateData& state, uint8_t focusIndex);
 void renderSettings(DisplayStateData& state, uint8_t focusIndex);
+void renderDiagnostics(const core::telemetry::Snapshot& snapshot, bool available, uint8_t page);
+uint8_t diagnosticsRowsPerPage();
+void renderProfilerOverlay(const profiler::FrameSample& last, const profiler::ScreenSummary& summary, uint32_t budgetUs);
 
 }  // namespace app::display::ui_component
@@ -1,6 +1,7 @@
 #include "ui_screens.h"
 
 #include "ui_common.h"
+#include "ui_text_cache.h"
 
 namespace app::display::ui_component {
 
@@ -14,8 +15,7 @@ void renderSettings(DisplayStateData& state, uint8_t focusIndex) {
   const uint16_t titleColor = tft.color565(34, 34, 44);
   tft.fillRoundRect(margin, margin, width - (margin * 2), 28, radius, titleColor);
   tft.setTextDatum(ML_DATUM);
-  tft.setTextColor(TFT_WHITE, titleColor);
-  tft.drawString("SETTINGS / HW TEST", margin + 10, margin + 14, 2);
+  drawCachedString("SETTINGS / HW TEST", margin + 10, margin + 14, 2, TFT_WHITE, titleColor);
 
   const int inputPanelY = margin + 34;
   const int inputPanelH = 116;
@@ -28,8 +28,7 @@ void renderSettings(DisplayStateData& state, uint8_t focusIndex) {
 
   auto drawAxisBar = [&](const char* label, int y, int16_t value, uint16_t fillColor) {
     tft.setTextDatum(TL_DATUM);
-    tft.setTextColor(TFT_WHITE, inputPanelColor);
-    tft.drawString(label, margin + 10, y - 1, 2);
+    drawCachedString(label, margin + 10, y - 1, 2, TFT_WHITE, inputPanelColor);
 
     const int centerX = barX + (barW / 2);
     tft.fillRoundRect(barX, y, barW, barH, 6, tft.color565(12, 28, 43));
@@ -53,11 +52,10 @@ void renderSettings(DisplayStateData& state, uint8_t focusIndex) {
   drawAxisBar("A2 Y", inputPanelY + 68, state.inputAnalog2Y, tft.color565(230, 120, 255));
 
   tft.setTextDatum(TL_DATUM);
-  tft.setTextColor(TFT_WHITE, inputPanelColor);
-  tft.drawString("BTN U", margin + 10, inputPanelY + 88, 2);
-  tft.drawString("D", margin + 64, inputPanelY + 88, 2);
-  tft.drawString("S", margin + 86, inputPanelY + 88, 2);
-  tft.drawString("B", margin + 108, inputPanelY + 88, 2);
+  drawCachedString("BTN U", margin + 10, inputPanelY + 88, 2, TFT_WHITE, inputPanelColor);
+  drawCachedString("D", margin + 64, inputPanelY + 88, 2, TFT_WHITE, inputPanelColor);
+  drawCachedString("S", margin + 86, inputPanelY + 88, 2, TFT_WHITE, inputPanelColor);
+  drawCachedString("B", margin + 108, inputPanelY + 88, 2, TFT_WHITE, inputPanelColor);
 
   auto drawIndicator = [&](int x, bool active) {
     tft.fillRoundRect(x, inputPanelY + 102, 14, 10, 4, active ? tft.color565(80, 220, 120) : tft.color565(70, 70, 70));
@@ -88,10 +86,10 @@ void renderSettings(DisplayStateData& state, uint8_t focusIndex) {
     tft.fillRoundRect(margin, y, rowW, rowH, 8, rowColor);
 
     tft.setTextDatum(ML_DATUM);
-    tft.setTextColor(TFT_WHITE, rowColor);
-    tft.drawString(rows[i].label, margin + 10, y + (rowH / 2), 2);
+    drawCachedString(rows[i].label, margin + 10, y + (rowH / 2), 2, TFT_WHITE, rowColor);
 
     tft.setTextDatum(MR_DATUM);
+    tft.setTextColor(TFT_WHITE, rowColor);
     tft.drawString(String(rows[i].value), width - margin - 10, y + (rowH / 2), 2);
   }
 
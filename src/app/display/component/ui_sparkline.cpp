@@ -0,0 +1,99 @@
+#include "ui_sparkline.h"
+
+#include "ui_common.h"
+#include "app/espnow/master_history_store.h"
+
+#include <cstdio>
+
+namespace app::display::ui_component {
+namespace {
+
+static constexpr size_t HOUR_WINDOW = 24;
+static constexpr size_t MINUTE_WINDOW = 120;
+static constexpr size_t MIN_HOUR_POINTS = 6;
+static constexpr int LABEL_W = 56;
+
+// Display task only; kept off the task stack.
+app::espnow::history::RollupPoint trendPoints[MINUTE_WINDOW + 1];
+float trendValues[MINUTE_WINDOW + 1];
+
+}  // namespace
+
+void drawSparkline(int x, int y, int w, int h, const float* values, size_t count, uint16_t lineColor) {
+  if (values == nullptr || count < 2 || w < 2 || h < 2) {
+    return;
+  }
+
+  float minValue = values[0];
+  float maxValue = values[0];
+  for (size_t i = 1; i < count; ++i) {
+    minValue = values[i] < minValue ? values[i] : minValue;
+    maxValue = values[i] > maxValue ? values[i] : maxValue;
+  }
+  const float span = maxValue - minValue;
+
+  auto pointY = [&](float value) {
+    if (span < 0.05f) {
+      return y + (h / 2);
+    }
+    return y + (h - 1) - static_cast<int>(((value - minValue) / span) * (h - 1) + 0.5f);
+  };
+
+  int prevX = x;
+  int prevY = pointY(values[0]);
+  for (size_t i = 1; i < count; ++i) {
+    const int px = x + static_cast<int>((i * static_cast<size_t>(w - 1)) / (count - 1));
+    const int py = pointY(values[i]);
+    tft.drawLine(prevX, prevY, px, py, lineColor);
+    prevX = px;
+    prevY = py;
+  }
+  tft.fillCircle(prevX, prevY, 2, lineColor);
+}
+
+void drawTemperatureTrend(int x, int y, int w, int h, uint16_t lineColor, uint16_t bgColor) {
+  using namespace app::espnow::history;
+
+  uint8_t mac[6] = {0};
+  Metric metric = Metric::WeatherTemperature;
+  if (!findLatestSeries(metric, mac)) {
+    metric = Metric::SensorTemperature;
+    if (!findLatestSeries(metric, mac)) {
+      return;
+    }
+  }
+
+  uint32_t nowSec = 0;
+  if (!nowEpochSeconds(nowSec)) {
+    return;
+  }
+
+  const char* spanLabel = "24h";
+  size_t count = queryRollups(mac, metric, Resolution::Hour, nowSec - (HOUR_WINDOW * 3600), nowSec, trendPoints, HOUR_WINDOW + 1);
+  if (count < MIN_HOUR_POINTS) {
+    spanLabel = "2h";
+    count = queryRollups(mac, metric, Resolution::Minute, nowSec - (MINUTE_WINDOW * 60), nowSec, trendPoints, MINUTE_WINDOW + 1);
+  }
+  if (count < 2) {
+    return;
+  }
+
+  float low = trendPoints[0].min;
+  float high = trendPoints[0].max;
+  for (size_t i = 0; i < count; ++i) {
+    trendValues[i] = trendPoints[i].avg;
+    low = trendPoints[i].min < low ? trendPoints[i].min : low;
+    high = trendPoints[i].max > high ? trendPoints[i].max : high;
+  }
+
+  drawSparkline(x, y, w - LABEL_W, h, trendValues, count, lineColor);
+
+  char range[24] = {0};
+  snprintf(range, sizeof(range), "%.1f-%.1f", low, high);
+  tft.setTextDatum(TR_DATUM);
+  tft.setTextColor(lineColor, bgColor);
+  tft.drawString(spanLabel, x + w, y, 1);
+  tft.drawString(range, x + w, y + h - 8, 1);
+}
+
+}  // namespace app::display::ui_component
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <Arduino.h>
+
+namespace app::display::ui_component {
+
+// Polyline of `values` scaled to the box; draws nothing for fewer than two points.
+void drawSparkline(int x, int y, int w, int h, const float* values, size_t count, uint16_t lineColor);
+
+// Latest outdoor (or, failing that, sensor) temperature trend from the
+// history store: hourly averages over 24 h, or per-minute over 2 h until
+// enough hours have been recorded.
+void drawTemperatureTrend(int x, int y, int w, int h, uint16_t lineColor, uint16_t bgColor);
+
+}  // namespace app::display::ui_component
@@ -0,0 +1,245 @@
+#include "ui_text_cache.h"
+
+#include "ui_common.h"
+#include "../display_profiler.h"
+
+#include <app_config.h>
+#include <esp_heap_caps.h>
+#include <esp_log.h>
+#include <cstring>
+
+namespace app::display::ui_component {
+namespace {
+
+static constexpr const char* TAG = "ui_text_cache";
+static constexpr size_t MAX_ENTRIES = 32;
+static constexpr size_t MAX_TEXT_LEN = 31;
+static constexpr size_t MAX_CACHE_BYTES = 64 * 1024;
+
+struct CachedRun {
+  bool used = false;
+  uint32_t hash = 0;
+  uint8_t font = 0;
+  uint16_t fg = 0;
+  uint16_t bg = 0;
+  char text[MAX_TEXT_LEN + 1] = {0};
+  uint16_t width = 0;
+  uint16_t height = 0;
+  uint16_t* pixels = nullptr;
+  uint32_t lastUseTick = 0;
+};
+
+CachedRun runs[MAX_ENTRIES];
+TextCacheStats stats;
+size_t bytesUsed = 0;
+uint32_t useTick = 0;
+bool enabled = MASTER_UI_TEXT_CACHE != 0;
+
+uint32_t hashRun(const char* text, uint8_t font, uint16_t fg, uint16_t bg) {
+  uint32_t hash = 2166136261UL;
+  for (const char* cursor = text; *cursor != '\0'; ++cursor) {
+    hash = (hash ^ static_cast<uint8_t>(*cursor)) * 16777619UL;
+  }
+  hash = (hash ^ font) * 16777619UL;
+  hash = (hash ^ fg) * 16777619UL;
+  hash = (hash ^ bg) * 16777619UL;
+  return hash;
+}
+
+void releaseRun(CachedRun& run) {
+  if (run.pixels != nullptr) {
+    heap_caps_free(run.pixels);
+    bytesUsed -= static_cast<size_t>(run.width) * run.height * sizeof(uint16_t);
+  }
+  run = CachedRun{};
+}
+
+CachedRun* findRun(uint32_t hash, const char* text, uint8_t font, uint16_t fg, uint16_t bg) {
+  for (auto& run : runs) {
+    if (!run.used || run.hash != hash) {
+      continue;
+    }
+    if (run.font == font && run.fg == fg && run.bg == bg && strcmp(run.text, text) == 0) {
+      return &run;
+    }
+  }
+  return nullptr;
+}
+
+CachedRun* findLeastRecentlyUsed() {
+  CachedRun* oldest = nullptr;
+  for (auto& run : runs) {
+    if (!run.used) {
+      return &run;
+    }
+    if (oldest == nullptr || run.lastUseTick < oldest->lastUseTick) {
+      oldest = &run;
+    }
+  }
+  return oldest;
+}
+
+bool makeRoom(size_t bytesNeeded) {
+  while (bytesUsed + bytesNeeded > MAX_CACHE_BYTES) {
+    CachedRun* victim = nullptr;
+    for (auto& run : runs) {
+      if (run.used && (victim == nullptr || run.lastUseTick < victim->lastUseTick)) {
+        victim = &run;
+      }
+    }
+    if (victim == nullptr) {
+      return false;
+    }
+    releaseRun(*victim);
+    stats.evictions++;
+  }
+  return true;
+}
+
+CachedRun* renderRun(uint32_t hash, const char* text, uint8_t font, uint16_t fg, uint16_t bg) {
+  const int16_t width = tft.textWidth(text, font);
+  const int16_t height = tft.fontHeight(font);
+  if (width <= 0 || height <= 0) {
+    return nullptr;
+  }
+
+  const size_t bytes = static_cast<size_t>(width) * height * sizeof(uint16_t);
+  if (bytes > MAX_CACHE_BYTES / 4 || !makeRoom(bytes)) {
+    return nullptr;
+  }
+
+  CachedRun* slot = findLeastRecentlyUsed();
+  if (slot == nullptr) {
+    return nullptr;
+  }
+  if (slot->used) {
+    releaseRun(*slot);
+    stats.evictions++;
+  }
+
+  auto* pixels = static_cast<uint16_t*>(heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+  if (pixels == nullptr) {
+    return nullptr;
+  }
+
+  TFT_eSprite sprite(&tft);
+  sprite.setColorDepth(16);
+  if (sprite.createSprite(width, height) == nullptr) {
+    heap_caps_free(pixels);
+    ESP_LOGW(TAG, "Sprite alloc failed for text run %dx%d", width, height);
+    return nullptr;
+  }
+
+  sprite.fillSprite(bg);
+  sprite.setTextDatum(TL_DATUM);
+  sprite.setTextColor(fg, bg);
+  sprite.drawString(text, 0, 0, font);
+  memcpy(pixels, sprite.getPointer(), bytes);
+  sprite.deleteSprite();
+
+  slot->used = true;
+  slot->hash = hash;
+  slot->font = font;
+  slot->fg = fg;
+  slot->bg = bg;
+  strncpy(slot->text, text, MAX_TEXT_LEN);
+  slot->text[MAX_TEXT_LEN] = '\0';
+  slot->width = static_cast<uint16_t>(width);
+  slot->height = static_cast<uint16_t>(height);
+  slot->pixels = pixels;
+  bytesUsed += bytes;
+  return slot;
+}
+
+void applyDatum(uint8_t datum, uint16_t width, uint16_t height, int32_t& x, int32_t& y) {
+  switch (datum) {
+    case TC_DATUM: x -= width / 2; break;
+    case TR_DATUM: x -= width; break;
+    case ML_DATUM: y -= height / 2; break;
+    case MC_DATUM: x -= width / 2; y -= height / 2; break;
+    case MR_DATUM: x -= width; y -= height / 2; break;
+    case BL_DATUM: y -= height; break;
+    case BC_DATUM: x -= width / 2; y -= height; break;
+    case BR_DATUM: x -= width; y -= height; break;
+    default: break;
+  }
+}
+
+void drawDirect(const char* text, int32_t x, int32_t y, uint8_t font, uint16_t fg, uint16_t bg) {
+  tft.setTextColor(fg, bg);
+  tft.drawString(text, x, y, font);
+}
+
+}  // namespace
+
+void drawCachedString(const char* text, int32_t x, int32_t y, uint8_t font, uint16_t fg, uint16_t bg) {
+  if (text == nullptr || text[0] == '\0') {
+    return;
+  }
+
+  const uint8_t datum = tft.getTextDatum();
+  const bool cacheableDatum = datum <= BR_DATUM;
+  if (!enabled || !cacheableDatum || strlen(text) > MAX_TEXT_LEN) {
+    stats.bypassed++;
+    drawDirect(text, x, y, font, fg, bg);
+    return;
+  }
+
+  const uint32_t hash = hashRun(text, font, fg, bg);
+  CachedRun* run = findRun(hash, text, font, fg, bg);
+  if (run != nullptr) {
+    stats.hits++;
+  } else {
+    stats.misses++;
+    run = renderRun(hash, text, font, fg, bg);
+  }
+
+  if (run == nullptr) {
+    drawDirect(text, x, y, font, fg, bg);
+    return;
+  }
+
+  run->lastUseTick = ++useTick;
+  applyDatum(datum, run->width, run->height, x, y);
+
+  profiler::PushScope pushScope;
+  const bool swapBytes = tft.getSwapBytes();
+  tft.setSwapBytes(false);
+  tft.pushImage(x, y, run->width, run->height, run->pixels);
+  tft.setSwapBytes(swapBytes);
+}
+
+void setTextCacheEnabled(bool value) {
+  enabled = value;
+}
+
+bool isTextCacheEnabled() {
+  return enabled;
+}
+
+void clearTextCache() {
+  for (auto& run : runs) {
+    if (run.used) {
+      releaseRun(run);
+    }
+  }
+  bytesUsed = 0;
+}
+
+TextCacheStats getTextCacheStats() {
+  TextCacheStats out = stats;
+  out.bytesUsed = bytesUsed;
+  out.entries = 0;
+  for (const auto& run : runs) {
+    if (run.used) {
+      out.entries++;
+    }
+  }
+  return out;
+}
+
+void resetTextCacheStats() {
+  stats = TextCacheStats{};
+}
+
+}  // namespace app::display::ui_component
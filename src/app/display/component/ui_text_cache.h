@@ -0,0 +1,26 @@
+#pragma once
+
+#include <Arduino.h>
+
+namespace app::display::ui_component {
+
+struct TextCacheStats {
+  uint32_t hits = 0;
+  uint32_t misses = 0;
+  uint32_t evictions = 0;
+  uint32_t bypassed = 0;
+  size_t entries = 0;
+  size_t bytesUsed = 0;
+};
+
+// Draws a static label through a PSRAM cache of pre-rendered text runs keyed on
+// (text, font, fg, bg). Honors the current tft text datum like drawString().
+void drawCachedString(const char* text, int32_t x, int32_t y, uint8_t font, uint16_t fg, uint16_t bg);
+
+void setTextCacheEnabled(bool enabled);
+bool isTextCacheEnabled();
+void clearTextCache();
+TextCacheStats getTextCacheStats();
+void resetTextCacheStats();
+
+}  // namespace app::display::ui_component
@@ -236,4 +236,14 @@ bool ensureWeatherIconLoaded(DisplayStateData& state) {
   return state.weatherIconLoaded;
 }
 
+bool preloadWeatherIcon(DisplayStateData& state, int weatherCode) {
+  if (state.weatherIconPixels == nullptr) {
+    return false;
+  }
+
+  state.loadedWeatherCode = weatherCode;
+  state.weatherIconLoaded = loadWeatherIconPixels(weatherCodeToIconFile(weatherCode), state.weatherIconPixels);
+  return state.weatherIconLoaded;
+}
+
 }  // namespace app::display::ui_component
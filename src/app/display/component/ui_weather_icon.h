@@ -6,5 +6,6 @@ namespace app::display::ui_component {
 
 size_t weatherIconBytes();
 bool ensureWeatherIconLoaded(DisplayStateData& state);
+bool preloadWeatherIcon(DisplayStateData& state, int weatherCode);
 
 }  // namespace app::display::ui_component
@@ -1,11 +1,18 @@
 #include "display_interface.h"
 
+#include "display_profiler.h"
 #include "display_state.h"
 #include "display_ui.h"
+#include "app/espnow/camera_recorder.h"
 #include "app/espnow/master.h"
 #include "app/espnow/state_binary.h"
+#include "core/boot.h"
+#include "core/task_telemetry.h"
 
 #include <app_config.h>
+#include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 #include <time.h>
 #include <cstdio>
 #include <cstring>
@@ -13,9 +20,11 @@
 namespace app::display {
 namespace {
 
+static constexpr const char* TAG = "display_if";
 static constexpr uint32_t MIN_RENDER_INTERVAL_MS = 120;
 static constexpr uint32_t CLOCK_CHECK_INTERVAL_MS = 1000;
-static constexpr uint32_t BOOT_ANIMATION_MS = 2200;
+static constexpr uint32_t BOOT_ANIMATION_MIN_MS = 600;
+static constexpr uint32_t BOOT_FRAME_INTERVAL_MS = 33;
 static constexpr uint32_t BOOT_GUARD_EXTRA_MS = 400;
 
 String formatClockDmyHi(const tm& timeInfo) {
@@ -28,6 +37,10 @@ int buildMinuteKey(const tm& timeInfo) {
   return ((timeInfo.tm_year + 1900) * 1000) + (timeInfo.tm_yday * 24 * 60) + (timeInfo.tm_hour * 60) + timeInfo.tm_min;
 }
 
+void onBootFrameTimer(void* arg) {
+  xTaskNotifyGive(static_cast<TaskHandle_t>(arg));
+}
+
 }  // namespace
 
 DisplayInterface displayInterface;
@@ -41,9 +54,7 @@ bool DisplayInterface::begin() {
     return false;
   }
 
-  ui_logic::renderBootAnimation(BOOT_ANIMATION_MS);
-
-  configTime(25200, 0, "pool.ntp.org", "time.google.com");
+  ui_logic::startAssetPreload(stateData);
 
   started = true;
   lastRenderMs = 0;
@@ -52,18 +63,97 @@ bool DisplayInterface::begin() {
   lastScrollMs = 0;
   lastActionMs = 0;
   scrollCooldownMs = MASTER_UI_SCROLL_COOLDOWN_MS;
-  bootGuardUntilMs = millis() + BOOT_GUARD_EXTRA_MS;
+  bootGuardUntilMs = UINT32_MAX;
   syncUiSettingsToState();
   updateClockDmyHi();
+  fullRedrawPending = true;
   dirty = true;
+
+  if (!startBootAnimation()) {
+    finishBoot();
+  }
+  return true;
+}
+
+bool DisplayInterface::startBootAnimation() {
+  esp_timer_create_args_t timerArgs = {};
+  timerArgs.callback = onBootFrameTimer;
+  timerArgs.arg = xTaskGetCurrentTaskHandle();
+  timerArgs.dispatch_method = ESP_TIMER_TASK;
+  timerArgs.name = "boot_frame";
+
+  if (esp_timer_create(&timerArgs, &bootFrameTimer) != ESP_OK) {
+    ESP_LOGW(TAG, "Boot frame timer unavailable, skipping animation");
+    bootFrameTimer = nullptr;
+    return false;
+  }
+
+  booting = true;
+  bootStartMs = millis();
+  lastBootFrameMs = 0;
+  bootFrameCount = 0;
+  esp_timer_start_periodic(bootFrameTimer, BOOT_FRAME_INTERVAL_MS * 1000ULL);
+  tickBootAnimation(bootStartMs);
   return true;
 }
 
+// Runs one animation frame per timer tick; the display task sleeps on a task
+// notification in between instead of spinning in delay().
+void DisplayInterface::tickBootAnimation(uint32_t now) {
+  if (bootFrameCount > 0 && (now - lastBootFrameMs) < BOOT_FRAME_INTERVAL_MS) {
+    return;
+  }
+
+  const uint32_t elapsed = now - bootStartMs;
+  ui_logic::renderBootFrame(elapsed, bootFrameCount == 0);
+  if (bootFrameCount == 0) {
+    core::boot::mark(core::boot::FirstFrame);
+  }
+  bootFrameCount++;
+  lastBootFrameMs = now;
+
+  if (elapsed >= BOOT_ANIMATION_MIN_MS && core::boot::isReached(core::boot::AssetsReady)) {
+    finishBoot();
+  }
+}
+
+void DisplayInterface::finishBoot() {
+  if (bootFrameTimer != nullptr) {
+    esp_timer_stop(bootFrameTimer);
+    esp_timer_delete(bootFrameTimer);
+    bootFrameTimer = nullptr;
+  }
+
+  if (booting) {
+    ESP_LOGI(TAG,
+             "Boot animation done: %lu frames in %lu ms",
+             static_cast<unsigned long>(bootFrameCount),
+             static_cast<unsigned long>(millis() - bootStartMs));
+  }
+  booting = false;
+
+#if MASTER_UI_TEXT_CACHE_BENCH
+  ui_logic::benchmarkHomeRender(stateData, MASTER_UI_TEXT_CACHE_BENCH_ITERATIONS);
+#endif
+
+  bootGuardUntilMs = millis() + BOOT_GUARD_EXTRA_MS;
+  pullFromStateStore();
+  fullRedrawPending = true;
+  requestRender();
+}
+
 void DisplayInterface::requestRender() {
   lastEventMs = millis();
   dirty = true;
 }
 
+void DisplayInterface::toggleProfilerOverlay() {
+  profiler::setOverlayEnabled(!profiler::isOverlayEnabled());
+  ESP_LOGI(TAG, "Profiler overlay %s", profiler::isOverlayEnabled() ? "on" : "off");
+  fullRedrawPending = true;
+  requestRender();
+}
+
 void DisplayInterface::setScreenState(ScreenState state) {
   if (screenState == state) {
     return;
@@ -90,6 +180,8 @@ uint8_t DisplayInterface::getFocusMaxIndex() const {
       return static_cast<uint8_t>(MASTER_UI_FOCUS_MAX_ESPNOW_CONTROL);
     case ScreenState::Settings:
       return static_cast<uint8_t>(MASTER_UI_FOCUS_MAX_SETTINGS);
+    case ScreenState::Diagnostics:
+      return ui_logic::getDiagnosticsFocusMax();
     default:
       return static_cast<uint8_t>(MASTER_UI_FOCUS_MAX_HOME);
   }
@@ -116,7 +208,7 @@ void DisplayInterface::moveFocus(int8_t delta) {
 }
 
 void DisplayInterface::nextScreen() {
-  if (screenState == ScreenState::Settings) {
+  if (screenState == ScreenState::Diagnostics) {
     setScreenState(ScreenState::HomeWeather);
     return;
   }
@@ -125,7 +217,7 @@ void DisplayInterface::nextScreen() {
 
 void DisplayInterface::prevScreen() {
   if (screenState == ScreenState::HomeWeather) {
-    setScreenState(ScreenState::Settings);
+    setScreenState(ScreenState::Diagnostics);
     return;
   }
   setScreenState(static_cast<ScreenState>(static_cast<uint8_t>(screenState) - 1));
@@ -192,6 +284,13 @@ void DisplayInterface::handleActionButtonPress(uint8_t index) {
     }
   }
 
+  // SELECT pages through the task list and wraps back to the first page.
+  if (screenState == ScreenState::Diagnostics && index == 2) {
+    uiFocusIndex = uiFocusIndex >= getFocusMaxIndex() ? getFocusMinIndex() : static_cast<uint8_t>(uiFocusIndex + 1);
+    requestRender();
+    return;
+  }
+
   if (screenState == ScreenState::DeviceList && index == 2) {
     bindSelectedDeviceFromFocus();
     setScreenState(ScreenState::EspNowControl);
@@ -311,6 +410,13 @@ void DisplayInterface::executeEspNowControlAction() {
       return;
     }
 
+    if (action == 1) {
+      const bool recording = !app::espnow::camera_recorder::isRecording(stateData.selectedDeviceMac);
+      app::espnow::camera_recorder::setRecording(stateData.selectedDeviceMac, recording);
+      stateData.selectedDeviceStatus = recording ? "recording" : "recording stopped";
+      return;
+    }
+
     if (action != 0) {
       setScreenState(ScreenState::DeviceList);
       return;
@@ -534,6 +640,10 @@ bool DisplayInterface::applyStatePayload(const String& payload) {
 }
 
 void DisplayInterface::render() {
+  stateData.uiFullRedraw = fullRedrawPending || (screenState != lastRenderedScreen);
+  fullRedrawPending = false;
+  lastRenderedScreen = screenState;
+
   switch (screenState) {
     case ScreenState::HomeWeather:
       ui_logic::renderHomeWeather(stateData, uiFocusIndex);
@@ -547,6 +657,9 @@ void DisplayInterface::render() {
     case ScreenState::Settings:
       ui_logic::renderSettings(stateData, uiFocusIndex);
       break;
+    case ScreenState::Diagnostics:
+      ui_logic::renderDiagnostics(stateData, uiFocusIndex);
+      break;
     default:
       ui_logic::renderHomeWeather(stateData, uiFocusIndex);
       break;
@@ -625,16 +738,32 @@ void DisplayInterface::loop() {
 
   const uint32_t now = millis();
 
+  if (booting) {
+    tickBootAnimation(now);
+    return;
+  }
+
   if (lastClockCheckMs == 0 || (now - lastClockCheckMs) >= CLOCK_CHECK_INTERVAL_MS) {
     lastClockCheckMs = now;
     updateClockDmyHi();
   }
 
+  profiler::logSummaryIfDue(now);
+
+  if (screenState == ScreenState::Diagnostics) {
+    const uint32_t sequence = core::telemetry::getSequence();
+    if (sequence != lastDiagnosticsSequence) {
+      lastDiagnosticsSequence = sequence;
+      requestRender();
+    }
+  }
+
   if (!dirty) {
     return;
   }
 
   if (lastRenderMs != 0 && (now - lastRenderMs) < renderMinIntervalMs) {
+    profiler::noteSkippedRender(screenState);
     return;
   }
 
@@ -642,9 +771,23 @@ void DisplayInterface::loop() {
     refreshSelectedDeviceSnapshot();
   }
 
+  profiler::beginFrame(screenState);
   render();
+  profiler::endFrame();
+
+  if (profiler::isOverlayEnabled()) {
+    profiler::ScreenSummary summary;
+    profiler::getScreenSummary(screenState, summary);
+    ui_logic::renderProfilerOverlay(profiler::getLastFrame(), summary, static_cast<uint32_t>(renderMinIntervalMs) * 1000U);
+  }
+
   dirty = false;
   lastRenderMs = now;
+
+  if (!uiReadyMarked) {
+    uiReadyMarked = true;
+    core::boot::mark(core::boot::UiReady);
+  }
 }
 
 }  // namespace app::display
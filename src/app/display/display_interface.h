@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Arduino.h>
+#include <esp_timer.h>
 #include "display_state.h"
 
 namespace app::display {
@@ -10,6 +11,7 @@ enum class ScreenState : uint8_t {
   DeviceList = 1,
   EspNowControl = 2,
   Settings = 3,
+  Diagnostics = 4,
 };
 
 class DisplayInterface {
@@ -25,6 +27,7 @@ class DisplayInterface {
 
   void setButtonState(uint8_t index, bool pressed);
   void setAnalogValue(uint8_t index, int16_t value);
+  void toggleProfilerOverlay();
 
  private:
   bool started = false;
@@ -43,8 +46,17 @@ class DisplayInterface {
   uint32_t lastRenderMs = 0;
   uint32_t lastClockCheckMs = 0;
   uint32_t lastEventMs = 0;
+  uint32_t lastDiagnosticsSequence = 0;
   uint32_t bootGuardUntilMs = 0;
+  bool booting = false;
+  bool uiReadyMarked = false;
+  uint32_t bootStartMs = 0;
+  uint32_t lastBootFrameMs = 0;
+  uint32_t bootFrameCount = 0;
+  esp_timer_handle_t bootFrameTimer = nullptr;
   bool dirty = true;
+  bool fullRedrawPending = true;
+  ScreenState lastRenderedScreen = ScreenState::HomeWeather;
   DisplayStateData stateData;
 
   uint16_t renderMinIntervalMs = 120;
@@ -54,6 +66,9 @@ class DisplayInterface {
   uint16_t scrollCooldownMs = 120;
   uint16_t actionCooldownMs = 180;
 
+  bool startBootAnimation();
+  void tickBootAnimation(uint32_t now);
+  void finishBoot();
   bool updateClockDmyHi();
   void nextScreen();
   void prevScreen();
@@ -0,0 +1,177 @@
+#include "display_profiler.h"
+
+#include "display_interface.h"
+
+#include <app_config.h>
+#include <esp_log.h>
+#include <algorithm>
+
+namespace app::display::profiler {
+namespace {
+
+static constexpr const char* TAG = "display_prof";
+static constexpr size_t SCREEN_COUNT = 5;
+static constexpr size_t RING_SIZE = 64;
+static constexpr bool PROFILER_ENABLED = MASTER_DISPLAY_PROFILER != 0;
+
+static constexpr const char* SCREEN_NAMES[SCREEN_COUNT] = {"home", "devices", "control", "settings", "diagnostics"};
+
+struct ScreenRing {
+  FrameSample samples[RING_SIZE];
+  size_t head = 0;
+  size_t count = 0;
+  uint32_t framesSinceLog = 0;
+  uint32_t skippedSinceLog = 0;
+  bool skipPending = false;
+};
+
+ScreenRing rings[SCREEN_COUNT];
+FrameSample current;
+FrameSample lastFrame;
+size_t currentScreen = 0;
+uint32_t frameStartUs = 0;
+bool frameActive = false;
+bool overlayEnabled = MASTER_DISPLAY_PROFILER_OVERLAY != 0;
+uint32_t lastLogMs = 0;
+
+size_t screenIndex(ScreenState screen) {
+  const size_t index = static_cast<size_t>(screen);
+  return index < SCREEN_COUNT ? index : 0;
+}
+
+uint32_t percentile(uint32_t* values, size_t count, uint8_t pct) {
+  if (count == 0) {
+    return 0;
+  }
+  const size_t rank = ((count - 1) * pct) / 100;
+  std::nth_element(values, values + rank, values + count);
+  return values[rank];
+}
+
+}  // namespace
+
+void beginFrame(ScreenState screen) {
+  if (!PROFILER_ENABLED) {
+    return;
+  }
+  currentScreen = screenIndex(screen);
+  current = FrameSample{};
+  frameActive = true;
+  frameStartUs = micros();
+}
+
+void endFrame() {
+  if (!PROFILER_ENABLED || !frameActive) {
+    return;
+  }
+  frameActive = false;
+  current.cpuUs = micros() - frameStartUs;
+  lastFrame = current;
+
+  ScreenRing& ring = rings[currentScreen];
+  ring.samples[ring.head] = current;
+  ring.head = (ring.head + 1) % RING_SIZE;
+  if (ring.count < RING_SIZE) {
+    ring.count++;
+  }
+  ring.framesSinceLog++;
+  ring.skipPending = false;
+}
+
+void noteSkippedRender(ScreenState screen) {
+  if (!PROFILER_ENABLED) {
+    return;
+  }
+  // Count one skip per deferred frame, not one per throttled loop pass.
+  ScreenRing& ring = rings[screenIndex(screen)];
+  if (!ring.skipPending) {
+    ring.skipPending = true;
+    ring.skippedSinceLog++;
+  }
+}
+
+void addSpiBytes(uint32_t bytes) {
+  if (frameActive) {
+    current.spiBytes += bytes;
+  }
+}
+
+void addPushBlockedUs(uint32_t us) {
+  if (frameActive) {
+    current.pushUs += us;
+  }
+}
+
+FrameSample getLastFrame() {
+  return lastFrame;
+}
+
+bool getScreenSummary(ScreenState screen, ScreenSummary& out) {
+  const ScreenRing& ring = rings[screenIndex(screen)];
+  out = ScreenSummary{};
+  out.frames = ring.framesSinceLog;
+  out.skipped = ring.skippedSinceLog;
+  if (ring.count == 0) {
+    return false;
+  }
+
+  uint32_t cpu[RING_SIZE];
+  uint32_t spi[RING_SIZE];
+  uint32_t push[RING_SIZE];
+  for (size_t i = 0; i < ring.count; ++i) {
+    cpu[i] = ring.samples[i].cpuUs;
+    spi[i] = ring.samples[i].spiBytes;
+    push[i] = ring.samples[i].pushUs;
+    out.cpuMaxUs = std::max(out.cpuMaxUs, cpu[i]);
+    out.spiBytesMax = std::max(out.spiBytesMax, spi[i]);
+  }
+
+  out.cpuP50Us = percentile(cpu, ring.count, 50);
+  out.cpuP95Us = percentile(cpu, ring.count, 95);
+  out.spiBytesP50 = percentile(spi, ring.count, 50);
+  out.pushP95Us = percentile(push, ring.count, 95);
+  return true;
+}
+
+void logSummaryIfDue(uint32_t nowMs) {
+  if (!PROFILER_ENABLED) {
+    return;
+  }
+  if (lastLogMs != 0 && (nowMs - lastLogMs) < MASTER_DISPLAY_PROFILER_LOG_MS) {
+    return;
+  }
+  lastLogMs = nowMs;
+
+  for (size_t i = 0; i < SCREEN_COUNT; ++i) {
+    ScreenSummary summary;
+    const ScreenState screen = static_cast<ScreenState>(i);
+    if (!getScreenSummary(screen, summary) || (summary.frames == 0 && summary.skipped == 0)) {
+      continue;
+    }
+
+    ESP_LOGI(TAG,
+             "%s: frames=%lu skipped=%lu cpu p50=%lu p95=%lu max=%lu us spi p50=%lu max=%lu B push p95=%lu us",
+             SCREEN_NAMES[i],
+             static_cast<unsigned long>(summary.frames),
+             static_cast<unsigned long>(summary.skipped),
+             static_cast<unsigned long>(summary.cpuP50Us),
+             static_cast<unsigned long>(summary.cpuP95Us),
+             static_cast<unsigned long>(summary.cpuMaxUs),
+             static_cast<unsigned long>(summary.spiBytesP50),
+             static_cast<unsigned long>(summary.spiBytesMax),
+             static_cast<unsigned long>(summary.pushP95Us));
+
+    rings[i].framesSinceLog = 0;
+    rings[i].skippedSinceLog = 0;
+  }
+}
+
+void setOverlayEnabled(bool enabled) {
+  overlayEnabled = PROFILER_ENABLED && enabled;
+}
+
+bool isOverlayEnabled() {
+  return overlayEnabled;
+}
+
+}  // namespace app::display::profiler
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <Arduino.h>
+
+namespace app::display {
+
+enum class ScreenState : uint8_t;
+
+namespace profiler {
+
+struct FrameSample {
+  uint32_t cpuUs = 0;
+  uint32_t spiBytes = 0;
+  uint32_t pushUs = 0;
+};
+
+struct ScreenSummary {
+  uint32_t frames = 0;
+  uint32_t skipped = 0;
+  uint32_t cpuP50Us = 0;
+  uint32_t cpuP95Us = 0;
+  uint32_t cpuMaxUs = 0;
+  uint32_t spiBytesP50 = 0;
+  uint32_t spiBytesMax = 0;
+  uint32_t pushP95Us = 0;
+};
+
+void beginFrame(ScreenState screen);
+void endFrame();
+void noteSkippedRender(ScreenState screen);
+
+// Called from the TFT write path and push call sites; ignored outside a frame.
+void addSpiBytes(uint32_t bytes);
+void addPushBlockedUs(uint32_t us);
+
+FrameSample getLastFrame();
+bool getScreenSummary(ScreenState screen, ScreenSummary& out);
+void logSummaryIfDue(uint32_t nowMs);
+
+void setOverlayEnabled(bool enabled);
+bool isOverlayEnabled();
+
+// Accumulates time spent blocked in a pixel push (pushImage/pushColors).
+class PushScope {
+ public:
+  PushScope() : startUs(micros()) {}
+  ~PushScope() { addPushBlockedUs(micros() - startUs); }
+
+ private:
+  uint32_t startUs;
+};
+
+}  // namespace profiler
+}  // namespace app::display
@@ -24,6 +24,28 @@ String trimUnit(const String& value, const char* suffix) {
   return out;
 }
 
+app::espnow::codec::Span trimUnit(app::espnow::codec::Span value, const char* suffix) {
+  const size_t suffixLen = suffix == nullptr ? 0 : strlen(suffix);
+  if (suffixLen == 0 || value.size < suffixLen
+      || strncasecmp(value.data + value.size - suffixLen, suffix, suffixLen) != 0) {
+    return value;
+  }
+
+  value.size = static_cast<uint16_t>(value.size - suffixLen);
+  while (value.size > 0 && value.data[value.size - 1] == ' ') {
+    value.size--;
+  }
+  return value;
+}
+
+bool assignIfChanged(String& target, app::espnow::codec::Span value) {
+  if (value.equals(target.c_str())) {
+    return false;
+  }
+  target = value.toString();
+  return true;
+}
+
 bool getFirstAvailableSensorValue(const char* const* keys, size_t keyCount, String& outValue) {
   using app::espnow::state_store::getLatestValue;
   for (size_t i = 0; i < keyCount; ++i) {
@@ -155,67 +177,54 @@ bool applyStatePayload(DisplayStateData& state, const String& payload) {
     return false;
   }
 
-  String stateName;
-  if (!app::espnow::codec::getField(payload, "state", stateName) || stateName.isEmpty()) {
+  const app::espnow::codec::PayloadView view(payload);
+  app::espnow::codec::Span stateName;
+  if (!view.get("state", stateName)) {
     return false;
   }
 
   bool changed = false;
+  app::espnow::codec::Span field;
 
-  if (stateName == "weather") {
-    String code;
-    if (app::espnow::codec::getField(payload, "code", code) && !code.isEmpty()) {
-      const int codeValue = code.toInt();
-      const String nextLabel = weatherCodeToText(codeValue);
+  if (stateName.equals("weather")) {
+    long codeValue = 0;
+    if (view.get("code", field) && field.toLong(codeValue)) {
+      const String nextLabel = weatherCodeToText(static_cast<int>(codeValue));
       if (state.weatherLabel != nextLabel) {
         state.weatherLabel = nextLabel;
         changed = true;
       }
       if (state.weatherCode != codeValue) {
-        state.weatherCode = codeValue;
+        state.weatherCode = static_cast<int>(codeValue);
         changed = true;
       }
     }
 
-    String time;
-    if (app::espnow::codec::getField(payload, "time", time) && !time.isEmpty()) {
-      if (state.weatherTime != time) {
-        state.weatherTime = time;
-        changed = true;
-      }
+    if (view.get("time", field)) {
+      changed |= assignIfChanged(state.weatherTime, field);
     }
-  } else if (stateName == "sensor") {
-    String temp;
-    if (app::espnow::codec::getField(payload, "temp", temp)) {
-      const String normalized = trimUnit(temp, "C");
-      if (!normalized.isEmpty() && state.sensorTemp != normalized) {
-        state.sensorTemp = normalized;
-        changed = true;
+  } else if (stateName.equals("sensor")) {
+    if (view.get("temp", field)) {
+      const auto normalized = trimUnit(field, "C");
+      if (!normalized.empty()) {
+        changed |= assignIfChanged(state.sensorTemp, normalized);
       }
     }
 
-    String hum;
-    if (app::espnow::codec::getField(payload, "hum", hum)) {
-      const String normalized = trimUnit(hum, "%");
-      if (!normalized.isEmpty() && state.sensorHum != normalized) {
-        state.sensorHum = normalized;
-        changed = true;
+    if (view.get("hum", field)) {
+      const auto normalized = trimUnit(field, "%");
+      if (!normalized.empty()) {
+        changed |= assignIfChanged(state.sensorHum, normalized);
       }
     }
 
-    String batt;
-    bool hasBatt = app::espnow::codec::getField(payload, "batt", batt)
-                || app::espnow::codec::getField(payload, "battery", batt)
-                || app::espnow::codec::getField(payload, "bat", batt)
-                || app::espnow::codec::getField(payload, "voltage", batt)
-                || app::espnow::codec::getField(payload, "vbat", batt);
+    const bool hasBatt = view.get("batt", field)
+                      || view.get("battery", field)
+                      || view.get("bat", field)
+                      || view.get("voltage", field)
+                      || view.get("vbat", field);
     if (hasBatt) {
-      batt.trim();
-      const String normalized = batt.isEmpty() ? "--" : batt;
-      if (state.sensorBattery != normalized) {
-        state.sensorBattery = normalized;
-        changed = true;
-      }
+      changed |= assignIfChanged(state.sensorBattery, field);
     }
   }
 
@@ -25,6 +25,7 @@ struct DisplayStateData {
   int16_t uiAnalogDeadzone = 3;
   int16_t uiAnalogNavThreshold = 40;
   bool uiSettingsEditMode = false;
+  bool uiFullRedraw = true;
   String selectedDeviceId = "";
   String selectedDeviceKind = "";
   String selectedDeviceStatus = "";
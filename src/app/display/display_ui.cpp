@@ -2,17 +2,52 @@
 
 #include "component/ui_common.h"
 #include "component/ui_screens.h"
+#include "component/ui_text_cache.h"
 #include "component/ui_weather_icon.h"
 
+#include "app/espnow/master_state_kv_store.h"
+#include "core/boot.h"
+#include "core/task_telemetry.h"
+#include "core/task_topology.h"
+
 #include <Arduino.h>
 #include <esp_heap_caps.h>
 #include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 
 namespace app::display::ui_logic {
 namespace {
 
 static constexpr const char* TAG = "display_if";
 
+// Kept off the display task stack.
+core::telemetry::Snapshot diagnosticsSnapshot;
+
+// Decodes the icon for the last stored weather code while the boot animation
+// runs, so the first home frame does not stall on PNG decode.
+void assetPreloadTask(void* arg) {
+  auto* state = static_cast<DisplayStateData*>(arg);
+  core::boot::waitFor(core::boot::FsReady, portMAX_DELAY);
+
+  int weatherCode = state->weatherCode;
+  String storedCode;
+  if (app::espnow::state_store::getLatestValue("weather", "code", storedCode) && !storedCode.isEmpty()) {
+    weatherCode = storedCode.toInt();
+  }
+
+  const uint32_t startMs = millis();
+  const bool loaded = ui_component::preloadWeatherIcon(*state, weatherCode);
+  ESP_LOGI(TAG,
+           "Weather icon preload code=%d %s in %lu ms",
+           weatherCode,
+           loaded ? "ok" : "failed",
+           static_cast<unsigned long>(millis() - startMs));
+
+  core::boot::mark(core::boot::AssetsReady);
+  vTaskDelete(nullptr);
+}
+
 }  // namespace
 
 bool begin(DisplayStateData& state) {
@@ -44,8 +79,20 @@ bool begin(DisplayStateData& state) {
   return true;
 }
 
-void renderBootAnimation(uint32_t durationMs) {
-  ui_component::renderBootAnimation(durationMs);
+void renderBootFrame(uint32_t elapsedMs, bool fullRedraw) {
+  ui_component::renderBootFrame(elapsedMs, fullRedraw);
+}
+
+bool startAssetPreload(DisplayStateData& state) {
+  const BaseType_t created =
+      core::topology::createTask(core::topology::Task::AssetPreload, assetPreloadTask, &state, nullptr);
+
+  if (created != pdPASS) {
+    ESP_LOGW(TAG, "Failed to start asset preload task");
+    core::boot::mark(core::boot::AssetsReady);
+    return false;
+  }
+  return true;
 }
 
 void renderHomeWeather(DisplayStateData& state, uint8_t focusIndex) {
@@ -64,4 +111,56 @@ void renderSettings(DisplayStateData& state, uint8_t focusIndex) {
   ui_component::renderSettings(state, focusIndex);
 }
 
+void renderDiagnostics(DisplayStateData&, uint8_t focusIndex) {
+  const bool available = core::telemetry::getSnapshot(diagnosticsSnapshot);
+  ui_component::renderDiagnostics(diagnosticsSnapshot, available, focusIndex);
+}
+
+uint8_t getDiagnosticsFocusMax() {
+  const uint8_t rows = ui_component::diagnosticsRowsPerPage();
+  const uint8_t tasks = diagnosticsSnapshot.taskCount;
+  return (rows == 0 || tasks <= rows) ? 0 : static_cast<uint8_t>((tasks - 1) / rows);
+}
+
+void renderProfilerOverlay(const profiler::FrameSample& last, const profiler::ScreenSummary& summary, uint32_t budgetUs) {
+  ui_component::renderProfilerOverlay(last, summary, budgetUs);
+}
+
+void benchmarkHomeRender(DisplayStateData& state, uint16_t iterations) {
+  if (iterations == 0) {
+    return;
+  }
+
+  const bool cacheWasEnabled = ui_component::isTextCacheEnabled();
+
+  auto measureAverageUs = [&](bool cacheEnabled) -> uint32_t {
+    ui_component::setTextCacheEnabled(cacheEnabled);
+    ui_component::clearTextCache();
+    ui_component::resetTextCacheStats();
+
+    const uint32_t startUs = micros();
+    for (uint16_t i = 0; i < iterations; ++i) {
+      ui_component::renderHomeWeather(state, static_cast<uint8_t>(i % 3));
+    }
+    return (micros() - startUs) / iterations;
+  };
+
+  const uint32_t uncachedUs = measureAverageUs(false);
+  const uint32_t cachedUs = measureAverageUs(true);
+  const auto stats = ui_component::getTextCacheStats();
+  const uint32_t lookups = stats.hits + stats.misses;
+
+  ESP_LOGI(TAG,
+           "Home render benchmark (%u frames): direct=%lu us cached=%lu us hit=%lu%% entries=%u bytes=%u",
+           static_cast<unsigned>(iterations),
+           static_cast<unsigned long>(uncachedUs),
+           static_cast<unsigned long>(cachedUs),
+           static_cast<unsigned long>(lookups == 0 ? 0 : (stats.hits * 100UL) / lookups),
+           static_cast<unsigned>(stats.entries),
+           static_cast<unsigned>(stats.bytesUsed));
+
+  ui_component::setTextCacheEnabled(cacheWasEnabled);
+  ui_component::resetTextCacheStats();
+}
+
 }  // namespace app::display::ui_logic
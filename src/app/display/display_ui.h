@@ -1,14 +1,20 @@
 #pragma once
 
+#include "display_profiler.h"
 #include "display_state.h"
 
 namespace app::display::ui_logic {
 
 bool begin(DisplayStateData& state);
-void renderBootAnimation(uint32_t durationMs);
+void renderBootFrame(uint32_t elapsedMs, bool fullRedraw);
+bool startAssetPreload(DisplayStateData& state);
 void renderHomeWeather(DisplayStateData& state, uint8_t focusIndex);
 void renderDeviceList(DisplayStateData& state, uint8_t focusIndex);
 void renderEspNowControl(DisplayStateData& state, uint8_t focusIndex);
 void renderSettings(DisplayStateData& state, uint8_t focusIndex);
+void renderDiagnostics(DisplayStateData& state, uint8_t focusIndex);
+uint8_t getDiagnosticsFocusMax();
+void renderProfilerOverlay(const profiler::FrameSample& last, const profiler::ScreenSummary& summary, uint32_t budgetUs);
+void benchmarkHomeRender(DisplayStateData& state, uint16_t iterations);
 
 }  // namespace app::display::ui_logic
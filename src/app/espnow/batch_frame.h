@@ -0,0 +1,81 @@
+#pragma once
+
+#include "protocol.h"
+
+#include <cstring>
+
+namespace app::espnow {
+
+// PacketType::BATCH payload: back-to-back {type, size, data[size]} entries,
+// each one a frame payload that would otherwise have been sent on its own.
+struct __attribute__((packed)) BatchEntryHeader {
+  uint8_t type;
+  uint8_t size;
+};
+
+class BatchBuilder {
+ public:
+  bool add(PacketType type, const void* data, size_t size) {
+    if (type == PacketType::BATCH || (size > 0 && data == nullptr) ||
+        used_ + sizeof(BatchEntryHeader) + size > sizeof(buffer_)) {
+      return false;
+    }
+
+    const BatchEntryHeader entry{static_cast<uint8_t>(type), static_cast<uint8_t>(size)};
+    memcpy(buffer_ + used_, &entry, sizeof(entry));
+    if (size > 0) {
+      memcpy(buffer_ + used_ + sizeof(entry), data, size);
+    }
+    used_ += sizeof(entry) + size;
+    ++count_;
+    return true;
+  }
+
+  const uint8_t* data() const { return buffer_; }
+  size_t size() const { return used_; }
+  size_t count() const { return count_; }
+
+ private:
+  uint8_t buffer_[MAX_PAYLOAD_SIZE] = {0};
+  size_t used_ = 0;
+  size_t count_ = 0;
+};
+
+class BatchReader {
+ public:
+  BatchReader(const uint8_t* payload, size_t size) : payload_(payload), size_(size) {}
+
+  // False at the end of the batch or on a truncated entry; nested batches
+  // are never produced and are rejected.
+  bool next(PacketType& type, const uint8_t*& data, uint8_t& size) {
+    if (payload_ == nullptr || offset_ + sizeof(BatchEntryHeader) > size_) {
+      malformed_ = malformed_ || offset_ != size_;
+      return false;
+    }
+
+    BatchEntryHeader entry;
+    memcpy(&entry, payload_ + offset_, sizeof(entry));
+    const size_t start = offset_ + sizeof(entry);
+    if (start + entry.size > size_ || entry.type == static_cast<uint8_t>(PacketType::BATCH)) {
+      malformed_ = true;
+      offset_ = size_;
+      return false;
+    }
+
+    type = static_cast<PacketType>(entry.type);
+    data = payload_ + start;
+    size = entry.size;
+    offset_ = start + entry.size;
+    return true;
+  }
+
+  bool malformed() const { return malformed_; }
+
+ private:
+  const uint8_t* payload_;
+  size_t size_;
+  size_t offset_ = 0;
+  bool malformed_ = false;
+};
+
+}  // namespace app::espnow
@@ -0,0 +1,188 @@
+#pragma once
+
+#include "state_binary.h"
+
+#include <cstring>
+
+namespace app::espnow::camera_fec {
+
+// Optional XOR parity for CameraChunk streams. A camera that sets
+// kFormatFecFlag in CameraMetaState.format sends, for every group of N data
+// chunks, K parity chunks; parity k is the XOR of the group members at
+// positions k, k + K, k + 2K, ... (zero padded to kChunkBytes), so any burst
+// of up to K consecutive losses inside a group can be rebuilt.
+//
+// Parity chunks reuse CameraChunkState: idx = kParityIdxFlag | k << 12 |
+// group, total = K << 8 | N. Data chunks keep idx 1..totalChunks.
+
+static constexpr uint8_t kFormatFecFlag = 0x80;
+static constexpr uint16_t kParityIdxFlag = 0x8000;
+static constexpr size_t kChunkBytes = state_binary::kCameraChunkDataBytes;
+static constexpr uint8_t kMaxDataPerGroup = 32;
+static constexpr uint8_t kMaxParityPerGroup = 4;
+static constexpr uint16_t kMaxGroups = 0x0FFF;
+
+struct Layout {
+  uint8_t dataPerGroup = 0;
+  uint8_t parityPerGroup = 0;
+};
+
+struct ParityId {
+  uint16_t group = 0;
+  uint8_t index = 0;
+};
+
+struct RecoveryResult {
+  uint16_t recovered = 0;
+  uint16_t lost = 0;
+};
+
+inline bool isValid(const Layout& layout) {
+  return layout.dataPerGroup >= 2 && layout.dataPerGroup <= kMaxDataPerGroup && layout.parityPerGroup >= 1 &&
+         layout.parityPerGroup <= kMaxParityPerGroup && layout.parityPerGroup <= layout.dataPerGroup;
+}
+
+inline bool isParityIdx(uint16_t idx) {
+  return (idx & kParityIdxFlag) != 0;
+}
+
+inline uint16_t parityChunkIdx(const ParityId& id) {
+  return static_cast<uint16_t>(kParityIdxFlag | (static_cast<uint16_t>(id.index) << 12) | (id.group & kMaxGroups));
+}
+
+inline uint16_t parityChunkTotal(const Layout& layout) {
+  return static_cast<uint16_t>((static_cast<uint16_t>(layout.parityPerGroup) << 8) | layout.dataPerGroup);
+}
+
+inline bool parseParityChunk(uint16_t idx, uint16_t total, Layout& layout, ParityId& id) {
+  if (!isParityIdx(idx)) {
+    return false;
+  }
+  layout.dataPerGroup = static_cast<uint8_t>(total & 0xFF);
+  layout.parityPerGroup = static_cast<uint8_t>(total >> 8);
+  id.group = idx & kMaxGroups;
+  id.index = static_cast<uint8_t>((idx >> 12) & 0x07);
+  return isValid(layout) && id.index < layout.parityPerGroup;
+}
+
+inline uint16_t groupCount(const Layout& layout, uint16_t dataChunks) {
+  return static_cast<uint16_t>((dataChunks + layout.dataPerGroup - 1) / layout.dataPerGroup);
+}
+
+inline size_t paritySlot(const Layout& layout, const ParityId& id) {
+  return static_cast<size_t>(id.group) * layout.parityPerGroup + id.index;
+}
+
+inline size_t parityChunkCount(const Layout& layout, uint16_t dataChunks) {
+  return static_cast<size_t>(groupCount(layout, dataChunks)) * layout.parityPerGroup;
+}
+
+// Length of the data chunk at 0-based `position` of a `totalBytes` frame.
+inline size_t dataChunkLength(uint32_t totalBytes, uint16_t position) {
+  const size_t offset = static_cast<size_t>(position) * kChunkBytes;
+  if (offset >= totalBytes) {
+    return 0;
+  }
+  const size_t remaining = totalBytes - offset;
+  return remaining < kChunkBytes ? remaining : kChunkBytes;
+}
+
+// Reference encoder (camera side): parity chunk `id` of `frame`.
+inline void buildParity(const uint8_t* frame,
+                        uint32_t totalBytes,
+                        const Layout& layout,
+                        const ParityId& id,
+                        uint8_t out[kChunkBytes]) {
+  memset(out, 0, kChunkBytes);
+  const uint16_t dataChunks = static_cast<uint16_t>((totalBytes + kChunkBytes - 1) / kChunkBytes);
+  const uint16_t first = static_cast<uint16_t>(id.group * layout.dataPerGroup);
+  for (uint16_t member = id.index; member < layout.dataPerGroup; member += layout.parityPerGroup) {
+    const uint16_t position = static_cast<uint16_t>(first + member);
+    if (position >= dataChunks) {
+      break;
+    }
+    const uint8_t* chunk = frame + static_cast<size_t>(position) * kChunkBytes;
+    const size_t length = dataChunkLength(totalBytes, position);
+    for (size_t i = 0; i < length; ++i) {
+      out[i] ^= chunk[i];
+    }
+  }
+}
+
+// Rebuilds missing data chunks in place. `dataSeen` is indexed by chunk idx
+// (1..dataChunks) and is updated for every chunk recovered; `parity` holds
+// paritySlot()-ordered chunks with `paritySeen` flags. `lost` counts chunks
+// still missing afterwards.
+inline RecoveryResult recover(uint8_t* frame,
+                              uint32_t totalBytes,
+                              uint16_t dataChunks,
+                              uint8_t* dataSeen,
+                              const Layout& layout,
+                              const uint8_t* parity,
+                              const uint8_t* paritySeen,
+                              size_t paritySlots) {
+  RecoveryResult result;
+  if (frame == nullptr || dataSeen == nullptr || totalBytes == 0 || !isValid(layout)) {
+    for (uint16_t idx = 1; idx <= dataChunks; ++idx) {
+      if (dataSeen != nullptr && dataSeen[idx] == 0) {
+        result.lost++;
+      }
+    }
+    return result;
+  }
+
+  const uint16_t groups = groupCount(layout, dataChunks);
+  for (uint16_t group = 0; group < groups; ++group) {
+    for (uint8_t index = 0; index < layout.parityPerGroup; ++index) {
+      const ParityId id{group, index};
+      const size_t slot = paritySlot(layout, id);
+      const uint16_t first = static_cast<uint16_t>(group * layout.dataPerGroup);
+
+      int missing = -1;
+      uint8_t missingCount = 0;
+      for (uint16_t member = index; member < layout.dataPerGroup; member += layout.parityPerGroup) {
+        const uint16_t position = static_cast<uint16_t>(first + member);
+        if (position >= dataChunks) {
+          break;
+        }
+        if (dataSeen[position + 1] == 0) {
+          missing = position;
+          missingCount++;
+        }
+      }
+
+      if (missingCount == 0) {
+        continue;
+      }
+      if (missingCount > 1 || slot >= paritySlots || paritySeen == nullptr || paritySeen[slot] == 0) {
+        result.lost += missingCount;
+        continue;
+      }
+
+      uint8_t* target = frame + static_cast<size_t>(missing) * kChunkBytes;
+      const size_t targetLength = dataChunkLength(totalBytes, static_cast<uint16_t>(missing));
+      uint8_t rebuilt[kChunkBytes];
+      memcpy(rebuilt, parity + slot * kChunkBytes, kChunkBytes);
+      for (uint16_t member = index; member < layout.dataPerGroup; member += layout.parityPerGroup) {
+        const uint16_t position = static_cast<uint16_t>(first + member);
+        if (position >= dataChunks) {
+          break;
+        }
+        if (position == missing) {
+          continue;
+        }
+        const uint8_t* chunk = frame + static_cast<size_t>(position) * kChunkBytes;
+        const size_t length = dataChunkLength(totalBytes, position);
+        for (size_t i = 0; i < length; ++i) {
+          rebuilt[i] ^= chunk[i];
+        }
+      }
+      memcpy(target, rebuilt, targetLength);
+      dataSeen[missing + 1] = 1;
+      result.recovered++;
+    }
+  }
+  return result;
+}
+
+}  // namespace app::espnow::camera_fec
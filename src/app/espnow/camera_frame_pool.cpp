@@ -0,0 +1,229 @@
+#include "camera_frame_pool.h"
+
+#include <app_config.h>
+#include <esp_heap_caps.h>
+#include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <cstring>
+
+namespace app::espnow::camera_frames {
+namespace {
+
+static constexpr const char* TAG = "cam_frames";
+static constexpr size_t SLOT_COUNT = MASTER_CAMERA_FRAME_SLOTS;
+static constexpr size_t SLOT_BYTES = kMaxJpegBytes;
+static constexpr size_t MAX_CAMERAS = 4;
+
+// Every camera holds its latest frame, every HTTP client may pin an older
+// one, and publish() needs one more to write into.
+static_assert(SLOT_COUNT >= MAX_CAMERAS + MASTER_CAMERA_HTTP_MAX_CLIENTS + 1, "MASTER_CAMERA_FRAME_SLOTS too small");
+
+struct Slot {
+  Frame frame;
+  uint8_t refs = 0;
+};
+
+struct Camera {
+  bool active = false;
+  uint8_t mac[6] = {0};
+  int latest = -1;
+  uint32_t sequence = 0;
+};
+
+Slot slots[SLOT_COUNT];
+Camera cameras[MAX_CAMERAS];
+int newestCamera = -1;
+bool allocated = false;
+bool allocationFailed = false;
+PoolStats stats;
+portMUX_TYPE poolLock = portMUX_INITIALIZER_UNLOCKED;
+
+bool ensureSlots() {
+  if (allocated) {
+    return true;
+  }
+  if (allocationFailed) {
+    return false;
+  }
+
+  for (auto& slot : slots) {
+    slot.frame.jpeg = static_cast<uint8_t*>(heap_caps_malloc(SLOT_BYTES, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+    if (slot.frame.jpeg == nullptr) {
+      slot.frame.jpeg = static_cast<uint8_t*>(malloc(SLOT_BYTES));
+    }
+    if (slot.frame.jpeg == nullptr) {
+      ESP_LOGE(TAG, "Alloc frame slot failed");
+      allocationFailed = true;
+      return false;
+    }
+  }
+  allocated = true;
+  return true;
+}
+
+// Caller holds poolLock.
+void releaseLocked(int slot) {
+  if (slot >= 0 && slots[slot].refs > 0) {
+    slots[slot].refs--;
+  }
+}
+
+// Caller holds poolLock.
+int findCameraLocked(const uint8_t mac[6], bool create) {
+  int freeIndex = -1;
+  for (size_t i = 0; i < MAX_CAMERAS; ++i) {
+    if (cameras[i].active && memcmp(cameras[i].mac, mac, 6) == 0) {
+      return static_cast<int>(i);
+    }
+    if (!cameras[i].active && freeIndex < 0) {
+      freeIndex = static_cast<int>(i);
+    }
+  }
+
+  if (!create) {
+    return -1;
+  }
+
+  if (freeIndex < 0) {
+    // Evict the camera that published longest ago.
+    freeIndex = 0;
+    for (size_t i = 1; i < MAX_CAMERAS; ++i) {
+      const int a = cameras[i].latest;
+      const int b = cameras[freeIndex].latest;
+      if (a < 0 || (b >= 0 && slots[a].frame.publishedMs < slots[b].frame.publishedMs)) {
+        freeIndex = static_cast<int>(i);
+      }
+    }
+    releaseLocked(cameras[freeIndex].latest);
+  }
+
+  cameras[freeIndex] = Camera{};
+  cameras[freeIndex].active = true;
+  memcpy(cameras[freeIndex].mac, mac, 6);
+  return freeIndex;
+}
+
+}  // namespace
+
+FrameRef::FrameRef(int slot) : slot_(slot) {}
+
+FrameRef::FrameRef(FrameRef&& other) noexcept : slot_(other.slot_) {
+  other.slot_ = -1;
+}
+
+FrameRef& FrameRef::operator=(FrameRef&& other) noexcept {
+  if (this != &other) {
+    reset();
+    slot_ = other.slot_;
+    other.slot_ = -1;
+  }
+  return *this;
+}
+
+FrameRef::~FrameRef() {
+  reset();
+}
+
+void FrameRef::reset() {
+  if (slot_ < 0) {
+    return;
+  }
+  portENTER_CRITICAL(&poolLock);
+  releaseLocked(slot_);
+  portEXIT_CRITICAL(&poolLock);
+  slot_ = -1;
+}
+
+const Frame* FrameRef::operator->() const {
+  return &slots[slot_].frame;
+}
+
+const Frame& FrameRef::operator*() const {
+  return slots[slot_].frame;
+}
+
+bool publish(const uint8_t mac[6], const uint8_t* jpeg, uint32_t bytes, uint32_t frameId, uint16_t width, uint16_t height) {
+  if (mac == nullptr || jpeg == nullptr || bytes == 0 || bytes > SLOT_BYTES || !ensureSlots()) {
+    return false;
+  }
+
+  // Claim a free slot for writing; the writer's ref becomes the camera's
+  // "latest" ref once the copy is done.
+  int target = -1;
+  portENTER_CRITICAL(&poolLock);
+  for (size_t i = 0; i < SLOT_COUNT; ++i) {
+    if (slots[i].refs == 0) {
+      target = static_cast<int>(i);
+      slots[i].refs = 1;
+      break;
+    }
+  }
+  if (target < 0) {
+    stats.publishFailed++;
+  }
+  portEXIT_CRITICAL(&poolLock);
+
+  if (target < 0) {
+    return false;
+  }
+
+  Frame& frame = slots[target].frame;
+  memcpy(frame.jpeg, jpeg, bytes);
+  memcpy(frame.mac, mac, sizeof(frame.mac));
+  frame.frameId = frameId;
+  frame.width = width;
+  frame.height = height;
+  frame.bytes = bytes;
+  frame.publishedMs = millis();
+
+  portENTER_CRITICAL(&poolLock);
+  const int camera = findCameraLocked(mac, true);
+  frame.sequence = ++cameras[camera].sequence;
+  releaseLocked(cameras[camera].latest);
+  cameras[camera].latest = target;
+  newestCamera = camera;
+  stats.published++;
+  portEXIT_CRITICAL(&poolLock);
+  return true;
+}
+
+FrameRef acquireLatest(const uint8_t mac[6]) {
+  int slot = -1;
+  portENTER_CRITICAL(&poolLock);
+  const int camera = mac != nullptr ? findCameraLocked(mac, false) : newestCamera;
+  if (camera >= 0 && cameras[camera].active) {
+    slot = cameras[camera].latest;
+    if (slot >= 0) {
+      slots[slot].refs++;
+    }
+  }
+  portEXIT_CRITICAL(&poolLock);
+  return FrameRef(slot);
+}
+
+size_t listCameras(uint8_t macs[][6], size_t maxCount) {
+  size_t count = 0;
+  portENTER_CRITICAL(&poolLock);
+  for (const auto& camera : cameras) {
+    if (camera.active && camera.latest >= 0 && count < maxCount) {
+      memcpy(macs[count++], camera.mac, 6);
+    }
+  }
+  portEXIT_CRITICAL(&poolLock);
+  return count;
+}
+
+void getStats(PoolStats& out) {
+  portENTER_CRITICAL(&poolLock);
+  out = stats;
+  out.slots = static_cast<uint8_t>(SLOT_COUNT);
+  out.pinned = 0;
+  for (const auto& slot : slots) {
+    if (slot.refs > 0) {
+      out.pinned++;
+    }
+  }
+  portEXIT_CRITICAL(&poolLock);
+}
+
+}  // namespace app::espnow::camera_frames
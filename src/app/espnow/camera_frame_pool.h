@@ -0,0 +1,60 @@
+#pragma once
+
+#include <Arduino.h>
+
+namespace app::espnow::camera_frames {
+
+static constexpr size_t kMaxJpegBytes = 32768;
+
+struct Frame {
+  uint8_t mac[6] = {0};
+  uint32_t frameId = 0;
+  uint16_t width = 0;
+  uint16_t height = 0;
+  uint32_t bytes = 0;
+  uint32_t publishedMs = 0;
+  // Per-camera publish counter; gaps seen by a reader are skipped frames.
+  uint32_t sequence = 0;
+  uint8_t* jpeg = nullptr;
+};
+
+// Pins one pool slot; the JPEG stays valid until the ref is released.
+class FrameRef {
+ public:
+  FrameRef() = default;
+  explicit FrameRef(int slot);
+  FrameRef(FrameRef&& other) noexcept;
+  FrameRef& operator=(FrameRef&& other) noexcept;
+  FrameRef(const FrameRef&) = delete;
+  FrameRef& operator=(const FrameRef&) = delete;
+  ~FrameRef();
+
+  void reset();
+  explicit operator bool() const { return slot_ >= 0; }
+  const Frame* operator->() const;
+  const Frame& operator*() const;
+
+ private:
+  int slot_ = -1;
+};
+
+struct PoolStats {
+  uint8_t slots = 0;
+  uint8_t pinned = 0;
+  uint32_t published = 0;
+  uint32_t publishFailed = 0;
+};
+
+// Copies a completed JPEG into a free slot and makes it the latest frame
+// of `mac`. Fails (and the frame is skipped) only when every slot is
+// pinned by readers.
+bool publish(const uint8_t mac[6], const uint8_t* jpeg, uint32_t bytes, uint32_t frameId, uint16_t width, uint16_t height);
+
+// Latest frame of `mac`, or of the most recently active camera when mac is
+// nullptr.
+FrameRef acquireLatest(const uint8_t mac[6]);
+
+size_t listCameras(uint8_t macs[][6], size_t maxCount);
+void getStats(PoolStats& out);
+
+}  // namespace app::espnow::camera_frames
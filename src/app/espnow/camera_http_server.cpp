@@ -0,0 +1,530 @@
+#include "camera_http_server.h"
+
+#include "camera_frame_pool.h"
+#include "camera_stream_buffer.h"
+#include "packet_capture.h"
+#include "app/tasks/ftpTask.h"
+#include "core/task_topology.h"
+#include "core/time_sync.h"
+
+#include <app_config.h>
+#include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <lwip/sockets.h>
+#include <cstring>
+
+namespace app::espnow::camera_http {
+namespace {
+
+static constexpr const char* TAG = "cam_http";
+static constexpr size_t MAX_CLIENTS = MASTER_CAMERA_HTTP_MAX_CLIENTS;
+static constexpr int LISTEN_BACKLOG = 4;
+static constexpr uint32_t SOCKET_TIMEOUT_MS = 2000;
+static constexpr uint32_t FRAME_POLL_MS = 15;
+static constexpr uint32_t STREAM_IDLE_MS = 30000;
+static constexpr size_t MAX_REQUEST_BYTES = 512;
+static constexpr const char* BOUNDARY = "mjpegframe";
+
+enum class Route : uint8_t {
+  Stream,
+  Snapshot,
+  Stats,
+  CaptureStart,
+  CaptureStop,
+  CaptureDump,
+  FtpStart,
+  FtpStop,
+  FtpStatus,
+  NotFound,
+};
+
+struct Client {
+  bool active = false;
+  int sock = -1;
+  Route route = Route::NotFound;
+  bool hasMac = false;
+  uint8_t mac[6] = {0};
+  uint32_t framesSent = 0;
+  uint32_t framesSkipped = 0;
+  uint32_t bytesSent = 0;
+  uint32_t startedMs = 0;
+};
+
+Client clients[MAX_CLIENTS];
+portMUX_TYPE clientLock = portMUX_INITIALIZER_UNLOCKED;
+TaskHandle_t listenerTaskHandle = nullptr;
+
+bool sendAll(int sock, const void* data, size_t length) {
+  const auto* cursor = static_cast<const uint8_t*>(data);
+  while (length > 0) {
+    const int sent = send(sock, cursor, length, 0);
+    if (sent <= 0) {
+      return false;
+    }
+    cursor += sent;
+    length -= static_cast<size_t>(sent);
+  }
+  return true;
+}
+
+bool sendText(int sock, const char* text) {
+  return sendAll(sock, text, strlen(text));
+}
+
+void sendStatus(int sock, const char* status, const char* body) {
+  char header[160];
+  snprintf(header,
+           sizeof(header),
+           "HTTP/1.1 %s\r\nContent-Type: text/plain\r\nContent-Length: %u\r\nConnection: close\r\n\r\n",
+           status,
+           static_cast<unsigned>(strlen(body)));
+  if (sendText(sock, header)) {
+    sendText(sock, body);
+  }
+}
+
+int hexValue(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+// Accepts AABBCCDDEEFF or AA:BB:CC:DD:EE:FF.
+bool parseMac(const char* text, uint8_t out[6]) {
+  size_t nibbles = 0;
+  for (const char* cursor = text; *cursor != '\0' && *cursor != '&' && *cursor != ' '; ++cursor) {
+    if (*cursor == ':' || *cursor == '-') {
+      continue;
+    }
+    const int value = hexValue(*cursor);
+    if (value < 0 || nibbles >= 12) {
+      return false;
+    }
+    out[nibbles / 2] = static_cast<uint8_t>((nibbles % 2 == 0) ? (value << 4) : (out[nibbles / 2] | value));
+    nibbles++;
+  }
+  return nibbles == 12;
+}
+
+bool readRequest(Client& client) {
+  char request[MAX_REQUEST_BYTES + 1] = {0};
+  size_t used = 0;
+  while (used < MAX_REQUEST_BYTES && strstr(request, "\r\n\r\n") == nullptr) {
+    const int received = recv(client.sock, request + used, MAX_REQUEST_BYTES - used, 0);
+    if (received <= 0) {
+      break;
+    }
+    used += static_cast<size_t>(received);
+    request[used] = '\0';
+  }
+
+  if (strncmp(request, "GET ", 4) != 0) {
+    return false;
+  }
+
+  const char* path = request + 4;
+  const size_t pathLength = strcspn(path, " ?");
+  auto pathIs = [&](const char* expected) {
+    return pathLength == strlen(expected) && strncmp(path, expected, pathLength) == 0;
+  };
+
+  if (pathIs("/stream")) {
+    client.route = Route::Stream;
+  } else if (pathIs("/snapshot.jpg")) {
+    client.route = Route::Snapshot;
+  } else if (pathIs("/stats")) {
+    client.route = Route::Stats;
+  } else if (pathIs("/capture/start")) {
+    client.route = Route::CaptureStart;
+  } else if (pathIs("/capture/stop")) {
+    client.route = Route::CaptureStop;
+  } else if (pathIs("/capture/dump")) {
+    client.route = Route::CaptureDump;
+  } else if (pathIs("/ftp/start")) {
+    client.route = Route::FtpStart;
+  } else if (pathIs("/ftp/stop")) {
+    client.route = Route::FtpStop;
+  } else if (pathIs("/ftp")) {
+    client.route = Route::FtpStatus;
+  } else {
+    client.route = Route::NotFound;
+  }
+
+  const char* lineEnd = strstr(path, " HTTP/");
+  const char* mac = strstr(path, "mac=");
+  if (mac != nullptr && (lineEnd == nullptr || mac < lineEnd)) {
+    client.hasMac = parseMac(mac + 4, client.mac);
+  }
+  return true;
+}
+
+// A peer that closed its end shows up as a zero-byte read; anything else
+// (no data, or request bytes we ignore) means it is still there.
+bool peerClosed(int sock) {
+  uint8_t byte = 0;
+  const int received = recv(sock, &byte, sizeof(byte), MSG_PEEK | MSG_DONTWAIT);
+  return received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK);
+}
+
+void serveStream(Client& client) {
+  char header[192];
+  snprintf(header,
+           sizeof(header),
+           "HTTP/1.1 200 OK\r\nContent-Type: multipart/x-mixed-replace; boundary=%s\r\n"
+           "Cache-Control: no-cache\r\nConnection: close\r\n\r\n",
+           BOUNDARY);
+  if (!sendText(client.sock, header)) {
+    return;
+  }
+
+  // Waiting for a camera that never sends must not hold a client slot:
+  // the stream ends when the peer goes away or no frame arrives for
+  // STREAM_IDLE_MS.
+  uint8_t lastMac[6] = {0};
+  uint32_t lastSequence = 0;
+  uint32_t lastFrameMs = millis();
+  while (true) {
+    camera_frames::FrameRef frame = camera_frames::acquireLatest(client.hasMac ? client.mac : nullptr);
+    const bool sameCamera = frame && memcmp(frame->mac, lastMac, sizeof(lastMac)) == 0;
+    if (!frame || (sameCamera && frame->sequence == lastSequence)) {
+      frame.reset();
+      if (millis() - lastFrameMs > STREAM_IDLE_MS || peerClosed(client.sock)) {
+        return;
+      }
+      vTaskDelay(pdMS_TO_TICKS(FRAME_POLL_MS));
+      continue;
+    }
+    lastFrameMs = millis();
+
+    // Always jump to the newest frame: a client that was still sending the
+    // previous one skips whatever was published in between.
+    const uint32_t skipped = (sameCamera && lastSequence != 0) ? frame->sequence - lastSequence - 1 : 0;
+    memcpy(lastMac, frame->mac, sizeof(lastMac));
+    lastSequence = frame->sequence;
+
+    char partHeader[160];
+    snprintf(partHeader,
+             sizeof(partHeader),
+             "--%s\r\nContent-Type: image/jpeg\r\nContent-Length: %lu\r\nX-Frame-Id: %lu\r\n\r\n",
+             BOUNDARY,
+             static_cast<unsigned long>(frame->bytes),
+             static_cast<unsigned long>(frame->frameId));
+    if (!sendText(client.sock, partHeader) || !sendAll(client.sock, frame->jpeg, frame->bytes) ||
+        !sendText(client.sock, "\r\n")) {
+      return;
+    }
+
+    portENTER_CRITICAL(&clientLock);
+    client.framesSent++;
+    client.framesSkipped += skipped;
+    client.bytesSent += frame->bytes;
+    portEXIT_CRITICAL(&clientLock);
+  }
+}
+
+void serveSnapshot(Client& client) {
+  camera_frames::FrameRef frame = camera_frames::acquireLatest(client.hasMac ? client.mac : nullptr);
+  if (!frame) {
+    sendStatus(client.sock, "503 Service Unavailable", "no frame yet\n");
+    return;
+  }
+
+  char header[192];
+  snprintf(header,
+           sizeof(header),
+           "HTTP/1.1 200 OK\r\nContent-Type: image/jpeg\r\nContent-Length: %lu\r\nX-Frame-Id: %lu\r\n"
+           "Cache-Control: no-cache\r\nConnection: close\r\n\r\n",
+           static_cast<unsigned long>(frame->bytes),
+           static_cast<unsigned long>(frame->frameId));
+  if (sendText(client.sock, header)) {
+    sendAll(client.sock, frame->jpeg, frame->bytes);
+  }
+}
+
+void serveStats(Client& client) {
+  char body[1536];
+  size_t used = 0;
+  auto append = [&](const char* format, auto... args) {
+    if (used < sizeof(body)) {
+      const int written = snprintf(body + used, sizeof(body) - used, format, args...);
+      used += written > 0 ? static_cast<size_t>(written) : 0;
+    }
+  };
+
+  camera_frames::PoolStats pool;
+  camera_frames::getStats(pool);
+  append("{\"pool\":{\"slots\":%u,\"pinned\":%u,\"published\":%lu,\"publishFailed\":%lu},\"cameras\":[",
+         pool.slots, pool.pinned,
+         static_cast<unsigned long>(pool.published), static_cast<unsigned long>(pool.publishFailed));
+
+  uint8_t macs[4][6];
+  const size_t cameraCount = camera_frames::listCameras(macs, 4);
+  const uint32_t now = millis();
+  for (size_t i = 0; i < cameraCount; ++i) {
+    camera_frames::FrameRef frame = camera_frames::acquireLatest(macs[i]);
+    if (!frame) {
+      continue;
+    }
+    append("%s{\"mac\":\"%02X%02X%02X%02X%02X%02X\",\"frame\":%lu,\"seq\":%lu,\"bytes\":%lu,\"w\":%u,\"h\":%u,\"ageMs\":%lu}",
+           i == 0 ? "" : ",",
+           macs[i][0], macs[i][1], macs[i][2], macs[i][3], macs[i][4], macs[i][5],
+           static_cast<unsigned long>(frame->frameId), static_cast<unsigned long>(frame->sequence),
+           static_cast<unsigned long>(frame->bytes), frame->width, frame->height,
+           static_cast<unsigned long>(now - frame->publishedMs));
+  }
+
+  camera_stream::FecStats fec;
+  camera_stream::getFecStats(fec);
+  append("],\"fec\":{\"recoveredChunks\":%lu,\"lostChunks\":%lu,\"recoveredFrames\":%lu,\"lostFrames\":%lu}",
+         static_cast<unsigned long>(fec.recoveredChunks), static_cast<unsigned long>(fec.lostChunks),
+         static_cast<unsigned long>(fec.recoveredFrames), static_cast<unsigned long>(fec.lostFrames));
+
+  camera_stream::DecodeStats decode;
+  camera_stream::getDecodeStats(decode);
+  append(",\"decode\":{\"decoded\":%lu,\"failed\":%lu,\"skipped\":%lu,\"lastUs\":%lu}",
+         static_cast<unsigned long>(decode.decoded), static_cast<unsigned long>(decode.failed),
+         static_cast<unsigned long>(decode.skipped), static_cast<unsigned long>(decode.lastDecodeUs));
+
+  capture::Stats cap;
+  capture::getStats(cap);
+  append(",\"capture\":{\"enabled\":%s,\"usedBytes\":%lu,\"records\":%lu,\"overwritten\":%lu}",
+         cap.enabled ? "true" : "false", static_cast<unsigned long>(cap.usedBytes),
+         static_cast<unsigned long>(cap.records), static_cast<unsigned long>(cap.overwritten));
+
+  app::tasks::FtpStats ftp;
+  app::tasks::getFtpStats(ftp);
+  append(",\"ftp\":{\"enabled\":%s,\"sessions\":%lu,\"sessionMs\":%lu}",
+         ftp.enabled ? "true" : "false", static_cast<unsigned long>(ftp.sessions),
+         static_cast<unsigned long>(ftp.sessionMs));
+
+  core::time_sync::Status clock;
+  core::time_sync::getStatus(clock);
+  append(",\"time\":{\"synced\":%s,\"server\":\"%s\",\"stratum\":%u,\"ageMs\":%lu,\"offsetUs\":%ld,\"rttUs\":%lu,\"errorUs\":%lu}",
+         clock.synced ? "true" : "false", clock.server, clock.stratum,
+         static_cast<unsigned long>(clock.lastSyncAgeMs), static_cast<long>(clock.lastOffsetUs),
+         static_cast<unsigned long>(clock.delayUs), static_cast<unsigned long>(clock.errorUs));
+
+  append(",\"clients\":[");
+  bool first = true;
+  for (const auto& other : clients) {
+    portENTER_CRITICAL(&clientLock);
+    const Client snapshot = other;
+    portEXIT_CRITICAL(&clientLock);
+    if (!snapshot.active || snapshot.route != Route::Stream) {
+      continue;
+    }
+    append("%s{\"sent\":%lu,\"skipped\":%lu,\"bytes\":%lu,\"ageMs\":%lu}",
+           first ? "" : ",",
+           static_cast<unsigned long>(snapshot.framesSent), static_cast<unsigned long>(snapshot.framesSkipped),
+           static_cast<unsigned long>(snapshot.bytesSent), static_cast<unsigned long>(now - snapshot.startedMs));
+    first = false;
+  }
+  append("]}\n");
+  used = used < sizeof(body) ? used : sizeof(body) - 1;
+
+  char header[128];
+  snprintf(header,
+           sizeof(header),
+           "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: %u\r\nConnection: close\r\n\r\n",
+           static_cast<unsigned>(used));
+  if (sendText(client.sock, header)) {
+    sendAll(client.sock, body, used);
+  }
+}
+
+void serveCapture(Client& client) {
+  bool ok = true;
+  char path[48] = "";
+  if (client.route == Route::CaptureStart || client.route == Route::CaptureStop) {
+    ok = capture::setEnabled(client.route == Route::CaptureStart);
+  } else {
+    ok = capture::dump(path, sizeof(path));
+  }
+
+  capture::Stats stats;
+  capture::getStats(stats);
+  char body[256];
+  const int written = snprintf(body,
+                               sizeof(body),
+                               "{\"ok\":%s,\"enabled\":%s,\"ringBytes\":%lu,\"usedBytes\":%lu,\"records\":%lu,"
+                               "\"overwritten\":%lu,\"skipped\":%lu,\"dumps\":%lu,\"path\":\"%s\"}\n",
+                               ok ? "true" : "false", stats.enabled ? "true" : "false",
+                               static_cast<unsigned long>(stats.ringBytes), static_cast<unsigned long>(stats.usedBytes),
+                               static_cast<unsigned long>(stats.records), static_cast<unsigned long>(stats.overwritten),
+                               static_cast<unsigned long>(stats.skipped), static_cast<unsigned long>(stats.dumps), path);
+  const size_t used = written > 0 ? (static_cast<size_t>(written) < sizeof(body) ? written : sizeof(body) - 1) : 0;
+
+  char header[128];
+  snprintf(header,
+           sizeof(header),
+           "HTTP/1.1 %s\r\nContent-Type: application/json\r\nContent-Length: %u\r\nConnection: close\r\n\r\n",
+           ok ? "200 OK" : "503 Service Unavailable",
+           static_cast<unsigned>(used));
+  if (sendText(client.sock, header)) {
+    sendAll(client.sock, body, used);
+  }
+}
+
+void serveFtp(Client& client) {
+  bool ok = true;
+  if (client.route == Route::FtpStart || client.route == Route::FtpStop) {
+    ok = app::tasks::setFtpEnabled(client.route == Route::FtpStart);
+  }
+
+  app::tasks::FtpStats stats;
+  app::tasks::getFtpStats(stats);
+  char body[256];
+  const int written = snprintf(body,
+                               sizeof(body),
+                               "{\"ok\":%s,\"enabled\":%s,\"sessions\":%lu,\"sessionMs\":%lu,\"polls\":%lu,"
+                               "\"busyUs\":%llu,\"maxPollUs\":%lu,\"lockWaitMaxUs\":%lu}\n",
+                               ok ? "true" : "false", stats.enabled ? "true" : "false",
+                               static_cast<unsigned long>(stats.sessions), static_cast<unsigned long>(stats.sessionMs),
+                               static_cast<unsigned long>(stats.polls), static_cast<unsigned long long>(stats.busyUs),
+                               static_cast<unsigned long>(stats.maxPollUs), static_cast<unsigned long>(stats.lockWaitMaxUs));
+  const size_t used = written > 0 ? (static_cast<size_t>(written) < sizeof(body) ? written : sizeof(body) - 1) : 0;
+
+  char header[128];
+  snprintf(header,
+           sizeof(header),
+           "HTTP/1.1 %s\r\nContent-Type: application/json\r\nContent-Length: %u\r\nConnection: close\r\n\r\n",
+           ok ? "200 OK" : "503 Service Unavailable",
+           static_cast<unsigned>(used));
+  if (sendText(client.sock, header)) {
+    sendAll(client.sock, body, used);
+  }
+}
+
+void clientTask(void* arg) {
+  Client& client = *static_cast<Client*>(arg);
+
+  if (readRequest(client)) {
+    switch (client.route) {
+      case Route::Stream:
+        serveStream(client);
+        break;
+      case Route::Snapshot:
+        serveSnapshot(client);
+        break;
+      case Route::Stats:
+        serveStats(client);
+        break;
+      case Route::CaptureStart:
+      case Route::CaptureStop:
+      case Route::CaptureDump:
+        serveCapture(client);
+        break;
+      case Route::FtpStart:
+      case Route::FtpStop:
+      case Route::FtpStatus:
+        serveFtp(client);
+        break;
+      case Route::NotFound:
+        sendStatus(client.sock, "404 Not Found", "try /stream, /snapshot.jpg, /stats, /capture/{start,stop,dump} or /ftp[/start,/stop]\n");
+        break;
+    }
+  }
+
+  shutdown(client.sock, SHUT_RDWR);
+  close(client.sock);
+  portENTER_CRITICAL(&clientLock);
+  client = Client{};
+  portEXIT_CRITICAL(&clientLock);
+  vTaskDelete(nullptr);
+}
+
+void listenerTask(void*) {
+  const int listener = socket(AF_INET, SOCK_STREAM, IPPROTO_IP);
+  if (listener < 0) {
+    ESP_LOGE(TAG, "socket() failed: %d", errno);
+    listenerTaskHandle = nullptr;
+    vTaskDelete(nullptr);
+    return;
+  }
+
+  const int reuse = 1;
+  setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+  sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_ANY);
+  address.sin_port = htons(MASTER_CAMERA_HTTP_PORT);
+  if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, LISTEN_BACKLOG) != 0) {
+    ESP_LOGE(TAG, "bind/listen on port %u failed: %d", MASTER_CAMERA_HTTP_PORT, errno);
+    close(listener);
+    listenerTaskHandle = nullptr;
+    vTaskDelete(nullptr);
+    return;
+  }
+
+  ESP_LOGI(TAG, "Camera HTTP server listening on port %u", MASTER_CAMERA_HTTP_PORT);
+
+  while (true) {
+    const int sock = accept(listener, nullptr, nullptr);
+    if (sock < 0) {
+      vTaskDelay(pdMS_TO_TICKS(100));
+      continue;
+    }
+
+    // A stalled client times out its own sends; it never blocks the
+    // listener or the other clients, which each run in their own task.
+    timeval timeout = {};
+    timeout.tv_sec = SOCKET_TIMEOUT_MS / 1000;
+    timeout.tv_usec = (SOCKET_TIMEOUT_MS % 1000) * 1000;
+    setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    const int noDelay = 1;
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+    Client* slot = nullptr;
+    portENTER_CRITICAL(&clientLock);
+    for (auto& client : clients) {
+      if (!client.active) {
+        slot = &client;
+        *slot = Client{};
+        slot->active = true;
+        slot->sock = sock;
+        slot->startedMs = millis();
+        break;
+      }
+    }
+    portEXIT_CRITICAL(&clientLock);
+
+    if (slot == nullptr) {
+      sendStatus(sock, "503 Service Unavailable", "too many clients\n");
+      close(sock);
+      continue;
+    }
+
+    if (core::topology::createTask(core::topology::Task::CameraHttpClient, clientTask, slot, nullptr) != pdPASS) {
+      ESP_LOGW(TAG, "Failed to create client task");
+      close(sock);
+      portENTER_CRITICAL(&clientLock);
+      *slot = Client{};
+      portEXIT_CRITICAL(&clientLock);
+    }
+  }
+}
+
+}  // namespace
+
+bool begin() {
+  if (listenerTaskHandle != nullptr) {
+    return true;
+  }
+
+  const BaseType_t created = core::topology::createTask(core::topology::Task::CameraHttpListener,
+                                                       listenerTask,
+                                                       nullptr,
+                                                       &listenerTaskHandle);
+  if (created != pdPASS) {
+    ESP_LOGE(TAG, "Failed to create camera HTTP listener");
+    listenerTaskHandle = nullptr;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace app::espnow::camera_http
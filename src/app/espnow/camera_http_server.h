@@ -0,0 +1,14 @@
+#pragma once
+
+#include <Arduino.h>
+
+namespace app::espnow::camera_http {
+
+// Starts the listener on MASTER_CAMERA_HTTP_PORT:
+//   /stream[?mac=AABBCCDDEEFF]        multipart/x-mixed-replace MJPEG
+//   /snapshot.jpg[?mac=AABBCCDDEEFF]  latest complete JPEG
+//   /stats                            pool, camera and client counters (JSON)
+// Without `mac` the most recently active camera is used.
+bool begin();
+
+}  // namespace app::espnow::camera_http
@@ -0,0 +1,313 @@
+#include "camera_rate_controller.h"
+
+#include "master.h"
+#include "protocol.h"
+#include "state_binary.h"
+
+#include <app_config.h>
+#include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <cstring>
+
+namespace app::espnow::camera_rate {
+namespace {
+
+static constexpr const char* TAG = "cam_rate";
+static constexpr size_t MAX_CAMERAS = 4;
+static constexpr uint16_t MIN_WINDOW_FRAMES = 3;
+static constexpr uint32_t MAX_FRAME_ID_GAP = 64;
+static constexpr uint8_t MIN_FPS = 1;
+static constexpr uint8_t QUALITY_BEST = 10;
+static constexpr uint8_t QUALITY_WORST = 50;
+static constexpr uint8_t QUALITY_STEP_DOWN = 8;
+static constexpr uint8_t QUALITY_STEP_UP = 2;
+static constexpr uint8_t HOLD_WINDOWS_AFTER_DECREASE = 2;
+static constexpr uint8_t IDLE_WINDOWS = 3;
+// Master-side decode must leave this share of each frame interval free.
+static constexpr uint32_t DECODE_BUDGET_PCT = 80;
+
+struct FrameSizeLevel {
+  uint16_t width;
+  uint16_t height;
+};
+
+static constexpr FrameSizeLevel FRAME_SIZE_LEVELS[] = {
+    {160, 120},
+    {240, 176},
+    {320, 240},
+    {400, 296},
+    {640, 480},
+};
+static constexpr uint8_t FRAME_SIZE_LEVEL_COUNT = sizeof(FRAME_SIZE_LEVELS) / sizeof(FRAME_SIZE_LEVELS[0]);
+
+struct WindowCounters {
+  uint16_t started = 0;
+  uint16_t completed = 0;
+  uint32_t chunksExpected = 0;
+  uint32_t chunksReceived = 0;
+  uint32_t decodeUsTotal = 0;
+  uint16_t decoded = 0;
+};
+
+struct CameraLink {
+  bool active = false;
+  uint8_t mac[6] = {0};
+  bool hasFrameId = false;
+  uint32_t lastFrameId = 0;
+  uint32_t lastFrameMs = 0;
+  WindowCounters window;
+
+  bool settingsKnown = false;
+  uint8_t fps = 0;
+  uint8_t quality = 0;
+  uint8_t sizeLevel = 0;
+  uint8_t maxSizeLevel = 0;  // size the camera started at; step-ups stop there
+  uint8_t holdWindows = 0;
+};
+
+CameraLink links[MAX_CAMERAS];
+portMUX_TYPE linkLock = portMUX_INITIALIZER_UNLOCKED;
+uint32_t lastWindowMs = 0;
+
+uint32_t levelPixels(uint8_t level) {
+  return static_cast<uint32_t>(FRAME_SIZE_LEVELS[level].width) * FRAME_SIZE_LEVELS[level].height;
+}
+
+uint8_t sizeLevelForWidth(uint16_t width) {
+  uint8_t best = 0;
+  for (uint8_t level = 0; level < FRAME_SIZE_LEVEL_COUNT; ++level) {
+    if (FRAME_SIZE_LEVELS[level].width <= width) {
+      best = level;
+    }
+  }
+  return best;
+}
+
+// Caller holds linkLock.
+CameraLink* findLink(const uint8_t mac[6], bool create) {
+  CameraLink* freeSlot = nullptr;
+  for (auto& link : links) {
+    if (link.active && memcmp(link.mac, mac, sizeof(link.mac)) == 0) {
+      return &link;
+    }
+    if (!link.active && freeSlot == nullptr) {
+      freeSlot = &link;
+    }
+  }
+
+  if (!create || freeSlot == nullptr) {
+    return nullptr;
+  }
+
+  *freeSlot = CameraLink{};
+  freeSlot->active = true;
+  memcpy(freeSlot->mac, mac, sizeof(freeSlot->mac));
+  return freeSlot;
+}
+
+const char* actionName(state_binary::CameraControlAction action) {
+  switch (action) {
+    case state_binary::CameraControlAction::SetQuality:
+      return "quality";
+    case state_binary::CameraControlAction::SetFrameSize:
+      return "size";
+    case state_binary::CameraControlAction::SetTargetFps:
+      return "fps";
+    default:
+      return "?";
+  }
+}
+
+bool sendControl(MasterNode& master, const uint8_t mac[6], state_binary::CameraControlAction action, uint8_t value) {
+  state_binary::CameraControlCommand command = {};
+  state_binary::initHeader(command.header, state_binary::Type::CameraControl);
+  command.action = static_cast<uint8_t>(action);
+  command.value = value;
+  return master.send(mac, PacketType::COMMAND, &command, sizeof(command));
+}
+
+void evaluate(MasterNode& master, CameraLink& link, const WindowCounters& window, uint32_t windowMs) {
+  const uint32_t measuredFps10 = (static_cast<uint32_t>(window.started) * 10000UL) / windowMs;
+  if (link.fps == 0) {
+    link.fps = static_cast<uint8_t>(constrain((measuredFps10 + 5) / 10, MIN_FPS, MASTER_CAMERA_MAX_FPS));
+  }
+
+  const uint32_t completionPct = (static_cast<uint32_t>(window.completed) * 100UL) / window.started;
+  const uint32_t lossPct = window.chunksExpected == 0
+                               ? 0
+                               : ((window.chunksExpected - window.chunksReceived) * 100UL) / window.chunksExpected;
+  const uint32_t decodeAvgUs = window.decoded == 0 ? 0 : window.decodeUsTotal / window.decoded;
+
+  state_binary::CameraControlAction action = state_binary::CameraControlAction::SetTargetFps;
+  uint8_t value = 0;
+  bool change = false;
+
+  if (completionPct < MASTER_CAMERA_TARGET_COMPLETION_PCT) {
+    link.holdWindows = HOLD_WINDOWS_AFTER_DECREASE;
+    if (link.fps > MIN_FPS) {
+      value = static_cast<uint8_t>(max<uint8_t>(MIN_FPS, link.fps / 2));
+      change = true;
+    } else if (link.quality < QUALITY_WORST) {
+      action = state_binary::CameraControlAction::SetQuality;
+      value = static_cast<uint8_t>(min<uint8_t>(QUALITY_WORST, link.quality + QUALITY_STEP_DOWN));
+      change = true;
+    } else if (link.sizeLevel > 0) {
+      action = state_binary::CameraControlAction::SetFrameSize;
+      value = static_cast<uint8_t>(link.sizeLevel - 1);
+      change = true;
+    }
+  } else if (link.holdWindows > 0) {
+    link.holdWindows--;
+  } else if (link.fps < MASTER_CAMERA_MAX_FPS) {
+    const uint32_t nextIntervalUs = 1000000UL / (link.fps + 1);
+    if (decodeAvgUs * 100UL < nextIntervalUs * DECODE_BUDGET_PCT) {
+      value = static_cast<uint8_t>(link.fps + 1);
+      change = true;
+    }
+  } else if (link.quality > QUALITY_BEST) {
+    action = state_binary::CameraControlAction::SetQuality;
+    value = static_cast<uint8_t>(max<int>(QUALITY_BEST, link.quality - QUALITY_STEP_UP));
+    change = true;
+  } else if (link.sizeLevel < link.maxSizeLevel && completionPct >= 100) {
+    // Decode time scales with pixels; the larger frame must still fit the
+    // current frame interval.
+    const uint8_t next = static_cast<uint8_t>(link.sizeLevel + 1);
+    const uint64_t nextDecodeUs = static_cast<uint64_t>(decodeAvgUs) * levelPixels(next) / levelPixels(link.sizeLevel);
+    const uint32_t intervalUs = 1000000UL / link.fps;
+    if (nextDecodeUs * 100UL < static_cast<uint64_t>(intervalUs) * DECODE_BUDGET_PCT) {
+      action = state_binary::CameraControlAction::SetFrameSize;
+      value = next;
+      change = true;
+    }
+  }
+
+  const uint8_t* mac = link.mac;
+  if (!change) {
+    ESP_LOGD(TAG,
+             "%02X:%02X:%02X:%02X:%02X:%02X frames=%u done=%u (%lu%%) loss=%lu%% decode=%lums rx=%lu.%lufps "
+             "fps=%u q=%u size=%u hold",
+             mac[0], mac[1], mac[2], mac[3], mac[4], mac[5],
+             window.started, window.completed,
+             static_cast<unsigned long>(completionPct), static_cast<unsigned long>(lossPct),
+             static_cast<unsigned long>(decodeAvgUs / 1000),
+             static_cast<unsigned long>(measuredFps10 / 10), static_cast<unsigned long>(measuredFps10 % 10),
+             link.fps, link.quality, link.sizeLevel);
+    return;
+  }
+
+  if (!sendControl(master, mac, action, value)) {
+    return;
+  }
+
+  ESP_LOGI(TAG,
+           "%02X:%02X:%02X:%02X:%02X:%02X frames=%u done=%u (%lu%%) loss=%lu%% decode=%lums rx=%lu.%lufps "
+           "fps=%u q=%u size=%u -> %s=%u",
+           mac[0], mac[1], mac[2], mac[3], mac[4], mac[5],
+           window.started, window.completed,
+           static_cast<unsigned long>(completionPct), static_cast<unsigned long>(lossPct),
+           static_cast<unsigned long>(decodeAvgUs / 1000),
+           static_cast<unsigned long>(measuredFps10 / 10), static_cast<unsigned long>(measuredFps10 % 10),
+           link.fps, link.quality, link.sizeLevel, actionName(action), value);
+
+  switch (action) {
+    case state_binary::CameraControlAction::SetTargetFps:
+      link.fps = value;
+      break;
+    case state_binary::CameraControlAction::SetQuality:
+      link.quality = value;
+      break;
+    case state_binary::CameraControlAction::SetFrameSize:
+      link.sizeLevel = value;
+      break;
+    default:
+      break;
+  }
+}
+
+}  // namespace
+
+void onFrameStarted(const uint8_t mac[6], uint32_t frameId, uint8_t quality, uint16_t width, uint16_t height) {
+  (void)height;
+  if (mac == nullptr) {
+    return;
+  }
+
+  portENTER_CRITICAL(&linkLock);
+  CameraLink* link = findLink(mac, true);
+  if (link != nullptr) {
+    // Frames whose meta never arrived still count as started.
+    uint32_t started = 1;
+    if (link->hasFrameId && frameId > link->lastFrameId && frameId - link->lastFrameId <= MAX_FRAME_ID_GAP) {
+      started = frameId - link->lastFrameId;
+    }
+    link->window.started = static_cast<uint16_t>(min<uint32_t>(0xFFFF, link->window.started + started));
+    link->hasFrameId = true;
+    link->lastFrameId = frameId;
+    link->lastFrameMs = millis();
+
+    if (!link->settingsKnown) {
+      link->settingsKnown = true;
+      link->quality = quality;
+      link->sizeLevel = sizeLevelForWidth(width);
+      link->maxSizeLevel = link->sizeLevel;
+    }
+  }
+  portEXIT_CRITICAL(&linkLock);
+}
+
+void onFrameFinished(const uint8_t mac[6], bool complete, uint16_t receivedChunks, uint16_t expectedChunks, uint32_t decodeUs) {
+  if (mac == nullptr) {
+    return;
+  }
+
+  portENTER_CRITICAL(&linkLock);
+  CameraLink* link = findLink(mac, false);
+  if (link != nullptr) {
+    if (complete) {
+      link->window.completed++;
+    }
+    link->window.chunksExpected += expectedChunks;
+    link->window.chunksReceived += min(receivedChunks, expectedChunks);
+    if (decodeUs > 0) {
+      link->window.decodeUsTotal += decodeUs;
+      link->window.decoded++;
+    }
+  }
+  portEXIT_CRITICAL(&linkLock);
+}
+
+void tick(MasterNode& master, uint32_t nowMs) {
+#if MASTER_CAMERA_RATE_CONTROL
+  const uint32_t windowMs = nowMs - lastWindowMs;
+  if (windowMs < MASTER_CAMERA_RATE_WINDOW_MS) {
+    return;
+  }
+  lastWindowMs = nowMs;
+
+  for (auto& link : links) {
+    WindowCounters window;
+    bool idle = false;
+
+    portENTER_CRITICAL(&linkLock);
+    if (link.active) {
+      window = link.window;
+      link.window = WindowCounters{};
+      idle = nowMs - link.lastFrameMs > IDLE_WINDOWS * MASTER_CAMERA_RATE_WINDOW_MS;
+      if (idle) {
+        link.active = false;
+      }
+    }
+    const bool evaluateLink = link.active && window.started >= MIN_WINDOW_FRAMES;
+    portEXIT_CRITICAL(&linkLock);
+
+    if (evaluateLink) {
+      evaluate(master, link, window, windowMs);
+    }
+  }
+#else
+  (void)master;
+  (void)nowMs;
+#endif
+}
+
+}  // namespace app::espnow::camera_rate
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <Arduino.h>
+
+namespace app::espnow {
+class MasterNode;
+}
+
+namespace app::espnow::camera_rate {
+
+// Called from the camera ingest path; cheap and safe from the ESP-NOW
+// receive callback.
+void onFrameStarted(const uint8_t mac[6], uint32_t frameId, uint8_t quality, uint16_t width, uint16_t height);
+void onFrameFinished(const uint8_t mac[6], bool complete, uint16_t receivedChunks, uint16_t expectedChunks, uint32_t decodeUs);
+
+// Once per MASTER_CAMERA_RATE_WINDOW_MS: AIMD on target fps (then quality,
+// then frame size) to keep frame completion at MASTER_CAMERA_TARGET_COMPLETION_PCT.
+// Recovery runs in the same order: fps, quality, then frame size back up to
+// the size the camera started at.
+void tick(MasterNode& master, uint32_t nowMs);
+
+}  // namespace app::espnow::camera_rate
@@ -0,0 +1,633 @@
+#include "camera_recorder.h"
+
+#include "master_history_store.h"
+#include "core/boot.h"
+#include "core/fs_lock.h"
+#include "core/task_topology.h"
+
+#include <LittleFS.h>
+#include <app_config.h>
+#include <esp_heap_caps.h>
+#include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/ringbuf.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <cstring>
+
+namespace app::espnow::camera_recorder {
+namespace {
+
+static constexpr const char* TAG = "cam_rec";
+static constexpr const char* REC_DIR = "/rec";
+static constexpr size_t BLOCK_BYTES = 4096;
+static constexpr size_t INDEX_BATCH = 32;
+static constexpr size_t MAX_RECORDING = 4;
+static constexpr size_t MAX_WRITERS = MAX_RECORDING;
+static constexpr size_t MAX_SEGMENTS = (MASTER_RECORDER_MAX_BYTES / MASTER_RECORDER_SEGMENT_BYTES) + 4;
+static constexpr uint32_t IDLE_CLOSE_MS = 5000;
+
+static_assert(MASTER_RECORDER_SEGMENT_BYTES % BLOCK_BYTES == 0, "segments must be whole flash blocks");
+static_assert(MASTER_RECORDER_MAX_BYTES >= 2 * MASTER_RECORDER_SEGMENT_BYTES, "recorder cap must hold two segments");
+static_assert(MAX_WRITERS >= MAX_RECORDING, "every recording camera needs its own writer");
+
+struct __attribute__((packed)) QueuedFrame {
+  uint8_t mac[6];
+  uint16_t width;
+  uint16_t height;
+  uint32_t frameId;
+  uint32_t epochSec;
+  uint32_t uptimeMs;
+  uint32_t bytes;
+};
+
+// One entry per frame in <segment>.idx, ordered by time.
+struct __attribute__((packed)) IndexEntry {
+  uint32_t epochSec;
+  uint32_t uptimeMs;
+  uint32_t frameId;
+  uint32_t offset;
+  uint32_t size;
+};
+
+static_assert(sizeof(IndexEntry) == 20, "IndexEntry layout changed");
+
+struct Segment {
+  bool used = false;
+  uint8_t mac[6] = {0};
+  uint32_t seq = 0;
+  uint32_t bytes = 0;
+  uint32_t writtenBytes = 0;  // bytes already on flash; the rest sit in the writer's block
+  uint32_t firstEpoch = 0;
+  uint32_t lastEpoch = 0;
+};
+
+struct SegmentWriter {
+  bool open = false;
+  uint8_t mac[6] = {0};
+  size_t segment = 0;
+  File data;
+  File index;
+  uint8_t* block = nullptr;
+  size_t blockUsed = 0;
+  IndexEntry pendingIndex[INDEX_BATCH];
+  size_t pendingIndexCount = 0;
+  uint32_t lastFrameMs = 0;
+};
+
+RingbufHandle_t frameRing = nullptr;
+StaticRingbuffer_t frameRingStruct;
+TaskHandle_t writerTaskHandle = nullptr;
+SemaphoreHandle_t tableMutex = nullptr;
+
+Segment segments[MAX_SEGMENTS];
+SegmentWriter writers[MAX_WRITERS];
+uint32_t nextSeq = 1;
+
+uint8_t recordingMacs[MAX_RECORDING][6] = {{0}};
+bool recordingUsed[MAX_RECORDING] = {false};
+portMUX_TYPE recordingLock = portMUX_INITIALIZER_UNLOCKED;
+
+Stats stats;
+portMUX_TYPE statsLock = portMUX_INITIALIZER_UNLOCKED;
+
+class TableLock {
+ public:
+  TableLock() {
+    if (tableMutex != nullptr) {
+      xSemaphoreTake(tableMutex, portMAX_DELAY);
+    }
+  }
+  ~TableLock() {
+    if (tableMutex != nullptr) {
+      xSemaphoreGive(tableMutex);
+    }
+  }
+};
+
+void* allocPsram(size_t size) {
+  void* buffer = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  return buffer != nullptr ? buffer : malloc(size);
+}
+
+void segmentPath(const Segment& segment, const char* extension, char* out, size_t outSize) {
+  snprintf(out,
+           outSize,
+           "%s/%02X%02X%02X%02X%02X%02X_%05lu.%s",
+           REC_DIR,
+           segment.mac[0], segment.mac[1], segment.mac[2], segment.mac[3], segment.mac[4], segment.mac[5],
+           static_cast<unsigned long>(segment.seq),
+           extension);
+}
+
+uint32_t totalBytesLocked() {
+  uint32_t total = 0;
+  for (const auto& segment : segments) {
+    if (segment.used) {
+      total += segment.bytes;
+    }
+  }
+  return total;
+}
+
+bool isSegmentOpen(size_t slot) {
+  for (const auto& writer : writers) {
+    if (writer.open && writer.segment == slot) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void deleteSegmentLocked(size_t slot) {
+  core::fs::Lock fsLock;
+  char path[48];
+  segmentPath(segments[slot], "mjpg", path, sizeof(path));
+  LittleFS.remove(path);
+  segmentPath(segments[slot], "idx", path, sizeof(path));
+  LittleFS.remove(path);
+  segments[slot] = Segment{};
+}
+
+// Drops the oldest closed segments until `incoming` more bytes fit under
+// MASTER_RECORDER_MAX_BYTES and a table slot is free.
+int reserveSegmentLocked(uint32_t incoming) {
+  while (true) {
+    int freeSlot = -1;
+    int oldest = -1;
+    for (size_t i = 0; i < MAX_SEGMENTS; ++i) {
+      if (!segments[i].used) {
+        if (freeSlot < 0) {
+          freeSlot = static_cast<int>(i);
+        }
+        continue;
+      }
+      if (!isSegmentOpen(i) && (oldest < 0 || segments[i].seq < segments[oldest].seq)) {
+        oldest = static_cast<int>(i);
+      }
+    }
+
+    if (freeSlot >= 0 && totalBytesLocked() + incoming <= MASTER_RECORDER_MAX_BYTES) {
+      return freeSlot;
+    }
+    if (oldest < 0) {
+      return -1;
+    }
+    deleteSegmentLocked(static_cast<size_t>(oldest));
+  }
+}
+
+bool readIndexEntry(File& index, size_t position, IndexEntry& out) {
+  return index.seek(position * sizeof(IndexEntry)) &&
+         index.read(reinterpret_cast<uint8_t*>(&out), sizeof(out)) == sizeof(out);
+}
+
+bool parseSegmentName(const char* name, Segment& out) {
+  const char* base = strrchr(name, '/');
+  base = base != nullptr ? base + 1 : name;
+
+  unsigned mac[6] = {0};
+  unsigned long seq = 0;
+  char extension[8] = {0};
+  if (sscanf(base, "%2X%2X%2X%2X%2X%2X_%lu.%7s", &mac[0], &mac[1], &mac[2], &mac[3], &mac[4], &mac[5], &seq, extension) != 8 ||
+      strcmp(extension, "mjpg") != 0) {
+    return false;
+  }
+
+  for (size_t i = 0; i < 6; ++i) {
+    out.mac[i] = static_cast<uint8_t>(mac[i]);
+  }
+  out.seq = static_cast<uint32_t>(seq);
+  return true;
+}
+
+void restoreSegments() {
+  TableLock lock;
+  core::fs::Lock fsLock;
+  LittleFS.mkdir(REC_DIR);
+  File dir = LittleFS.open(REC_DIR);
+  if (!dir || !dir.isDirectory()) {
+    return;
+  }
+
+  size_t restoredCount = 0;
+  File entry = dir.openNextFile();
+  while (entry) {
+    Segment segment;
+    if (!entry.isDirectory() && parseSegmentName(entry.name(), segment)) {
+      segment.used = true;
+      segment.bytes = static_cast<uint32_t>(entry.size());
+      segment.writtenBytes = segment.bytes;
+
+      char path[48];
+      segmentPath(segment, "idx", path, sizeof(path));
+      File index = LittleFS.open(path, "r");
+      const size_t entries = index ? index.size() / sizeof(IndexEntry) : 0;
+      IndexEntry first = {};
+      IndexEntry last = {};
+      if (entries > 0 && readIndexEntry(index, 0, first) && readIndexEntry(index, entries - 1, last)) {
+        segment.firstEpoch = first.epochSec;
+        segment.lastEpoch = last.epochSec;
+      }
+      index.close();
+
+      for (auto& slot : segments) {
+        if (!slot.used) {
+          slot = segment;
+          restoredCount++;
+          break;
+        }
+      }
+      if (segment.seq >= nextSeq) {
+        nextSeq = segment.seq + 1;
+      }
+    }
+    entry = dir.openNextFile();
+  }
+
+  ESP_LOGI(TAG, "Restored %u segments (%lu bytes)", static_cast<unsigned>(restoredCount),
+           static_cast<unsigned long>(totalBytesLocked()));
+}
+
+void flushIndex(SegmentWriter& writer) {
+  if (writer.pendingIndexCount == 0) {
+    return;
+  }
+  core::fs::Lock fsLock;
+  writer.index.write(reinterpret_cast<const uint8_t*>(writer.pendingIndex), writer.pendingIndexCount * sizeof(IndexEntry));
+  writer.index.flush();
+  writer.pendingIndexCount = 0;
+}
+
+void closeWriter(SegmentWriter& writer) {
+  if (!writer.open) {
+    return;
+  }
+
+  {
+    core::fs::Lock fsLock;
+    if (writer.blockUsed > 0) {
+      writer.data.write(writer.block, writer.blockUsed);
+      writer.blockUsed = 0;
+    }
+    flushIndex(writer);
+    writer.data.close();
+    writer.index.close();
+  }
+  writer.open = false;
+
+  TableLock lock;
+  segments[writer.segment].writtenBytes = segments[writer.segment].bytes;
+}
+
+bool openWriter(SegmentWriter& writer, const uint8_t mac[6]) {
+  if (writer.block == nullptr) {
+    writer.block = static_cast<uint8_t*>(allocPsram(BLOCK_BYTES));
+    if (writer.block == nullptr) {
+      return false;
+    }
+  }
+
+  TableLock lock;
+  const int slot = reserveSegmentLocked(MASTER_RECORDER_SEGMENT_BYTES);
+  if (slot < 0) {
+    ESP_LOGW(TAG, "No room for a new segment");
+    return false;
+  }
+
+  Segment& segment = segments[slot];
+  segment = Segment{};
+  segment.used = true;
+  memcpy(segment.mac, mac, sizeof(segment.mac));
+  segment.seq = nextSeq++;
+
+  core::fs::Lock fsLock;
+  char path[48];
+  segmentPath(segment, "mjpg", path, sizeof(path));
+  writer.data = LittleFS.open(path, "w");
+  segmentPath(segment, "idx", path, sizeof(path));
+  writer.index = LittleFS.open(path, "w");
+  if (!writer.data || !writer.index) {
+    ESP_LOGW(TAG, "Open segment %lu failed", static_cast<unsigned long>(segment.seq));
+    writer.data.close();
+    writer.index.close();
+    deleteSegmentLocked(static_cast<size_t>(slot));
+    return false;
+  }
+
+  memcpy(writer.mac, mac, sizeof(writer.mac));
+  writer.segment = static_cast<size_t>(slot);
+  writer.blockUsed = 0;
+  writer.pendingIndexCount = 0;
+  writer.open = true;
+  return true;
+}
+
+SegmentWriter* writerFor(const uint8_t mac[6], uint32_t nowMs) {
+  SegmentWriter* idle = nullptr;
+  for (auto& writer : writers) {
+    if (writer.open && memcmp(writer.mac, mac, sizeof(writer.mac)) == 0) {
+      return &writer;
+    }
+    if (idle == nullptr && (!writer.open || nowMs - writer.lastFrameMs > IDLE_CLOSE_MS)) {
+      idle = &writer;
+    }
+  }
+
+  // Never steal an active writer: that would close its segment mid-stream.
+  if (idle == nullptr) {
+    return nullptr;
+  }
+  closeWriter(*idle);
+  return openWriter(*idle, mac) ? idle : nullptr;
+}
+
+// Flushed per block so a power cut keeps everything up to the last full block.
+void writeBlock(SegmentWriter& writer) {
+  {
+    core::fs::Lock fsLock;
+    writer.data.write(writer.block, BLOCK_BYTES);
+    writer.data.flush();
+  }
+  writer.blockUsed = 0;
+
+  TableLock lock;
+  segments[writer.segment].writtenBytes += BLOCK_BYTES;
+}
+
+// Data is staged in 4 KB blocks so every write lands on a flash block boundary.
+void appendFrame(SegmentWriter& writer, const QueuedFrame& frame, const uint8_t* jpeg) {
+  uint32_t segmentBytes = 0;
+  {
+    TableLock lock;
+    segmentBytes = segments[writer.segment].bytes;
+  }
+
+  const IndexEntry entry{frame.epochSec, frame.uptimeMs, frame.frameId, segmentBytes, frame.bytes};
+  size_t remaining = frame.bytes;
+  while (remaining > 0) {
+    const size_t take = min(remaining, BLOCK_BYTES - writer.blockUsed);
+    memcpy(writer.block + writer.blockUsed, jpeg, take);
+    writer.blockUsed += take;
+    jpeg += take;
+    remaining -= take;
+    if (writer.blockUsed == BLOCK_BYTES) {
+      writeBlock(writer);
+    }
+  }
+
+  writer.pendingIndex[writer.pendingIndexCount++] = entry;
+  if (writer.pendingIndexCount == INDEX_BATCH) {
+    flushIndex(writer);
+  }
+
+  TableLock lock;
+  Segment& segment = segments[writer.segment];
+  segment.bytes += frame.bytes;
+  if (segment.firstEpoch == 0) {
+    segment.firstEpoch = frame.epochSec;
+  }
+  segment.lastEpoch = frame.epochSec;
+}
+
+void writeFrame(const QueuedFrame& frame, const uint8_t* jpeg) {
+  const uint32_t nowMs = millis();
+  SegmentWriter* writer = writerFor(frame.mac, nowMs);
+  if (writer == nullptr) {
+    return;
+  }
+
+  uint32_t segmentBytes = 0;
+  {
+    TableLock lock;
+    segmentBytes = segments[writer->segment].bytes;
+  }
+  if (segmentBytes > 0 && segmentBytes + frame.bytes > MASTER_RECORDER_SEGMENT_BYTES) {
+    closeWriter(*writer);
+    if (!openWriter(*writer, frame.mac)) {
+      return;
+    }
+  }
+
+  appendFrame(*writer, frame, jpeg);
+  writer->lastFrameMs = nowMs;
+
+  portENTER_CRITICAL(&statsLock);
+  stats.framesWritten++;
+  portEXIT_CRITICAL(&statsLock);
+}
+
+void closeStoppedWriters(uint32_t nowMs) {
+  for (auto& writer : writers) {
+    if (writer.open && (!isRecording(writer.mac) || nowMs - writer.lastFrameMs > IDLE_CLOSE_MS)) {
+      closeWriter(writer);
+    }
+  }
+}
+
+void writerTask(void*) {
+  core::boot::waitFor(core::boot::FsReady, portMAX_DELAY);
+  if (core::boot::isFsMounted()) {
+    restoreSegments();
+  }
+
+  while (true) {
+    size_t itemSize = 0;
+    auto* item = static_cast<uint8_t*>(xRingbufferReceive(frameRing, &itemSize, pdMS_TO_TICKS(1000)));
+    if (item != nullptr) {
+      QueuedFrame frame;
+      memcpy(&frame, item, sizeof(frame));
+      if (core::boot::isFsMounted() && itemSize == sizeof(frame) + frame.bytes) {
+        writeFrame(frame, item + sizeof(frame));
+      }
+      vRingbufferReturnItem(frameRing, item);
+    }
+    closeStoppedWriters(millis());
+  }
+}
+
+}  // namespace
+
+bool begin() {
+  if (writerTaskHandle != nullptr) {
+    return true;
+  }
+
+  tableMutex = xSemaphoreCreateMutex();
+  auto* storage = static_cast<uint8_t*>(heap_caps_malloc(MASTER_RECORDER_RING_BYTES, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+  if (tableMutex == nullptr || storage == nullptr) {
+    ESP_LOGE(TAG, "Recorder allocation failed");
+    return false;
+  }
+
+  frameRing = xRingbufferCreateStatic(MASTER_RECORDER_RING_BYTES, RINGBUF_TYPE_NOSPLIT, storage, &frameRingStruct);
+  if (frameRing == nullptr) {
+    ESP_LOGE(TAG, "Recorder ring creation failed");
+    return false;
+  }
+
+  const BaseType_t created =
+      core::topology::createTask(core::topology::Task::CameraRecorder, writerTask, nullptr, &writerTaskHandle);
+  if (created != pdPASS) {
+    ESP_LOGE(TAG, "Failed to create recorder task");
+    return false;
+  }
+  return true;
+}
+
+void setRecording(const uint8_t mac[6], bool enabled) {
+  if (mac == nullptr) {
+    return;
+  }
+
+  portENTER_CRITICAL(&recordingLock);
+  int freeSlot = -1;
+  int found = -1;
+  for (size_t i = 0; i < MAX_RECORDING; ++i) {
+    if (recordingUsed[i] && memcmp(recordingMacs[i], mac, 6) == 0) {
+      found = static_cast<int>(i);
+    } else if (!recordingUsed[i] && freeSlot < 0) {
+      freeSlot = static_cast<int>(i);
+    }
+  }
+  if (enabled && found < 0 && freeSlot >= 0) {
+    memcpy(recordingMacs[freeSlot], mac, 6);
+    recordingUsed[freeSlot] = true;
+  } else if (!enabled && found >= 0) {
+    recordingUsed[found] = false;
+  }
+  portEXIT_CRITICAL(&recordingLock);
+
+  ESP_LOGI(TAG,
+           "Recording %s for %02X:%02X:%02X:%02X:%02X:%02X",
+           enabled ? "on" : "off", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+}
+
+bool isRecording(const uint8_t mac[6]) {
+  if (mac == nullptr) {
+    return false;
+  }
+
+  bool recording = false;
+  portENTER_CRITICAL(&recordingLock);
+  for (size_t i = 0; i < MAX_RECORDING && !recording; ++i) {
+    recording = recordingUsed[i] && memcmp(recordingMacs[i], mac, 6) == 0;
+  }
+  portEXIT_CRITICAL(&recordingLock);
+  return recording;
+}
+
+void onFrameComplete(const uint8_t mac[6],
+                     const uint8_t* jpeg,
+                     uint32_t jpegBytes,
+                     uint32_t frameId,
+                     uint16_t width,
+                     uint16_t height) {
+  if (frameRing == nullptr || jpeg == nullptr || jpegBytes == 0 || !isRecording(mac)) {
+    return;
+  }
+
+  QueuedFrame frame = {};
+  memcpy(frame.mac, mac, sizeof(frame.mac));
+  frame.width = width;
+  frame.height = height;
+  frame.frameId = frameId;
+  uint32_t epochSec = 0;
+  history::nowEpochSeconds(epochSec);
+  frame.epochSec = epochSec;
+  frame.uptimeMs = millis();
+  frame.bytes = jpegBytes;
+
+  void* slot = nullptr;
+  const bool acquired = xRingbufferSendAcquire(frameRing, &slot, sizeof(frame) + jpegBytes, 0) == pdTRUE;
+  if (acquired) {
+    memcpy(slot, &frame, sizeof(frame));
+    memcpy(static_cast<uint8_t*>(slot) + sizeof(frame), jpeg, jpegBytes);
+    xRingbufferSendComplete(frameRing, slot);
+  }
+
+  portENTER_CRITICAL(&statsLock);
+  if (acquired) {
+    stats.framesQueued++;
+  } else {
+    stats.framesDropped++;
+  }
+  portEXIT_CRITICAL(&statsLock);
+}
+
+bool seek(const uint8_t mac[6], uint32_t epochSec, FrameLocation& out) {
+  out = FrameLocation{};
+  if (mac == nullptr || tableMutex == nullptr) {
+    return false;
+  }
+
+  Segment target;
+  {
+    TableLock lock;
+    for (const auto& segment : segments) {
+      if (!segment.used || memcmp(segment.mac, mac, sizeof(segment.mac)) != 0 || segment.lastEpoch < epochSec) {
+        continue;
+      }
+      if (!target.used || segment.seq < target.seq) {
+        target = segment;
+      }
+    }
+  }
+  if (!target.used) {
+    return false;
+  }
+
+  core::fs::Lock fsLock;
+  char path[48];
+  segmentPath(target, "idx", path, sizeof(path));
+  File index = LittleFS.open(path, "r");
+  if (!index) {
+    return false;
+  }
+
+  // Lower bound on epochSec; index entries are appended in time order.
+  size_t low = 0;
+  size_t high = index.size() / sizeof(IndexEntry);
+  IndexEntry entry = {};
+  while (low < high) {
+    const size_t mid = low + (high - low) / 2;
+    if (!readIndexEntry(index, mid, entry)) {
+      return false;
+    }
+    if (entry.epochSec < epochSec) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+
+  const bool found = readIndexEntry(index, low, entry) && entry.offset + entry.size <= target.writtenBytes;
+  index.close();
+  if (!found) {
+    return false;
+  }
+
+  segmentPath(target, "mjpg", out.path, sizeof(out.path));
+  out.offset = entry.offset;
+  out.size = entry.size;
+  out.epochSec = entry.epochSec;
+  out.frameId = entry.frameId;
+  return true;
+}
+
+void getStats(Stats& out) {
+  portENTER_CRITICAL(&statsLock);
+  out = stats;
+  portEXIT_CRITICAL(&statsLock);
+
+  TableLock lock;
+  out.bytesOnDisk = totalBytesLocked();
+  out.segments = 0;
+  for (const auto& segment : segments) {
+    if (segment.used) {
+      out.segments++;
+    }
+  }
+}
+
+}  // namespace app::espnow::camera_recorder
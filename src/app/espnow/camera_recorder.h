@@ -0,0 +1,44 @@
+#pragma once
+
+#include <Arduino.h>
+
+namespace app::espnow::camera_recorder {
+
+struct FrameLocation {
+  char path[40] = {0};
+  uint32_t offset = 0;
+  uint32_t size = 0;
+  uint32_t epochSec = 0;
+  uint32_t frameId = 0;
+};
+
+struct Stats {
+  uint32_t framesQueued = 0;
+  uint32_t framesDropped = 0;
+  uint32_t framesWritten = 0;
+  uint32_t bytesOnDisk = 0;
+  uint16_t segments = 0;
+};
+
+// Allocates the PSRAM frame ring and starts the writer task; the task
+// waits for LittleFS before touching /rec.
+bool begin();
+
+void setRecording(const uint8_t mac[6], bool enabled);
+bool isRecording(const uint8_t mac[6]);
+
+// RX path: copies a completed JPEG into the ring and returns. Never blocks
+// and never touches the filesystem; frames are dropped when the ring is full.
+void onFrameComplete(const uint8_t mac[6],
+                     const uint8_t* jpeg,
+                     uint32_t jpegBytes,
+                     uint32_t frameId,
+                     uint16_t width,
+                     uint16_t height);
+
+// First recorded frame of `mac` at or after epochSec, via the segment
+// index files.
+bool seek(const uint8_t mac[6], uint32_t epochSec, FrameLocation& out);
+void getStats(Stats& out);
+
+}  // namespace app::espnow::camera_recorder
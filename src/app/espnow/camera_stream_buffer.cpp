@@ -1,11 +1,20 @@
 #include "camera_stream_buffer.h"
+#include "camera_fec.h"
+#include "camera_frame_pool.h"
+#include "camera_rate_controller.h"
+#include "camera_recorder.h"
+#include "core/crc32.h"
+#include "core/task_topology.h"
 
 #include <JPEGDEC.h>
 #include <LittleFS.h>
 #include <esp_log.h>
 #include <cstring>
 #include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 #include <TJpg_Decoder.h>
+#include <utility>
 
 namespace app::espnow::camera_stream {
 namespace {
@@ -13,10 +22,12 @@ namespace {
 static constexpr const char* TAG = "cam_stream_buf";
 static constexpr uint16_t PREVIEW_W = 160;
 static constexpr uint16_t PREVIEW_H = 120;
-static constexpr size_t MAX_JPEG_BYTES = 32768;
-static constexpr size_t MAX_DECODE_BYTES = MAX_JPEG_BYTES + 512;
+static constexpr size_t MAX_JPEG_BYTES = camera_frames::kMaxJpegBytes;
 static constexpr uint16_t MAX_TRACKED_CHUNKS = static_cast<uint16_t>(MAX_JPEG_BYTES / state_binary::kCameraChunkDataBytes) + 2;
 static constexpr uint8_t MAX_FAILED_DUMP_SLOTS = 4;
+static constexpr size_t MAX_PARITY_CHUNKS = MAX_TRACKED_CHUNKS;
+// Largest sensor mode (QSXGA); meta beyond it would size the decode buffer.
+static constexpr uint16_t MAX_SOURCE_DIMENSION = 2592;
 
 JPEGDEC jpeg;
 // TJpg_Decoder instance is provided by the library (TJpgDec)
@@ -122,29 +133,94 @@ uint16_t computeChecksum16(const uint8_t* data, size_t length) {
   return static_cast<uint16_t>(sum & 0xFFFF);
 }
 
-uint16_t detectSofMarker(const uint8_t* data, size_t length) {
-  if (data == nullptr || length < 4) {
-    return 0;
+// Decode-time header written in front of jpegBytes when a frame has no DHT:
+// SOI + default DHT + a 2-byte COM segment that swallows the frame's own SOI,
+// so the original bytes follow unchanged and nothing is copied.
+static constexpr uint8_t kDhtPrefixComment[] = {0xFF, 0xFE, 0x00, 0x04};
+static constexpr size_t JPEG_HEADROOM = 2 + sizeof(kDefaultDhtSegment) + sizeof(kDhtPrefixComment);
+
+bool isSofMarker(uint8_t marker) {
+  return marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC;
+}
+
+// Header markers up to SOS, parsed as the frame's leading bytes arrive.
+struct MarkerIndex {
+  size_t parsed = 0;     // offset of the next marker to inspect
+  bool headerDone = false;
+  bool valid = false;    // SOI ... SOS walked without errors
+  bool hasDht = false;
+  uint16_t sofMarker = 0;
+  size_t sosOffset = 0;
+  size_t eoiEnd = 0;     // offset just past EOI, 0 = not seen yet
+};
+
+void advanceMarkerIndex(MarkerIndex& index, const uint8_t* data, size_t available) {
+  if (index.headerDone) {
+    return;
   }
 
-  for (size_t index = 0; index + 1 < length; ++index) {
-    if (data[index] != 0xFF) {
+  if (index.parsed == 0) {
+    if (available < 2) {
+      return;
+    }
+    if (data[0] != 0xFF || data[1] != 0xD8) {
+      index.headerDone = true;
+      return;
+    }
+    index.parsed = 2;
+  }
+
+  while (index.parsed + 4 <= available) {
+    const uint8_t* cursor = data + index.parsed;
+    if (cursor[0] != 0xFF) {
+      index.headerDone = true;
+      return;
+    }
+
+    const uint8_t marker = cursor[1];
+    if (marker == 0xFF) {
+      index.parsed++;
+      continue;
+    }
+    if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7)) {
+      index.parsed += 2;
       continue;
     }
 
-    const uint8_t marker = data[index + 1];
-    if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC) {
-      return static_cast<uint16_t>(0xFF00 | marker);
+    const size_t length = (static_cast<size_t>(cursor[2]) << 8) | cursor[3];
+    if (length < 2) {
+      index.headerDone = true;
+      return;
+    }
+
+    if (marker == 0xC4) {
+      index.hasDht = true;
+    } else if (isSofMarker(marker) && index.sofMarker == 0) {
+      index.sofMarker = static_cast<uint16_t>(0xFF00 | marker);
+    } else if (marker == 0xDA) {
+      index.sosOffset = index.parsed;
+      index.valid = index.sofMarker != 0;
+      index.headerDone = true;
+      return;
     }
+
+    index.parsed += 2 + length;
   }
+}
 
+// Offset just past the last FF D9 in [from, to), 0 when absent.
+size_t findEoiEnd(const uint8_t* data, size_t from, size_t to) {
+  for (size_t end = to; end >= from + 2; --end) {
+    if (data[end - 2] == 0xFF && data[end - 1] == 0xD9) {
+      return end;
+    }
+  }
   return 0;
 }
 
 struct StreamState {
   bool frameOpen = false;
   bool previewReady = false;
-  bool rawReady = false;
   uint8_t sourceMac[6] = {0};
   uint32_t frameId = 0;
   uint16_t srcW = 0;
@@ -155,15 +231,19 @@ struct StreamState {
   size_t receivedBytes = 0;
   size_t maxWrittenOffset = 0;
   uint8_t chunkSeen[MAX_TRACKED_CHUNKS] = {0};
-  uint8_t* jpegBytes = nullptr;
-  uint8_t* rawJpegBytes = nullptr;
-  uint8_t* decodeWorkBytes = nullptr;
-  uint32_t rawJpegSize = 0;
-  uint32_t rawFrameId = 0;
-  uint16_t rawW = 0;
-  uint16_t rawH = 0;
-  uint8_t rawSourceMac[6] = {0};
+  // CRC-32 of jpegBytes[0, crcOffset), advanced as chunks become contiguous.
+  uint32_t runningCrc = 0;
+  size_t crcOffset = 0;
+  MarkerIndex markers;
+  uint8_t* frameStorage = nullptr;  // JPEG_HEADROOM + MAX_JPEG_BYTES
+  uint8_t* jpegBytes = nullptr;     // frameStorage + JPEG_HEADROOM
+  bool fecEnabled = false;
+  camera_fec::Layout fecLayout;
+  uint8_t paritySeen[MAX_PARITY_CHUNKS] = {0};
+  uint8_t* parityBytes = nullptr;
   uint16_t* previewPixels = nullptr;
+  uint8_t previewMac[6] = {0};
+  uint32_t previewFrameId = 0;
   // decoded (no-downscale) buffer and metadata
   uint16_t* decodedPixels = nullptr;
   uint16_t decodedW = 0;
@@ -172,6 +252,28 @@ struct StreamState {
 };
 
 StreamState state;
+FecStats fecStats;
+
+// A completed frame handed to the decoder. Inline decodes point into the
+// reassembly buffer; the worker decodes the buffer it was swapped out to.
+struct DecodeJob {
+  uint8_t mac[6] = {0};
+  uint32_t frameId = 0;
+  uint16_t srcW = 0;
+  uint16_t srcH = 0;
+  size_t bytes = 0;
+  MarkerIndex markers;
+  uint8_t* jpegBytes = nullptr;
+  uint16_t receivedChunks = 0;
+  uint16_t expectedChunks = 0;
+};
+
+TaskHandle_t decodeTaskHandle = nullptr;
+uint8_t* spareStorage = nullptr;  // JPEG_HEADROOM + MAX_JPEG_BYTES, owned by the worker while busy
+DecodeJob pendingJob;
+bool decodeBusy = false;
+DecodeStats decodeStats;
+portMUX_TYPE decodeLock = portMUX_INITIALIZER_UNLOCKED;
 
 bool legacyDumpCleanupDone = false;
 
@@ -210,13 +312,27 @@ void cleanupLegacyCameraDumpsOnce() {
   dir.close();
 }
 
+// Frame buffer with the decode-time DHT header already in its headroom.
+uint8_t* allocFrameStorage() {
+  auto* storage = static_cast<uint8_t*>(malloc(JPEG_HEADROOM + MAX_JPEG_BYTES));
+  if (storage == nullptr) {
+    return nullptr;
+  }
+  storage[0] = 0xFF;
+  storage[1] = 0xD8;
+  memcpy(storage + 2, kDefaultDhtSegment, sizeof(kDefaultDhtSegment));
+  memcpy(storage + 2 + sizeof(kDefaultDhtSegment), kDhtPrefixComment, sizeof(kDhtPrefixComment));
+  return storage;
+}
+
 bool ensureBuffers() {
-  if (state.jpegBytes == nullptr) {
-    state.jpegBytes = static_cast<uint8_t*>(malloc(MAX_JPEG_BYTES));
-    if (state.jpegBytes == nullptr) {
+  if (state.frameStorage == nullptr) {
+    state.frameStorage = allocFrameStorage();
+    if (state.frameStorage == nullptr) {
       ESP_LOGE(TAG, "Alloc jpeg buffer failed");
       return false;
     }
+    state.jpegBytes = state.frameStorage + JPEG_HEADROOM;
   }
 
   if (state.previewPixels == nullptr) {
@@ -227,37 +343,105 @@ bool ensureBuffers() {
     }
   }
 
-  if (state.rawJpegBytes == nullptr) {
-    state.rawJpegBytes = static_cast<uint8_t*>(malloc(MAX_JPEG_BYTES));
-    if (state.rawJpegBytes == nullptr) {
-      ESP_LOGE(TAG, "Alloc raw jpeg buffer failed");
+  return true;
+}
+
+bool ensureParityBuffer() {
+  if (state.parityBytes == nullptr) {
+    state.parityBytes = static_cast<uint8_t*>(malloc(MAX_PARITY_CHUNKS * camera_fec::kChunkBytes));
+    if (state.parityBytes == nullptr) {
+      ESP_LOGE(TAG, "Alloc parity buffer failed");
       return false;
     }
   }
+  return true;
+}
 
-  if (state.decodeWorkBytes == nullptr) {
-    state.decodeWorkBytes = static_cast<uint8_t*>(malloc(MAX_DECODE_BYTES));
-    if (state.decodeWorkBytes == nullptr) {
-      ESP_LOGE(TAG, "Alloc decode work buffer failed");
-      return false;
-    }
+void resetParity() {
+  state.fecLayout = camera_fec::Layout{};
+  memset(state.paritySeen, 0, sizeof(state.paritySeen));
+}
+
+void storeParityChunk(const state_binary::CameraChunkState& chunk) {
+  camera_fec::Layout layout;
+  camera_fec::ParityId id;
+  if (!state.fecEnabled || !camera_fec::parseParityChunk(chunk.idx, chunk.total, layout, id)) {
+    return;
   }
 
-  return true;
+  if (camera_fec::isValid(state.fecLayout) &&
+      (layout.dataPerGroup != state.fecLayout.dataPerGroup || layout.parityPerGroup != state.fecLayout.parityPerGroup)) {
+    return;
+  }
+
+  const size_t slot = camera_fec::paritySlot(layout, id);
+  if (slot >= MAX_PARITY_CHUNKS || chunk.dataLen > camera_fec::kChunkBytes) {
+    return;
+  }
+
+  state.fecLayout = layout;
+  uint8_t* target = state.parityBytes + slot * camera_fec::kChunkBytes;
+  memcpy(target, chunk.data, chunk.dataLen);
+  memset(target + chunk.dataLen, 0, camera_fec::kChunkBytes - chunk.dataLen);
+  state.paritySeen[slot] = 1;
 }
 
-bool hasMarker(const uint8_t* data, size_t length, uint8_t marker) {
-  if (data == nullptr || length < 2) {
-    return false;
+// Runs before the completeness check so a frame with losses covered by
+// parity is decoded instead of dropped.
+void recoverMissingChunks() {
+  if (!state.fecEnabled || state.expectedChunks == 0 || state.receivedChunks >= state.expectedChunks) {
+    return;
+  }
+
+  const uint16_t dataChunks = state.expectedChunks < MAX_TRACKED_CHUNKS ? state.expectedChunks : MAX_TRACKED_CHUNKS - 1;
+  const uint32_t totalBytes = static_cast<uint32_t>(state.expectedBytes <= MAX_JPEG_BYTES ? state.expectedBytes : 0);
+  const camera_fec::RecoveryResult result = camera_fec::recover(state.jpegBytes,
+                                                                totalBytes,
+                                                                dataChunks,
+                                                                state.chunkSeen,
+                                                                state.fecLayout,
+                                                                state.parityBytes,
+                                                                state.paritySeen,
+                                                                MAX_PARITY_CHUNKS);
+
+  state.receivedChunks = static_cast<uint16_t>(state.receivedChunks + result.recovered);
+  if (result.recovered > 0 && totalBytes > state.maxWrittenOffset) {
+    state.maxWrittenOffset = totalBytes;
+  }
+
+  fecStats.recoveredChunks += result.recovered;
+  fecStats.lostChunks += result.lost;
+  if (result.lost == 0) {
+    fecStats.recoveredFrames++;
+  } else {
+    fecStats.lostFrames++;
   }
 
-  for (size_t index = 0; index + 1 < length; ++index) {
-    if (data[index] == 0xFF && data[index + 1] == marker) {
-      return true;
+  ESP_LOGD(TAG,
+           "FEC frame=%lu recovered=%u lost=%u",
+           static_cast<unsigned long>(state.frameId),
+           static_cast<unsigned>(result.recovered),
+           static_cast<unsigned>(result.lost));
+}
+
+// Only full chunks before the last one are folded here; the last chunk's
+// length (and anything filled by FEC) is settled in finishRunningCrc.
+void advanceRunningCrc() {
+  while (true) {
+    const size_t nextIdx = state.crcOffset / state_binary::kCameraChunkDataBytes + 1;
+    if (nextIdx >= MAX_TRACKED_CHUNKS || nextIdx >= state.expectedChunks || state.chunkSeen[nextIdx] == 0) {
+      return;
     }
+    state.runningCrc = core::crc32(state.jpegBytes + state.crcOffset, state_binary::kCameraChunkDataBytes, state.runningCrc);
+    state.crcOffset += state_binary::kCameraChunkDataBytes;
   }
+}
 
-  return false;
+uint32_t finishRunningCrc() {
+  if (state.crcOffset > state.receivedBytes) {
+    return core::crc32(state.jpegBytes, state.receivedBytes);
+  }
+  return core::crc32(state.jpegBytes + state.crcOffset, state.receivedBytes - state.crcOffset, state.runningCrc);
 }
 
 void resetCurrentFrame() {
@@ -268,6 +452,10 @@ void resetCurrentFrame() {
   state.receivedBytes = 0;
   state.maxWrittenOffset = 0;
   memset(state.chunkSeen, 0, sizeof(state.chunkSeen));
+  state.runningCrc = 0;
+  state.crcOffset = 0;
+  state.markers = MarkerIndex{};
+  resetParity();
 }
 
 int jpegDrawCallback(JPEGDRAW* draw) {
@@ -305,39 +493,42 @@ int jpegDrawCallback(JPEGDRAW* draw) {
   return 1;
 }
 
-bool decodeLatestFrameToPreview() {
-  if (!ensureBuffers()) {
+bool decodeFrameToPreview(const DecodeJob& job) {
+  if (state.previewPixels == nullptr || job.jpegBytes == nullptr) {
     return false;
   }
 
-  if (state.receivedBytes == 0 || state.srcW == 0 || state.srcH == 0) {
+  if (job.bytes == 0 || job.srcW == 0 || job.srcH == 0) {
     return false;
   }
 
-  if (!(state.jpegBytes[0] == 0xFF && state.jpegBytes[1] == 0xD8)) {
+  if (job.srcW > MAX_SOURCE_DIMENSION || job.srcH > MAX_SOURCE_DIMENSION) {
+    ESP_LOGW(TAG,
+             "Frame size %ux%u out of range, frame=%lu",
+             job.srcW,
+             job.srcH,
+             static_cast<unsigned long>(job.frameId));
+    return false;
+  }
+
+  if (!(job.jpegBytes[0] == 0xFF && job.jpegBytes[1] == 0xD8)) {
     ESP_LOGW(TAG,
              "invalid SOI for frame=%lu bytes=%u",
-             static_cast<unsigned long>(state.frameId),
-             static_cast<unsigned>(state.receivedBytes));
+             static_cast<unsigned long>(job.frameId),
+             static_cast<unsigned>(job.bytes));
     return false;
   }
 
-  size_t decodeBytes = 0;
-  for (size_t index = state.receivedBytes; index >= 2; --index) {
-    if (state.jpegBytes[index - 2] == 0xFF && state.jpegBytes[index - 1] == 0xD9) {
-      decodeBytes = index;
-      break;
-    }
-    if (index == 2) {
-      break;
-    }
+  size_t decodeBytes = job.markers.eoiEnd;
+  if (decodeBytes == 0 || decodeBytes > job.bytes) {
+    decodeBytes = findEoiEnd(job.jpegBytes, 0, job.bytes);
   }
 
   if (decodeBytes == 0) {
     ESP_LOGW(TAG,
              "missing EOI for frame=%lu bytes=%u",
-             static_cast<unsigned long>(state.frameId),
-             static_cast<unsigned>(state.receivedBytes));
+             static_cast<unsigned long>(job.frameId),
+             static_cast<unsigned>(job.bytes));
     return false;
   }
 
@@ -358,25 +549,25 @@ bool decodeLatestFrameToPreview() {
   // artifacts. Otherwise select the smallest decoder scale that still
   // yields at least PREVIEW size.
   int chosenScale = 0;
-  uint16_t decW = state.srcW;
-  uint16_t decH = state.srcH;
+  uint16_t decW = job.srcW;
+  uint16_t decH = job.srcH;
 
   const size_t MAX_FULL_DECODE_PIXELS = static_cast<size_t>(240) * static_cast<size_t>(180); // 240x180
-  const size_t srcPixels = static_cast<size_t>(state.srcW) * static_cast<size_t>(state.srcH);
+  const size_t srcPixels = static_cast<size_t>(job.srcW) * static_cast<size_t>(job.srcH);
 
   if (srcPixels <= MAX_FULL_DECODE_PIXELS) {
     // prefer full decode (scale=0)
     chosenScale = 0;
-    decW = state.srcW;
-    decH = state.srcH;
+    decW = job.srcW;
+    decH = job.srcH;
   } else {
     // pick smallest decoder scale that yields >= PREVIEW size
     chosenScale = 3; // default to highest reduction
-    decW = static_cast<uint16_t>(state.srcW >> chosenScale);
-    decH = static_cast<uint16_t>(state.srcH >> chosenScale);
+    decW = static_cast<uint16_t>(job.srcW >> chosenScale);
+    decH = static_cast<uint16_t>(job.srcH >> chosenScale);
     for (int s = 0; s <= 3; ++s) {
-      uint16_t w = static_cast<uint16_t>(state.srcW >> s);
-      uint16_t h = static_cast<uint16_t>(state.srcH >> s);
+      uint16_t w = static_cast<uint16_t>(job.srcW >> s);
+      uint16_t h = static_cast<uint16_t>(job.srcH >> s);
       if (w == 0) w = 1;
       if (h == 0) h = 1;
       if (w >= PREVIEW_W && h >= PREVIEW_H) {
@@ -413,21 +604,14 @@ bool decodeLatestFrameToPreview() {
 
   activeDecodeCtx = &ctx;
 
-  uint8_t* decodePtr = state.jpegBytes;
+  uint8_t* decodePtr = job.jpegBytes;
   size_t decodeLen = decodeBytes;
   bool dhtInjected = false;
 
-  if (!hasMarker(state.jpegBytes, decodeBytes, 0xC4) && state.decodeWorkBytes != nullptr) {
-    const size_t injectedLen = decodeBytes + sizeof(kDefaultDhtSegment);
-    if (decodeBytes > 2 && injectedLen <= MAX_DECODE_BYTES) {
-      state.decodeWorkBytes[0] = state.jpegBytes[0];
-      state.decodeWorkBytes[1] = state.jpegBytes[1];
-      memcpy(state.decodeWorkBytes + 2, kDefaultDhtSegment, sizeof(kDefaultDhtSegment));
-      memcpy(state.decodeWorkBytes + 2 + sizeof(kDefaultDhtSegment), state.jpegBytes + 2, decodeBytes - 2);
-      decodePtr = state.decodeWorkBytes;
-      decodeLen = injectedLen;
-      dhtInjected = true;
-    }
+  if (job.markers.valid && !job.markers.hasDht) {
+    decodePtr = job.jpegBytes - JPEG_HEADROOM;
+    decodeLen = decodeBytes + JPEG_HEADROOM;
+    dhtInjected = true;
   }
 
   // Try TJpg_Decoder first; fallback to JPEGDEC if TJpg_Decoder fails.
@@ -475,12 +659,12 @@ bool decodeLatestFrameToPreview() {
     if (!openRamOk && !openFlashOk) {
       cleanupLegacyCameraDumpsOnce();
 
-      const unsigned dumpSlot = static_cast<unsigned>(state.frameId % MAX_FAILED_DUMP_SLOTS);
+      const unsigned dumpSlot = static_cast<unsigned>(job.frameId % MAX_FAILED_DUMP_SLOTS);
       snprintf(dumpPath, sizeof(dumpPath), "/cache/cam_fail_%u.jpg", dumpSlot);
 
       File dumpFile = LittleFS.open(dumpPath, "w");
       if (dumpFile) {
-        dumpFile.write(state.jpegBytes, decodeBytes);
+        dumpFile.write(job.jpegBytes, decodeBytes);
         dumpFile.close();
       }
 
@@ -494,27 +678,29 @@ bool decodeLatestFrameToPreview() {
     }
 
     if (!openRamOk && !openFlashOk && !openFileOk) {
-      const uint8_t h0 = decodeBytes > 0 ? state.jpegBytes[0] : 0;
-      const uint8_t h1 = decodeBytes > 1 ? state.jpegBytes[1] : 0;
-      const uint8_t t0 = decodeBytes > 1 ? state.jpegBytes[decodeBytes - 2] : 0;
-      const uint8_t t1 = decodeBytes > 0 ? state.jpegBytes[decodeBytes - 1] : 0;
-      const uint16_t sof = detectSofMarker(state.jpegBytes, decodeBytes);
+      const uint8_t h0 = decodeBytes > 0 ? job.jpegBytes[0] : 0;
+      const uint8_t h1 = decodeBytes > 1 ? job.jpegBytes[1] : 0;
+      const uint8_t t0 = decodeBytes > 1 ? job.jpegBytes[decodeBytes - 2] : 0;
+      const uint8_t t1 = decodeBytes > 0 ? job.jpegBytes[decodeBytes - 1] : 0;
+      const uint16_t sof = job.markers.sofMarker;
 
       activeDecodeCtx = nullptr;
-      ESP_LOGW(TAG, "jpeg open failed frame=%lu bytes=%u used=%u hdr=%02X%02X tail=%02X%02X sof=0x%04X dht=%u openErr(ram=%d flash=%d file=%d) file=%s",
-               static_cast<unsigned long>(state.frameId),
-               static_cast<unsigned>(state.receivedBytes),
+      ESP_LOGW(TAG, "jpeg open failed frame=%lu bytes=%u used=%u hdr=%02X%02X tail=%02X%02X sof=0x%04X sos=%u dht=%u openErr(ram=%d flash=%d file=%d) file=%s",
+               static_cast<unsigned long>(job.frameId),
+               static_cast<unsigned>(job.bytes),
                static_cast<unsigned>(decodeBytes),
                static_cast<unsigned>(h0),
                static_cast<unsigned>(h1),
                static_cast<unsigned>(t0),
                static_cast<unsigned>(t1),
                static_cast<unsigned>(sof),
+               static_cast<unsigned>(job.markers.sosOffset),
                static_cast<unsigned>(dhtInjected ? 1 : 0),
                openRamErr,
                openFlashErr,
                openFileErr,
                dumpPath[0] != '\0' ? dumpPath : "-");
+      free(ctx.tmpPixels);
       return false;
     }
 
@@ -524,7 +710,7 @@ bool decodeLatestFrameToPreview() {
 
     if (jdecRc == 0) {
       ESP_LOGW(TAG, "decode failed frame=%lu rc=%d err=%d",
-               static_cast<unsigned long>(state.frameId),
+               static_cast<unsigned long>(job.frameId),
                jdecRc,
                jpeg.getLastError());
       free(ctx.tmpPixels);
@@ -644,10 +830,83 @@ bool decodeLatestFrameToPreview() {
     free(ctx.tmpPixels);
   }
 
+  memcpy(state.previewMac, job.mac, sizeof(state.previewMac));
+  state.previewFrameId = job.frameId;
   state.previewReady = true;
   return true;
 }
 
+DecodeJob jobFromState() {
+  DecodeJob job;
+  memcpy(job.mac, state.sourceMac, sizeof(job.mac));
+  job.frameId = state.frameId;
+  job.srcW = state.srcW;
+  job.srcH = state.srcH;
+  job.bytes = state.receivedBytes;
+  job.markers = state.markers;
+  job.jpegBytes = state.jpegBytes;
+  job.receivedChunks = state.receivedChunks;
+  job.expectedChunks = state.expectedChunks;
+  return job;
+}
+
+void runDecode(const DecodeJob& job) {
+  const uint32_t decodeStartUs = micros();
+  const bool decodeOk = decodeFrameToPreview(job);
+  const uint32_t decodeUs = micros() - decodeStartUs;
+
+  portENTER_CRITICAL(&decodeLock);
+  if (decodeOk) {
+    decodeStats.decoded++;
+  } else {
+    decodeStats.failed++;
+  }
+  decodeStats.lastDecodeUs = decodeUs;
+  portEXIT_CRITICAL(&decodeLock);
+
+  camera_rate::onFrameFinished(job.mac, decodeOk, job.receivedChunks, job.expectedChunks, decodeUs);
+}
+
+void decodeWorker(void*) {
+  while (true) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    runDecode(pendingJob);
+
+    portENTER_CRITICAL(&decodeLock);
+    decodeBusy = false;
+    portEXIT_CRITICAL(&decodeLock);
+  }
+}
+
+// Without the worker the frame is decoded here, in the receive callback.
+// With it, the finished buffer is swapped with the idle spare so reassembly
+// goes on during the decode; a frame that ends while the previous one is
+// still decoding is skipped (it was already published to the pool).
+void decodeCompletedFrame() {
+  if (decodeTaskHandle == nullptr) {
+    runDecode(jobFromState());
+    return;
+  }
+
+  portENTER_CRITICAL(&decodeLock);
+  const bool busy = decodeBusy;
+  decodeBusy = true;
+  if (busy) {
+    decodeStats.skipped++;
+  }
+  portEXIT_CRITICAL(&decodeLock);
+
+  if (busy) {
+    camera_rate::onFrameFinished(state.sourceMac, true, state.receivedChunks, state.expectedChunks, 0);
+    return;
+  }
+
+  pendingJob = jobFromState();
+  std::swap(state.frameStorage, spareStorage);
+  state.jpegBytes = state.frameStorage + JPEG_HEADROOM;
+  xTaskNotifyGive(decodeTaskHandle);
+}
+
 }  // namespace
 
 void ingestMeta(const uint8_t mac[6], const state_binary::CameraMetaState& meta) {
@@ -659,6 +918,11 @@ void ingestMeta(const uint8_t mac[6], const state_binary::CameraMetaState& meta)
     return;
   }
 
+  if (state.frameOpen) {
+    camera_rate::onFrameFinished(state.sourceMac, false, state.receivedChunks, state.expectedChunks, 0);
+  }
+  camera_rate::onFrameStarted(mac, meta.frameId, meta.quality, meta.width, meta.height);
+
   memcpy(state.sourceMac, mac, sizeof(state.sourceMac));
   state.frameId = meta.frameId;
   state.srcW = meta.width;
@@ -669,6 +933,11 @@ void ingestMeta(const uint8_t mac[6], const state_binary::CameraMetaState& meta)
   state.receivedBytes = 0;
   state.maxWrittenOffset = 0;
   memset(state.chunkSeen, 0, sizeof(state.chunkSeen));
+  state.runningCrc = 0;
+  state.crcOffset = 0;
+  state.markers = MarkerIndex{};
+  resetParity();
+  state.fecEnabled = (meta.format & camera_fec::kFormatFecFlag) != 0 && ensureParityBuffer();
   state.frameOpen = true;
 }
 
@@ -681,7 +950,12 @@ void ingestChunk(const uint8_t mac[6], const state_binary::CameraChunkState& chu
     return;
   }
 
-  if (chunk.frameId != state.frameId || chunk.dataLen == 0) {
+  if (chunk.frameId != state.frameId || chunk.dataLen == 0 || chunk.dataLen > state_binary::kCameraChunkDataBytes) {
+    return;
+  }
+
+  if (camera_fec::isParityIdx(chunk.idx)) {
+    storeParityChunk(chunk);
     return;
   }
 
@@ -713,9 +987,14 @@ void ingestChunk(const uint8_t mac[6], const state_binary::CameraChunkState& chu
     state.maxWrittenOffset = chunkEnd;
   }
 
+  advanceRunningCrc();
+  advanceMarkerIndex(state.markers, state.jpegBytes, state.crcOffset);
+  if (chunk.idx == state.expectedChunks) {
+    state.markers.eoiEnd = findEoiEnd(state.jpegBytes, chunkOffset, chunkEnd);
+  }
 }
 
-void ingestFrameEnd(const uint8_t mac[6], const state_binary::CameraFrameEndState& frameEnd) {
+void ingestFrameEnd(const uint8_t mac[6], const state_binary::CameraFrameEndState& frameEnd, bool hasCrc32) {
   if (mac == nullptr || !state.frameOpen) {
     return;
   }
@@ -735,13 +1014,29 @@ void ingestFrameEnd(const uint8_t mac[6], const state_binary::CameraFrameEndStat
     state.expectedBytes = frameEnd.totalBytes;
   }
 
+  recoverMissingChunks();
+
   if (state.expectedBytes > 0 && state.expectedBytes < state.maxWrittenOffset) {
     state.receivedBytes = state.expectedBytes;
   } else {
     state.receivedBytes = state.maxWrittenOffset;
   }
+  advanceMarkerIndex(state.markers, state.jpegBytes, state.receivedBytes);
 
-  if (frameEnd.reserved != 0 && state.receivedBytes > 0) {
+  if (hasCrc32 && state.receivedBytes > 0) {
+    const uint32_t actualCrc = finishRunningCrc();
+    if (actualCrc != frameEnd.crc32) {
+      ESP_LOGW(TAG,
+               "Frame CRC mismatch frame=%lu expected=0x%08lX actual=0x%08lX bytes=%u",
+               static_cast<unsigned long>(state.frameId),
+               static_cast<unsigned long>(frameEnd.crc32),
+               static_cast<unsigned long>(actualCrc),
+               static_cast<unsigned>(state.receivedBytes));
+      camera_rate::onFrameFinished(mac, false, state.receivedChunks, state.expectedChunks, 0);
+      resetCurrentFrame();
+      return;
+    }
+  } else if (frameEnd.reserved != 0 && state.receivedBytes > 0) {
     const uint16_t actualChecksum = computeChecksum16(state.jpegBytes, state.receivedBytes);
     if (actualChecksum != frameEnd.reserved) {
       ESP_LOGW(TAG,
@@ -750,6 +1045,7 @@ void ingestFrameEnd(const uint8_t mac[6], const state_binary::CameraFrameEndStat
                static_cast<unsigned>(frameEnd.reserved),
                static_cast<unsigned>(actualChecksum),
                static_cast<unsigned>(state.receivedBytes));
+      camera_rate::onFrameFinished(mac, false, state.receivedChunks, state.expectedChunks, 0);
       resetCurrentFrame();
       return;
     }
@@ -762,32 +1058,61 @@ void ingestFrameEnd(const uint8_t mac[6], const state_binary::CameraFrameEndStat
              static_cast<unsigned>(state.receivedChunks),
              static_cast<unsigned>(state.expectedChunks),
              static_cast<unsigned>(state.receivedBytes));
+    camera_rate::onFrameFinished(mac, false, state.receivedChunks, state.expectedChunks, 0);
     resetCurrentFrame();
     return;
   }
 
-  if (state.receivedBytes > 0 && state.receivedBytes <= MAX_JPEG_BYTES && state.rawJpegBytes != nullptr) {
-    memcpy(state.rawJpegBytes, state.jpegBytes, state.receivedBytes);
-    state.rawJpegSize = static_cast<uint32_t>(state.receivedBytes);
-    state.rawFrameId = state.frameId;
-    state.rawW = state.srcW;
-    state.rawH = state.srcH;
-    memcpy(state.rawSourceMac, state.sourceMac, sizeof(state.rawSourceMac));
-    state.rawReady = true;
+  if (state.receivedBytes > 0 && state.receivedBytes <= MAX_JPEG_BYTES) {
+    const uint32_t jpegBytes = static_cast<uint32_t>(state.receivedBytes);
+    camera_frames::publish(state.sourceMac, state.jpegBytes, jpegBytes, state.frameId, state.srcW, state.srcH);
+    camera_recorder::onFrameComplete(state.sourceMac, state.jpegBytes, jpegBytes, state.frameId, state.srcW, state.srcH);
   }
 
   if (state.receivedBytes > 4 && state.jpegBytes[0] == 0xFF && state.jpegBytes[1] == 0xD8) {
-    const bool decodeOk = decodeLatestFrameToPreview();
+    decodeCompletedFrame();
   } else {
     ESP_LOGW(TAG,
              "Frame invalid jpeg header frame=%lu bytes=%u, skip decode",
              static_cast<unsigned long>(state.frameId),
              static_cast<unsigned>(state.receivedBytes));
+    camera_rate::onFrameFinished(mac, false, state.receivedChunks, state.expectedChunks, 0);
   }
 
   resetCurrentFrame();
 }
 
+void getFecStats(FecStats& out) {
+  out = fecStats;
+}
+
+bool beginDecodeWorker() {
+  if (decodeTaskHandle != nullptr) {
+    return true;
+  }
+
+  if (spareStorage == nullptr) {
+    spareStorage = allocFrameStorage();
+  }
+  if (spareStorage == nullptr) {
+    ESP_LOGW(TAG, "No spare frame buffer, decoding in the receive callback");
+    return false;
+  }
+
+  if (core::topology::createTask(core::topology::Task::CameraDecode, decodeWorker, nullptr, &decodeTaskHandle) != pdPASS) {
+    ESP_LOGW(TAG, "Failed to start decode worker, decoding in the receive callback");
+    decodeTaskHandle = nullptr;
+    return false;
+  }
+  return true;
+}
+
+void getDecodeStats(DecodeStats& out) {
+  portENTER_CRITICAL(&decodeLock);
+  out = decodeStats;
+  portEXIT_CRITICAL(&decodeLock);
+}
+
 bool getPreviewForMac(const uint8_t mac[6],
                       const uint16_t*& pixels,
                       uint16_t& width,
@@ -802,14 +1127,14 @@ bool getPreviewForMac(const uint8_t mac[6],
     return false;
   }
 
-  if (memcmp(mac, state.sourceMac, sizeof(state.sourceMac)) != 0) {
+  if (memcmp(mac, state.previewMac, sizeof(state.previewMac)) != 0) {
     return false;
   }
 
   pixels = state.previewPixels;
   width = PREVIEW_W;
   height = PREVIEW_H;
-  frameId = state.frameId;
+  frameId = state.previewFrameId;
   return true;
 }
 
@@ -828,42 +1153,14 @@ bool getDecodedForMac(const uint8_t mac[6],
     return false;
   }
 
-  if (memcmp(mac, state.sourceMac, sizeof(state.sourceMac)) != 0) {
+  if (memcmp(mac, state.previewMac, sizeof(state.previewMac)) != 0) {
     return false;
   }
 
   pixels = state.decodedPixels;
   width = state.decodedW;
   height = state.decodedH;
-  frameId = state.frameId;
-  return true;
-}
-
-bool getRawJpegForMac(const uint8_t mac[6],
-                      const uint8_t*& jpeg,
-                      uint32_t& jpegBytes,
-                      uint16_t& width,
-                      uint16_t& height,
-                      uint32_t& frameId) {
-  jpeg = nullptr;
-  jpegBytes = 0;
-  width = 0;
-  height = 0;
-  frameId = 0;
-
-  if (mac == nullptr || !state.rawReady || state.rawJpegBytes == nullptr || state.rawJpegSize == 0) {
-    return false;
-  }
-
-  if (memcmp(mac, state.rawSourceMac, sizeof(state.rawSourceMac)) != 0) {
-    return false;
-  }
-
-  jpeg = state.rawJpegBytes;
-  jpegBytes = state.rawJpegSize;
-  width = state.rawW;
-  height = state.rawH;
-  frameId = state.rawFrameId;
+  frameId = state.previewFrameId;
   return true;
 }
 
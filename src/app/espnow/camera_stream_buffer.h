@@ -6,9 +6,36 @@
 
 namespace app::espnow::camera_stream {
 
+// Frames that needed parity recovery (see camera_fec.h): recovered ones
+// were rebuilt completely, lost ones still had missing chunks.
+struct FecStats {
+  uint32_t recoveredChunks = 0;
+  uint32_t lostChunks = 0;
+  uint32_t recoveredFrames = 0;
+  uint32_t lostFrames = 0;
+};
+
+// Completed frames handed to the decoder: decoded, failed to decode, or
+// skipped because the worker was still busy with the previous frame.
+struct DecodeStats {
+  uint32_t decoded = 0;
+  uint32_t failed = 0;
+  uint32_t skipped = 0;
+  uint32_t lastDecodeUs = 0;
+};
+
+// Moves JPEG decode out of the ESP-NOW receive callback into its own task
+// (core::topology::Task::CameraDecode). Until it runs, or if it cannot
+// start, frames are decoded inline.
+bool beginDecodeWorker();
+
 void ingestMeta(const uint8_t mac[6], const state_binary::CameraMetaState& meta);
 void ingestChunk(const uint8_t mac[6], const state_binary::CameraChunkState& chunk);
-void ingestFrameEnd(const uint8_t mac[6], const state_binary::CameraFrameEndState& frameEnd);
+// hasCrc32: the sender filled CameraFrameEndState::crc32 (v2); otherwise the
+// v1 16-bit sum in `reserved` is checked.
+void ingestFrameEnd(const uint8_t mac[6], const state_binary::CameraFrameEndState& frameEnd, bool hasCrc32);
+void getFecStats(FecStats& out);
+void getDecodeStats(DecodeStats& out);
 
 bool getPreviewForMac(const uint8_t mac[6],
                       const uint16_t*& pixels,
@@ -22,11 +49,4 @@ bool getDecodedForMac(const uint8_t mac[6],
                       uint16_t& height,
                       uint32_t& frameId);
 
-bool getRawJpegForMac(const uint8_t mac[6],
-                      const uint8_t*& jpeg,
-                      uint32_t& jpegBytes,
-                      uint16_t& width,
-                      uint16_t& height,
-                      uint32_t& frameId);
-
 }  // namespace app::espnow::camera_stream
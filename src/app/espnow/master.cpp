@@ -1,9 +1,14 @@
 #include "master.h"
 #include "master_state_handler.h"
+#include "batch_frame.h"
+#include "camera_rate_controller.h"
+#include "camera_recorder.h"
+#include "master_history_store.h"
 #include "master_http_proxy.h"
-#include "payload_codec.h"
+#include "packet_capture.h"
 #include "state_binary.h"
 #include "device_driver_registry.h"
+#include "core/boot.h"
 #include "core/weather_sync.h"
 #include <app_config.h>
 
@@ -18,9 +23,11 @@ static const char* TAG = "espnow_master";
 static constexpr uint8_t MAX_CHANNEL_SET_RETRIES = 5;
 static constexpr uint32_t INTERNET_STATUS_INTERVAL_MS = 5000;
 static constexpr uint32_t IDENTITY_REQ_INTERVAL_MS = 3000;
-static constexpr size_t MAX_TRACKED_DEVICES = 32;
+static constexpr size_t MAX_TRACKED_DEVICES = MASTER_MAX_TRACKED_DEVICES;
 static constexpr uint32_t DEVICE_TIMEOUT_MS = 15000;
 static constexpr size_t MAX_BLACKLISTED_DEVICES = 32;
+static constexpr uint32_t HELLO_INTERVAL_MS = 2000;
+static constexpr uint32_t HEARTBEAT_INTERVAL_MS = 5000;
 
 struct TrackedDevice {
   bool active = false;
@@ -39,6 +46,7 @@ struct TrackedDevice {
   uint32_t cameraFrameId = 0;
   uint32_t cameraBytes = 0;
   uint16_t cameraChunks = 0;
+  uint32_t generation = 0;
 };
 
 struct BlacklistedDevice {
@@ -49,6 +57,8 @@ struct BlacklistedDevice {
 
 static TrackedDevice trackedDevices[MAX_TRACKED_DEVICES];
 static BlacklistedDevice blacklistedDevices[MAX_BLACKLISTED_DEVICES];
+static uint32_t deviceGenerationCounter = 0;
+static uint32_t registryGeneration = 0;
 
 static void macToText(const uint8_t mac[6], char out[18]) {
   snprintf(out,
@@ -104,6 +114,22 @@ static bool hasIdentifiedTrackedDevice() {
   return false;
 }
 
+// Batched broadcasts are only understood by slaves advertising
+// FeatureBatchFrames, so every tracked device must have it.
+static bool trackedDevicesAcceptBatch() {
+  bool any = false;
+  for (const auto& device : trackedDevices) {
+    if (!device.active) {
+      continue;
+    }
+    if ((device.featureBits & app::espnow::state_binary::FeatureBatchFrames) == 0) {
+      return false;
+    }
+    any = true;
+  }
+  return any;
+}
+
 static void logTrackedDevices() {
   ESP_LOGI(TAG, "Active devices: %u", static_cast<unsigned>(countTrackedDevices()));
   for (const auto& device : trackedDevices) {
@@ -139,6 +165,8 @@ static void touchTrackedDevice(const uint8_t mac[6], uint32_t nowMs) {
     trackedDevices[i].featureBits = 0;
     trackedDevices[i].kindLabel = "Unknown";
     trackedDevices[i].statusLine = "pending";
+    trackedDevices[i].generation = ++deviceGenerationCounter;
+    registryGeneration++;
 
     char macText[18] = {0};
     macToText(mac, macText);
@@ -174,7 +202,7 @@ static void requestIdentityFromUnverified(MasterNode& master, uint32_t nowMs) {
   }
 }
 
-static void refreshTrackedDeviceProfile(TrackedDevice& device) {
+static void applyTrackedDeviceProfile(TrackedDevice& device) {
   const auto profile = app::espnow::device_driver::classify(device.lastKnownId, device.featureBits);
   device.kindLabel = profile.kindLabel;
 
@@ -203,6 +231,16 @@ static void refreshTrackedDeviceProfile(TrackedDevice& device) {
   device.statusLine = device.lastKnownId.isEmpty() ? "pending" : "online";
 }
 
+static void refreshTrackedDeviceProfile(TrackedDevice& device, bool identityChanged = false) {
+  const String previousKind = device.kindLabel;
+  const String previousStatus = device.statusLine;
+  applyTrackedDeviceProfile(device);
+
+  if (identityChanged || device.kindLabel != previousKind || device.statusLine != previousStatus) {
+    device.generation = ++deviceGenerationCounter;
+  }
+}
+
 void updateTrackedDeviceIdentity(const uint8_t mac[6], const String& deviceId) {
   if (mac == nullptr || deviceId.isEmpty()) {
     return;
@@ -219,7 +257,7 @@ void updateTrackedDeviceIdentity(const uint8_t mac[6], const String& deviceId) {
 
   trackedDevices[index].lastKnownId = deviceId;
   trackedDevices[index].lastIdentityReqMs = 0;
-  refreshTrackedDeviceProfile(trackedDevices[index]);
+  refreshTrackedDeviceProfile(trackedDevices[index], true);
   char macText[18] = {0};
   macToText(mac, macText);
   ESP_LOGI(TAG, "Device identity updated: %s -> %s", macText, deviceId.c_str());
@@ -240,8 +278,9 @@ void updateTrackedDeviceFeatures(const uint8_t mac[6], uint32_t featureBits) {
   refreshTrackedDeviceProfile(trackedDevices[index]);
 }
 
-void updateTrackedDeviceStatePayload(const uint8_t mac[6], const String& payload) {
-  if (mac == nullptr || payload.isEmpty()) {
+// `payload` is the validated, zero-extended binary struct for `type`.
+void updateTrackedDeviceState(const uint8_t mac[6], state_binary::Type type, const uint8_t* payload) {
+  if (mac == nullptr || payload == nullptr) {
     return;
   }
 
@@ -251,64 +290,35 @@ void updateTrackedDeviceStatePayload(const uint8_t mac[6], const String& payload
   }
 
   auto& device = trackedDevices[index];
-
-  String stateName;
-  if (!app::espnow::codec::getField(payload, "state", stateName) || stateName.isEmpty()) {
-    return;
-  }
-
-  if (stateName == "features") {
-    String bits;
-    if (app::espnow::codec::getField(payload, "bits", bits)) {
-      device.featureBits = static_cast<uint32_t>(strtoul(bits.c_str(), nullptr, 10));
-    }
-    refreshTrackedDeviceProfile(device);
-    return;
-  }
-
-  if (stateName == "sensor") {
-    String temp;
-    String hum;
-    if (app::espnow::codec::getField(payload, "temp", temp)) {
-      device.sensorTemp10 = static_cast<int16_t>(temp.toFloat() * 10.0f);
-      device.hasSensor = true;
-    }
-    if (app::espnow::codec::getField(payload, "hum", hum)) {
-      device.sensorHum10 = static_cast<uint16_t>(hum.toFloat() * 10.0f);
+  switch (type) {
+    case state_binary::Type::Sensor: {
+      const auto* state = reinterpret_cast<const state_binary::SensorState*>(payload);
+      device.sensorTemp10 = state->temperature10;
+      device.sensorHum10 = state->humidity10;
       device.hasSensor = true;
+      break;
     }
-    refreshTrackedDeviceProfile(device);
-    return;
-  }
-
-  if (stateName == "weather") {
-    String code;
-    String time;
-    if (app::espnow::codec::getField(payload, "code", code)) {
-      device.weatherCode = static_cast<int16_t>(code.toInt());
+    case state_binary::Type::Weather: {
+      const auto* state = reinterpret_cast<const state_binary::WeatherState*>(payload);
+      device.weatherCode = state->code;
+      const size_t timeLength = strnlen(state->time, sizeof(state->time));
+      if (device.weatherTime.length() != timeLength || strncmp(device.weatherTime.c_str(), state->time, timeLength) != 0) {
+        device.weatherTime = String(state->time, timeLength);
+      }
+      break;
     }
-    if (app::espnow::codec::getField(payload, "time", time)) {
-      device.weatherTime = time;
+    case state_binary::Type::CameraMeta: {
+      const auto* state = reinterpret_cast<const state_binary::CameraMetaState*>(payload);
+      device.cameraFrameId = state->frameId;
+      device.cameraBytes = state->totalBytes;
+      device.cameraChunks = state->totalChunks;
+      break;
     }
-    refreshTrackedDeviceProfile(device);
-    return;
+    default:
+      return;
   }
 
-  if (stateName == "camera") {
-    String frameId;
-    String totalBytes;
-    String totalChunks;
-    if (app::espnow::codec::getField(payload, "frame", frameId)) {
-      device.cameraFrameId = static_cast<uint32_t>(strtoul(frameId.c_str(), nullptr, 10));
-    }
-    if (app::espnow::codec::getField(payload, "bytes", totalBytes)) {
-      device.cameraBytes = static_cast<uint32_t>(strtoul(totalBytes.c_str(), nullptr, 10));
-    }
-    if (app::espnow::codec::getField(payload, "chunks", totalChunks)) {
-      device.cameraChunks = static_cast<uint16_t>(strtoul(totalChunks.c_str(), nullptr, 10));
-    }
-    refreshTrackedDeviceProfile(device);
-  }
+  refreshTrackedDeviceProfile(device);
 }
 
 size_t getTrackedDeviceSnapshotCount() {
@@ -394,6 +404,40 @@ bool getTrackedDeviceSnapshotByMac(const uint8_t mac[6], TrackedDeviceSnapshot&
   return false;
 }
 
+size_t getTrackedDeviceRows(size_t offset, TrackedDeviceRow* out, size_t maxCount) {
+  if (out == nullptr || maxCount == 0) {
+    return 0;
+  }
+
+  size_t position = 0;
+  size_t written = 0;
+  for (const auto& device : trackedDevices) {
+    if (!device.active) {
+      continue;
+    }
+    if (position++ < offset) {
+      continue;
+    }
+    if (written >= maxCount) {
+      break;
+    }
+
+    auto& row = out[written++];
+    memcpy(row.mac, device.mac, sizeof(row.mac));
+    row.generation = device.generation;
+    row.verified = !device.lastKnownId.isEmpty();
+    strlcpy(row.deviceId, device.lastKnownId.c_str(), sizeof(row.deviceId));
+    strlcpy(row.kind, device.kindLabel.c_str(), sizeof(row.kind));
+    strlcpy(row.status, device.statusLine.c_str(), sizeof(row.status));
+  }
+
+  return written;
+}
+
+uint32_t getTrackedDeviceRegistryGeneration() {
+  return registryGeneration;
+}
+
 uint8_t getTrackedDeviceFocusMax() {
   const size_t count = countTrackedDevices();
   if (count == 0) {
@@ -417,6 +461,15 @@ bool isTrackedDeviceVerified(const uint8_t mac[6]) {
   return !trackedDevices[index].lastKnownId.isEmpty();
 }
 
+uint32_t getTrackedDeviceFeatureBits(const uint8_t mac[6]) {
+  if (mac == nullptr) {
+    return 0;
+  }
+
+  const int index = findTrackedDevice(mac);
+  return index < 0 ? 0 : trackedDevices[index].featureBits;
+}
+
 bool getTrackedDeviceIdentity(const uint8_t mac[6], String& identityOut) {
   identityOut = "";
   if (mac == nullptr) {
@@ -447,6 +500,7 @@ static void pruneTrackedDevices(uint32_t nowMs) {
     macToText(device.mac, macText);
     ESP_LOGI(TAG, "Device disconnected (timeout): %s", macText);
     device = TrackedDevice{};
+    registryGeneration++;
     changed = true;
   }
 
@@ -465,6 +519,7 @@ static void removeTrackedDevice(const uint8_t mac[6], const char* reason) {
   macToText(mac, macText);
   ESP_LOGI(TAG, "Device removed: %s (%s)", macText, reason == nullptr ? "unknown" : reason);
   trackedDevices[index] = TrackedDevice{};
+  registryGeneration++;
   logTrackedDevices();
 }
 
@@ -572,6 +627,7 @@ MasterNode* MasterNode::activeInstance = nullptr;
 SlaveStateHandler MasterNode::stateHandler = defaultSlaveStateHandler;
 MasterNode espnowMaster;
 static uint32_t lastInternetStatusMs = 0;
+static bool firstPacketAccepted = false;
 
 bool MasterNode::isBroadcastMac(const uint8_t mac[6]) {
   if (mac == nullptr) {
@@ -620,6 +676,10 @@ bool MasterNode::begin(uint8_t channel) {
   esp_now_register_send_cb(MasterNode::onSendStatic);
   esp_now_register_recv_cb(MasterNode::onReceiveStatic);
   beginProxyWorker();
+  camera_recorder::begin();
+  if (MASTER_CAPTURE_AT_BOOT) {
+    capture::setEnabled(true);
+  }
 
   esp_now_peer_info_t broadcastPeer = {};
   memcpy(broadcastPeer.peer_addr, BROADCAST_MAC, 6);
@@ -647,35 +707,102 @@ void MasterNode::loop() {
   }
 
   const uint32_t now = millis();
-  pruneTrackedDevices(now);
-  pruneBlacklist(now);
+  pruneDevices(now);
+  sendBeacons(now);
+
+  core::weather_sync::tick(*this);
+  camera_rate::tick(*this, now);
+  history::flushIfDue(now);
+
+  requestIdentities(now);
+
+  processProxyResponses(*this);
+}
+
+void MasterNode::pruneDevices(uint32_t nowMs) {
+  if (!started) {
+    return;
+  }
+
+  pruneTrackedDevices(nowMs);
+  pruneBlacklist(nowMs);
+}
+
+void MasterNode::requestIdentities(uint32_t nowMs) {
+  if (!started) {
+    return;
+  }
+
+  requestIdentityFromUnverified(*this, nowMs);
+}
+
+uint32_t MasterNode::sendBeacons(uint32_t now) {
+  if (!started) {
+    return HELLO_INTERVAL_MS;
+  }
+
+  // Heartbeat and MasterNet due before the next HELLO ride along with it
+  // when batching; every MASTER_BATCH_PLAIN_HELLO_EVERY-th HELLO stays a
+  // plain frame so slaves that have not joined yet can still find us.
+  const bool helloDue = now - lastHelloMs >= HELLO_INTERVAL_MS;
+  bool batching = false;
+#if MASTER_BATCH_FRAMES
+  if (helloDue && ++helloCount % MASTER_BATCH_PLAIN_HELLO_EVERY != 0) {
+    batching = trackedDevicesAcceptBatch();
+  }
+#endif
+  const uint32_t lookaheadMs = batching ? HELLO_INTERVAL_MS : 0;
+  const bool heartbeatDue = now - lastHeartbeatMs + lookaheadMs >= HEARTBEAT_INTERVAL_MS;
+  const bool internetStatusDue = now - lastInternetStatusMs + lookaheadMs >= INTERNET_STATUS_INTERVAL_MS;
 
-  if (now - lastHelloMs >= 2000) {
-    broadcast(PacketType::HELLO, MASTER_BEACON_ID, MASTER_BEACON_ID_LEN);
+  BatchBuilder batch;
+  auto emit = [&](PacketType type, const void* payload, size_t payloadSize) {
+    if (!batching || !batch.add(type, payload, payloadSize)) {
+      broadcast(type, payload, payloadSize);
+    }
+  };
+
+  if (helloDue) {
+    emit(PacketType::HELLO, MASTER_BEACON_ID, MASTER_BEACON_ID_LEN);
     lastHelloMs = now;
   }
 
-  if (now - lastHeartbeatMs >= 5000) {
-    broadcast(PacketType::HEARTBEAT, MASTER_BEACON_ID, MASTER_BEACON_ID_LEN);
+  if (heartbeatDue) {
+    emit(PacketType::HEARTBEAT, MASTER_BEACON_ID, MASTER_BEACON_ID_LEN);
     lastHeartbeatMs = now;
   }
 
-  if (now - lastInternetStatusMs >= INTERNET_STATUS_INTERVAL_MS) {
+  if (internetStatusDue) {
     if (hasIdentifiedTrackedDevice()) {
       app::espnow::state_binary::MasterNetState internetState = {};
       app::espnow::state_binary::initHeader(internetState.header, app::espnow::state_binary::Type::MasterNet);
       internetState.online = static_cast<uint8_t>(WiFi.status() == WL_CONNECTED ? 1 : 0);
       internetState.channel = WiFi.channel();
-      broadcast(PacketType::STATE, &internetState, sizeof(internetState));
+      emit(PacketType::STATE, &internetState, sizeof(internetState));
     }
     lastInternetStatusMs = now;
   }
 
-  core::weather_sync::tick(*this);
-
-  requestIdentityFromUnverified(*this, now);
+  if (batch.count() == 1) {
+    BatchReader single(batch.data(), batch.size());
+    PacketType type;
+    const uint8_t* data = nullptr;
+    uint8_t size = 0;
+    if (single.next(type, data, size)) {
+      broadcast(type, data, size);
+    }
+  } else if (batch.count() > 1) {
+    broadcast(PacketType::BATCH, batch.data(), batch.size());
+  }
 
-  processProxyResponses(*this);
+  const auto remaining = [now](uint32_t lastMs, uint32_t intervalMs) -> uint32_t {
+    const uint32_t elapsed = now - lastMs;
+    return elapsed >= intervalMs ? 1 : intervalMs - elapsed;
+  };
+  uint32_t nextMs = remaining(lastHelloMs, HELLO_INTERVAL_MS);
+  nextMs = min(nextMs, remaining(lastHeartbeatMs, HEARTBEAT_INTERVAL_MS));
+  nextMs = min(nextMs, remaining(lastInternetStatusMs, INTERNET_STATUS_INTERVAL_MS));
+  return nextMs;
 }
 
 bool MasterNode::addPeer(const uint8_t mac[6], uint8_t channel, bool encrypted) {
@@ -727,6 +854,7 @@ bool MasterNode::send(const uint8_t mac[6], PacketType type, const void* payload
     return false;
   }
 
+  capture::recordTx(mac, reinterpret_cast<const uint8_t*>(&frame), frameBytes);
   return true;
 }
 
@@ -756,6 +884,8 @@ void MasterNode::onReceiveStatic(const esp_now_recv_info_t* recv_info, const uin
     return;
   }
 
+  capture::recordRx(recv_info->src_addr, recv_info->rx_ctrl != nullptr ? recv_info->rx_ctrl->rssi : 0, data, len);
+
   if (len < static_cast<int>(sizeof(PacketHeader) + sizeof(uint8_t))) {
     ESP_LOGW(TAG, "Received frame too small: %d", len);
     return;
@@ -780,6 +910,11 @@ void MasterNode::onReceiveStatic(const esp_now_recv_info_t* recv_info, const uin
     activeInstance->addPeer(recv_info->src_addr);
   }
 
+  if (!firstPacketAccepted) {
+    firstPacketAccepted = true;
+    core::boot::mark(core::boot::FirstPacketAccepted);
+  }
+
   ESP_LOGD(TAG,
            "RX from %02X:%02X:%02X:%02X:%02X:%02X type=%u seq=%u len=%d",
            recv_info->src_addr[0], recv_info->src_addr[1], recv_info->src_addr[2],
@@ -787,19 +922,41 @@ void MasterNode::onReceiveStatic(const esp_now_recv_info_t* recv_info, const uin
            header->type, header->sequence, len);
 
   const PacketType type = static_cast<PacketType>(header->type);
+  if (type != PacketType::BATCH) {
+    dispatchPacket(recv_info, type, payload, payloadSize);
+    return;
+  }
+
+  BatchReader reader(payload, payloadSize);
+  PacketType entryType;
+  const uint8_t* entryPayload = nullptr;
+  uint8_t entrySize = 0;
+  while (reader.next(entryType, entryPayload, entrySize)) {
+    dispatchPacket(recv_info, entryType, entryPayload, entrySize);
+  }
+  if (reader.malformed()) {
+    ESP_LOGW(TAG, "Malformed batch frame: payload=%u", payloadSize);
+  }
+}
+
+void MasterNode::dispatchPacket(const esp_now_recv_info_t* recv_info,
+                                PacketType type,
+                                const uint8_t* payload,
+                                uint8_t payloadSize) {
   switch (type) {
     case PacketType::HELLO:
       handleMasterHelloEvent(recv_info);
       break;
     case PacketType::STATE:
       if (payloadSize > 0) {
-        handleMasterStateEvent(*activeInstance, recv_info, payload, payloadSize, stateHandler);
+        handleMasterStateEvent(recv_info, payload, payloadSize, stateHandler);
       } else {
         stateHandler(recv_info->src_addr, nullptr, 0);
       }
       break;
     case PacketType::COMMAND:
     case PacketType::HEARTBEAT:
+    case PacketType::BATCH:
     default:
       break;
   }
@@ -4,6 +4,7 @@
 #include <esp_now.h>
 
 #include "protocol.h"
+#include "state_binary.h"
 #include "master_state_handler.h"
 
 namespace app::espnow {
@@ -27,13 +28,32 @@ struct TrackedDeviceSnapshot {
   uint32_t ageMs = 0;
 };
 
+// Heap-free row for list views; generation changes whenever any displayed
+// field of the device changes.
+struct TrackedDeviceRow {
+  uint8_t mac[6] = {0};
+  uint32_t generation = 0;
+  bool verified = false;
+  char deviceId[24] = {0};
+  char kind[16] = {0};
+  char status[40] = {0};
+};
+
 class MasterNode {
  public:
   MasterNode() = default;
 
   bool begin(uint8_t channel = 1);
+  // Runs every periodic job below once; the network task schedules them
+  // separately (see app/tasks/networkTask.cpp).
   void loop();
 
+  // HELLO / HEARTBEAT / MasterNet beacons that are due; returns the ms until
+  // the next one is.
+  uint32_t sendBeacons(uint32_t nowMs);
+  void pruneDevices(uint32_t nowMs);
+  void requestIdentities(uint32_t nowMs);
+
   bool addPeer(const uint8_t mac[6], uint8_t channel = 0, bool encrypted = false);
   bool send(const uint8_t mac[6], PacketType type, const void* payload, size_t payloadSize);
   bool broadcast(PacketType type, const void* payload, size_t payloadSize);
@@ -48,6 +68,10 @@ class MasterNode {
 
   static void onSendStatic(const esp_now_send_info_t* tx_info, esp_now_send_status_t status);
   static void onReceiveStatic(const esp_now_recv_info_t* recv_info, const uint8_t* data, int len);
+  static void dispatchPacket(const esp_now_recv_info_t* recv_info,
+                             PacketType type,
+                             const uint8_t* payload,
+                             uint8_t payloadSize);
 
   static MasterNode* activeInstance;
   static SlaveStateHandler stateHandler;
@@ -56,6 +80,7 @@ class MasterNode {
   bool started = false;
   uint32_t lastHelloMs = 0;
   uint32_t lastHeartbeatMs = 0;
+  uint32_t helloCount = 0;
   size_t peersCount = 0;
 };
 
@@ -63,13 +88,16 @@ extern MasterNode espnowMaster;
 
 void updateTrackedDeviceIdentity(const uint8_t mac[6], const String& deviceId);
 void updateTrackedDeviceFeatures(const uint8_t mac[6], uint32_t featureBits);
-void updateTrackedDeviceStatePayload(const uint8_t mac[6], const String& payload);
+void updateTrackedDeviceState(const uint8_t mac[6], state_binary::Type type, const uint8_t* payload);
 bool isTrackedDeviceVerified(const uint8_t mac[6]);
+uint32_t getTrackedDeviceFeatureBits(const uint8_t mac[6]);
 bool getTrackedDeviceIdentity(const uint8_t mac[6], String& identityOut);
 size_t getTrackedDeviceSnapshotCount();
 size_t getTrackedDeviceSnapshots(TrackedDeviceSnapshot* out, size_t maxCount);
 bool getTrackedDeviceSnapshotAt(size_t index, TrackedDeviceSnapshot& out);
 bool getTrackedDeviceSnapshotByMac(const uint8_t mac[6], TrackedDeviceSnapshot& out);
+size_t getTrackedDeviceRows(size_t offset, TrackedDeviceRow* out, size_t maxCount);
+uint32_t getTrackedDeviceRegistryGeneration();
 uint8_t getTrackedDeviceFocusMax();
 void blacklistDeviceTemporarily(const uint8_t mac[6]);
 
@@ -0,0 +1,827 @@
+#include "master_history_store.h"
+
+#include "core/boot.h"
+#include "core/crc32.h"
+#include "core/fs_lock.h"
+
+#include <LittleFS.h>
+#include <app_config.h>
+#include <esp_heap_caps.h>
+#include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#include <cstddef>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+namespace app::espnow::history {
+
+namespace {
+
+static constexpr const char* TAG = "history";
+static constexpr const char* STORE_DIR = "/data";
+static constexpr const char* MINUTE_SEGMENT_PATH = "/data/history_1m.bin";
+static constexpr const char* MINUTE_SEGMENT_PREV_PATH = "/data/history_1m.1.bin";
+static constexpr const char* HOUR_SEGMENT_PATH = "/data/history_1h.bin";
+static constexpr const char* HOUR_SEGMENT_PREV_PATH = "/data/history_1h.1.bin";
+static constexpr uint8_t FILE_MAGIC[4] = {'H', 'I', 'S', 'T'};
+static constexpr uint8_t FORMAT_VERSION = 1;
+static constexpr size_t FILE_HEADER_BYTES = 8;
+static constexpr uint32_t MIN_VALID_EPOCH = 1700000000UL;
+
+static constexpr size_t MAX_SERIES = MASTER_HISTORY_MAX_SERIES;
+static constexpr size_t BLOCKS_PER_SERIES = MASTER_HISTORY_BLOCKS_PER_SERIES;
+static constexpr size_t BLOCK_BYTES = 192;
+static constexpr size_t BLOCK_BITS = BLOCK_BYTES * 8;
+// Worst case per sample: 4-bit tag + 32-bit delta-of-delta, then a 2-bit
+// tag, 5-bit leading-zero count, 5-bit length and 32 meaningful bits.
+static constexpr size_t MAX_SAMPLE_BITS = 36 + 44;
+static constexpr size_t MINUTE_POINTS = 120;
+static constexpr size_t HOUR_POINTS = 48;
+static constexpr uint32_t MINUTE_SECONDS = 60;
+static constexpr uint32_t HOUR_SECONDS = 3600;
+static constexpr uint8_t NO_WINDOW = 0xFF;
+
+// Gorilla-style block: the first sample is stored raw, later timestamps as
+// delta-of-delta and values as XOR against the previous value.
+struct Block {
+  uint32_t startTs;
+  uint32_t endTs;
+  uint16_t count;
+  uint16_t bitLength;
+  uint8_t data[BLOCK_BYTES];
+};
+
+struct Bucket {
+  uint32_t startTs;
+  float min;
+  float max;
+  float sum;
+  uint16_t count;
+  bool flushed;  // already written to a rollup segment
+};
+
+template <size_t N>
+struct Rollup {
+  Bucket points[N];  // sealed buckets, sorted by startTs
+  uint16_t size;
+  Bucket open;
+};
+
+struct Series {
+  bool used;
+  uint8_t mac[6];
+  Metric metric;
+  uint32_t lastTs;
+  uint32_t prevTs;
+  int32_t prevDelta;
+  uint32_t prevBits;
+  uint8_t prevLeading;
+  uint8_t prevTrailing;
+  uint8_t headBlock;
+  uint8_t blockCount;
+  Block blocks[BLOCKS_PER_SERIES];
+  Rollup<MINUTE_POINTS> minute;
+  Rollup<HOUR_POINTS> hour;
+};
+
+struct __attribute__((packed)) PersistedRollup {
+  uint8_t mac[6];
+  uint8_t metric;
+  uint8_t resolution;
+  uint32_t startTs;
+  float min;
+  float max;
+  float sum;
+  uint16_t count;
+  uint16_t reserved;
+  uint32_t crc;
+};
+
+static_assert(sizeof(PersistedRollup) == 32, "PersistedRollup layout changed");
+
+Series* seriesTable = nullptr;
+bool allocationFailed = false;
+bool restored = false;
+bool flushing = false;
+uint32_t lastFlushMs = 0;
+SemaphoreHandle_t historyMutex = nullptr;
+portMUX_TYPE historyMutexInitLock = portMUX_INITIALIZER_UNLOCKED;
+
+SemaphoreHandle_t getHistoryMutex() {
+  if (historyMutex != nullptr) {
+    return historyMutex;
+  }
+
+  SemaphoreHandle_t created = xSemaphoreCreateMutex();
+  portENTER_CRITICAL(&historyMutexInitLock);
+  if (historyMutex == nullptr) {
+    historyMutex = created;
+    created = nullptr;
+  }
+  portEXIT_CRITICAL(&historyMutexInitLock);
+
+  if (created != nullptr) {
+    vSemaphoreDelete(created);
+  }
+  return historyMutex;
+}
+
+class HistoryLock {
+ public:
+  HistoryLock() : handle(getHistoryMutex()) {
+    if (handle != nullptr) {
+      xSemaphoreTake(handle, portMAX_DELAY);
+    }
+  }
+  ~HistoryLock() {
+    if (handle != nullptr) {
+      xSemaphoreGive(handle);
+    }
+  }
+
+ private:
+  SemaphoreHandle_t handle;
+};
+
+// Caller must hold the history lock.
+bool ensureSeriesTable() {
+  if (seriesTable != nullptr) {
+    return true;
+  }
+  if (allocationFailed) {
+    return false;
+  }
+
+  const size_t bytes = MAX_SERIES * sizeof(Series);
+  seriesTable = static_cast<Series*>(heap_caps_calloc(MAX_SERIES, sizeof(Series), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+  if (seriesTable == nullptr) {
+    seriesTable = static_cast<Series*>(calloc(MAX_SERIES, sizeof(Series)));
+  }
+  if (seriesTable == nullptr) {
+    allocationFailed = true;
+    ESP_LOGE(TAG, "Failed to allocate %u bytes for history series", static_cast<unsigned>(bytes));
+    return false;
+  }
+
+  ESP_LOGI(TAG, "History store: %u series x %u bytes", static_cast<unsigned>(MAX_SERIES), static_cast<unsigned>(sizeof(Series)));
+  return true;
+}
+
+Series* findSeries(const uint8_t mac[6], Metric metric, bool create) {
+  if (!ensureSeriesTable()) {
+    return nullptr;
+  }
+
+  Series* freeSlot = nullptr;
+  Series* oldest = nullptr;
+  for (size_t i = 0; i < MAX_SERIES; ++i) {
+    Series& series = seriesTable[i];
+    if (!series.used) {
+      if (freeSlot == nullptr) {
+        freeSlot = &series;
+      }
+      continue;
+    }
+    if (series.metric == metric && memcmp(series.mac, mac, sizeof(series.mac)) == 0) {
+      return &series;
+    }
+    if (oldest == nullptr || series.lastTs < oldest->lastTs) {
+      oldest = &series;
+    }
+  }
+
+  if (!create) {
+    return nullptr;
+  }
+
+  Series* slot = freeSlot != nullptr ? freeSlot : oldest;
+  if (slot == nullptr) {
+    return nullptr;
+  }
+  if (slot == oldest) {
+    ESP_LOGW(TAG, "Series table full, evicting metric %u", static_cast<unsigned>(slot->metric));
+  }
+
+  memset(slot, 0, sizeof(Series));
+  slot->used = true;
+  memcpy(slot->mac, mac, sizeof(slot->mac));
+  slot->metric = metric;
+  slot->prevLeading = NO_WINDOW;
+  return slot;
+}
+
+void writeBits(Block& block, uint32_t value, uint8_t bits) {
+  for (int i = bits - 1; i >= 0; --i) {
+    const uint16_t pos = block.bitLength++;
+    if ((value >> i) & 1U) {
+      block.data[pos >> 3] |= static_cast<uint8_t>(0x80U >> (pos & 7));
+    }
+  }
+}
+
+class BitReader {
+ public:
+  explicit BitReader(const Block& block) : block(block) {}
+
+  uint32_t read(uint8_t bits) {
+    uint32_t value = 0;
+    for (uint8_t i = 0; i < bits; ++i) {
+      const uint8_t bit = (block.data[pos >> 3] >> (7 - (pos & 7))) & 1U;
+      value = (value << 1) | bit;
+      ++pos;
+    }
+    return value;
+  }
+
+ private:
+  const Block& block;
+  uint16_t pos = 0;
+};
+
+void encodeDeltaOfDelta(Block& block, int32_t dod) {
+  if (dod == 0) {
+    writeBits(block, 0b0, 1);
+  } else if (dod >= -63 && dod <= 64) {
+    writeBits(block, 0b10, 2);
+    writeBits(block, static_cast<uint32_t>(dod + 63), 7);
+  } else if (dod >= -255 && dod <= 256) {
+    writeBits(block, 0b110, 3);
+    writeBits(block, static_cast<uint32_t>(dod + 255), 9);
+  } else if (dod >= -2047 && dod <= 2048) {
+    writeBits(block, 0b1110, 4);
+    writeBits(block, static_cast<uint32_t>(dod + 2047), 12);
+  } else {
+    writeBits(block, 0b1111, 4);
+    writeBits(block, static_cast<uint32_t>(dod), 32);
+  }
+}
+
+int32_t decodeDeltaOfDelta(BitReader& reader) {
+  if (reader.read(1) == 0) {
+    return 0;
+  }
+  if (reader.read(1) == 0) {
+    return static_cast<int32_t>(reader.read(7)) - 63;
+  }
+  if (reader.read(1) == 0) {
+    return static_cast<int32_t>(reader.read(9)) - 255;
+  }
+  if (reader.read(1) == 0) {
+    return static_cast<int32_t>(reader.read(12)) - 2047;
+  }
+  return static_cast<int32_t>(reader.read(32));
+}
+
+void encodeValue(Series& series, Block& block, uint32_t bits) {
+  const uint32_t xorValue = bits ^ series.prevBits;
+  if (xorValue == 0) {
+    writeBits(block, 0b0, 1);
+    return;
+  }
+
+  const uint8_t leading = static_cast<uint8_t>(__builtin_clz(xorValue));
+  const uint8_t trailing = static_cast<uint8_t>(__builtin_ctz(xorValue));
+  if (series.prevLeading != NO_WINDOW && leading >= series.prevLeading && trailing >= series.prevTrailing) {
+    writeBits(block, 0b10, 2);
+    writeBits(block, xorValue >> series.prevTrailing, 32 - series.prevLeading - series.prevTrailing);
+    return;
+  }
+
+  const uint8_t length = 32 - leading - trailing;
+  writeBits(block, 0b11, 2);
+  writeBits(block, leading, 5);
+  writeBits(block, length - 1, 5);
+  writeBits(block, xorValue >> trailing, length);
+  series.prevLeading = leading;
+  series.prevTrailing = trailing;
+}
+
+// Calls fn(ts, value) for each sample in order; stops early if fn returns false.
+template <typename Fn>
+void decodeBlock(const Block& block, Fn&& fn) {
+  if (block.count == 0) {
+    return;
+  }
+
+  BitReader reader(block);
+  uint32_t ts = reader.read(32);
+  uint32_t bits = reader.read(32);
+  int32_t delta = 0;
+  uint8_t leading = NO_WINDOW;
+  uint8_t trailing = 0;
+
+  float value = 0.0f;
+  memcpy(&value, &bits, sizeof(value));
+  if (!fn(ts, value)) {
+    return;
+  }
+
+  for (uint16_t i = 1; i < block.count; ++i) {
+    delta += decodeDeltaOfDelta(reader);
+    ts += static_cast<uint32_t>(delta);
+
+    if (reader.read(1) != 0) {
+      if (reader.read(1) != 0) {
+        leading = static_cast<uint8_t>(reader.read(5));
+        const uint8_t length = static_cast<uint8_t>(reader.read(5) + 1);
+        trailing = static_cast<uint8_t>(32 - leading - length);
+      }
+      bits ^= reader.read(32 - leading - trailing) << trailing;
+    }
+
+    memcpy(&value, &bits, sizeof(value));
+    if (!fn(ts, value)) {
+      return;
+    }
+  }
+}
+
+Block& startBlock(Series& series) {
+  series.headBlock = series.blockCount == 0 ? 0 : static_cast<uint8_t>((series.headBlock + 1) % BLOCKS_PER_SERIES);
+  if (series.blockCount < BLOCKS_PER_SERIES) {
+    series.blockCount++;
+  }
+
+  Block& block = series.blocks[series.headBlock];
+  memset(&block, 0, sizeof(block));
+  return block;
+}
+
+void appendSample(Series& series, uint32_t ts, float value) {
+  uint32_t bits = 0;
+  memcpy(&bits, &value, sizeof(bits));
+
+  Block* block = series.blockCount == 0 ? nullptr : &series.blocks[series.headBlock];
+  if (block == nullptr || block->bitLength + MAX_SAMPLE_BITS > BLOCK_BITS) {
+    block = &startBlock(series);
+  }
+
+  if (block->count == 0) {
+    writeBits(*block, ts, 32);
+    writeBits(*block, bits, 32);
+    block->startTs = ts;
+    series.prevDelta = 0;
+    series.prevLeading = NO_WINDOW;
+    series.prevTrailing = 0;
+  } else {
+    const int32_t delta = static_cast<int32_t>(ts - series.prevTs);
+    encodeDeltaOfDelta(*block, delta - series.prevDelta);
+    encodeValue(series, *block, bits);
+    series.prevDelta = delta;
+  }
+
+  series.prevTs = ts;
+  series.prevBits = bits;
+  block->endTs = ts;
+  block->count++;
+}
+
+template <size_t N>
+bool insertPoint(Rollup<N>& rollup, const Bucket& bucket) {
+  size_t pos = rollup.size;
+  while (pos > 0 && rollup.points[pos - 1].startTs > bucket.startTs) {
+    --pos;
+  }
+  if (pos > 0 && rollup.points[pos - 1].startTs == bucket.startTs) {
+    return false;
+  }
+
+  if (rollup.size == N) {
+    if (pos == 0) {
+      return false;
+    }
+    memmove(&rollup.points[0], &rollup.points[1], (pos - 1) * sizeof(Bucket));
+    rollup.points[pos - 1] = bucket;
+    return true;
+  }
+
+  memmove(&rollup.points[pos + 1], &rollup.points[pos], (rollup.size - pos) * sizeof(Bucket));
+  rollup.points[pos] = bucket;
+  rollup.size++;
+  return true;
+}
+
+template <size_t N>
+void addToRollup(Rollup<N>& rollup, uint32_t bucketSeconds, uint32_t ts, float value) {
+  const uint32_t startTs = ts - (ts % bucketSeconds);
+  if (rollup.open.count > 0 && rollup.open.startTs != startTs) {
+    insertPoint(rollup, rollup.open);
+    rollup.open = Bucket{};
+  }
+
+  if (rollup.open.count == 0) {
+    rollup.open = Bucket{startTs, value, value, 0.0f, 0, false};
+  }
+  if (value < rollup.open.min) {
+    rollup.open.min = value;
+  }
+  if (value > rollup.open.max) {
+    rollup.open.max = value;
+  }
+  rollup.open.sum += value;
+  rollup.open.count++;
+}
+
+RollupPoint toPoint(const Bucket& bucket) {
+  RollupPoint point;
+  point.startTs = bucket.startTs;
+  point.min = bucket.min;
+  point.max = bucket.max;
+  point.avg = bucket.count > 0 ? bucket.sum / bucket.count : 0.0f;
+  point.count = bucket.count;
+  return point;
+}
+
+template <size_t N>
+size_t collectRollup(const Rollup<N>& rollup,
+                     uint32_t bucketSeconds,
+                     uint32_t fromTs,
+                     uint32_t toTs,
+                     RollupPoint* out,
+                     size_t maxCount) {
+  size_t count = 0;
+  auto emit = [&](const Bucket& bucket) {
+    if (count < maxCount && bucket.startTs + bucketSeconds > fromTs && bucket.startTs <= toTs) {
+      out[count++] = toPoint(bucket);
+    }
+  };
+
+  for (size_t i = 0; i < rollup.size; ++i) {
+    emit(rollup.points[i]);
+  }
+  if (rollup.open.count > 0) {
+    emit(rollup.open);
+  }
+  return count;
+}
+
+// Restored and older late buckets can land anywhere in the rollup, so every
+// sealed bucket carries its own flushed flag instead of a tail count.
+template <size_t N>
+void collectUnflushed(const Rollup<N>& rollup, const Series& series, Resolution resolution, std::vector<PersistedRollup>& out) {
+  for (size_t i = 0; i < rollup.size; ++i) {
+    const Bucket& bucket = rollup.points[i];
+    if (bucket.flushed) {
+      continue;
+    }
+    PersistedRollup record = {};
+    memcpy(record.mac, series.mac, sizeof(record.mac));
+    record.metric = static_cast<uint8_t>(series.metric);
+    record.resolution = static_cast<uint8_t>(resolution);
+    record.startTs = bucket.startTs;
+    record.min = bucket.min;
+    record.max = bucket.max;
+    record.sum = bucket.sum;
+    record.count = bucket.count;
+    record.crc = core::crc32(&record, offsetof(PersistedRollup, crc));
+    out.push_back(record);
+  }
+}
+
+template <size_t N>
+void markFlushed(Rollup<N>& rollup, uint32_t startTs) {
+  for (size_t i = 0; i < rollup.size; ++i) {
+    if (rollup.points[i].startTs == startTs) {
+      rollup.points[i].flushed = true;
+      return;
+    }
+  }
+}
+
+// Caller must hold the history lock. Buckets that were evicted or replaced
+// since the records were collected are simply not found.
+void markRecordsFlushed(const std::vector<PersistedRollup>& records) {
+  for (const auto& record : records) {
+    Series* series = findSeries(record.mac, static_cast<Metric>(record.metric), false);
+    if (series == nullptr) {
+      continue;
+    }
+    if (record.resolution == static_cast<uint8_t>(Resolution::Hour)) {
+      markFlushed(series->hour, record.startTs);
+    } else {
+      markFlushed(series->minute, record.startTs);
+    }
+  }
+}
+
+uint8_t* readWholeFile(const char* path, size_t& sizeOut) {
+  sizeOut = 0;
+  if (!LittleFS.exists(path)) {
+    return nullptr;
+  }
+
+  File file = LittleFS.open(path, FILE_READ);
+  if (!file) {
+    return nullptr;
+  }
+
+  const size_t size = file.size();
+  auto* buffer = static_cast<uint8_t*>(heap_caps_malloc(size == 0 ? 1 : size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+  if (buffer == nullptr) {
+    buffer = static_cast<uint8_t*>(malloc(size == 0 ? 1 : size));
+  }
+  if (buffer == nullptr) {
+    file.close();
+    return nullptr;
+  }
+
+  sizeOut = file.read(buffer, size);
+  file.close();
+  return buffer;
+}
+
+// Reads the file under the fs lock only, then merges it under the history
+// lock so record() on the RX path never waits on flash.
+size_t restoreSegment(const char* path) {
+  size_t size = 0;
+  uint8_t* buffer = nullptr;
+  {
+    core::fs::Lock fsLock;
+    buffer = readWholeFile(path, size);
+  }
+  if (buffer == nullptr) {
+    return 0;
+  }
+
+  HistoryLock lock;
+  size_t restoredCount = 0;
+  if (size >= FILE_HEADER_BYTES && memcmp(buffer, FILE_MAGIC, sizeof(FILE_MAGIC)) == 0 && buffer[4] == FORMAT_VERSION) {
+    for (size_t offset = FILE_HEADER_BYTES; offset + sizeof(PersistedRollup) <= size; offset += sizeof(PersistedRollup)) {
+      PersistedRollup record;
+      memcpy(&record, buffer + offset, sizeof(record));
+      if (core::crc32(&record, offsetof(PersistedRollup, crc)) != record.crc) {
+        ESP_LOGW(TAG, "%s: bad record at %u, ignoring tail", path, static_cast<unsigned>(offset));
+        break;
+      }
+
+      Series* series = findSeries(record.mac, static_cast<Metric>(record.metric), true);
+      if (series == nullptr) {
+        break;
+      }
+
+      const Bucket bucket{record.startTs, record.min, record.max, record.sum, record.count, true};
+      const bool inserted = record.resolution == static_cast<uint8_t>(Resolution::Hour)
+                                ? insertPoint(series->hour, bucket)
+                                : insertPoint(series->minute, bucket);
+      if (inserted) {
+        restoredCount++;
+        if (record.startTs > series->lastTs) {
+          series->lastTs = record.startTs;
+        }
+      }
+    }
+  }
+
+  free(buffer);
+  return restoredCount;
+}
+
+bool appendSegment(const char* path, const char* prevPath, const std::vector<PersistedRollup>& records) {
+  if (records.empty()) {
+    return true;
+  }
+
+  core::fs::Lock fsLock;
+  const size_t recordBytes = records.size() * sizeof(PersistedRollup);
+  if (LittleFS.exists(path)) {
+    File current = LittleFS.open(path, FILE_READ);
+    const size_t currentSize = current ? current.size() : 0;
+    if (current) {
+      current.close();
+    }
+    if (currentSize + recordBytes > MASTER_HISTORY_SEGMENT_BYTES) {
+      LittleFS.remove(prevPath);
+      LittleFS.rename(path, prevPath);
+    }
+  }
+
+  const bool fresh = !LittleFS.exists(path);
+  File file = LittleFS.open(path, FILE_APPEND);
+  if (!file) {
+    ESP_LOGW(TAG, "Failed to open %s", path);
+    return false;
+  }
+
+  if (fresh) {
+    const uint8_t header[FILE_HEADER_BYTES] = {FILE_MAGIC[0], FILE_MAGIC[1], FILE_MAGIC[2], FILE_MAGIC[3], FORMAT_VERSION, 0, 0, 0};
+    file.write(header, sizeof(header));
+  }
+
+  const size_t written = file.write(reinterpret_cast<const uint8_t*>(records.data()), recordBytes);
+  file.close();
+  return written == recordBytes;
+}
+
+}  // namespace
+
+bool nowEpochSeconds(uint32_t& out) {
+  const time_t now = time(nullptr);
+  if (now < static_cast<time_t>(MIN_VALID_EPOCH)) {
+    return false;
+  }
+  out = static_cast<uint32_t>(now);
+  return true;
+}
+
+bool record(const uint8_t mac[6], Metric metric, float value) {
+  uint32_t nowSec = 0;
+  if (!nowEpochSeconds(nowSec)) {
+    return false;
+  }
+  return recordAt(mac, metric, nowSec, value);
+}
+
+bool recordAt(const uint8_t mac[6], Metric metric, uint32_t epochSec, float value) {
+  if (mac == nullptr || epochSec < MIN_VALID_EPOCH) {
+    return false;
+  }
+
+  HistoryLock lock;
+  Series* series = findSeries(mac, metric, true);
+  if (series == nullptr) {
+    return false;
+  }
+  if (series->blockCount > 0 && epochSec < series->prevTs) {
+    return false;
+  }
+
+  appendSample(*series, epochSec, value);
+  addToRollup(series->minute, MINUTE_SECONDS, epochSec, value);
+  addToRollup(series->hour, HOUR_SECONDS, epochSec, value);
+  series->lastTs = epochSec;
+  return true;
+}
+
+size_t querySamples(const uint8_t mac[6], Metric metric, uint32_t fromTs, uint32_t toTs, Sample* out, size_t maxCount) {
+  if (mac == nullptr || out == nullptr || maxCount == 0 || fromTs > toTs) {
+    return 0;
+  }
+
+  HistoryLock lock;
+  const Series* series = findSeries(mac, metric, false);
+  if (series == nullptr) {
+    return 0;
+  }
+
+  size_t count = 0;
+  const size_t oldest = (series->headBlock + BLOCKS_PER_SERIES - (series->blockCount - 1)) % BLOCKS_PER_SERIES;
+  for (size_t i = 0; i < series->blockCount && count < maxCount; ++i) {
+    const Block& block = series->blocks[(oldest + i) % BLOCKS_PER_SERIES];
+    if (block.count == 0 || block.endTs < fromTs || block.startTs > toTs) {
+      continue;
+    }
+
+    decodeBlock(block, [&](uint32_t ts, float value) {
+      if (ts > toTs) {
+        return false;
+      }
+      if (ts >= fromTs) {
+        out[count].ts = ts;
+        out[count].value = value;
+        ++count;
+      }
+      return count < maxCount;
+    });
+  }
+  return count;
+}
+
+size_t queryRollups(const uint8_t mac[6],
+                    Metric metric,
+                    Resolution resolution,
+                    uint32_t fromTs,
+                    uint32_t toTs,
+                    RollupPoint* out,
+                    size_t maxCount) {
+  if (mac == nullptr || out == nullptr || maxCount == 0 || fromTs > toTs) {
+    return 0;
+  }
+
+  HistoryLock lock;
+  const Series* series = findSeries(mac, metric, false);
+  if (series == nullptr) {
+    return 0;
+  }
+
+  if (resolution == Resolution::Hour) {
+    return collectRollup(series->hour, HOUR_SECONDS, fromTs, toTs, out, maxCount);
+  }
+  return collectRollup(series->minute, MINUTE_SECONDS, fromTs, toTs, out, maxCount);
+}
+
+bool findLatestSeries(Metric metric, uint8_t macOut[6]) {
+  if (macOut == nullptr) {
+    return false;
+  }
+
+  HistoryLock lock;
+  if (seriesTable == nullptr) {
+    return false;
+  }
+
+  const Series* latest = nullptr;
+  for (size_t i = 0; i < MAX_SERIES; ++i) {
+    const Series& series = seriesTable[i];
+    if (series.used && series.metric == metric && (latest == nullptr || series.lastTs > latest->lastTs)) {
+      latest = &series;
+    }
+  }
+
+  if (latest == nullptr) {
+    return false;
+  }
+  memcpy(macOut, latest->mac, sizeof(latest->mac));
+  return true;
+}
+
+void flushIfDue(uint32_t nowMs) {
+  if (!core::boot::isFsReady()) {
+    return;
+  }
+
+  std::vector<PersistedRollup> minuteRecords;
+  std::vector<PersistedRollup> hourRecords;
+  bool restoring = false;
+  {
+    HistoryLock lock;
+    if (flushing) {
+      return;
+    }
+    if (!restored) {
+      if (!ensureSeriesTable()) {
+        return;
+      }
+      restored = true;
+      restoring = true;
+      flushing = true;
+      lastFlushMs = nowMs;
+    } else {
+      if ((nowMs - lastFlushMs) < MASTER_HISTORY_FLUSH_MS || seriesTable == nullptr) {
+        return;
+      }
+      lastFlushMs = nowMs;
+      flushing = true;
+
+      for (size_t i = 0; i < MAX_SERIES; ++i) {
+        const Series& series = seriesTable[i];
+        if (!series.used) {
+          continue;
+        }
+        collectUnflushed(series.minute, series, Resolution::Minute, minuteRecords);
+        collectUnflushed(series.hour, series, Resolution::Hour, hourRecords);
+      }
+    }
+  }
+
+  if (restoring) {
+    {
+      core::fs::Lock fsLock;
+      if (!LittleFS.exists(STORE_DIR)) {
+        LittleFS.mkdir(STORE_DIR);
+      }
+    }
+
+    const uint32_t startMs = millis();
+    size_t count = restoreSegment(HOUR_SEGMENT_PREV_PATH);
+    count += restoreSegment(HOUR_SEGMENT_PATH);
+    count += restoreSegment(MINUTE_SEGMENT_PREV_PATH);
+    count += restoreSegment(MINUTE_SEGMENT_PATH);
+    ESP_LOGI(TAG, "Restored %u rollups in %lu ms", static_cast<unsigned>(count), static_cast<unsigned long>(millis() - startMs));
+
+    HistoryLock lock;
+    flushing = false;
+    return;
+  }
+
+  // Buckets stay unflushed until their append succeeds, so a failed write is
+  // retried on the next flush.
+  const bool minuteOk = appendSegment(MINUTE_SEGMENT_PATH, MINUTE_SEGMENT_PREV_PATH, minuteRecords);
+  const bool hourOk = appendSegment(HOUR_SEGMENT_PATH, HOUR_SEGMENT_PREV_PATH, hourRecords);
+  {
+    HistoryLock lock;
+    if (minuteOk) {
+      markRecordsFlushed(minuteRecords);
+    }
+    if (hourOk) {
+      markRecordsFlushed(hourRecords);
+    }
+    flushing = false;
+  }
+
+  if (!minuteOk || !hourOk) {
+    ESP_LOGW(TAG, "Rollup flush incomplete (minute=%u hour=%u)", minuteOk, hourOk);
+    return;
+  }
+
+  if (!minuteRecords.empty() || !hourRecords.empty()) {
+    ESP_LOGD(TAG,
+             "Flushed %u minute / %u hour rollups",
+             static_cast<unsigned>(minuteRecords.size()),
+             static_cast<unsigned>(hourRecords.size()));
+  }
+}
+
+}  // namespace app::espnow::history
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <Arduino.h>
+
+namespace app::espnow::history {
+
+enum class Metric : uint8_t {
+  SensorTemperature = 1,
+  SensorHumidity = 2,
+  WeatherTemperature = 3,
+  WindSpeed = 4,
+};
+
+enum class Resolution : uint8_t {
+  Minute = 1,
+  Hour = 2,
+};
+
+struct Sample {
+  uint32_t ts = 0;
+  float value = 0.0f;
+};
+
+struct RollupPoint {
+  uint32_t startTs = 0;
+  float min = 0.0f;
+  float max = 0.0f;
+  float avg = 0.0f;
+  uint16_t count = 0;
+};
+
+// Timestamps are wall-clock epoch seconds; samples are dropped until the
+// clock has been set. Out-of-order samples for a series are ignored.
+bool record(const uint8_t mac[6], Metric metric, float value);
+bool recordAt(const uint8_t mac[6], Metric metric, uint32_t epochSec, float value);
+
+// Both queries return points oldest first and stop at maxCount. Raw samples
+// are decoded only from blocks that overlap [fromTs, toTs].
+size_t querySamples(const uint8_t mac[6], Metric metric, uint32_t fromTs, uint32_t toTs, Sample* out, size_t maxCount);
+size_t queryRollups(const uint8_t mac[6],
+                    Metric metric,
+                    Resolution resolution,
+                    uint32_t fromTs,
+                    uint32_t toTs,
+                    RollupPoint* out,
+                    size_t maxCount);
+
+// Series of `metric` that received the newest sample, from any device.
+bool findLatestSeries(Metric metric, uint8_t macOut[6]);
+bool nowEpochSeconds(uint32_t& out);
+
+// Restores persisted rollups once LittleFS is up, then appends sealed
+// rollups to the segment file every MASTER_HISTORY_FLUSH_MS.
+void flushIfDue(uint32_t nowMs);
+
+}  // namespace app::espnow::history
@@ -2,7 +2,9 @@
 
 #include "master.h"
 #include "payload_codec.h"
+#include "proxy_chunker.h"
 #include "state_binary.h"
+#include "core/task_topology.h"
 
 #include <HTTPClient.h>
 #include <WiFi.h>
@@ -23,9 +25,6 @@ static constexpr uint32_t CACHE_TTL_MS = 3600000;
 static constexpr uint8_t MAX_PROXY_QUEUE = 8;
 static constexpr uint32_t WIFI_WAIT_TIMEOUT_MS = 30000;
 static constexpr uint32_t WIFI_WAIT_STEP_MS = 500;
-static constexpr uint16_t PROXY_STACK_SIZE = 8192;
-static constexpr UBaseType_t PROXY_TASK_PRIORITY = 2;
-static constexpr BaseType_t PROXY_TASK_CORE = 0;
 static constexpr size_t MAX_PROXY_RESPONSE_TEXT = 1024;
 
 static uint16_t nextProxyRequestId = 1;
@@ -48,14 +47,14 @@ QueueHandle_t requestQueue = nullptr;
 QueueHandle_t responseQueue = nullptr;
 TaskHandle_t proxyTaskHandle = nullptr;
 volatile bool proxyBusy = false;
+void (*responseReadyHook)() = nullptr;
 
 void setProxyBusy(bool busy) {
   proxyBusy = busy;
 }
 
-bool isProxyRequest(const String& request) {
-  String stateName;
-  return app::espnow::codec::getField(request, "state", stateName) && stateName == "proxy_req";
+bool isProxyRequest(const char* request) {
+  return app::espnow::codec::PayloadView(request).is("state", "proxy_req");
 }
 
 String trimResponseBody(String body) {
@@ -136,6 +135,8 @@ void proxyWorkerTask(void*) {
     if (xQueueSend(responseQueue, &responseItem, 0) != pdTRUE) {
       ESP_LOGW(TAG, "Response queue full, dropping proxy response");
       setProxyBusy(false);
+    } else if (responseReadyHook != nullptr) {
+      responseReadyHook();
     }
   }
 }
@@ -154,14 +155,7 @@ bool beginProxyWorker() {
     return false;
   }
 
-  BaseType_t created = xTaskCreatePinnedToCore(
-      proxyWorkerTask,
-      "proxy_worker",
-      PROXY_STACK_SIZE,
-      nullptr,
-      PROXY_TASK_PRIORITY,
-      &proxyTaskHandle,
-      PROXY_TASK_CORE);
+  BaseType_t created = core::topology::createTask(core::topology::Task::Proxy, proxyWorkerTask, nullptr, &proxyTaskHandle);
 
   if (created != pdPASS) {
     ESP_LOGE(TAG, "Failed to create proxy worker task");
@@ -178,15 +172,15 @@ bool tryHandleProxyRequest(const char* requestText, String& responseOut) {
     return false;
   }
 
+  if (!isProxyRequest(requestText)) {
+    return false;
+  }
+
   const String request = String(requestText);
   String method;
   String url;
   String payload;
 
-  if (!isProxyRequest(request)) {
-    return false;
-  }
-
   if (!app::espnow::codec::getField(request, "method", method) ||
       !app::espnow::codec::getField(request, "url", url)) {
     return false;
@@ -265,8 +259,7 @@ bool enqueueProxyRequest(const uint8_t mac[6], const char* requestText) {
     return false;
   }
 
-  const String request = String(requestText);
-  if (!isProxyRequest(request)) {
+  if (!isProxyRequest(requestText)) {
     return false;
   }
 
@@ -277,7 +270,7 @@ bool enqueueProxyRequest(const uint8_t mac[6], const char* requestText) {
 
   ProxyRequestItem item;
   memcpy(item.mac, mac, 6);
-  strncpy(item.request, request.c_str(), MAX_PAYLOAD_SIZE);
+  strncpy(item.request, requestText, MAX_PAYLOAD_SIZE);
   item.request[MAX_PAYLOAD_SIZE] = '\0';
 
   if (xQueueSend(requestQueue, &item, 0) != pdTRUE) {
@@ -305,10 +298,7 @@ void processProxyResponses(MasterNode& master) {
     String responseBody;
     parseResponsePayload(response, ok, code, responseBody);
 
-    const size_t chunkSize = app::espnow::state_binary::kProxyChunkDataBytes;
-    const size_t totalChunks = responseBody.isEmpty()
-                                   ? 1
-                                   : (responseBody.length() + chunkSize - 1) / chunkSize;
+    const size_t totalChunks = proxy_chunks::count(responseBody.length());
     const uint16_t requestId = nextProxyRequestId++;
 
     ESP_LOGI(TAG,
@@ -317,22 +307,8 @@ void processProxyResponses(MasterNode& master) {
              static_cast<unsigned>(totalChunks));
 
     for (size_t index = 0; index < totalChunks; ++index) {
-      app::espnow::state_binary::ProxyRespChunkCommand command = {};
-      app::espnow::state_binary::initHeader(command.header, app::espnow::state_binary::Type::ProxyRespChunk);
-      command.requestId = requestId;
-      command.idx = static_cast<uint16_t>(index + 1);
-      command.total = static_cast<uint16_t>(totalChunks);
-      command.ok = ok;
-      command.code = code;
-
-      if (!responseBody.isEmpty()) {
-        const size_t offset = index * chunkSize;
-        const String chunkData = responseBody.substring(offset, offset + chunkSize);
-        command.dataLen = static_cast<uint8_t>(chunkData.length());
-        memcpy(command.data, chunkData.c_str(), command.dataLen);
-      } else {
-        command.dataLen = 0;
-      }
+      app::espnow::state_binary::ProxyRespChunkCommand command;
+      proxy_chunks::fill(command, requestId, index, totalChunks, ok, code, responseBody.c_str(), responseBody.length());
 
       master.send(item.mac,
                   PacketType::COMMAND,
@@ -345,6 +321,10 @@ void processProxyResponses(MasterNode& master) {
   }
 }
 
+void setProxyResponseHook(void (*hook)()) {
+  responseReadyHook = hook;
+}
+
 bool isProxyBusy() {
   return proxyBusy;
 }
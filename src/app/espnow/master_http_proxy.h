@@ -10,6 +10,9 @@ bool beginProxyWorker();
 bool tryHandleProxyRequest(const char* requestText, String& responseOut);
 bool enqueueProxyRequest(const uint8_t mac[6], const char* requestText);
 void processProxyResponses(MasterNode& master);
+// Called on the proxy worker after a response is queued for
+// processProxyResponses().
+void setProxyResponseHook(void (*hook)());
 bool isProxyBusy();
 
 }  // namespace app::espnow
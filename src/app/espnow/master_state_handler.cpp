@@ -1,190 +1,187 @@
 #include "master_state_handler.h"
 #include "master.h"
 #include "app/display/display_interface.h"
+#include "master_history_store.h"
 #include "master_http_proxy.h"
 #include "master_state_kv_store.h"
 #include "payload_codec.h"
 #include "state_binary.h"
+#include "state_schema.h"
 #include "camera_stream_buffer.h"
 
 #include <esp_log.h>
+#include <array>
 #include <cstring>
-#include <cstdlib>
 
 namespace app::espnow {
 
 static constexpr const char* TAG = "espnow_state";
 
-static String buildTextPayloadFromBinary(const uint8_t* payload, uint8_t payloadSize) {
-  if (payload == nullptr || payloadSize == 0) {
-    return "";
-  }
+namespace {
 
-  using namespace app::espnow::state_binary;
+// payloadSize is the size on the wire; payload is always a full struct.
+using IngestHandler = void (*)(const uint8_t mac[6], const uint8_t* payload, uint8_t payloadSize);
 
-  if (hasTypeAndSize(payload, payloadSize, Type::Identity, sizeof(IdentityState))) {
-    const auto* state = reinterpret_cast<const IdentityState*>(payload);
-    return app::espnow::codec::buildPayload({
-        {"state", "identity"},
-        {"id", String(state->id)},
-    });
+void ingestIdentity(const uint8_t mac[6], const uint8_t* payload, uint8_t) {
+  const auto* identity = reinterpret_cast<const state_binary::IdentityState*>(payload);
+  const size_t idLength = strnlen(identity->id, sizeof(identity->id));
+  if (idLength > 0) {
+    updateTrackedDeviceIdentity(mac, String(identity->id, idLength));
   }
+}
+
+// Nothing to store: receiving any packet already refreshed lastSeenMs.
+void ingestSlaveAlive(const uint8_t[6], const uint8_t*, uint8_t) {}
+
+void ingestSensor(const uint8_t mac[6], const uint8_t* payload, uint8_t) {
+  const auto* state = reinterpret_cast<const state_binary::SensorState*>(payload);
+  history::record(mac, history::Metric::SensorTemperature, state->temperature10 / 10.0f);
+  history::record(mac, history::Metric::SensorHumidity, state->humidity10 / 10.0f);
+}
 
-  if (hasTypeAndSize(payload, payloadSize, Type::Sensor, sizeof(SensorState))) {
-    const auto* state = reinterpret_cast<const SensorState*>(payload);
-    return app::espnow::codec::buildPayload({
-        {"state", "sensor"},
-        {"temp", String(state->temperature10 / 10.0f, 1) + "C"},
-        {"hum", String(state->humidity10 / 10.0f, 1) + "%"},
-    });
+void ingestWeather(const uint8_t mac[6], const uint8_t* payload, uint8_t) {
+  const auto* state = reinterpret_cast<const state_binary::WeatherState*>(payload);
+  if (state->ok != 0) {
+    history::record(mac, history::Metric::WeatherTemperature, state->temperature10 / 10.0f);
+    history::record(mac, history::Metric::WindSpeed, state->windspeed10 / 10.0f);
   }
+}
 
-  if (hasTypeAndSize(payload, payloadSize, Type::ProxyReq, sizeof(ProxyReqState))) {
-    const auto* state = reinterpret_cast<const ProxyReqState*>(payload);
+void ingestFeatures(const uint8_t mac[6], const uint8_t* payload, uint8_t) {
+  const auto* state = reinterpret_cast<const state_binary::FeaturesState*>(payload);
+  updateTrackedDeviceFeatures(mac, state->featureBits);
+}
 
-    String method = "GET";
-    if (state->method == static_cast<uint8_t>(HttpMethod::Post)) {
-      method = "POST";
-    } else if (state->method == static_cast<uint8_t>(HttpMethod::Patch)) {
-      method = "PATCH";
-    }
+void ingestCameraMeta(const uint8_t mac[6], const uint8_t* payload, uint8_t) {
+  camera_stream::ingestMeta(mac, *reinterpret_cast<const state_binary::CameraMetaState*>(payload));
+  app::display::displayInterface.requestRender();
+}
 
-    return app::espnow::codec::buildPayload({
-        {"state", "proxy_req"},
-        {"method", method},
-        {"url", String(state->url)},
-        {"payload", "{}"},
-    });
-  }
+void ingestCameraChunk(const uint8_t mac[6], const uint8_t* payload, uint8_t) {
+  camera_stream::ingestChunk(mac, *reinterpret_cast<const state_binary::CameraChunkState*>(payload));
+}
 
-  if (hasTypeAndSize(payload, payloadSize, Type::Weather, sizeof(WeatherState))) {
-    const auto* state = reinterpret_cast<const WeatherState*>(payload);
-    return app::espnow::codec::buildPayload({
-        {"state", "weather"},
-        {"ok", String(state->ok)},
-        {"code", String(state->code)},
-        {"time", String(state->time)},
-        {"temperature", String(state->temperature10 / 10.0f, 1)},
-        {"windspeed", String(state->windspeed10 / 10.0f, 1)},
-        {"winddirection", String(state->winddirection)},
-    });
-  }
+void ingestCameraFrameEnd(const uint8_t mac[6], const uint8_t* payload, uint8_t payloadSize) {
+  camera_stream::ingestFrameEnd(mac,
+                                *reinterpret_cast<const state_binary::CameraFrameEndState*>(payload),
+                                payloadSize >= sizeof(state_binary::CameraFrameEndState));
+  app::display::displayInterface.requestRender();
+}
 
-  if (hasTypeAndSize(payload, payloadSize, Type::SlaveAlive, sizeof(SlaveAliveState))) {
-    return app::espnow::codec::buildPayload({
-        {"state", "slave_alive"},
-    });
-  }
+constexpr std::array<IngestHandler, 256> buildIngestTable() {
+  std::array<IngestHandler, 256> table{};
+  table[static_cast<uint8_t>(state_binary::Type::Identity)] = &ingestIdentity;
+  table[static_cast<uint8_t>(state_binary::Type::SlaveAlive)] = &ingestSlaveAlive;
+  table[static_cast<uint8_t>(state_binary::Type::Sensor)] = &ingestSensor;
+  table[static_cast<uint8_t>(state_binary::Type::Weather)] = &ingestWeather;
+  table[static_cast<uint8_t>(state_binary::Type::Features)] = &ingestFeatures;
+  table[static_cast<uint8_t>(state_binary::Type::CameraMeta)] = &ingestCameraMeta;
+  table[static_cast<uint8_t>(state_binary::Type::CameraChunk)] = &ingestCameraChunk;
+  table[static_cast<uint8_t>(state_binary::Type::CameraFrameEnd)] = &ingestCameraFrameEnd;
+  return table;
+}
 
-  if (hasTypeAndSize(payload, payloadSize, Type::Features, sizeof(FeaturesState))) {
-    const auto* state = reinterpret_cast<const FeaturesState*>(payload);
-    return app::espnow::codec::buildPayload({
-        {"state", "features"},
-        {"bits", String(state->featureBits)},
-        {"contract", String(state->contractVersion)},
-    });
-  }
+constexpr std::array<IngestHandler, 256> kIngestHandlers = buildIngestTable();
 
-  if (hasTypeAndSize(payload, payloadSize, Type::CameraMeta, sizeof(CameraMetaState))) {
-    const auto* state = reinterpret_cast<const CameraMetaState*>(payload);
-    return app::espnow::codec::buildPayload({
-        {"state", "camera"},
-        {"frame", String(state->frameId)},
-        {"bytes", String(state->totalBytes)},
-        {"chunks", String(state->totalChunks)},
-        {"w", String(state->width)},
-        {"h", String(state->height)},
-    });
+// Every inbound type that needs a verified sender (or verifies it) must be
+// ingested; bootstrap types are handled inline (proxy_req) or listed above.
+constexpr bool everyInboundTypeIngested() {
+  for (const auto& schema : state_schema::kSchemas) {
+    if (schema.direction == state_schema::Direction::SlaveToMaster &&
+        schema.verification != state_schema::Verification::Bootstrap &&
+        kIngestHandlers[static_cast<uint8_t>(schema.type)] == nullptr) {
+      return false;
+    }
   }
+  return true;
+}
 
-  if (hasTypeAndSize(payload, payloadSize, Type::CameraChunk, sizeof(CameraChunkState))) {
-    const auto* state = reinterpret_cast<const CameraChunkState*>(payload);
-    return app::espnow::codec::buildPayload({
-        {"state", "camera_chunk"},
-        {"frame", String(state->frameId)},
-        {"idx", String(state->idx)},
-        {"total", String(state->total)},
-    });
-  }
+static_assert(everyInboundTypeIngested(), "inbound state_schema type without an ingest handler in buildIngestTable()");
 
-  if (hasTypeAndSize(payload, payloadSize, Type::CameraFrameEnd, sizeof(CameraFrameEndState))) {
-    const auto* state = reinterpret_cast<const CameraFrameEndState*>(payload);
-    return app::espnow::codec::buildPayload({
-        {"state", "camera_end"},
-        {"frame", String(state->frameId)},
-        {"bytes", String(state->totalBytes)},
-        {"chunks", String(state->totalChunks)},
-    });
+// Identity is accepted when it carries an id (that is what verifies the
+// slave); bootstrap types may arrive before that.
+bool isAccepted(const state_schema::Schema& schema, const uint8_t* payload, bool verified) {
+  switch (schema.verification) {
+    case state_schema::Verification::Identifies: {
+      const auto* identity = reinterpret_cast<const state_binary::IdentityState*>(payload);
+      return verified || identity->id[0] != '\0';
+    }
+    case state_schema::Verification::Bootstrap:
+      return true;
+    case state_schema::Verification::RequireVerified:
+      return verified;
   }
-
-  return "";
+  return false;
 }
 
+}  // namespace
+
 void defaultSlaveStateHandler(const uint8_t mac[6], const char* stateText, uint8_t payloadSize) {
   if (stateText == nullptr) {
     ESP_LOGI(TAG, "Slave state packet (empty)");
     return;
   }
 
-  const String payload = String(stateText);
-  String stateName;
-  app::espnow::codec::getField(payload, "state", stateName);
+  const codec::PayloadView view(stateText);
+  codec::Span stateName;
+  view.get("state", stateName);
 
-  if (stateName == "camera_chunk" || stateName == "camera_end") {
-    updateTrackedDeviceStatePayload(mac, payload);
+  if (stateName.equals("camera_chunk") || stateName.equals("camera_end")) {
     return;
   }
 
-  updateTrackedDeviceStatePayload(mac, payload);
-
-  if (stateName != "features") {
+  const String payload = String(stateText);
+  if (!stateName.equals("features")) {
     app::espnow::state_store::upsertFromStatePayload(payload);
     app::display::displayInterface.applyStatePayload(payload);
   }
 
   String deviceId;
-  if (!app::espnow::codec::getField(payload, "id", deviceId) || deviceId.isEmpty()) {
+  codec::Span idSpan;
+  if (view.get("id", idSpan)) {
+    deviceId = idSpan.toString();
+  } else {
     getTrackedDeviceIdentity(mac, deviceId);
   }
 
   const char* idText = deviceId.isEmpty() ? "unknown" : deviceId.c_str();
 
-  if (stateName == "identity") {
+  if (stateName.equals("identity")) {
     ESP_LOGI(TAG,
              "Slave %02X:%02X:%02X:%02X:%02X:%02X identity accepted: id=%s",
              mac[0], mac[1], mac[2], mac[3], mac[4], mac[5], idText);
     return;
   }
 
-  if (stateName == "sensor") {
+  if (stateName.equals("sensor")) {
     ESP_LOGI(TAG,
              "Slave %02X:%02X:%02X:%02X:%02X:%02X id=%s sensor update: %s",
              mac[0], mac[1], mac[2], mac[3], mac[4], mac[5], idText, stateText);
     return;
   }
 
-  if (stateName == "proxy_req") {
+  if (stateName.equals("proxy_req")) {
     ESP_LOGI(TAG,
              "Slave %02X:%02X:%02X:%02X:%02X:%02X id=%s proxy request: %s",
              mac[0], mac[1], mac[2], mac[3], mac[4], mac[5], idText, stateText);
     return;
   }
 
-  if (stateName == "weather") {
+  if (stateName.equals("weather")) {
     ESP_LOGI(TAG,
              "Slave %02X:%02X:%02X:%02X:%02X:%02X id=%s weather update: %s",
              mac[0], mac[1], mac[2], mac[3], mac[4], mac[5], idText, stateText);
     return;
   }
 
-  if (stateName == "features") {
+  if (stateName.equals("features")) {
     ESP_LOGI(TAG,
              "Slave %02X:%02X:%02X:%02X:%02X:%02X id=%s features: %s",
              mac[0], mac[1], mac[2], mac[3], mac[4], mac[5], idText, stateText);
     return;
   }
 
-  if (stateName == "camera") {
+  if (stateName.equals("camera")) {
     return;
   }
 
@@ -204,8 +201,7 @@ void handleMasterHelloEvent(const esp_now_recv_info_t* recvInfo) {
            recvInfo->src_addr[3], recvInfo->src_addr[4], recvInfo->src_addr[5]);
 }
 
-void handleMasterStateEvent(MasterNode& master,
-                            const esp_now_recv_info_t* recvInfo,
+void handleMasterStateEvent(const esp_now_recv_info_t* recvInfo,
                             const uint8_t* payload,
                             uint8_t payloadSize,
                             SlaveStateHandler stateHandler) {
@@ -213,77 +209,61 @@ void handleMasterStateEvent(MasterNode& master,
     return;
   }
 
-  if (app::espnow::state_binary::hasTypeAndSize(payload,
-                                                 payloadSize,
-                                                 app::espnow::state_binary::Type::CameraMeta,
-                                                 sizeof(app::espnow::state_binary::CameraMetaState))) {
-    const auto* meta = reinterpret_cast<const app::espnow::state_binary::CameraMetaState*>(payload);
-    app::espnow::camera_stream::ingestMeta(recvInfo->src_addr, *meta);
-    app::display::displayInterface.requestRender();
-  } else if (app::espnow::state_binary::hasTypeAndSize(payload,
-                                                        payloadSize,
-                                                        app::espnow::state_binary::Type::CameraChunk,
-                                                        sizeof(app::espnow::state_binary::CameraChunkState))) {
-    const auto* chunk = reinterpret_cast<const app::espnow::state_binary::CameraChunkState*>(payload);
-    app::espnow::camera_stream::ingestChunk(recvInfo->src_addr, *chunk);
-  } else if (app::espnow::state_binary::hasTypeAndSize(payload,
-                                                        payloadSize,
-                                                        app::espnow::state_binary::Type::CameraFrameEnd,
-                                                        sizeof(app::espnow::state_binary::CameraFrameEndState))) {
-    const auto* frameEnd = reinterpret_cast<const app::espnow::state_binary::CameraFrameEndState*>(payload);
-    app::espnow::camera_stream::ingestFrameEnd(recvInfo->src_addr, *frameEnd);
-    app::display::displayInterface.requestRender();
-  }
-
-  const String payloadText = buildTextPayloadFromBinary(payload, payloadSize);
-  if (payloadText.isEmpty()) {
+  const uint8_t* mac = recvInfo->src_addr;
+  const state_schema::Schema* schema = state_schema::validate(payload, payloadSize);
+  if (schema == nullptr) {
     ESP_LOGW(TAG,
              "Ignore invalid/unknown binary state from %02X:%02X:%02X:%02X:%02X:%02X",
-             recvInfo->src_addr[0], recvInfo->src_addr[1], recvInfo->src_addr[2],
-             recvInfo->src_addr[3], recvInfo->src_addr[4], recvInfo->src_addr[5]);
+             mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
     return;
   }
 
-  String deviceId;
-  String stateName;
-  app::espnow::codec::getField(payloadText, "state", stateName);
-
-  const bool hasDeviceId = app::espnow::codec::getField(payloadText, "id", deviceId) && !deviceId.isEmpty();
-  const bool verified = isTrackedDeviceVerified(recvInfo->src_addr);
-  const bool allowPreVerifiedProxyReq = (stateName == "proxy_req" || stateName == "features");
+  // Older, shorter revisions are zero-extended to the current struct.
+  uint8_t widened[MAX_PAYLOAD_SIZE];
+  if (payloadSize < schema->size) {
+    memset(widened, 0, schema->size);
+    memcpy(widened, payload, payloadSize);
+    payload = widened;
+  }
 
-  if (!verified && !hasDeviceId && !allowPreVerifiedProxyReq) {
+  const bool verified = isTrackedDeviceVerified(mac);
+  if (!isAccepted(*schema, payload, verified)) {
     return;
   }
 
-  if (!verified && !hasDeviceId && allowPreVerifiedProxyReq) {
+  if (!verified && schema->verification == state_schema::Verification::Bootstrap) {
     ESP_LOGW(TAG,
-             "Allow proxy_req from unverified slave %02X:%02X:%02X:%02X:%02X:%02X",
-             recvInfo->src_addr[0], recvInfo->src_addr[1], recvInfo->src_addr[2],
-             recvInfo->src_addr[3], recvInfo->src_addr[4], recvInfo->src_addr[5]);
-  }
-
-  if (hasDeviceId) {
-    updateTrackedDeviceIdentity(recvInfo->src_addr, deviceId);
+             "Allow %s from unverified slave %02X:%02X:%02X:%02X:%02X:%02X",
+             schema->stateName, mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
   }
 
-  if (stateName == "features") {
-    String bits;
-    if (app::espnow::codec::getField(payloadText, "bits", bits)) {
-      updateTrackedDeviceFeatures(recvInfo->src_addr, static_cast<uint32_t>(strtoul(bits.c_str(), nullptr, 10)));
+  if (schema->requiredFeature != 0) {
+    const uint32_t featureBits = getTrackedDeviceFeatureBits(mac);
+    if (featureBits != 0 && (featureBits & schema->requiredFeature) == 0) {
+      ESP_LOGD(TAG,
+               "%s from %02X:%02X:%02X:%02X:%02X:%02X without advertised feature 0x%08lX",
+               schema->stateName, mac[0], mac[1], mac[2], mac[3], mac[4], mac[5],
+               static_cast<unsigned long>(schema->requiredFeature));
     }
   }
 
   char stateText[MAX_PAYLOAD_SIZE + 1] = {0};
-  strncpy(stateText, payloadText.c_str(), MAX_PAYLOAD_SIZE);
-  stateText[MAX_PAYLOAD_SIZE] = '\0';
+  codec::PayloadWriter writer(stateText, sizeof(stateText));
+  state_schema::renderText(*schema, payload, writer);
+
+  updateTrackedDeviceState(mac, schema->type, payload);
+
+  const IngestHandler ingest = kIngestHandlers[static_cast<uint8_t>(schema->type)];
+  if (ingest != nullptr) {
+    ingest(mac, payload, payloadSize);
+  }
 
   if (stateHandler != nullptr) {
-    stateHandler(recvInfo->src_addr, stateText, strlen(stateText));
+    stateHandler(mac, stateText, writer.size());
   }
 
-  if (enqueueProxyRequest(recvInfo->src_addr, stateText)) {
-    return;
+  if (schema->type == state_binary::Type::ProxyReq) {
+    enqueueProxyRequest(mac, stateText);
   }
 }
 
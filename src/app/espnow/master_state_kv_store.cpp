@@ -1,9 +1,16 @@
 #include "master_state_kv_store.h"
 
 #include "payload_codec.h"
+#include "core/boot.h"
+#include "core/crc32.h"
+#include "core/fs_lock.h"
 
 #include <LittleFS.h>
+#include <app_config.h>
+#include <esp_heap_caps.h>
 #include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 #include <vector>
 
 namespace app::espnow::state_store {
@@ -12,16 +19,32 @@ namespace {
 
 static constexpr const char* TAG = "state_kv_store";
 static constexpr const char* STORE_DIR = "/data";
-static constexpr const char* STORE_PATH = "/data/state_latest.csv";
-
-struct Row {
-  String state;
-  String key;
-  String value;
+static constexpr const char* SNAPSHOT_PATH = "/data/state_latest.bin";
+static constexpr const char* SNAPSHOT_TMP_PATH = "/data/state_latest.bin.tmp";
+static constexpr const char* JOURNAL_PATH = "/data/state_journal.bin";
+static constexpr const char* LEGACY_CSV_PATH = "/data/state_latest.csv";
+static constexpr const char* LEGACY_CSV_MIGRATED_PATH = "/data/state_latest.csv.migrated";
+
+// File layout: 8-byte header {magic[4], version, reserved[3]} followed by
+// records {kind, reserved, len:u16, crc32:u32, payload[len]} (little endian).
+// The CRC covers the first 4 header bytes and the payload.
+static constexpr uint8_t FILE_MAGIC[4] = {'S', 'K', 'V', 'B'};
+static constexpr uint8_t FORMAT_VERSION = 1;
+static constexpr size_t FILE_HEADER_SIZE = 8;
+static constexpr size_t RECORD_HEADER_SIZE = 8;
+static constexpr size_t MAX_NAME_LEN = 255;
+static constexpr size_t MAX_VALUE_LEN = 1024;
+
+enum class RecordKind : uint8_t {
+  // payload: id:u16, len:u8, bytes[len]
+  Intern = 1,
+  // payload: stateId:u16, keyId:u16, len:u16, bytes[len]
+  Value = 2,
 };
 
-struct Field {
-  String key;
+struct Row {
+  uint16_t stateId = 0;
+  uint16_t keyId = 0;
   String value;
 };
 
@@ -34,21 +57,357 @@ struct StateTimestamp {
 static constexpr size_t kStateTimestampSlots = 16;
 StateTimestamp stateTimestamps[kStateTimestampSlots];
 
-String csvEscape(const String& value) {
-  String out = "\"";
-  for (size_t i = 0; i < value.length(); ++i) {
-    const char ch = value[i];
-    if (ch == '"') {
-      out += "\"\"";
-    } else {
-      out += ch;
+std::vector<String> internTable;
+std::vector<Row> rows;
+bool loaded = false;
+size_t journalBytes = 0;
+// Set when a journal write was skipped; the next write rewrites the snapshot.
+bool compactPending = false;
+SemaphoreHandle_t storeMutex = nullptr;
+portMUX_TYPE storeMutexInitLock = portMUX_INITIALIZER_UNLOCKED;
+
+SemaphoreHandle_t getStoreMutex() {
+  if (storeMutex != nullptr) {
+    return storeMutex;
+  }
+
+  SemaphoreHandle_t created = xSemaphoreCreateMutex();
+  portENTER_CRITICAL(&storeMutexInitLock);
+  if (storeMutex == nullptr) {
+    storeMutex = created;
+    created = nullptr;
+  }
+  portEXIT_CRITICAL(&storeMutexInitLock);
+
+  if (created != nullptr) {
+    vSemaphoreDelete(created);
+  }
+  return storeMutex;
+}
+
+class StoreLock {
+ public:
+  StoreLock() : handle(getStoreMutex()) {
+    if (handle != nullptr) {
+      xSemaphoreTake(handle, portMAX_DELAY);
+    }
+  }
+  ~StoreLock() {
+    if (handle != nullptr) {
+      xSemaphoreGive(handle);
+    }
+  }
+
+ private:
+  SemaphoreHandle_t handle;
+};
+
+void putU16(uint8_t* out, uint16_t value) {
+  out[0] = static_cast<uint8_t>(value & 0xFF);
+  out[1] = static_cast<uint8_t>(value >> 8);
+}
+
+uint16_t getU16(const uint8_t* in) {
+  return static_cast<uint16_t>(in[0] | (in[1] << 8));
+}
+
+void appendFileHeader(std::vector<uint8_t>& out) {
+  out.insert(out.end(), FILE_MAGIC, FILE_MAGIC + sizeof(FILE_MAGIC));
+  out.push_back(FORMAT_VERSION);
+  out.push_back(0);
+  out.push_back(0);
+  out.push_back(0);
+}
+
+void appendRecord(std::vector<uint8_t>& out, RecordKind kind, const uint8_t* payload, uint16_t length) {
+  uint8_t header[RECORD_HEADER_SIZE] = {static_cast<uint8_t>(kind), 0, 0, 0, 0, 0, 0, 0};
+  putU16(header + 2, length);
+  uint32_t crc = core::crc32(header, 4);
+  crc = core::crc32(payload, length, crc);
+  for (size_t i = 0; i < 4; ++i) {
+    header[4 + i] = static_cast<uint8_t>(crc >> (8 * i));
+  }
+
+  out.insert(out.end(), header, header + RECORD_HEADER_SIZE);
+  out.insert(out.end(), payload, payload + length);
+}
+
+void appendInternRecord(std::vector<uint8_t>& out, uint16_t id, const String& name) {
+  uint8_t payload[3 + MAX_NAME_LEN];
+  const size_t length = name.length() > MAX_NAME_LEN ? MAX_NAME_LEN : name.length();
+  putU16(payload, id);
+  payload[2] = static_cast<uint8_t>(length);
+  memcpy(payload + 3, name.c_str(), length);
+  appendRecord(out, RecordKind::Intern, payload, static_cast<uint16_t>(3 + length));
+}
+
+void appendValueRecord(std::vector<uint8_t>& out, const Row& row) {
+  const size_t length = row.value.length() > MAX_VALUE_LEN ? MAX_VALUE_LEN : row.value.length();
+  std::vector<uint8_t> payload(6 + length);
+  putU16(payload.data(), row.stateId);
+  putU16(payload.data() + 2, row.keyId);
+  putU16(payload.data() + 4, static_cast<uint16_t>(length));
+  memcpy(payload.data() + 6, row.value.c_str(), length);
+  appendRecord(out, RecordKind::Value, payload.data(), static_cast<uint16_t>(payload.size()));
+}
+
+int findInternId(app::espnow::codec::Span name) {
+  for (size_t i = 0; i < internTable.size(); ++i) {
+    if (name.equals(internTable[i].c_str())) {
+      return static_cast<int>(i);
     }
   }
-  out += "\"";
-  return out;
+  return -1;
+}
+
+int findInternId(const String& name) {
+  return findInternId(app::espnow::codec::toSpan(name));
+}
+
+// Returns the id for `name`, interning it (and journaling the new name) if needed.
+int internName(app::espnow::codec::Span name, std::vector<uint8_t>& journalOut) {
+  const int existing = findInternId(name);
+  if (existing >= 0) {
+    return existing;
+  }
+  if (name.size > MAX_NAME_LEN || internTable.size() >= UINT16_MAX) {
+    return -1;
+  }
+
+  const uint16_t id = static_cast<uint16_t>(internTable.size());
+  internTable.push_back(name.toString());
+  appendInternRecord(journalOut, id, internTable.back());
+  return id;
+}
+
+int internName(const String& name, std::vector<uint8_t>& journalOut) {
+  return internName(app::espnow::codec::toSpan(name), journalOut);
+}
+
+Row* findRow(uint16_t stateId, uint16_t keyId) {
+  for (auto& row : rows) {
+    if (row.stateId == stateId && row.keyId == keyId) {
+      return &row;
+    }
+  }
+  return nullptr;
+}
+
+void setRowValue(uint16_t stateId, uint16_t keyId, const String& value) {
+  Row* row = findRow(stateId, keyId);
+  if (row != nullptr) {
+    row->value = value;
+    return;
+  }
+  rows.push_back(Row{stateId, keyId, value});
+}
+
+bool applyRecord(RecordKind kind, const uint8_t* payload, uint16_t length) {
+  switch (kind) {
+    case RecordKind::Intern: {
+      if (length < 3 || static_cast<size_t>(3 + payload[2]) != length) {
+        return false;
+      }
+      const uint16_t id = getU16(payload);
+      if (id >= internTable.size()) {
+        internTable.resize(static_cast<size_t>(id) + 1);
+      }
+      internTable[id] = String(reinterpret_cast<const char*>(payload + 3), payload[2]);
+      return true;
+    }
+    case RecordKind::Value: {
+      if (length < 6) {
+        return false;
+      }
+      const uint16_t stateId = getU16(payload);
+      const uint16_t keyId = getU16(payload + 2);
+      const uint16_t valueLen = getU16(payload + 4);
+      if (static_cast<size_t>(6 + valueLen) != length || stateId >= internTable.size() || keyId >= internTable.size()) {
+        return false;
+      }
+      setRowValue(stateId, keyId, String(reinterpret_cast<const char*>(payload + 6), valueLen));
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+enum class LoadResult : uint8_t {
+  Missing,
+  Clean,
+  // Valid records before a torn/corrupt one were applied.
+  TornTail,
+  // Not a store file this build can read; nothing was applied.
+  Rejected,
+  // Open, allocation or read failed; the file may still be fine.
+  Failed,
+};
+
+// Applies every valid record in `data`.
+LoadResult parseStoreImage(const uint8_t* data, size_t size, const char* path) {
+  if (size < FILE_HEADER_SIZE || memcmp(data, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0) {
+    ESP_LOGW(TAG, "%s: bad header", path);
+    return LoadResult::Rejected;
+  }
+  if (data[4] > FORMAT_VERSION) {
+    ESP_LOGW(TAG, "%s: unsupported version %u", path, data[4]);
+    return LoadResult::Rejected;
+  }
+
+  size_t offset = FILE_HEADER_SIZE;
+  while (offset + RECORD_HEADER_SIZE <= size) {
+    const uint8_t* header = data + offset;
+    const uint16_t length = getU16(header + 2);
+    if (offset + RECORD_HEADER_SIZE + length > size) {
+      break;
+    }
+
+    const uint8_t* payload = header + RECORD_HEADER_SIZE;
+    const uint32_t storedCrc = static_cast<uint32_t>(header[4])
+                             | (static_cast<uint32_t>(header[5]) << 8)
+                             | (static_cast<uint32_t>(header[6]) << 16)
+                             | (static_cast<uint32_t>(header[7]) << 24);
+    const uint32_t crc = core::crc32(payload, length, core::crc32(header, 4));
+    if (crc != storedCrc || !applyRecord(static_cast<RecordKind>(header[0]), payload, length)) {
+      break;
+    }
+    offset += RECORD_HEADER_SIZE + length;
+  }
+
+  if (offset != size) {
+    ESP_LOGW(TAG, "%s: dropped corrupt tail at %u/%u", path, static_cast<unsigned>(offset), static_cast<unsigned>(size));
+    return LoadResult::TornTail;
+  }
+  return LoadResult::Clean;
+}
+
+// Reads the whole file with a single read() into a PSRAM buffer.
+LoadResult loadStoreFile(const char* path, size_t& sizeOut) {
+  sizeOut = 0;
+  if (!LittleFS.exists(path)) {
+    return LoadResult::Missing;
+  }
+
+  File file = LittleFS.open(path, "r");
+  if (!file) {
+    ESP_LOGW(TAG, "Failed opening %s for read", path);
+    return LoadResult::Failed;
+  }
+
+  const size_t size = file.size();
+  auto* buffer = static_cast<uint8_t*>(heap_caps_malloc(size == 0 ? 1 : size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+  if (buffer == nullptr) {
+    buffer = static_cast<uint8_t*>(malloc(size == 0 ? 1 : size));
+  }
+  if (buffer == nullptr) {
+    file.close();
+    ESP_LOGE(TAG, "No memory to load %s (%u bytes)", path, static_cast<unsigned>(size));
+    return LoadResult::Failed;
+  }
+
+  const size_t readBytes = file.read(buffer, size);
+  file.close();
+  if (readBytes != size) {
+    free(buffer);
+    ESP_LOGW(TAG, "Short read of %s %u/%u", path, static_cast<unsigned>(readBytes), static_cast<unsigned>(size));
+    return LoadResult::Failed;
+  }
+
+  const LoadResult result = parseStoreImage(buffer, readBytes, path);
+  free(buffer);
+  sizeOut = size;
+  return result;
+}
+
+// Moves a file this build cannot read out of the way instead of
+// overwriting it.
+void setAsideRejected(const char* path) {
+  const String rejectedPath = String(path) + ".rejected";
+  LittleFS.remove(rejectedPath.c_str());
+  if (LittleFS.rename(path, rejectedPath.c_str())) {
+    ESP_LOGW(TAG, "Kept unreadable %s as %s", path, rejectedPath.c_str());
+  }
+}
+
+bool writeFileAtomically(const std::vector<uint8_t>& image) {
+  File file = LittleFS.open(SNAPSHOT_TMP_PATH, "w");
+  if (!file) {
+    ESP_LOGW(TAG, "Failed opening snapshot for write");
+    return false;
+  }
+
+  const size_t written = file.write(image.data(), image.size());
+  file.close();
+  if (written != image.size()) {
+    LittleFS.remove(SNAPSHOT_TMP_PATH);
+    ESP_LOGW(TAG, "Short snapshot write %u/%u", static_cast<unsigned>(written), static_cast<unsigned>(image.size()));
+    return false;
+  }
+
+  return LittleFS.rename(SNAPSHOT_TMP_PATH, SNAPSHOT_PATH);
+}
+
+// Rewrites the snapshot from memory and drops the journal. Intern ids are
+// preserved, so replaying a journal left over from a crash stays consistent.
+bool compact() {
+  core::fs::Lock fsLock;
+  std::vector<uint8_t> image;
+  image.reserve(FILE_HEADER_SIZE + rows.size() * 32);
+  appendFileHeader(image);
+  for (size_t id = 0; id < internTable.size(); ++id) {
+    appendInternRecord(image, static_cast<uint16_t>(id), internTable[id]);
+  }
+  for (const auto& row : rows) {
+    appendValueRecord(image, row);
+  }
+
+  if (!writeFileAtomically(image)) {
+    return false;
+  }
+
+  LittleFS.remove(JOURNAL_PATH);
+  journalBytes = 0;
+  ESP_LOGD(TAG, "Compacted store: %u rows, %u bytes", static_cast<unsigned>(rows.size()), static_cast<unsigned>(image.size()));
+  return true;
+}
+
+bool appendJournal(const std::vector<uint8_t>& records) {
+  core::fs::Lock fsLock;
+  std::vector<uint8_t> chunk;
+  if (journalBytes == 0) {
+    appendFileHeader(chunk);
+  }
+  chunk.insert(chunk.end(), records.begin(), records.end());
+
+  File file = LittleFS.open(JOURNAL_PATH, journalBytes == 0 ? "w" : "a");
+  if (!file) {
+    ESP_LOGW(TAG, "Failed opening journal for append");
+    return false;
+  }
+
+  const size_t written = file.write(chunk.data(), chunk.size());
+  file.close();
+  journalBytes += written;
+  if (written != chunk.size()) {
+    ESP_LOGW(TAG, "Short journal write, compacting");
+    return compact();
+  }
+
+  if (journalBytes >= MASTER_STATE_JOURNAL_COMPACT_BYTES) {
+    return compact();
+  }
+  return true;
 }
 
-bool parseCsvLine(const String& line, Row& rowOut) {
+struct LegacyRow {
+  String state;
+  String key;
+  String value;
+};
+
+// Only used for the one-time import of the old CSV store.
+bool parseCsvLine(const String& line, LegacyRow& rowOut) {
   std::vector<String> columns;
   String current;
   bool inQuotes = false;
@@ -85,18 +444,14 @@ bool parseCsvLine(const String& line, Row& rowOut) {
   return true;
 }
 
-bool loadRows(std::vector<Row>& rowsOut) {
-  rowsOut.clear();
-  if (!LittleFS.exists(STORE_PATH)) {
-    return true;
-  }
-
-  File file = LittleFS.open(STORE_PATH, "r");
+bool importLegacyCsv() {
+  File file = LittleFS.open(LEGACY_CSV_PATH, "r");
   if (!file) {
-    ESP_LOGW(TAG, "Failed opening store for read");
     return false;
   }
 
+  std::vector<uint8_t> discard;
+  size_t imported = 0;
   while (file.available()) {
     String line = file.readStringUntil('\n');
     line.trim();
@@ -104,91 +459,119 @@ bool loadRows(std::vector<Row>& rowsOut) {
       continue;
     }
 
-    Row row;
-    if (parseCsvLine(line, row)) {
-      rowsOut.push_back(row);
+    LegacyRow row;
+    if (!parseCsvLine(line, row)) {
+      continue;
     }
-  }
 
+    const int stateId = internName(row.state, discard);
+    const int keyId = internName(row.key, discard);
+    if (stateId < 0 || keyId < 0) {
+      continue;
+    }
+    setRowValue(static_cast<uint16_t>(stateId), static_cast<uint16_t>(keyId), row.value);
+    imported++;
+  }
   file.close();
+
+  if (!compact()) {
+    return false;
+  }
+
+  LittleFS.rename(LEGACY_CSV_PATH, LEGACY_CSV_MIGRATED_PATH);
+  ESP_LOGI(TAG, "Imported %u rows from legacy CSV store", static_cast<unsigned>(imported));
   return true;
 }
 
-bool saveRows(const std::vector<Row>& rows) {
+// Caller must hold the store lock. The network task loads the store right
+// after boot; if an ESP-NOW upsert gets here first, the same bounded wait as
+// the journal append applies and the load is retried on a later call.
+bool ensureLoaded() {
+  if (loaded) {
+    return true;
+  }
+  if (!core::boot::isFsReady()) {
+    return false;
+  }
+
+  core::fs::Lock fsLock(pdMS_TO_TICKS(MASTER_FS_LOCK_WAIT_MS));
+  if (!fsLock.held()) {
+    return false;
+  }
   if (!LittleFS.exists(STORE_DIR)) {
     LittleFS.mkdir(STORE_DIR);
   }
 
-  File file = LittleFS.open(STORE_PATH, "w");
-  if (!file) {
-    ESP_LOGW(TAG, "Failed opening store for write");
+  const uint32_t startMs = millis();
+  internTable.clear();
+  rows.clear();
+
+  size_t snapshotBytes = 0;
+  const LoadResult snapshot = loadStoreFile(SNAPSHOT_PATH, snapshotBytes);
+  const LoadResult journal =
+      snapshot == LoadResult::Failed ? LoadResult::Failed : loadStoreFile(JOURNAL_PATH, journalBytes);
+
+  // Compacting now would overwrite files that may be readable next time.
+  if (snapshot == LoadResult::Failed || journal == LoadResult::Failed) {
+    internTable.clear();
+    rows.clear();
+    journalBytes = 0;
+    ESP_LOGE(TAG, "State store not loaded, will retry");
     return false;
   }
 
-  file.println("state,key,value");
-  for (const auto& row : rows) {
-    file.print(csvEscape(row.state));
-    file.print(',');
-    file.print(csvEscape(row.key));
-    file.print(',');
-    file.println(csvEscape(row.value));
+  if (snapshot == LoadResult::Rejected) {
+    setAsideRejected(SNAPSHOT_PATH);
+  }
+  if (journal == LoadResult::Rejected) {
+    setAsideRejected(JOURNAL_PATH);
+    journalBytes = 0;
   }
 
-  file.close();
+  loaded = true;
+  if (snapshot == LoadResult::Missing && LittleFS.exists(LEGACY_CSV_PATH)) {
+    importLegacyCsv();
+  } else if (snapshot == LoadResult::TornTail || snapshot == LoadResult::Rejected || journal == LoadResult::TornTail ||
+             journal == LoadResult::Rejected) {
+    compactPending = !compact();
+  }
+
+  ESP_LOGI(TAG,
+           "Loaded %u rows / %u names (snapshot=%u journal=%u bytes) in %lu ms",
+           static_cast<unsigned>(rows.size()),
+           static_cast<unsigned>(internTable.size()),
+           static_cast<unsigned>(snapshotBytes),
+           static_cast<unsigned>(journalBytes),
+           static_cast<unsigned long>(millis() - startMs));
   return true;
 }
 
-void parseFields(const String& payload, std::vector<Field>& fieldsOut) {
-  fieldsOut.clear();
-  int start = 0;
-  while (start < static_cast<int>(payload.length())) {
-    const int end = payload.indexOf(app::espnow::codec::kSeparator, start);
-    const int tokenEnd = end < 0 ? payload.length() : end;
-    String token = payload.substring(start, tokenEnd);
-    token.trim();
-
-    const int equalsPos = token.indexOf('=');
-    if (equalsPos > 0) {
-      Field field;
-      field.key = token.substring(0, equalsPos);
-      field.value = token.substring(equalsPos + 1);
-      field.key.trim();
-      field.value.trim();
-      if (!field.key.isEmpty()) {
-        fieldsOut.push_back(field);
-      }
-    }
-
-    if (end < 0) {
-      break;
+bool isTruthySuccess(app::espnow::codec::Span value) {
+  for (const char* accepted : {"1", "true", "ok", "success"}) {
+    const size_t length = strlen(accepted);
+    if (value.size == length && strncasecmp(value.data, accepted, length) == 0) {
+      return true;
     }
-    start = end + strlen(app::espnow::codec::kSeparator);
   }
+  return false;
 }
 
-bool isTruthySuccess(const String& value) {
-  String normalized = value;
-  normalized.toLowerCase();
-  return normalized == "1" || normalized == "true" || normalized == "ok" || normalized == "success";
-}
-
-bool shouldSkipUpdateByStatus(const std::vector<Field>& fields) {
-  for (const auto& field : fields) {
-    if (field.key == "ok" || field.key == "status") {
-      if (!isTruthySuccess(field.value)) {
-        return true;
-      }
+bool shouldSkipUpdateByStatus(const app::espnow::codec::PayloadView& view) {
+  for (size_t i = 0; i < view.size(); ++i) {
+    const auto key = view.key(i);
+    if ((key.equals("ok") || key.equals("status")) && !isTruthySuccess(view.value(i))) {
+      return true;
     }
   }
   return false;
 }
 
-void touchStateTimestamp(const String& stateName, uint32_t nowMs) {
+void touchStateTimestamp(app::espnow::codec::Span stateName, uint32_t nowMs) {
   for (auto& slot : stateTimestamps) {
     if (!slot.used) {
       continue;
     }
-    if (slot.state == stateName) {
+    if (stateName.equals(slot.state.c_str())) {
       slot.lastUpdateMs = nowMs;
       return;
     }
@@ -199,84 +582,99 @@ void touchStateTimestamp(const String& stateName, uint32_t nowMs) {
       continue;
     }
     slot.used = true;
-    slot.state = stateName;
+    slot.state = stateName.toString();
     slot.lastUpdateMs = nowMs;
     return;
   }
 
   stateTimestamps[0].used = true;
-  stateTimestamps[0].state = stateName;
+  stateTimestamps[0].state = stateName.toString();
   stateTimestamps[0].lastUpdateMs = nowMs;
 }
 
 }  // namespace
 
+bool load() {
+  StoreLock lock;
+  return ensureLoaded();
+}
+
 bool upsertFromStatePayload(const String& payload) {
   if (payload.isEmpty()) {
     return false;
   }
 
-  std::vector<Field> fields;
-  parseFields(payload, fields);
-  if (fields.empty()) {
+  const app::espnow::codec::PayloadView view(payload);
+  app::espnow::codec::Span stateName;
+  if (!view.get("state", stateName)) {
     return false;
   }
 
-  String stateName;
-  for (const auto& field : fields) {
-    if (field.key == "state") {
-      stateName = field.value;
-      break;
-    }
-  }
-
-  if (stateName.isEmpty()) {
-    return false;
-  }
-
-  if (shouldSkipUpdateByStatus(fields)) {
-    ESP_LOGI(TAG, "Skip upsert for state=%s due to failed ok/status", stateName.c_str());
+  if (shouldSkipUpdateByStatus(view)) {
+    ESP_LOGI(TAG, "Skip upsert for state=%.*s due to failed ok/status", stateName.size, stateName.data);
     return true;
   }
 
+  StoreLock lock;
   touchStateTimestamp(stateName, millis());
 
-  std::vector<Row> rows;
-  if (!loadRows(rows)) {
+  if (!ensureLoaded()) {
+    return false;
+  }
+
+  std::vector<uint8_t> journal;
+  const int stateId = internName(stateName, journal);
+  if (stateId < 0) {
     return false;
   }
 
-  bool changed = false;
-  for (const auto& field : fields) {
-    if (field.key == "state") {
+  for (size_t i = 0; i < view.size(); ++i) {
+    const auto key = view.key(i);
+    if (key.equals("state")) {
       continue;
     }
 
-    bool found = false;
-    for (auto& row : rows) {
-      if (row.state == stateName && row.key == field.key) {
-        if (row.value != field.value) {
-          row.value = field.value;
-          changed = true;
-        }
-        found = true;
-        break;
-      }
+    const int keyId = internName(key, journal);
+    if (keyId < 0) {
+      continue;
     }
 
-    if (!found) {
-      rows.push_back(Row{stateName, field.key, field.value});
-      changed = true;
+    const auto value = view.value(i);
+    Row* row = findRow(static_cast<uint16_t>(stateId), static_cast<uint16_t>(keyId));
+    if (row != nullptr && value.equals(row->value.c_str())) {
+      continue;
     }
+
+    setRowValue(static_cast<uint16_t>(stateId), static_cast<uint16_t>(keyId), value.toString());
+    appendValueRecord(journal, *findRow(static_cast<uint16_t>(stateId), static_cast<uint16_t>(keyId)));
+  }
+
+  if (journal.empty()) {
+    return true;
   }
 
-  if (!changed) {
+  // This runs on the ESP-NOW receive path, so the filesystem wait is bounded.
+  // Memory is already current; a skipped journal write is covered by
+  // rewriting the snapshot once the lock is free again.
+  core::fs::Lock fsLock(pdMS_TO_TICKS(MASTER_FS_LOCK_WAIT_MS));
+  if (!fsLock.held()) {
+    if (!compactPending) {
+      ESP_LOGW(TAG, "Filesystem busy, deferring state write");
+    }
+    compactPending = true;
     return true;
   }
+  if (compactPending) {
+    compactPending = !compact();
+    return !compactPending;
+  }
 
-  const bool saved = saveRows(rows);
+  const bool saved = appendJournal(journal);
   if (saved) {
-    ESP_LOGD(TAG, "Upserted latest state values for %s", stateName.c_str());
+    ESP_LOGD(TAG, "Upserted latest state values for %.*s", stateName.size, stateName.data);
+  } else {
+    // Later records may refer to intern ids this append carried.
+    compactPending = true;
   }
   return saved;
 }
@@ -287,19 +685,24 @@ bool getLatestValue(const String& state, const String& key, String& valueOut) {
     return false;
   }
 
-  std::vector<Row> rows;
-  if (!loadRows(rows)) {
+  StoreLock lock;
+  if (!ensureLoaded()) {
     return false;
   }
 
-  for (const auto& row : rows) {
-    if (row.state == state && row.key == key) {
-      valueOut = row.value;
-      return true;
-    }
+  const int stateId = findInternId(state);
+  const int keyId = stateId < 0 ? -1 : findInternId(key);
+  if (keyId < 0) {
+    return false;
   }
 
-  return false;
+  const Row* row = findRow(static_cast<uint16_t>(stateId), static_cast<uint16_t>(keyId));
+  if (row == nullptr) {
+    return false;
+  }
+
+  valueOut = row->value;
+  return true;
 }
 
 bool getLastUpdateMs(const String& state, uint32_t& lastUpdateMsOut) {
@@ -308,6 +711,7 @@ bool getLastUpdateMs(const String& state, uint32_t& lastUpdateMsOut) {
     return false;
   }
 
+  StoreLock lock;
   for (const auto& slot : stateTimestamps) {
     if (!slot.used) {
       continue;
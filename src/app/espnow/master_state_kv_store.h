@@ -4,6 +4,9 @@
 
 namespace app::espnow::state_store {
 
+// Loads the snapshot and journal once LittleFS is up; false while the
+// filesystem is not ready or its lock stays busy for MASTER_FS_LOCK_WAIT_MS.
+bool load();
 bool upsertFromStatePayload(const String& payload);
 bool getLatestValue(const String& state, const String& key, String& valueOut);
 bool getLastUpdateMs(const String& state, uint32_t& lastUpdateMsOut);
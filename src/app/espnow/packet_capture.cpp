@@ -0,0 +1,207 @@
+#include "packet_capture.h"
+
+#include "master_history_store.h"
+#include "core/boot.h"
+#include "core/fs_lock.h"
+
+#include <LittleFS.h>
+#include <app_config.h>
+#include <esp_heap_caps.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <cstring>
+
+namespace app::espnow::capture {
+namespace {
+
+static constexpr const char* TAG = "espnow_cap";
+static constexpr const char* CAPTURE_DIR = "/capture";
+static constexpr size_t RING_BYTES = MASTER_CAPTURE_RING_BYTES;
+static constexpr size_t MAX_RECORD_BYTES = sizeof(RecordHeader) + UINT8_MAX;
+
+static_assert(RING_BYTES >= 8 * MAX_RECORD_BYTES, "capture ring must hold several frames");
+
+uint8_t* ring = nullptr;
+size_t head = 0;
+size_t tail = 0;
+size_t used = 0;
+volatile bool enabled = false;
+bool dumping = false;
+int64_t lastRecordUs = 0;
+Stats stats;
+portMUX_TYPE ringLock = portMUX_INITIALIZER_UNLOCKED;
+
+// Caller holds ringLock.
+void copyIn(const void* data, size_t length) {
+  const size_t first = length < RING_BYTES - head ? length : RING_BYTES - head;
+  memcpy(ring + head, data, first);
+  memcpy(ring, static_cast<const uint8_t*>(data) + first, length - first);
+  head = (head + length) % RING_BYTES;
+}
+
+void copyOut(size_t offset, void* out, size_t length) {
+  const size_t first = length < RING_BYTES - offset ? length : RING_BYTES - offset;
+  memcpy(out, ring + offset, first);
+  memcpy(static_cast<uint8_t*>(out) + first, ring, length - first);
+}
+
+// Caller holds ringLock.
+void dropOldest() {
+  RecordHeader header;
+  copyOut(tail, &header, sizeof(header));
+  const size_t bytes = sizeof(header) + header.length;
+  tail = (tail + bytes) % RING_BYTES;
+  used -= bytes;
+  stats.records--;
+  stats.overwritten++;
+}
+
+void record(Direction direction, const uint8_t mac[6], int8_t rssi, const uint8_t* frame, size_t length) {
+  if (!enabled || mac == nullptr || frame == nullptr || length == 0) {
+    return;
+  }
+
+  RecordHeader header;
+  header.direction = static_cast<uint8_t>(direction);
+  header.rssi = rssi;
+  memcpy(header.mac, mac, sizeof(header.mac));
+  header.length = static_cast<uint8_t>(length > UINT8_MAX ? UINT8_MAX : length);
+  const size_t bytes = sizeof(header) + header.length;
+  const int64_t nowUs = esp_timer_get_time();
+
+  portENTER_CRITICAL(&ringLock);
+  if (ring == nullptr || !enabled) {
+    portEXIT_CRITICAL(&ringLock);
+    return;
+  }
+  if (dumping) {
+    stats.skipped++;
+    portEXIT_CRITICAL(&ringLock);
+    return;
+  }
+
+  const int64_t delta = lastRecordUs == 0 || nowUs < lastRecordUs ? 0 : nowUs - lastRecordUs;
+  header.deltaUs = delta > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(delta);
+  lastRecordUs = nowUs;
+  while (RING_BYTES - used < bytes) {
+    dropOldest();
+  }
+  copyIn(&header, sizeof(header));
+  copyIn(frame, header.length);
+  used += bytes;
+  stats.records++;
+  portEXIT_CRITICAL(&ringLock);
+}
+
+bool writeAll(File& file, const uint8_t* data, size_t length) {
+  return length == 0 || file.write(data, length) == length;
+}
+
+}  // namespace
+
+bool setEnabled(bool enable) {
+  if (enable && ring == nullptr) {
+    auto* buffer = static_cast<uint8_t*>(heap_caps_malloc(RING_BYTES, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+    if (buffer == nullptr) {
+      ESP_LOGE(TAG, "Cannot allocate %u byte capture ring", static_cast<unsigned>(RING_BYTES));
+      return false;
+    }
+    portENTER_CRITICAL(&ringLock);
+    ring = buffer;
+    portEXIT_CRITICAL(&ringLock);
+  }
+
+  enabled = enable;
+  ESP_LOGI(TAG, "Packet capture %s", enable ? "on" : "off");
+  return true;
+}
+
+bool isEnabled() {
+  return enabled;
+}
+
+void recordRx(const uint8_t mac[6], int8_t rssi, const uint8_t* frame, size_t length) {
+  record(Direction::Rx, mac, rssi, frame, length);
+}
+
+void recordTx(const uint8_t mac[6], const uint8_t* frame, size_t length) {
+  record(Direction::Tx, mac, 0, frame, length);
+}
+
+bool dump(char* pathOut, size_t pathSize) {
+  if (!core::boot::isFsReady()) {
+    return false;
+  }
+
+  portENTER_CRITICAL(&ringLock);
+  if (ring == nullptr || dumping) {
+    portEXIT_CRITICAL(&ringLock);
+    return false;
+  }
+  dumping = true;
+  const size_t start = tail;
+  const size_t bytes = used;
+  const uint32_t overwritten = stats.overwritten;
+  portEXIT_CRITICAL(&ringLock);
+
+  uint32_t epochSec = 0;
+  history::nowEpochSeconds(epochSec);
+  char path[48];
+  snprintf(path, sizeof(path), "%s/cap_%lu.encp", CAPTURE_DIR,
+           static_cast<unsigned long>(epochSec != 0 ? epochSec : millis()));
+
+  // Writers skip the ring while `dumping` is set, so it is read unlocked.
+  bool ok = false;
+  {
+    core::fs::Lock fsLock;
+    LittleFS.mkdir(CAPTURE_DIR);
+    File file = LittleFS.open(path, FILE_WRITE);
+    ok = static_cast<bool>(file);
+    if (ok) {
+      FileHeader header = {};
+      memcpy(header.magic, kMagic, sizeof(header.magic));
+      header.version = kVersion;
+      header.recordHeaderBytes = sizeof(RecordHeader);
+      header.dumpEpochSec = epochSec;
+      header.overwritten = overwritten;
+      const size_t first = bytes < RING_BYTES - start ? bytes : RING_BYTES - start;
+      ok = writeAll(file, reinterpret_cast<const uint8_t*>(&header), sizeof(header)) &&
+           writeAll(file, ring + start, first) && writeAll(file, ring, bytes - first);
+      file.close();
+    }
+  }
+
+  portENTER_CRITICAL(&ringLock);
+  if (ok) {
+    head = tail = used = 0;
+    lastRecordUs = 0;
+    stats.records = 0;
+    stats.overwritten = 0;
+    stats.dumps++;
+  }
+  dumping = false;
+  portEXIT_CRITICAL(&ringLock);
+
+  if (!ok) {
+    ESP_LOGW(TAG, "Capture dump to %s failed", path);
+    return false;
+  }
+
+  ESP_LOGI(TAG, "Capture dumped: %s (%u bytes)", path, static_cast<unsigned>(bytes + sizeof(FileHeader)));
+  if (pathOut != nullptr && pathSize > 0) {
+    strlcpy(pathOut, path, pathSize);
+  }
+  return true;
+}
+
+void getStats(Stats& out) {
+  portENTER_CRITICAL(&ringLock);
+  out = stats;
+  out.enabled = enabled;
+  out.ringBytes = ring != nullptr ? RING_BYTES : 0;
+  out.usedBytes = static_cast<uint32_t>(used);
+  portEXIT_CRITICAL(&ringLock);
+}
+
+}  // namespace app::espnow::capture
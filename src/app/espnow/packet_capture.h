@@ -0,0 +1,58 @@
+#pragma once
+
+#include <Arduino.h>
+
+namespace app::espnow::capture {
+
+// Capture file (.encp): FileHeader, then records oldest-first, each a
+// RecordHeader followed by `length` raw ESP-NOW frame bytes.
+static constexpr char kMagic[4] = {'E', 'N', 'C', 'P'};
+static constexpr uint8_t kVersion = 1;
+
+enum class Direction : uint8_t {
+  Rx = 0,
+  Tx = 1,
+};
+
+struct __attribute__((packed)) FileHeader {
+  char magic[4];
+  uint8_t version;
+  uint8_t reserved;
+  uint16_t recordHeaderBytes;
+  uint32_t dumpEpochSec;  // 0 when the clock was not set
+  uint32_t overwritten;   // records lost to ring wrap before the dump
+};
+
+struct __attribute__((packed)) RecordHeader {
+  uint32_t deltaUs;  // since the previous record, saturating
+  uint8_t direction;
+  int8_t rssi;       // 0 for Tx
+  uint8_t mac[6];    // source for Rx, destination for Tx
+  uint8_t length;
+};
+
+struct Stats {
+  bool enabled = false;
+  uint32_t ringBytes = 0;
+  uint32_t usedBytes = 0;
+  uint32_t records = 0;
+  uint32_t overwritten = 0;
+  uint32_t skipped = 0;  // arrived while a dump was writing
+  uint32_t dumps = 0;
+};
+
+// First enable allocates the MASTER_CAPTURE_RING_BYTES PSRAM ring.
+bool setEnabled(bool enabled);
+bool isEnabled();
+
+// RX callback / send path: one short critical section, never blocks;
+// the oldest records are overwritten when the ring is full.
+void recordRx(const uint8_t mac[6], int8_t rssi, const uint8_t* frame, size_t length);
+void recordTx(const uint8_t mac[6], const uint8_t* frame, size_t length);
+
+// Writes the ring to a new file under /capture (reachable over FTP) and
+// empties it. Capture pauses while the file is written.
+bool dump(char* pathOut, size_t pathSize);
+void getStats(Stats& out);
+
+}  // namespace app::espnow::capture
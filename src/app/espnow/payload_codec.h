@@ -1,11 +1,16 @@
 #pragma once
 
 #include <Arduino.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <initializer_list>
 
 namespace app::espnow::codec {
 
 static constexpr const char* kSeparator = "|---|";
+static constexpr size_t kSeparatorLength = 5;
+static constexpr size_t kMaxViewFields = 16;
 
 struct Field {
   const char* key;
@@ -57,4 +62,235 @@ inline bool getField(const String& source, const char* key, String& out) {
   return out.length() > 0;
 }
 
+// Non-owning slice of a payload buffer; not NUL-terminated.
+struct Span {
+  const char* data = nullptr;
+  uint16_t size = 0;
+
+  bool empty() const { return size == 0; }
+
+  bool equals(const char* text) const {
+    if (text == nullptr) {
+      return false;
+    }
+    const size_t length = strlen(text);
+    return length == size && (size == 0 || memcmp(data, text, size) == 0);
+  }
+
+  // Copies into `out` (always NUL-terminated); false if truncated.
+  bool copyTo(char* out, size_t capacity) const {
+    if (out == nullptr || capacity == 0) {
+      return false;
+    }
+    const size_t length = size < capacity ? size : capacity - 1;
+    if (length > 0) {
+      memcpy(out, data, length);
+    }
+    out[length] = '\0';
+    return length == size;
+  }
+
+  bool toLong(long& out) const {
+    char text[24];
+    if (empty() || !copyTo(text, sizeof(text))) {
+      return false;
+    }
+    char* end = nullptr;
+    out = strtol(text, &end, 10);
+    return end != text;
+  }
+
+  bool toULong(unsigned long& out) const {
+    char text[24];
+    if (empty() || !copyTo(text, sizeof(text))) {
+      return false;
+    }
+    char* end = nullptr;
+    out = strtoul(text, &end, 10);
+    return end != text;
+  }
+
+  bool toFloat(float& out) const {
+    char text[24];
+    if (empty() || !copyTo(text, sizeof(text))) {
+      return false;
+    }
+    char* end = nullptr;
+    out = strtof(text, &end);
+    return end != text;
+  }
+
+  String toString() const { return empty() ? String() : String(data, size); }
+};
+
+inline Span toSpan(const String& text) {
+  return Span{text.c_str(), static_cast<uint16_t>(text.length())};
+}
+
+// Tokenises a `key=value|---|...` payload once into spans over the caller's
+// buffer, which must outlive the view. Keys and values are trimmed; fields
+// past kMaxViewFields are dropped.
+class PayloadView {
+ public:
+  PayloadView(const char* text, size_t length) { parse(text, length); }
+  explicit PayloadView(const char* text) { parse(text, text == nullptr ? 0 : strlen(text)); }
+  explicit PayloadView(const String& text) { parse(text.c_str(), text.length()); }
+
+  size_t size() const { return count; }
+  Span key(size_t index) const { return index < count ? keys[index] : Span{}; }
+  Span value(size_t index) const { return index < count ? values[index] : Span{}; }
+
+  // Same contract as getField(): first match, false when missing or empty.
+  bool get(const char* name, Span& out) const {
+    out = Span{};
+    for (size_t i = 0; i < count; ++i) {
+      if (keys[i].equals(name)) {
+        out = values[i];
+        return !out.empty();
+      }
+    }
+    return false;
+  }
+
+  bool is(const char* name, const char* expected) const {
+    Span found;
+    return get(name, found) && found.equals(expected);
+  }
+
+ private:
+  static bool isTrimmed(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+  static Span trimmed(const char* begin, const char* end) {
+    while (begin < end && isTrimmed(*begin)) {
+      ++begin;
+    }
+    while (end > begin && isTrimmed(*(end - 1))) {
+      --end;
+    }
+    return Span{begin, static_cast<uint16_t>(end - begin)};
+  }
+
+  void parse(const char* text, size_t length) {
+    count = 0;
+    if (text == nullptr) {
+      return;
+    }
+
+    const char* cursor = text;
+    const char* const end = text + length;
+    while (cursor < end && count < kMaxViewFields) {
+      const char* tokenEnd = cursor;
+      while (tokenEnd < end && !(static_cast<size_t>(end - tokenEnd) >= kSeparatorLength
+                                 && memcmp(tokenEnd, kSeparator, kSeparatorLength) == 0)) {
+        ++tokenEnd;
+      }
+
+      const char* equals = static_cast<const char*>(memchr(cursor, '=', tokenEnd - cursor));
+      if (equals != nullptr) {
+        const Span key = trimmed(cursor, equals);
+        if (!key.empty()) {
+          keys[count] = key;
+          values[count] = trimmed(equals + 1, tokenEnd);
+          ++count;
+        }
+      }
+
+      if (tokenEnd == end) {
+        break;
+      }
+      cursor = tokenEnd + kSeparatorLength;
+    }
+  }
+
+  Span keys[kMaxViewFields];
+  Span values[kMaxViewFields];
+  size_t count = 0;
+};
+
+// Formats a payload into a caller-provided buffer. Empty values are skipped
+// like buildPayload(); overflow truncates at a field boundary and clears ok().
+class PayloadWriter {
+ public:
+  PayloadWriter(char* buffer, size_t capacity) : buffer(buffer), capacity(capacity) {
+    if (buffer != nullptr && capacity > 0) {
+      buffer[0] = '\0';
+    } else {
+      overflow = true;
+    }
+  }
+
+  PayloadWriter& add(const char* key, const char* value, size_t valueLength) {
+    if (key == nullptr || value == nullptr || valueLength == 0 || overflow) {
+      return *this;
+    }
+
+    const size_t keyLength = strlen(key);
+    const size_t separatorLength = length == 0 ? 0 : kSeparatorLength;
+    const size_t needed = separatorLength + keyLength + 1 + valueLength;
+    if (length + needed >= capacity) {
+      overflow = true;
+      return *this;
+    }
+
+    char* out = buffer + length;
+    if (separatorLength > 0) {
+      memcpy(out, kSeparator, separatorLength);
+      out += separatorLength;
+    }
+    memcpy(out, key, keyLength);
+    out += keyLength;
+    *out++ = '=';
+    memcpy(out, value, valueLength);
+    length += needed;
+    buffer[length] = '\0';
+    return *this;
+  }
+
+  PayloadWriter& add(const char* key, const char* value) {
+    return add(key, value, value == nullptr ? 0 : strlen(value));
+  }
+
+  PayloadWriter& add(const char* key, Span value) { return add(key, value.data, value.size); }
+
+  PayloadWriter& add(const char* key, long value) {
+    char text[24];
+    const int written = snprintf(text, sizeof(text), "%ld", value);
+    return add(key, text, written > 0 ? static_cast<size_t>(written) : 0);
+  }
+
+  PayloadWriter& add(const char* key, unsigned long value) {
+    char text[24];
+    const int written = snprintf(text, sizeof(text), "%lu", value);
+    return add(key, text, written > 0 ? static_cast<size_t>(written) : 0);
+  }
+
+  PayloadWriter& add(const char* key, int value) { return add(key, static_cast<long>(value)); }
+  PayloadWriter& add(const char* key, unsigned value) { return add(key, static_cast<unsigned long>(value)); }
+
+  // Fixed-point tenths (e.g. temperature10) without going through float;
+  // `suffix` is appended verbatim.
+  PayloadWriter& addTenths(const char* key, long tenths, const char* suffix = "") {
+    char text[32];
+    const unsigned long magnitude = static_cast<unsigned long>(tenths < 0 ? -tenths : tenths);
+    const int written = snprintf(text,
+                                 sizeof(text),
+                                 "%s%lu.%lu%s",
+                                 tenths < 0 ? "-" : "",
+                                 magnitude / 10,
+                                 magnitude % 10,
+                                 suffix == nullptr ? "" : suffix);
+    return add(key, text, written > 0 ? static_cast<size_t>(written) : 0);
+  }
+
+  const char* c_str() const { return buffer; }
+  size_t size() const { return length; }
+  bool ok() const { return !overflow; }
+
+ private:
+  char* buffer;
+  size_t capacity;
+  size_t length = 0;
+  bool overflow = false;
+};
+
 }  // namespace app::espnow::codec
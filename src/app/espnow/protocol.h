@@ -9,6 +9,7 @@ enum class PacketType : uint8_t {
   HEARTBEAT = 2,
   COMMAND = 3,
   STATE = 4,
+  BATCH = 5,
 };
 
 static constexpr uint8_t PROTOCOL_VERSION = 1;
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "state_binary.h"
+
+#include <cstring>
+
+namespace app::espnow::proxy_chunks {
+
+// An empty body still produces one (empty) chunk carrying ok/code.
+inline size_t count(size_t bodyLength) {
+  return bodyLength == 0 ? 1 : (bodyLength + state_binary::kProxyChunkDataBytes - 1) / state_binary::kProxyChunkDataBytes;
+}
+
+// Builds chunk `index` (0-based) of `body` straight from the caller's bytes.
+inline void fill(state_binary::ProxyRespChunkCommand& command,
+                 uint16_t requestId,
+                 size_t index,
+                 size_t total,
+                 uint8_t ok,
+                 int16_t code,
+                 const char* body,
+                 size_t bodyLength) {
+  memset(&command, 0, sizeof(command));
+  state_binary::initHeader(command.header, state_binary::Type::ProxyRespChunk);
+  command.requestId = requestId;
+  command.idx = static_cast<uint16_t>(index + 1);
+  command.total = static_cast<uint16_t>(total);
+  command.ok = ok;
+  command.code = code;
+
+  const size_t offset = index * state_binary::kProxyChunkDataBytes;
+  if (body != nullptr && offset < bodyLength) {
+    const size_t remaining = bodyLength - offset;
+    command.dataLen = static_cast<uint8_t>(remaining < state_binary::kProxyChunkDataBytes ? remaining : state_binary::kProxyChunkDataBytes);
+    memcpy(command.data, body + offset, command.dataLen);
+  }
+}
+
+}  // namespace app::espnow::proxy_chunks
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Arduino.h>
+#include <cstddef>
 
 namespace app::espnow::state_binary {
 
@@ -32,6 +33,7 @@ enum Feature : uint32_t {
   FeatureCameraJpeg = 1UL << 4,
   FeatureCameraStream = 1UL << 5,
   FeatureControlBasic = 1UL << 6,
+  FeatureBatchFrames = 1UL << 7,
 };
 
 enum class HttpMethod : uint8_t {
@@ -113,17 +115,25 @@ struct __attribute__((packed)) CameraChunkState {
   uint8_t data[kCameraChunkDataBytes];
 };
 
+// v1 senders stop after `reserved` (16-bit byte sum of the JPEG, 0 = none);
+// v2 adds `crc32`, the CRC-32 of the JPEG, which the master checks instead.
 struct __attribute__((packed)) CameraFrameEndState {
   Header header;
   uint32_t frameId;
   uint32_t totalBytes;
   uint16_t totalChunks;
   uint16_t reserved;
+  uint32_t crc32;
 };
 
+static constexpr size_t kCameraFrameEndV1Size = offsetof(CameraFrameEndState, crc32);
+
 enum class CameraControlAction : uint8_t {
   CaptureOnce = 1,
   SetStreaming = 2,
+  SetQuality = 3,
+  SetFrameSize = 4,
+  SetTargetFps = 5,
 };
 
 struct __attribute__((packed)) CameraControlCommand {
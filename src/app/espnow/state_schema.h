@@ -0,0 +1,314 @@
+#pragma once
+
+#include "payload_codec.h"
+#include "protocol.h"
+#include "state_binary.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+// Single description of every state_binary message: validation, dispatch
+// tables and the legacy text rendering are all derived from kSchemas.
+// Adding a message type = struct in state_binary.h + one row here + its
+// ingest handler in master_state_handler.cpp (a static_assert there fails
+// the build for an inbound type without one).
+namespace app::espnow::state_schema {
+
+using state_binary::Type;
+
+enum class Direction : uint8_t {
+  SlaveToMaster,
+  MasterToSlave,
+};
+
+enum class Verification : uint8_t {
+  RequireVerified,  // dropped until the sender's identity is known
+  Bootstrap,        // accepted from unverified senders (proxy_req, features)
+  Identifies,       // carries the identity that verifies the sender
+};
+
+enum class FieldKind : uint8_t {
+  U8,
+  U16,
+  U32,
+  I16,
+  Tenths16,   // int16 fixed point, rendered as "x.y" + suffix
+  UTenths16,  // uint16 fixed point, rendered as "x.y" + suffix
+  Chars,      // NUL-padded char array
+  HttpMethod,
+  Literal,    // constant text, no payload bytes
+};
+
+struct FieldSpec {
+  const char* key;
+  FieldKind kind;
+  uint16_t offset;
+  uint16_t size;
+  const char* text;  // unit suffix for tenths, value for Literal
+};
+
+struct Schema {
+  Type type;
+  const char* stateName;
+  uint16_t size;
+  Direction direction;
+  uint32_t requiredFeature;  // any of these bits; 0 = always allowed
+  Verification verification;
+  const FieldSpec* fields;
+  uint8_t fieldCount;
+  uint16_t minSize;  // older, shorter revisions still accepted; equals size otherwise
+};
+
+#define STATE_SCHEMA_FIELD(Struct, member, key, kind, text) \
+  FieldSpec { key, FieldKind::kind, static_cast<uint16_t>(offsetof(Struct, member)), sizeof(Struct::member), text }
+
+namespace fields {
+
+using namespace state_binary;
+
+inline constexpr FieldSpec kIdentity[] = {
+    STATE_SCHEMA_FIELD(IdentityState, id, "id", Chars, nullptr),
+};
+
+inline constexpr FieldSpec kSensor[] = {
+    STATE_SCHEMA_FIELD(SensorState, temperature10, "temp", Tenths16, "C"),
+    STATE_SCHEMA_FIELD(SensorState, humidity10, "hum", UTenths16, "%"),
+};
+
+inline constexpr FieldSpec kProxyReq[] = {
+    STATE_SCHEMA_FIELD(ProxyReqState, method, "method", HttpMethod, nullptr),
+    STATE_SCHEMA_FIELD(ProxyReqState, url, "url", Chars, nullptr),
+    FieldSpec{"payload", FieldKind::Literal, 0, 0, "{}"},
+};
+
+inline constexpr FieldSpec kWeather[] = {
+    STATE_SCHEMA_FIELD(WeatherState, ok, "ok", U8, nullptr),
+    STATE_SCHEMA_FIELD(WeatherState, code, "code", I16, nullptr),
+    STATE_SCHEMA_FIELD(WeatherState, time, "time", Chars, nullptr),
+    STATE_SCHEMA_FIELD(WeatherState, temperature10, "temperature", Tenths16, ""),
+    STATE_SCHEMA_FIELD(WeatherState, windspeed10, "windspeed", Tenths16, ""),
+    STATE_SCHEMA_FIELD(WeatherState, winddirection, "winddirection", U16, nullptr),
+};
+
+inline constexpr FieldSpec kFeatures[] = {
+    STATE_SCHEMA_FIELD(FeaturesState, featureBits, "bits", U32, nullptr),
+    STATE_SCHEMA_FIELD(FeaturesState, contractVersion, "contract", U16, nullptr),
+};
+
+inline constexpr FieldSpec kCameraMeta[] = {
+    STATE_SCHEMA_FIELD(CameraMetaState, frameId, "frame", U32, nullptr),
+    STATE_SCHEMA_FIELD(CameraMetaState, totalBytes, "bytes", U32, nullptr),
+    STATE_SCHEMA_FIELD(CameraMetaState, totalChunks, "chunks", U16, nullptr),
+    STATE_SCHEMA_FIELD(CameraMetaState, width, "w", U16, nullptr),
+    STATE_SCHEMA_FIELD(CameraMetaState, height, "h", U16, nullptr),
+};
+
+inline constexpr FieldSpec kCameraChunk[] = {
+    STATE_SCHEMA_FIELD(CameraChunkState, frameId, "frame", U32, nullptr),
+    STATE_SCHEMA_FIELD(CameraChunkState, idx, "idx", U16, nullptr),
+    STATE_SCHEMA_FIELD(CameraChunkState, total, "total", U16, nullptr),
+};
+
+inline constexpr FieldSpec kCameraFrameEnd[] = {
+    STATE_SCHEMA_FIELD(CameraFrameEndState, frameId, "frame", U32, nullptr),
+    STATE_SCHEMA_FIELD(CameraFrameEndState, totalBytes, "bytes", U32, nullptr),
+    STATE_SCHEMA_FIELD(CameraFrameEndState, totalChunks, "chunks", U16, nullptr),
+};
+
+}  // namespace fields
+
+#undef STATE_SCHEMA_FIELD
+
+static constexpr uint32_t kCameraFeatures = state_binary::FeatureCameraJpeg | state_binary::FeatureCameraStream;
+
+template <typename T, size_t N>
+constexpr Schema inbound(Type type,
+                         const char* stateName,
+                         uint32_t requiredFeature,
+                         Verification verification,
+                         const FieldSpec (&fieldList)[N]) {
+  return Schema{type, stateName, sizeof(T), Direction::SlaveToMaster, requiredFeature, verification, fieldList, N, sizeof(T)};
+}
+
+template <typename T>
+constexpr Schema inbound(Type type, const char* stateName, uint32_t requiredFeature, Verification verification) {
+  return Schema{type, stateName, sizeof(T), Direction::SlaveToMaster, requiredFeature, verification, nullptr, 0, sizeof(T)};
+}
+
+template <typename T>
+constexpr Schema outbound(Type type, const char* stateName, uint32_t requiredFeature) {
+  return Schema{type, stateName, sizeof(T), Direction::MasterToSlave, requiredFeature, Verification::RequireVerified, nullptr, 0, sizeof(T)};
+}
+
+// Also accept payloads truncated to `minSize` (fields appended in a later
+// revision); the dispatcher zero-fills the missing tail.
+constexpr Schema acceptsShorter(Schema schema, size_t minSize) {
+  schema.minSize = static_cast<uint16_t>(minSize);
+  return schema;
+}
+
+inline constexpr Schema kSchemas[] = {
+    inbound<state_binary::IdentityState>(Type::Identity, "identity", 0, Verification::Identifies, fields::kIdentity),
+    inbound<state_binary::SensorState>(Type::Sensor, "sensor", state_binary::FeatureSensor, Verification::RequireVerified, fields::kSensor),
+    inbound<state_binary::ProxyReqState>(Type::ProxyReq, "proxy_req", state_binary::FeatureProxyClient, Verification::Bootstrap, fields::kProxyReq),
+    inbound<state_binary::WeatherState>(Type::Weather, "weather", state_binary::FeatureWeather, Verification::RequireVerified, fields::kWeather),
+    inbound<state_binary::SlaveAliveState>(Type::SlaveAlive, "slave_alive", 0, Verification::RequireVerified),
+    inbound<state_binary::FeaturesState>(Type::Features, "features", 0, Verification::Bootstrap, fields::kFeatures),
+    inbound<state_binary::CameraMetaState>(Type::CameraMeta, "camera", kCameraFeatures, Verification::RequireVerified, fields::kCameraMeta),
+    inbound<state_binary::CameraChunkState>(Type::CameraChunk, "camera_chunk", kCameraFeatures, Verification::RequireVerified, fields::kCameraChunk),
+    acceptsShorter(inbound<state_binary::CameraFrameEndState>(Type::CameraFrameEnd, "camera_end", kCameraFeatures, Verification::RequireVerified, fields::kCameraFrameEnd),
+                   state_binary::kCameraFrameEndV1Size),
+    outbound<state_binary::MasterNetState>(Type::MasterNet, "master_net", 0),
+    outbound<state_binary::ProxyRespChunkCommand>(Type::ProxyRespChunk, "proxy_resp_chunk", state_binary::FeatureProxyClient),
+    outbound<state_binary::WeatherSyncReqCommand>(Type::WeatherSyncReq, "weather_sync_req", state_binary::FeatureWeather),
+    outbound<state_binary::IdentityReqCommand>(Type::IdentityReq, "identity_req", state_binary::FeatureIdentity),
+    outbound<state_binary::CameraControlCommand>(Type::CameraControl, "camera_control", kCameraFeatures),
+};
+
+inline constexpr size_t kSchemaCount = sizeof(kSchemas) / sizeof(kSchemas[0]);
+static constexpr uint8_t kNoSchema = 0xFF;
+
+constexpr bool schemasFitFrame() {
+  for (const auto& schema : kSchemas) {
+    if (schema.size > MAX_PAYLOAD_SIZE || schema.minSize < sizeof(state_binary::Header) || schema.minSize > schema.size) {
+      return false;
+    }
+  }
+  return true;
+}
+
+constexpr bool schemaIdsUnique() {
+  for (size_t i = 0; i < kSchemaCount; ++i) {
+    for (size_t j = i + 1; j < kSchemaCount; ++j) {
+      if (kSchemas[i].type == kSchemas[j].type) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+constexpr bool fieldsInsideStructs() {
+  for (const auto& schema : kSchemas) {
+    for (size_t i = 0; i < schema.fieldCount; ++i) {
+      const FieldSpec& field = schema.fields[i];
+      if (field.kind != FieldKind::Literal && field.offset + field.size > schema.minSize) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+static_assert(schemasFitFrame(), "state_binary message does not fit Frame::payload (MAX_PAYLOAD_SIZE)");
+static_assert(schemaIdsUnique(), "duplicate state_binary::Type in kSchemas");
+static_assert(fieldsInsideStructs(), "text field outside its message struct");
+static_assert(kSchemaCount < kNoSchema, "schema index does not fit uint8_t");
+
+// Type id -> index into kSchemas, built at compile time.
+constexpr std::array<uint8_t, 256> buildSchemaIndex() {
+  std::array<uint8_t, 256> index{};
+  for (auto& slot : index) {
+    slot = kNoSchema;
+  }
+  for (size_t i = 0; i < kSchemaCount; ++i) {
+    index[static_cast<uint8_t>(kSchemas[i].type)] = static_cast<uint8_t>(i);
+  }
+  return index;
+}
+
+inline constexpr std::array<uint8_t, 256> kSchemaIndex = buildSchemaIndex();
+
+constexpr const Schema* find(Type type) {
+  const uint8_t slot = kSchemaIndex[static_cast<uint8_t>(type)];
+  return slot == kNoSchema ? nullptr : &kSchemas[slot];
+}
+
+inline const Schema* findByStateName(codec::Span stateName) {
+  for (const auto& schema : kSchemas) {
+    if (stateName.equals(schema.stateName)) {
+      return &schema;
+    }
+  }
+  return nullptr;
+}
+
+// Header, known type and a size between minSize and size; nullptr when the
+// payload is not valid.
+inline const Schema* validate(const uint8_t* payload, size_t payloadSize, Direction direction = Direction::SlaveToMaster) {
+  if (!state_binary::hasValidHeader(payload, payloadSize)) {
+    return nullptr;
+  }
+
+  const Schema* schema = find(static_cast<Type>(reinterpret_cast<const state_binary::Header*>(payload)->type));
+  if (schema == nullptr || payloadSize < schema->minSize || payloadSize > schema->size || schema->direction != direction) {
+    return nullptr;
+  }
+  return schema;
+}
+
+inline void renderField(const FieldSpec& field, const uint8_t* payload, codec::PayloadWriter& writer) {
+  const uint8_t* source = payload + field.offset;
+  switch (field.kind) {
+    case FieldKind::U8:
+      writer.add(field.key, static_cast<unsigned>(source[0]));
+      break;
+    case FieldKind::U16: {
+      uint16_t value = 0;
+      memcpy(&value, source, sizeof(value));
+      writer.add(field.key, static_cast<unsigned>(value));
+      break;
+    }
+    case FieldKind::U32: {
+      uint32_t value = 0;
+      memcpy(&value, source, sizeof(value));
+      writer.add(field.key, static_cast<unsigned long>(value));
+      break;
+    }
+    case FieldKind::I16: {
+      int16_t value = 0;
+      memcpy(&value, source, sizeof(value));
+      writer.add(field.key, static_cast<int>(value));
+      break;
+    }
+    case FieldKind::Tenths16: {
+      int16_t value = 0;
+      memcpy(&value, source, sizeof(value));
+      writer.addTenths(field.key, value, field.text);
+      break;
+    }
+    case FieldKind::UTenths16: {
+      uint16_t value = 0;
+      memcpy(&value, source, sizeof(value));
+      writer.addTenths(field.key, value, field.text);
+      break;
+    }
+    case FieldKind::Chars:
+      writer.add(field.key, reinterpret_cast<const char*>(source), strnlen(reinterpret_cast<const char*>(source), field.size));
+      break;
+    case FieldKind::HttpMethod: {
+      const char* method = "GET";
+      if (source[0] == static_cast<uint8_t>(state_binary::HttpMethod::Post)) {
+        method = "POST";
+      } else if (source[0] == static_cast<uint8_t>(state_binary::HttpMethod::Patch)) {
+        method = "PATCH";
+      }
+      writer.add(field.key, method);
+      break;
+    }
+    case FieldKind::Literal:
+      writer.add(field.key, field.text);
+      break;
+  }
+}
+
+// `state=<name>|---|...` text form consumed by the state store, UI and proxy.
+inline void renderText(const Schema& schema, const uint8_t* payload, codec::PayloadWriter& writer) {
+  writer.add("state", schema.stateName);
+  for (size_t i = 0; i < schema.fieldCount; ++i) {
+    renderField(schema.fields[i], payload, writer);
+  }
+}
+
+}  // namespace app::espnow::state_schema
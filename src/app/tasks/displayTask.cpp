@@ -1,6 +1,7 @@
 #include "displayTask.h"
 
 #include "app/display/display_interface.h"
+#include "core/task_topology.h"
 
 #include <esp_log.h>
 #include <freertos/FreeRTOS.h>
@@ -11,8 +12,6 @@ namespace app::tasks {
 namespace {
 
 static constexpr const char* TAG = "DISPLAY_TASK";
-static constexpr uint16_t DISPLAY_TASK_STACK = 6144;
-static constexpr UBaseType_t DISPLAY_TASK_PRIORITY = 1;
 
 TaskHandle_t displayTaskHandle = nullptr;
 
@@ -24,7 +23,8 @@ void displayTaskRunner(void*) {
 
   while (true) {
     app::display::displayInterface.loop();
-    vTaskDelay(pdMS_TO_TICKS(20));
+    // Woken early by the boot frame timer; otherwise a plain 20 ms tick.
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(20));
   }
 }
 
@@ -35,14 +35,7 @@ bool startDisplayTask() {
     return true;
   }
 
-  BaseType_t created = xTaskCreatePinnedToCore(
-      displayTaskRunner,
-      "display_task",
-      DISPLAY_TASK_STACK,
-      nullptr,
-      DISPLAY_TASK_PRIORITY,
-      &displayTaskHandle,
-      tskNO_AFFINITY);
+  BaseType_t created = core::topology::createTask(core::topology::Task::Display, displayTaskRunner, nullptr, &displayTaskHandle);
 
   if (created != pdPASS) {
     ESP_LOGE(TAG, "Failed to start display task");
@@ -0,0 +1,150 @@
+#include "ftpTask.h"
+
+#include "core/boot.h"
+#include "core/fs_lock.h"
+#include "core/task_topology.h"
+
+#include <app_config.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <FTPServer.h>
+#include <LittleFS.h>
+
+namespace app::tasks {
+
+namespace {
+
+static constexpr const char* TAG = "FTP_TASK";
+
+TaskHandle_t ftpTaskHandle = nullptr;
+FTPServer ftpServer(LittleFS);
+
+portMUX_TYPE statsLock = portMUX_INITIALIZER_UNLOCKED;
+bool wanted = MASTER_FTP_AT_BOOT != 0;
+FtpStats stats;
+uint32_t sessionStartMs = 0;
+
+bool isWanted() {
+  portENTER_CRITICAL(&statsLock);
+  const bool value = wanted;
+  portEXIT_CRITICAL(&statsLock);
+  return value;
+}
+
+void startSession() {
+  ftpServer.begin(FTP_USER, FTP_PASS);
+
+  portENTER_CRITICAL(&statsLock);
+  const uint32_t sessions = stats.sessions + 1;
+  stats = FtpStats{};
+  stats.enabled = true;
+  stats.sessions = sessions;
+  sessionStartMs = millis();
+  portEXIT_CRITICAL(&statsLock);
+
+  ESP_LOGI(TAG, "FTP server started");
+}
+
+void stopSession() {
+  ftpServer.stop();
+
+  portENTER_CRITICAL(&statsLock);
+  stats.enabled = false;
+  stats.sessionMs = millis() - sessionStartMs;
+  const FtpStats snapshot = stats;
+  portEXIT_CRITICAL(&statsLock);
+
+  ESP_LOGI(TAG, "FTP server stopped after %lu ms: %lu polls, busy %lu ms, max poll %lu us, max lock wait %lu us",
+           static_cast<unsigned long>(snapshot.sessionMs), static_cast<unsigned long>(snapshot.polls),
+           static_cast<unsigned long>(snapshot.busyUs / 1000ULL), static_cast<unsigned long>(snapshot.maxPollUs),
+           static_cast<unsigned long>(snapshot.lockWaitMaxUs));
+}
+
+void poll() {
+  const int64_t waitStartUs = esp_timer_get_time();
+  core::fs::Lock fsLock;
+  const int64_t startUs = esp_timer_get_time();
+  ftpServer.handleFTP();
+  const int64_t endUs = esp_timer_get_time();
+
+  const uint32_t waitUs = static_cast<uint32_t>(startUs - waitStartUs);
+  const uint32_t pollUs = static_cast<uint32_t>(endUs - startUs);
+  portENTER_CRITICAL(&statsLock);
+  stats.polls++;
+  stats.busyUs += pollUs;
+  if (pollUs > stats.maxPollUs) {
+    stats.maxPollUs = pollUs;
+  }
+  if (waitUs > stats.lockWaitMaxUs) {
+    stats.lockWaitMaxUs = waitUs;
+  }
+  portEXIT_CRITICAL(&statsLock);
+}
+
+void ftpTaskRunner(void*) {
+  core::boot::waitFor(core::boot::FsReady, portMAX_DELAY);
+
+  bool running = false;
+  while (true) {
+    const bool enable = isWanted();
+    if (enable && !running) {
+      startSession();
+      running = true;
+    } else if (!enable && running) {
+      stopSession();
+      running = false;
+    }
+
+    if (!running) {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      continue;
+    }
+
+    poll();
+    vTaskDelay(pdMS_TO_TICKS(MASTER_FTP_POLL_MS));
+  }
+}
+
+}  // namespace
+
+bool startFtpTask() {
+  if (ftpTaskHandle != nullptr) {
+    return true;
+  }
+
+  BaseType_t created = core::topology::createTask(core::topology::Task::Ftp, ftpTaskRunner, nullptr, &ftpTaskHandle);
+
+  if (created != pdPASS) {
+    ESP_LOGE(TAG, "Failed to start FTP task");
+    ftpTaskHandle = nullptr;
+    return false;
+  }
+
+  ESP_LOGI(TAG, "FTP task started (%s)", MASTER_FTP_AT_BOOT ? "enabled" : "on demand");
+  return true;
+}
+
+bool setFtpEnabled(bool enabled) {
+  portENTER_CRITICAL(&statsLock);
+  wanted = enabled;
+  portEXIT_CRITICAL(&statsLock);
+
+  if (ftpTaskHandle == nullptr) {
+    return false;
+  }
+  xTaskNotifyGive(ftpTaskHandle);
+  return true;
+}
+
+void getFtpStats(FtpStats& out) {
+  portENTER_CRITICAL(&statsLock);
+  out = stats;
+  if (stats.enabled) {
+    out.sessionMs = millis() - sessionStartMs;
+  }
+  portEXIT_CRITICAL(&statsLock);
+}
+
+}  // namespace app::tasks
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <Arduino.h>
+
+namespace app::tasks {
+
+// Accounting for the current FTP session, or the last one once stopped.
+// The FTP library exposes no byte counters, so this is time-based.
+struct FtpStats {
+  bool enabled = false;
+  uint32_t sessions = 0;
+  uint32_t sessionMs = 0;
+  uint32_t polls = 0;
+  uint64_t busyUs = 0;  // inside handleFTP()
+  uint32_t maxPollUs = 0;
+  uint32_t lockWaitMaxUs = 0;  // waiting for the LittleFS lock
+};
+
+// Starts the worker; it waits for LittleFS before serving anything.
+bool startFtpTask();
+
+// Starts or stops the server. While stopped the worker sleeps.
+bool setFtpEnabled(bool enabled);
+void getFtpStats(FtpStats& out);
+
+}  // namespace app::tasks
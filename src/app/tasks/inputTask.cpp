@@ -6,6 +6,7 @@
 #include "app/input/battery/battery_manager.h"
 #include "app/input/button/input_manager.h"
 #include "app/input/joystick/joystick_manager.h"
+#include "core/task_topology.h"
 
 #include <app_config.h>
 #include <esp_log.h>
@@ -17,8 +18,6 @@ namespace app::tasks {
 namespace {
 
 static constexpr const char* TAG = "INPUT_TASK";
-static constexpr uint16_t INPUT_TASK_STACK = 4096;
-static constexpr UBaseType_t INPUT_TASK_PRIORITY = 1;
 static constexpr uint32_t INPUT_POLL_INTERVAL_MS = 20;
 static constexpr uint32_t BATTERY_PUBLISH_INTERVAL_MS = 1000;
 
@@ -31,6 +30,7 @@ uint32_t lastBatteryPublishMs = 0;
 int lastPublishedBatteryLevel = -1;
 bool l3PrevPressed = false;
 bool r3PrevPressed = false;
+bool stickChordUsed = false;
 
 void emitVirtualButtonPress(uint8_t index) {
   app::display::displayInterface.setButtonState(index, true);
@@ -41,14 +41,25 @@ void handleStickButtonShortcuts() {
   const bool l3Pressed = joystickManager.getJoystickCount() > 0 ? joystickManager.isSwitchPressed(0) : false;
   const bool r3Pressed = joystickManager.getJoystickCount() > 1 ? joystickManager.isSwitchPressed(1) : false;
 
-  if (l3Pressed && !l3PrevPressed) {
+  // L3+R3 together toggles the profiler overlay; single clicks fire on release
+  // so the chord can swallow them.
+  if (l3Pressed && r3Pressed && !stickChordUsed) {
+    stickChordUsed = true;
+    app::display::displayInterface.toggleProfilerOverlay();
+  }
+
+  if (!l3Pressed && l3PrevPressed && !stickChordUsed) {
     emitVirtualButtonPress(3);  // BACK
   }
 
-  if (r3Pressed && !r3PrevPressed) {
+  if (!r3Pressed && r3PrevPressed && !stickChordUsed) {
     emitVirtualButtonPress(2);  // SELECT
   }
 
+  if (!l3Pressed && !r3Pressed) {
+    stickChordUsed = false;
+  }
+
   l3PrevPressed = l3Pressed;
   r3PrevPressed = r3Pressed;
 }
@@ -136,14 +147,7 @@ bool startInputTask() {
     return true;
   }
 
-  BaseType_t created = xTaskCreatePinnedToCore(
-      inputTaskRunner,
-      "input_task",
-      INPUT_TASK_STACK,
-      nullptr,
-      INPUT_TASK_PRIORITY,
-      &inputTaskHandle,
-      tskNO_AFFINITY);
+  BaseType_t created = core::topology::createTask(core::topology::Task::Input, inputTaskRunner, nullptr, &inputTaskHandle);
 
   if (created != pdPASS) {
     ESP_LOGE(TAG, "Failed to start input task");
@@ -1,95 +1,237 @@
 #include "networkTask.h"
+#include "ftpTask.h"
 
+#include "app/espnow/camera_http_server.h"
+#include "app/espnow/camera_rate_controller.h"
+#include "app/espnow/camera_stream_buffer.h"
 #include "app/espnow/master.h"
+#include "app/espnow/master_history_store.h"
+#include "app/espnow/master_http_proxy.h"
+#include "app/espnow/master_state_kv_store.h"
+#include "core/boot.h"
+#include "core/reactor.h"
+#include "core/task_topology.h"
+#include "core/time_sync.h"
+#include "core/weather_sync.h"
 #include "WiFiManager.h"
-#include <SimpleNTP.h>
 
 #include <Arduino.h>
 #include <WiFi.h>
 #include <app_config.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
-#include <FTPServer.h>
-#include <LittleFS.h>
 
 namespace app::tasks {
 
 namespace {
 
-static constexpr uint16_t NETWORK_TASK_STACK = 8192;
-static constexpr UBaseType_t NETWORK_TASK_PRIORITY = 2;
 static constexpr uint32_t RADIO_MODE_LOG_INTERVAL_MS = 5000;
-static constexpr uint32_t NTP_UPDATE_CHECK_INTERVAL_MS = 2000;
+static constexpr uint32_t NTP_LINK_CHECK_INTERVAL_MS = 2000;
+static constexpr uint32_t PRUNE_INTERVAL_MS = 1000;
+static constexpr uint32_t IDENTITY_INTERVAL_MS = 1000;
+static constexpr uint32_t WEATHER_SYNC_INTERVAL_MS = 1000;
+static constexpr uint32_t PROXY_RETRY_MS = 1000;
+static constexpr uint32_t STATE_LOAD_RETRY_MS = 200;
+
+using app::espnow::espnowMaster;
 
 TaskHandle_t networkTaskHandle = nullptr;
-SimpleNTP ntpClient;
+core::reactor::SourceId proxySource = -1;
 
-void networkTaskRunner(void*) {
-  wifiManager.init();
-  wifiManager.setIdentity(DEVICE_NAME, WIFI_HOSTNAME);
-  wifiManager.addNetwork(WIFI_SSID, WIFI_PASS);
-  wifiManager.begin();
-	FTPServer ftpServer(LittleFS);
-	ftpServer.begin(FTP_USER, FTP_PASS);
+bool wifiConnected = false;
 
-  uint8_t channel = wifiManager.getConnectedChannel();
+uint32_t lastStatsLogMs = 0;
+
+// ESP-NOW follows the STA onto the AP's channel; remember it for the next
+// boot and bring ESP-NOW up now if it failed before WiFi connected.
+void onWifiConnected() {
+  const uint8_t channel = wifiManager.getConnectedChannel();
   if (channel == 0) {
-    channel = app::espnow::DEFAULT_CHANNEL;
-    ESP_LOGW("NET_TASK", "WiFi channel unknown, fallback to default channel %u", channel);
+    ESP_LOGW("NET_TASK", "WiFi channel unknown, keeping ESP-NOW channel");
+    return;
+  }
+
+  core::boot::storeChannel(channel);
+  if (!espnowMaster.isReady() && espnowMaster.begin(channel)) {
+    core::boot::mark(core::boot::EspNowReady);
   }
+}
 
-  app::espnow::espnowMaster.begin(channel);
+uint32_t runWifi(uint32_t) {
+  // Once slaves are paired, scans must not hop the radio off their channel.
+  wifiManager.setChannelPinned(espnowMaster.peerCount() > 0);
+  const uint32_t nextMs = wifiManager.handle();
+
+  const bool connected = wifiManager.isConnected();
+  if (connected && !wifiConnected) {
+    onWifiConnected();
+  }
+  wifiConnected = connected;
+  return nextMs;
+}
 
-  ntpClient.setTimeZone(7);
-  ntpClient.setUpdateInterval(30UL * 60UL * 1000UL);
+uint32_t runBeacons(uint32_t nowMs) {
+  return espnowMaster.sendBeacons(nowMs);
+}
 
-  uint32_t lastRadioModeLogMs = millis();
-  uint32_t lastNtpCheckMs = 0;
-  bool ntpBeginDone = false;
-  bool ntpTimeLogged = false;
+uint32_t runPrune(uint32_t nowMs) {
+  espnowMaster.pruneDevices(nowMs);
+  return PRUNE_INTERVAL_MS;
+}
 
-  while (true) {
-    wifiManager.handle();
-    app::espnow::espnowMaster.loop();
-    ftpServer.handleFTP();
-
-    const uint32_t now = millis();
-
-    if (wifiManager.isConnected()) {
-      if (!ntpBeginDone) {
-        ntpBeginDone = ntpClient.begin("pool.ntp.org");
-        if (ntpBeginDone) {
-          ESP_LOGI("NET_TASK", "NTP initialized");
-        } else {
-          ESP_LOGW("NET_TASK", "NTP init pending (WiFi/stack not ready)");
-        }
-      }
-
-      if (ntpBeginDone && (lastNtpCheckMs == 0 || (now - lastNtpCheckMs) >= NTP_UPDATE_CHECK_INTERVAL_MS)) {
-        lastNtpCheckMs = now;
-        ntpClient.update();
-
-        if (!ntpTimeLogged && ntpClient.isTimeSet()) {
-          ESP_LOGI("NET_TASK", "NTP time set: %s", ntpClient.getFormattedDateTime().c_str());
-          ntpTimeLogged = true;
-        }
-      }
-    } else {
-      ntpBeginDone = false;
-      ntpTimeLogged = false;
+uint32_t runIdentityRequests(uint32_t nowMs) {
+  espnowMaster.requestIdentities(nowMs);
+  return IDENTITY_INTERVAL_MS;
+}
+
+uint32_t runWeatherSync(uint32_t) {
+  if (espnowMaster.isReady()) {
+    core::weather_sync::tick(espnowMaster);
+  }
+  return WEATHER_SYNC_INTERVAL_MS;
+}
+
+#if MASTER_CAMERA_RATE_CONTROL
+uint32_t runCameraRate(uint32_t nowMs) {
+  app::espnow::camera_rate::tick(espnowMaster, nowMs);
+  return MASTER_CAMERA_RATE_WINDOW_MS;
+}
+#endif
+
+// Loads the state store off the receive path; idle once it is loaded.
+uint32_t runStateLoad(uint32_t) {
+  return app::espnow::state_store::load() ? 0 : STATE_LOAD_RETRY_MS;
+}
+
+uint32_t runHistoryFlush(uint32_t nowMs) {
+  app::espnow::history::flushIfDue(nowMs);
+  return MASTER_HISTORY_FLUSH_MS;
+}
+
+// Woken by the proxy worker; responses wait until ESP-NOW is up.
+uint32_t runProxyResponses(uint32_t) {
+  if (!espnowMaster.isReady()) {
+    return PROXY_RETRY_MS;
+  }
+  app::espnow::processProxyResponses(espnowMaster);
+  return 0;
+}
+
+uint32_t runNtp(uint32_t nowMs) {
+  if (!wifiManager.isConnected()) {
+    core::time_sync::stop();
+    return NTP_LINK_CHECK_INTERVAL_MS;
+  }
+  return core::time_sync::tick(nowMs);
+}
+
+void logReactorStats(uint32_t nowMs) {
+  const uint32_t windowMs = nowMs - lastStatsLogMs;
+  if (windowMs == 0) {
+    return;
+  }
+
+  const uint32_t wakeups = core::reactor::getWakeups();
+  ESP_LOGI("NET_TASK", "Reactor: %lu wakeups in %lu ms (%lu.%lu/s)",
+           static_cast<unsigned long>(wakeups), static_cast<unsigned long>(windowMs),
+           static_cast<unsigned long>((wakeups * 1000ULL) / windowMs),
+           static_cast<unsigned long>(((wakeups * 10000ULL) / windowMs) % 10));
+
+  for (size_t index = 0; index < core::reactor::getSourceCount(); ++index) {
+    core::reactor::SourceStats stats;
+    if (!core::reactor::getStats(static_cast<core::reactor::SourceId>(index), stats) || stats.runs == 0) {
+      continue;
     }
+    const uint32_t lateAvgUs = stats.timerRuns == 0 ? 0 : static_cast<uint32_t>(stats.lateTotalUs / stats.timerRuns);
+    ESP_LOGI("NET_TASK", "  %-12s runs=%lu late avg=%luus max=%luus run max=%luus",
+             stats.name, static_cast<unsigned long>(stats.runs), static_cast<unsigned long>(lateAvgUs),
+             static_cast<unsigned long>(stats.lateMaxUs), static_cast<unsigned long>(stats.runMaxUs));
+  }
+
+  core::reactor::resetStats();
+  lastStatsLogMs = nowMs;
+}
+
+uint32_t runStatusLog(uint32_t nowMs) {
+  ESP_LOGI("NET_TASK",
+           "Radio status: espnow=%s wifi=%s channel=%u ip=%s",
+           espnowMaster.isReady() ? "ready" : "not_ready",
+           wifiManager.isConnected() ? "connected" : "disconnected",
+           WiFi.channel(),
+           wifiManager.getIPAddress().c_str());
+
+  if (MASTER_NETWORK_STATS_LOG_MS > 0 && nowMs - lastStatsLogMs >= MASTER_NETWORK_STATS_LOG_MS) {
+    logReactorStats(nowMs);
+  }
+  return RADIO_MODE_LOG_INTERVAL_MS;
+}
+
+bool addSources() {
+  using core::reactor::add;
+
+  bool ok = add("wifi", runWifi, 1) >= 0;
+  ok &= add("beacons", runBeacons, 1) >= 0;
+  ok &= add("prune", runPrune, PRUNE_INTERVAL_MS) >= 0;
+  ok &= add("identity", runIdentityRequests, IDENTITY_INTERVAL_MS) >= 0;
+  ok &= add("weather_sync", runWeatherSync, WEATHER_SYNC_INTERVAL_MS) >= 0;
+#if MASTER_CAMERA_RATE_CONTROL
+  ok &= add("camera_rate", runCameraRate, MASTER_CAMERA_RATE_WINDOW_MS) >= 0;
+#endif
+  ok &= add("state_load", runStateLoad, 1) >= 0;
+  ok &= add("history", runHistoryFlush, 1) >= 0;
+  ok &= add("ntp", runNtp, 1) >= 0;
+  ok &= add("status", runStatusLog, RADIO_MODE_LOG_INTERVAL_MS) >= 0;
+
+  proxySource = add("proxy_resp", runProxyResponses, 0);
+  ok &= proxySource >= 0;
+  app::espnow::setProxyResponseHook([]() { core::reactor::signal(proxySource); });
+  // Responses queued before the hook was installed.
+  core::reactor::signal(proxySource);
+  return ok;
+}
+
+void networkTaskRunner(void*) {
+  wifiManager.setIdentity(DEVICE_NAME, WIFI_HOSTNAME);
+  wifiManager.init();
+
+  // Bring ESP-NOW up on the last known channel so slaves are served while the
+  // STA scan and connect run from the event loop.
+  const uint8_t storedChannel = core::boot::loadStoredChannel(app::espnow::DEFAULT_CHANNEL);
+  app::espnow::camera_stream::beginDecodeWorker();
+  if (espnowMaster.begin(storedChannel)) {
+    core::boot::mark(core::boot::EspNowReady);
+    espnowMaster.broadcast(app::espnow::PacketType::HELLO,
+                           app::espnow::MASTER_BEACON_ID,
+                           app::espnow::MASTER_BEACON_ID_LEN);
+  }
+
+  wifiManager.addNetwork(WIFI_SSID, WIFI_PASS);
+  wifiManager.begin();
 
-    if (now - lastRadioModeLogMs >= RADIO_MODE_LOG_INTERVAL_MS) {
-      ESP_LOGI("NET_TASK",
-               "Radio status: espnow=%s wifi=%s channel=%u ip=%s",
-               app::espnow::espnowMaster.isReady() ? "ready" : "not_ready",
-               wifiManager.isConnected() ? "connected" : "disconnected",
-               WiFi.channel(),
-               wifiManager.getIPAddress().c_str());
-      lastRadioModeLogMs = now;
+  app::espnow::camera_http::begin();
+
+  if (!startFtpTask()) {
+    ESP_LOGE("NET_TASK", "FTP task failed to start");
+  }
+
+  core::time_sync::begin();
+
+  if (!core::reactor::begin()) {
+    ESP_LOGE("NET_TASK", "No reactor, polling every 10 ms");
+    while (true) {
+      wifiManager.handle();
+      espnowMaster.loop();
+      vTaskDelay(pdMS_TO_TICKS(10));
     }
+  }
+
+  if (!addSources()) {
+    ESP_LOGE("NET_TASK", "Failed to add every reactor source");
+  }
+  lastStatsLogMs = millis();
 
-    vTaskDelay(pdMS_TO_TICKS(10));
+  while (true) {
+    core::reactor::runOnce();
   }
 }
 
@@ -100,14 +242,7 @@ bool startNetworkTask() {
     return true;
   }
 
-  BaseType_t created = xTaskCreatePinnedToCore(
-      networkTaskRunner,
-      "network_task",
-      NETWORK_TASK_STACK,
-      nullptr,
-      NETWORK_TASK_PRIORITY,
-      &networkTaskHandle,
-      tskNO_AFFINITY);
+  BaseType_t created = core::topology::createTask(core::topology::Task::Network, networkTaskRunner, nullptr, &networkTaskHandle);
 
   if (created != pdPASS) {
     ESP_LOGE("NET_TASK", "Failed to start network task");
@@ -0,0 +1,164 @@
+#include "boot.h"
+
+#include "task_topology.h"
+
+#include <LittleFS.h>
+#include <Preferences.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <freertos/task.h>
+
+namespace core::boot {
+
+namespace {
+
+static constexpr const char* TAG = "boot";
+static constexpr const char* PREFS_NAMESPACE = "boot";
+static constexpr const char* PREFS_CHANNEL_KEY = "channel";
+static constexpr size_t MILESTONE_COUNT = 6;
+
+struct MilestoneInfo {
+  Milestone bit;
+  const char* name;
+};
+
+static constexpr MilestoneInfo MILESTONES[MILESTONE_COUNT] = {
+    {FsReady, "fs_ready"},
+    {EspNowReady, "espnow_ready"},
+    {AssetsReady, "assets_ready"},
+    {FirstFrame, "first_frame"},
+    {UiReady, "ui_ready"},
+    {FirstPacketAccepted, "first_packet_accepted"},
+};
+
+EventGroupHandle_t milestoneGroup = nullptr;
+uint32_t milestoneAtMs[MILESTONE_COUNT] = {0};
+bool fsMounted = false;
+portMUX_TYPE markLock = portMUX_INITIALIZER_UNLOCKED;
+
+int milestoneIndex(Milestone milestone) {
+  for (size_t i = 0; i < MILESTONE_COUNT; ++i) {
+    if (MILESTONES[i].bit == milestone) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+void fsMountTask(void*) {
+  const int64_t startUs = esp_timer_get_time();
+  fsMounted = LittleFS.begin(true);
+  if (!fsMounted) {
+    ESP_LOGE(TAG, "LittleFS mount failed");
+  } else {
+    ESP_LOGI(TAG, "LittleFS mounted in %lu ms", static_cast<unsigned long>((esp_timer_get_time() - startUs) / 1000));
+  }
+
+  mark(FsReady);
+  vTaskDelete(nullptr);
+}
+
+}  // namespace
+
+void begin() {
+  if (milestoneGroup != nullptr) {
+    return;
+  }
+
+  milestoneGroup = xEventGroupCreate();
+  if (milestoneGroup == nullptr) {
+    ESP_LOGE(TAG, "Failed to create milestone group, mounting LittleFS inline");
+    fsMounted = LittleFS.begin(true);
+    return;
+  }
+
+  const BaseType_t created = topology::createTask(topology::Task::BootFs, fsMountTask, nullptr, nullptr);
+
+  if (created != pdPASS) {
+    ESP_LOGW(TAG, "Failed to start FS mount task, mounting inline");
+    fsMounted = LittleFS.begin(true);
+    mark(FsReady);
+  }
+}
+
+void mark(Milestone milestone) {
+  const int index = milestoneIndex(milestone);
+  if (milestoneGroup == nullptr || index < 0) {
+    return;
+  }
+
+  bool first = false;
+  const uint32_t nowMs = static_cast<uint32_t>(esp_timer_get_time() / 1000);
+  portENTER_CRITICAL(&markLock);
+  if (milestoneAtMs[index] == 0) {
+    milestoneAtMs[index] = nowMs == 0 ? 1 : nowMs;
+    first = true;
+  }
+  portEXIT_CRITICAL(&markLock);
+
+  if (!first) {
+    return;
+  }
+
+  xEventGroupSetBits(milestoneGroup, milestone);
+  ESP_LOGI(TAG, "%s at %lu ms", MILESTONES[index].name, static_cast<unsigned long>(nowMs));
+}
+
+bool isReached(Milestone milestone) {
+  if (milestoneGroup == nullptr) {
+    return milestone == FsReady;
+  }
+  return (xEventGroupGetBits(milestoneGroup) & milestone) != 0;
+}
+
+bool waitFor(Milestone milestone, TickType_t timeoutTicks) {
+  if (milestoneGroup == nullptr) {
+    return milestone == FsReady;
+  }
+  const EventBits_t bits = xEventGroupWaitBits(milestoneGroup, milestone, pdFALSE, pdTRUE, timeoutTicks);
+  return (bits & milestone) != 0;
+}
+
+uint32_t milestoneMs(Milestone milestone) {
+  const int index = milestoneIndex(milestone);
+  return index < 0 ? 0 : milestoneAtMs[index];
+}
+
+bool isFsReady() {
+  return isReached(FsReady) && fsMounted;
+}
+
+bool isFsMounted() {
+  return fsMounted;
+}
+
+uint8_t loadStoredChannel(uint8_t fallback) {
+  Preferences preferences;
+  if (!preferences.begin(PREFS_NAMESPACE, true)) {
+    return fallback;
+  }
+
+  const uint8_t channel = preferences.getUChar(PREFS_CHANNEL_KEY, 0);
+  preferences.end();
+  return (channel >= 1 && channel <= 13) ? channel : fallback;
+}
+
+void storeChannel(uint8_t channel) {
+  if (channel < 1 || channel > 13) {
+    return;
+  }
+
+  Preferences preferences;
+  if (!preferences.begin(PREFS_NAMESPACE, false)) {
+    ESP_LOGW(TAG, "Failed to open boot preferences");
+    return;
+  }
+
+  if (preferences.getUChar(PREFS_CHANNEL_KEY, 0) != channel) {
+    preferences.putUChar(PREFS_CHANNEL_KEY, channel);
+    ESP_LOGI(TAG, "Stored ESP-NOW channel %u", channel);
+  }
+  preferences.end();
+}
+
+}  // namespace core::boot
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+
+namespace core::boot {
+
+enum Milestone : EventBits_t {
+  FsReady = BIT0,
+  EspNowReady = BIT1,
+  AssetsReady = BIT2,
+  FirstFrame = BIT3,
+  UiReady = BIT4,
+  FirstPacketAccepted = BIT5,
+};
+
+// Creates the milestone group and starts the one-shot LittleFS mount task.
+void begin();
+
+// Records a milestone once and logs its time since reset.
+void mark(Milestone milestone);
+bool isReached(Milestone milestone);
+bool waitFor(Milestone milestone, TickType_t timeoutTicks);
+uint32_t milestoneMs(Milestone milestone);
+
+bool isFsReady();
+bool isFsMounted();
+
+// Last WiFi channel ESP-NOW ran on, persisted so the next boot can start
+// the radio before the STA connection resolves the channel.
+uint8_t loadStoredChannel(uint8_t fallback);
+void storeChannel(uint8_t channel);
+
+}  // namespace core::boot
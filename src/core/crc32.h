@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(ESP_PLATFORM)
+#include <esp_rom_crc.h>
+#endif
+
+namespace core {
+
+#if defined(ESP_PLATFORM)
+
+// Standard CRC-32 (zlib/IEEE); pass the previous result as `crc` to chain.
+inline uint32_t crc32(const void* data, size_t length, uint32_t crc = 0) {
+  return esp_rom_crc32_le(crc, static_cast<const uint8_t*>(data), static_cast<uint32_t>(length));
+}
+
+#else
+
+namespace crc32_detail {
+
+constexpr std::array<std::array<uint32_t, 256>, 8> buildTables() {
+  std::array<std::array<uint32_t, 256>, 8> tables{};
+  for (uint32_t i = 0; i < 256; ++i) {
+    uint32_t value = i;
+    for (int bit = 0; bit < 8; ++bit) {
+      value = (value >> 1) ^ (0xEDB88320u & (0u - (value & 1u)));
+    }
+    tables[0][i] = value;
+  }
+  for (size_t t = 1; t < 8; ++t) {
+    for (uint32_t i = 0; i < 256; ++i) {
+      tables[t][i] = (tables[t - 1][i] >> 8) ^ tables[0][tables[t - 1][i] & 0xFF];
+    }
+  }
+  return tables;
+}
+
+inline constexpr std::array<std::array<uint32_t, 256>, 8> kTables = buildTables();
+
+}  // namespace crc32_detail
+
+// Host build: same CRC-32 as the ESP ROM, slicing-by-8 (little endian).
+inline uint32_t crc32(const void* data, size_t length, uint32_t crc = 0) {
+  const auto& t = crc32_detail::kTables;
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  crc = ~crc;
+  while (length >= 8) {
+    uint32_t low = 0;
+    uint32_t high = 0;
+    memcpy(&low, bytes, sizeof(low));
+    memcpy(&high, bytes + 4, sizeof(high));
+    low ^= crc;
+    crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+          t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+    bytes += 8;
+    length -= 8;
+  }
+  while (length-- > 0) {
+    crc = (crc >> 8) ^ t[0][(crc ^ *bytes++) & 0xFF];
+  }
+  return ~crc;
+}
+
+#endif
+
+}  // namespace core
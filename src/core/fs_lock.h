@@ -0,0 +1,57 @@
+#pragma once
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+// One recursive mutex around LittleFS work shared by the state store,
+// history, camera recorder, packet capture and the FTP worker. Take it
+// last: never acquire another lock while holding it.
+namespace core::fs {
+
+namespace detail {
+inline SemaphoreHandle_t mutex = nullptr;
+inline portMUX_TYPE initLock = portMUX_INITIALIZER_UNLOCKED;
+}  // namespace detail
+
+inline SemaphoreHandle_t getMutex() {
+  if (detail::mutex != nullptr) {
+    return detail::mutex;
+  }
+
+  SemaphoreHandle_t created = xSemaphoreCreateRecursiveMutex();
+  portENTER_CRITICAL(&detail::initLock);
+  if (detail::mutex == nullptr) {
+    detail::mutex = created;
+    created = nullptr;
+  }
+  portEXIT_CRITICAL(&detail::initLock);
+
+  if (created != nullptr) {
+    vSemaphoreDelete(created);
+  }
+  return detail::mutex;
+}
+
+class Lock {
+ public:
+  explicit Lock(TickType_t waitTicks = portMAX_DELAY) : handle(getMutex()) {
+    held_ = handle != nullptr && xSemaphoreTakeRecursive(handle, waitTicks) == pdTRUE;
+  }
+  ~Lock() {
+    if (held_) {
+      xSemaphoreGiveRecursive(handle);
+    }
+  }
+  Lock(const Lock&) = delete;
+  Lock& operator=(const Lock&) = delete;
+
+  // False only when a bounded wait timed out.
+  bool held() const { return held_ || handle == nullptr; }
+
+ private:
+  SemaphoreHandle_t handle;
+  bool held_ = false;
+};
+
+}  // namespace core::fs
@@ -0,0 +1,171 @@
+#include "reactor.h"
+
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+#include <freertos/task.h>
+
+namespace core::reactor {
+
+namespace {
+
+static constexpr const char* TAG = "reactor";
+
+struct Source {
+  Handler handler = nullptr;
+  esp_timer_handle_t timer = nullptr;
+  // Deadline of the armed one-shot, 0 when disarmed.
+  int64_t dueUs = 0;
+  SourceStats stats;
+};
+
+EventGroupHandle_t events = nullptr;
+Source sources[kMaxSources];
+size_t sourceCount = 0;
+EventBits_t allBits = 0;
+uint32_t wakeups = 0;
+
+static_assert(kMaxSources <= 24, "event group holds 24 bits");
+
+void onTimer(void* arg) {
+  const size_t index = reinterpret_cast<size_t>(arg);
+  xEventGroupSetBits(events, static_cast<EventBits_t>(1) << index);
+}
+
+bool validId(SourceId id) {
+  return id >= 0 && static_cast<size_t>(id) < sourceCount;
+}
+
+}  // namespace
+
+bool begin() {
+  if (events != nullptr) {
+    return true;
+  }
+
+  events = xEventGroupCreate();
+  if (events == nullptr) {
+    ESP_LOGE(TAG, "Failed to create event group");
+    return false;
+  }
+  return true;
+}
+
+SourceId add(const char* name, Handler handler, uint32_t firstDelayMs) {
+  if (events == nullptr || handler == nullptr || sourceCount >= kMaxSources) {
+    return -1;
+  }
+
+  Source& source = sources[sourceCount];
+  esp_timer_create_args_t args = {};
+  args.callback = onTimer;
+  args.arg = reinterpret_cast<void*>(sourceCount);
+  args.dispatch_method = ESP_TIMER_TASK;
+  args.name = name;
+  if (esp_timer_create(&args, &source.timer) != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to create timer for %s", name);
+    return -1;
+  }
+
+  source.handler = handler;
+  source.stats = SourceStats{};
+  source.stats.name = name;
+  allBits |= static_cast<EventBits_t>(1) << sourceCount;
+
+  const SourceId id = static_cast<SourceId>(sourceCount++);
+  if (firstDelayMs > 0) {
+    schedule(id, firstDelayMs);
+  }
+  return id;
+}
+
+void schedule(SourceId id, uint32_t delayMs) {
+  if (!validId(id)) {
+    return;
+  }
+
+  Source& source = sources[id];
+  esp_timer_stop(source.timer);
+  const uint64_t delayUs = static_cast<uint64_t>(delayMs) * 1000ULL;
+  source.dueUs = esp_timer_get_time() + static_cast<int64_t>(delayUs);
+  if (esp_timer_start_once(source.timer, delayUs) != ESP_OK) {
+    source.dueUs = 0;
+    ESP_LOGW(TAG, "Failed to arm %s", source.stats.name);
+  }
+}
+
+void signal(SourceId id) {
+  if (validId(id)) {
+    xEventGroupSetBits(events, static_cast<EventBits_t>(1) << id);
+  }
+}
+
+void runOnce() {
+  if (events == nullptr || sourceCount == 0) {
+    vTaskDelay(pdMS_TO_TICKS(100));
+    return;
+  }
+
+  const EventBits_t ready = xEventGroupWaitBits(events, allBits, pdTRUE, pdFALSE, portMAX_DELAY) & allBits;
+  wakeups++;
+
+  for (size_t index = 0; index < sourceCount; ++index) {
+    if ((ready & (static_cast<EventBits_t>(1) << index)) == 0) {
+      continue;
+    }
+
+    Source& source = sources[index];
+    const int64_t startUs = esp_timer_get_time();
+    // A signal can beat the timer; only a run at or past the deadline
+    // counts as a timer run.
+    if (source.dueUs != 0 && startUs >= source.dueUs) {
+      const uint32_t lateUs = static_cast<uint32_t>(startUs - source.dueUs);
+      source.stats.timerRuns++;
+      source.stats.lateTotalUs += lateUs;
+      if (lateUs > source.stats.lateMaxUs) {
+        source.stats.lateMaxUs = lateUs;
+      }
+      source.dueUs = 0;
+    }
+
+    const uint32_t nextMs = source.handler(millis());
+
+    const uint32_t runUs = static_cast<uint32_t>(esp_timer_get_time() - startUs);
+    source.stats.runs++;
+    if (runUs > source.stats.runMaxUs) {
+      source.stats.runMaxUs = runUs;
+    }
+
+    if (nextMs > 0) {
+      schedule(static_cast<SourceId>(index), nextMs);
+    }
+  }
+}
+
+uint32_t getWakeups() {
+  return wakeups;
+}
+
+size_t getSourceCount() {
+  return sourceCount;
+}
+
+bool getStats(SourceId id, SourceStats& out) {
+  if (!validId(id)) {
+    return false;
+  }
+  out = sources[id].stats;
+  return true;
+}
+
+void resetStats() {
+  wakeups = 0;
+  for (size_t index = 0; index < sourceCount; ++index) {
+    const char* name = sources[index].stats.name;
+    sources[index].stats = SourceStats{};
+    sources[index].stats.name = name;
+  }
+}
+
+}  // namespace core::reactor
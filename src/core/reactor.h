@@ -0,0 +1,43 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Event loop for the network task. Each source is a handler with its own
+// esp_timer one-shot; the timer (or signal() from another task) sets the
+// source's bit in an event group and runOnce() runs the handlers whose bits
+// are set. A handler returns the ms until it should run again, 0 to stay
+// idle until it is signalled or scheduled.
+namespace core::reactor {
+
+static constexpr size_t kMaxSources = 16;
+
+using SourceId = int8_t;
+using Handler = uint32_t (*)(uint32_t nowMs);
+
+struct SourceStats {
+  const char* name = nullptr;
+  uint32_t runs = 0;
+  uint32_t timerRuns = 0;
+  // Handler start minus timer deadline, timer runs only.
+  uint64_t lateTotalUs = 0;
+  uint32_t lateMaxUs = 0;
+  uint32_t runMaxUs = 0;
+};
+
+// Must be called before add().
+bool begin();
+
+// Returns -1 when the table is full or the timer cannot be created.
+SourceId add(const char* name, Handler handler, uint32_t firstDelayMs);
+void schedule(SourceId id, uint32_t delayMs);
+void signal(SourceId id);
+
+// Blocks until at least one source is ready, then runs the ready ones.
+void runOnce();
+
+uint32_t getWakeups();
+size_t getSourceCount();
+bool getStats(SourceId id, SourceStats& out);
+void resetStats();
+
+}  // namespace core::reactor
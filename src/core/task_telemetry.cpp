@@ -0,0 +1,386 @@
+#include "task_telemetry.h"
+
+#include "task_topology.h"
+
+#include <app_config.h>
+#include <esp_heap_caps.h>
+#include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+namespace core::telemetry {
+
+namespace {
+
+static constexpr const char* TAG = "telemetry";
+static constexpr size_t STATUS_SLACK = 4;
+static constexpr size_t LOG_LINE_BYTES = 2048;
+static constexpr uint32_t INTERNAL_CAPS = MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT;
+#if configGENERATE_RUN_TIME_STATS
+static constexpr bool RUNTIME_STATS = true;
+#else
+static constexpr bool RUNTIME_STATS = false;
+#endif
+
+struct TaskTrack {
+  UBaseType_t number = 0;
+  configRUN_TIME_COUNTER_TYPE runtime = 0;
+  bool stackAlert = false;
+};
+
+TaskHandle_t telemetryTaskHandle = nullptr;
+portMUX_TYPE snapshotLock = portMUX_INITIALIZER_UNLOCKED;
+Snapshot published;
+Snapshot working;
+char logLine[LOG_LINE_BYTES];
+
+#if configUSE_TRACE_FACILITY
+TaskStatus_t* statuses = nullptr;
+TaskTrack* previous = nullptr;
+TaskTrack* scratch = nullptr;
+size_t statusCapacity = 0;
+size_t previousCount = 0;
+configRUN_TIME_COUNTER_TYPE previousTotalRuntime = 0;
+#endif
+uint32_t previousSampleMs = 0;
+uint32_t previousAlerts = 0;
+
+void sampleHeap(HeapSample& out, uint32_t caps) {
+  out.totalBytes = heap_caps_get_total_size(caps);
+  out.freeBytes = heap_caps_get_free_size(caps);
+  out.minFreeBytes = heap_caps_get_minimum_free_size(caps);
+  out.largestBlockBytes = heap_caps_get_largest_free_block(caps);
+}
+
+// Stack alerts first, then the busiest tasks.
+bool ranksAbove(const TaskSample& a, const TaskSample& b) {
+  if (a.stackAlert != b.stackAlert) {
+    return a.stackAlert;
+  }
+  return a.cpuPermille > b.cpuPermille;
+}
+
+void keepTask(Snapshot& snapshot, const TaskSample& sample) {
+  if (snapshot.taskCount < kMaxTasks) {
+    snapshot.tasks[snapshot.taskCount++] = sample;
+    return;
+  }
+
+  size_t lowest = 0;
+  for (size_t i = 1; i < snapshot.taskCount; ++i) {
+    if (ranksAbove(snapshot.tasks[lowest], snapshot.tasks[i])) {
+      lowest = i;
+    }
+  }
+  if (ranksAbove(sample, snapshot.tasks[lowest])) {
+    snapshot.tasks[lowest] = sample;
+  }
+}
+
+#if configUSE_TRACE_FACILITY
+bool ensureCapacity(size_t wanted) {
+  if (wanted <= statusCapacity) {
+    return true;
+  }
+
+  auto* grownStatuses = static_cast<TaskStatus_t*>(heap_caps_malloc(wanted * sizeof(TaskStatus_t), MALLOC_CAP_8BIT));
+  auto* grownPrevious = static_cast<TaskTrack*>(heap_caps_malloc(wanted * sizeof(TaskTrack), MALLOC_CAP_8BIT));
+  auto* grownScratch = static_cast<TaskTrack*>(heap_caps_malloc(wanted * sizeof(TaskTrack), MALLOC_CAP_8BIT));
+  if (grownStatuses == nullptr || grownPrevious == nullptr || grownScratch == nullptr) {
+    heap_caps_free(grownStatuses);
+    heap_caps_free(grownPrevious);
+    heap_caps_free(grownScratch);
+    return false;
+  }
+
+  if (previousCount > 0) {
+    memcpy(grownPrevious, previous, previousCount * sizeof(TaskTrack));
+  }
+  heap_caps_free(statuses);
+  heap_caps_free(previous);
+  heap_caps_free(scratch);
+  statuses = grownStatuses;
+  previous = grownPrevious;
+  scratch = grownScratch;
+  statusCapacity = wanted;
+  return true;
+}
+
+const TaskTrack* findPrevious(UBaseType_t number) {
+  for (size_t i = 0; i < previousCount; ++i) {
+    if (previous[i].number == number) {
+      return &previous[i];
+    }
+  }
+  return nullptr;
+}
+
+uint8_t taskCore(const TaskStatus_t& status) {
+#if configTASKLIST_INCLUDE_COREID
+  if (status.xCoreID >= 0 && status.xCoreID < portNUM_PROCESSORS) {
+    return static_cast<uint8_t>(status.xCoreID);
+  }
+#endif
+  return kAnyCore;
+}
+
+bool sampleTasks(Snapshot& snapshot) {
+  UBaseType_t count = 0;
+  configRUN_TIME_COUNTER_TYPE totalRuntime = 0;
+  // A task created between the count and the copy makes the copy fail; retry once.
+  for (int attempt = 0; attempt < 2 && count == 0; ++attempt) {
+    if (!ensureCapacity(uxTaskGetNumberOfTasks() + STATUS_SLACK)) {
+      ESP_LOGW(TAG, "No memory for %u task entries", static_cast<unsigned>(uxTaskGetNumberOfTasks()));
+      return false;
+    }
+    count = uxTaskGetSystemState(statuses, statusCapacity, &totalRuntime);
+  }
+  if (count == 0) {
+    return false;
+  }
+
+  const configRUN_TIME_COUNTER_TYPE elapsed = totalRuntime - previousTotalRuntime;
+  const bool haveWindow = RUNTIME_STATS && previousTotalRuntime != 0 && elapsed > 0;
+  TaskHandle_t idleHandles[2] = {xTaskGetIdleTaskHandleForCore(0), nullptr};
+#if portNUM_PROCESSORS > 1
+  idleHandles[1] = xTaskGetIdleTaskHandleForCore(1);
+#endif
+
+  snapshot.runtimeStats = haveWindow;
+  snapshot.taskTotal = static_cast<uint8_t>(std::min<UBaseType_t>(count, UINT8_MAX));
+  for (UBaseType_t i = 0; i < count; ++i) {
+    const TaskStatus_t& status = statuses[i];
+    const TaskTrack* before = findPrevious(status.xTaskNumber);
+
+    TaskSample sample;
+    strncpy(sample.name, status.pcTaskName, kTaskNameBytes - 1);
+    sample.core = taskCore(status);
+    sample.priority = static_cast<uint8_t>(status.uxCurrentPriority);
+    sample.stackFreeBytes = static_cast<uint32_t>(status.usStackHighWaterMark);
+    sample.stackAlert = sample.stackFreeBytes < MASTER_TELEMETRY_STACK_ALERT_BYTES;
+
+    if (haveWindow) {
+      const configRUN_TIME_COUNTER_TYPE ran = status.ulRunTimeCounter - (before != nullptr ? before->runtime : 0);
+      const uint64_t permille = (static_cast<uint64_t>(ran) * 1000U) / elapsed;
+      sample.cpuPermille = static_cast<uint16_t>(std::min<uint64_t>(permille, 1000));
+    }
+
+    for (size_t core = 0; core < 2; ++core) {
+      if (idleHandles[core] != nullptr && status.xHandle == idleHandles[core]) {
+        snapshot.idlePermille[core] = sample.cpuPermille;
+      }
+    }
+
+    if (sample.stackAlert) {
+      snapshot.alerts |= AlertStack;
+      if (before == nullptr || !before->stackAlert) {
+        ESP_LOGW(TAG,
+                 "%s stack high-water %lu bytes free (alert below %u)",
+                 sample.name,
+                 static_cast<unsigned long>(sample.stackFreeBytes),
+                 static_cast<unsigned>(MASTER_TELEMETRY_STACK_ALERT_BYTES));
+      }
+    }
+
+    scratch[i].number = status.xTaskNumber;
+    scratch[i].runtime = status.ulRunTimeCounter;
+    scratch[i].stackAlert = sample.stackAlert;
+    keepTask(snapshot, sample);
+  }
+
+  std::swap(previous, scratch);
+  previousCount = count;
+  previousTotalRuntime = totalRuntime;
+  std::sort(snapshot.tasks, snapshot.tasks + snapshot.taskCount, ranksAbove);
+  return true;
+}
+#else
+bool sampleTasks(Snapshot&) {
+  return false;
+}
+#endif
+
+void sample(Snapshot& snapshot) {
+  const uint32_t now = millis();
+  const uint32_t sequence = snapshot.sequence + 1;
+  snapshot = Snapshot{};
+  snapshot.sequence = sequence;
+  snapshot.uptimeMs = now;
+  snapshot.windowMs = previousSampleMs == 0 ? 0 : now - previousSampleMs;
+  previousSampleMs = now;
+
+  sampleHeap(snapshot.internal, INTERNAL_CAPS);
+  sampleHeap(snapshot.psram, MALLOC_CAP_SPIRAM);
+  sampleTasks(snapshot);
+
+  if (snapshot.runtimeStats) {
+    for (size_t core = 0; core < portNUM_PROCESSORS && core < 2; ++core) {
+      if (snapshot.idlePermille[core] < MASTER_TELEMETRY_IDLE_ALERT_PCT * 10) {
+        snapshot.alerts |= AlertIdle;
+      }
+    }
+  }
+  if (snapshot.internal.freeBytes < MASTER_TELEMETRY_HEAP_ALERT_BYTES) {
+    snapshot.alerts |= AlertHeap;
+  }
+  if (snapshot.internal.largestBlockBytes < MASTER_TELEMETRY_BLOCK_ALERT_BYTES) {
+    snapshot.alerts |= AlertHeapBlock;
+  }
+  if (snapshot.psram.totalBytes > 0 && snapshot.psram.freeBytes < MASTER_TELEMETRY_PSRAM_ALERT_BYTES) {
+    snapshot.alerts |= AlertPsram;
+  }
+}
+
+void logAlertChanges(const Snapshot& snapshot) {
+  const uint32_t raised = snapshot.alerts & ~previousAlerts;
+  const uint32_t cleared = previousAlerts & ~snapshot.alerts;
+  previousAlerts = snapshot.alerts;
+
+  if ((raised & AlertIdle) != 0) {
+    ESP_LOGW(TAG,
+             "CPU idle low: core0 %u.%u%% core1 %u.%u%% (alert below %u%%)",
+             snapshot.idlePermille[0] / 10,
+             snapshot.idlePermille[0] % 10,
+             snapshot.idlePermille[1] / 10,
+             snapshot.idlePermille[1] % 10,
+             static_cast<unsigned>(MASTER_TELEMETRY_IDLE_ALERT_PCT));
+  }
+  if ((raised & AlertHeap) != 0) {
+    ESP_LOGW(TAG, "Internal heap free %lu bytes (alert below %lu)",
+             static_cast<unsigned long>(snapshot.internal.freeBytes),
+             static_cast<unsigned long>(MASTER_TELEMETRY_HEAP_ALERT_BYTES));
+  }
+  if ((raised & AlertHeapBlock) != 0) {
+    ESP_LOGW(TAG, "Internal heap largest block %lu bytes (alert below %lu)",
+             static_cast<unsigned long>(snapshot.internal.largestBlockBytes),
+             static_cast<unsigned long>(MASTER_TELEMETRY_BLOCK_ALERT_BYTES));
+  }
+  if ((raised & AlertPsram) != 0) {
+    ESP_LOGW(TAG, "PSRAM free %lu bytes (alert below %lu)",
+             static_cast<unsigned long>(snapshot.psram.freeBytes),
+             static_cast<unsigned long>(MASTER_TELEMETRY_PSRAM_ALERT_BYTES));
+  }
+  if ((cleared & (AlertIdle | AlertHeap | AlertHeapBlock | AlertPsram)) != 0) {
+    ESP_LOGI(TAG, "Alerts cleared: 0x%02lx", static_cast<unsigned long>(cleared));
+  }
+}
+
+void append(size_t& used, const char* format, ...) {
+  if (used >= LOG_LINE_BYTES) {
+    return;
+  }
+  va_list args;
+  va_start(args, format);
+  const int written = vsnprintf(logLine + used, LOG_LINE_BYTES - used, format, args);
+  va_end(args);
+  used = written < 0 ? LOG_LINE_BYTES : std::min(LOG_LINE_BYTES, used + static_cast<size_t>(written));
+}
+
+void appendHeap(size_t& used, const char* key, const HeapSample& heap) {
+  append(used,
+         ",\"%s\":{\"total\":%lu,\"free\":%lu,\"min\":%lu,\"largest\":%lu}",
+         key,
+         static_cast<unsigned long>(heap.totalBytes),
+         static_cast<unsigned long>(heap.freeBytes),
+         static_cast<unsigned long>(heap.minFreeBytes),
+         static_cast<unsigned long>(heap.largestBlockBytes));
+}
+
+// One JSON object per line, after the `telemetry:` log prefix.
+void logSnapshot(const Snapshot& snapshot) {
+  size_t used = 0;
+  append(used,
+         "{\"seq\":%lu,\"up_ms\":%lu,\"win_ms\":%lu,\"alerts\":%lu",
+         static_cast<unsigned long>(snapshot.sequence),
+         static_cast<unsigned long>(snapshot.uptimeMs),
+         static_cast<unsigned long>(snapshot.windowMs),
+         static_cast<unsigned long>(snapshot.alerts));
+  if (snapshot.runtimeStats) {
+    append(used, ",\"idle_pm\":[%u,%u]", snapshot.idlePermille[0], snapshot.idlePermille[1]);
+  }
+  appendHeap(used, "heap", snapshot.internal);
+  appendHeap(used, "psram", snapshot.psram);
+  append(used, ",\"tasks_total\":%u,\"tasks\":[", snapshot.taskTotal);
+  for (size_t i = 0; i < snapshot.taskCount; ++i) {
+    const TaskSample& task = snapshot.tasks[i];
+    append(used,
+           "%s{\"name\":\"%s\",\"core\":%d,\"prio\":%u,\"cpu_pm\":%u,\"stack_free\":%lu}",
+           i == 0 ? "" : ",",
+           task.name,
+           task.core == kAnyCore ? -1 : task.core,
+           task.priority,
+           task.cpuPermille,
+           static_cast<unsigned long>(task.stackFreeBytes));
+  }
+  append(used, "]}");
+
+  if (used >= LOG_LINE_BYTES) {
+    ESP_LOGW(TAG, "Telemetry line truncated");
+    return;
+  }
+  ESP_LOGI(TAG, "%s", logLine);
+}
+
+void telemetryTaskRunner(void*) {
+#if !configUSE_TRACE_FACILITY
+  ESP_LOGW(TAG, "configUSE_TRACE_FACILITY is off; sampling heap only");
+#endif
+  TickType_t lastWake = xTaskGetTickCount();
+  uint32_t lastLogMs = 0;
+
+  while (true) {
+    sample(working);
+    logAlertChanges(working);
+
+    portENTER_CRITICAL(&snapshotLock);
+    published = working;
+    portEXIT_CRITICAL(&snapshotLock);
+
+    // The first sample has no CPU window yet.
+    if (MASTER_TELEMETRY_LOG_MS > 0 && working.windowMs > 0
+        && (lastLogMs == 0 || (working.uptimeMs - lastLogMs) >= MASTER_TELEMETRY_LOG_MS)) {
+      lastLogMs = working.uptimeMs;
+      logSnapshot(working);
+    }
+
+    vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(MASTER_TELEMETRY_PERIOD_MS));
+  }
+}
+
+}  // namespace
+
+bool start() {
+  if (telemetryTaskHandle != nullptr) {
+    return true;
+  }
+
+  const BaseType_t created =
+      topology::createTask(topology::Task::Telemetry, telemetryTaskRunner, nullptr, &telemetryTaskHandle);
+
+  if (created != pdPASS) {
+    ESP_LOGE(TAG, "Failed to start telemetry task");
+    telemetryTaskHandle = nullptr;
+    return false;
+  }
+  return true;
+}
+
+bool getSnapshot(Snapshot& out) {
+  portENTER_CRITICAL(&snapshotLock);
+  out = published;
+  portEXIT_CRITICAL(&snapshotLock);
+  return out.sequence != 0;
+}
+
+uint32_t getSequence() {
+  portENTER_CRITICAL(&snapshotLock);
+  const uint32_t sequence = published.sequence;
+  portEXIT_CRITICAL(&snapshotLock);
+  return sequence;
+}
+
+}  // namespace core::telemetry
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <Arduino.h>
+
+namespace core::telemetry {
+
+static constexpr size_t kMaxTasks = 24;
+static constexpr size_t kTaskNameBytes = 16;
+static constexpr uint8_t kAnyCore = 0xFF;
+
+enum Alert : uint32_t {
+  AlertStack = BIT0,
+  AlertIdle = BIT1,
+  AlertHeap = BIT2,
+  AlertHeapBlock = BIT3,
+  AlertPsram = BIT4,
+};
+
+struct TaskSample {
+  char name[kTaskNameBytes] = {0};
+  uint8_t core = kAnyCore;
+  uint8_t priority = 0;
+  bool stackAlert = false;
+  // CPU share of one core over the last window, 0..1000.
+  uint16_t cpuPermille = 0;
+  uint32_t stackFreeBytes = 0;
+};
+
+struct HeapSample {
+  uint32_t totalBytes = 0;
+  uint32_t freeBytes = 0;
+  uint32_t minFreeBytes = 0;
+  uint32_t largestBlockBytes = 0;
+};
+
+struct Snapshot {
+  uint32_t sequence = 0;
+  uint32_t uptimeMs = 0;
+  uint32_t windowMs = 0;
+  bool runtimeStats = false;
+  uint16_t idlePermille[2] = {0, 0};
+  HeapSample internal;
+  HeapSample psram;
+  uint32_t alerts = 0;
+  // Sorted by CPU share; taskTotal counts tasks that did not fit.
+  uint8_t taskCount = 0;
+  uint8_t taskTotal = 0;
+  TaskSample tasks[kMaxTasks];
+};
+
+// Starts the sampling task (every MASTER_TELEMETRY_PERIOD_MS).
+bool start();
+
+// Copies the latest sample; false until the first one is taken.
+bool getSnapshot(Snapshot& out);
+uint32_t getSequence();
+
+}  // namespace core::telemetry
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <app_config.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// Core, priority and stack of every firmware task, one row per subsystem.
+// WiFi (priority 23), lwIP (18) and the ESP-NOW receive callback run on the
+// protocol core, so radio-adjacent and socket work goes there; JPEG decode,
+// rendering and input go on the app core; blocking HTTP runs below both.
+// tools/bench/task_topology_bench.cpp compares the plans.
+namespace core::topology {
+
+static constexpr BaseType_t kProtocolCore = 0;
+static constexpr BaseType_t kAppCore = 1;
+static constexpr BaseType_t kAnyCore = tskNO_AFFINITY;
+
+enum class Task : uint8_t {
+  Network = 0,
+  Display,
+  Input,
+  CameraDecode,
+  Proxy,
+  CameraHttpListener,
+  CameraHttpClient,
+  CameraRecorder,
+  AssetPreload,
+  BootFs,
+  Telemetry,
+  Ftp,
+  Count,
+};
+
+enum Plan : uint8_t {
+  // Affinities and priorities the tasks were created with before the table.
+  PlanUnpinned = 0,
+  PlanSplit = 1,
+  // As PlanSplit, with the proxy worker moved next to the UI.
+  PlanSplitProxyOnApp = 2,
+  PlanCount,
+};
+
+struct TaskSpec {
+  const char* name;
+  uint32_t stackBytes;
+  UBaseType_t priority;
+  BaseType_t core;
+};
+
+static constexpr size_t kTaskCount = static_cast<size_t>(Task::Count);
+
+static constexpr const char* kPlanNames[PlanCount] = {"unpinned", "split", "split_proxy_app"};
+
+static constexpr TaskSpec kPlans[PlanCount][kTaskCount] = {
+    {
+        {"network_task", 8192, 2, kAnyCore},
+        {"display_task", 6144, 1, kAnyCore},
+        {"input_task", 4096, 1, kAnyCore},
+        {"cam_decode", 6144, 1, kAnyCore},
+        {"proxy_worker", 8192, 2, kProtocolCore},
+        {"cam_http", 3072, 1, kAnyCore},
+        {"cam_http_cli", 4096, 1, kAnyCore},
+        {"cam_rec", 4096, 1, kProtocolCore},
+        {"asset_preload", 6144, 1, kAnyCore},
+        {"boot_fs", 4096, 2, kAnyCore},
+        {"telemetry", 4096, 1, kAnyCore},
+        {"ftp_task", 6144, 2, kAnyCore},
+    },
+    {
+        {"network_task", 8192, 5, kProtocolCore},
+        {"display_task", 6144, 3, kAppCore},
+        {"input_task", 4096, 4, kAppCore},
+        {"cam_decode", 6144, 2, kAppCore},
+        {"proxy_worker", 8192, 1, kProtocolCore},
+        {"cam_http", 3072, 1, kProtocolCore},
+        {"cam_http_cli", 4096, 1, kProtocolCore},
+        {"cam_rec", 4096, 1, kProtocolCore},
+        {"asset_preload", 6144, 2, kAppCore},
+        {"boot_fs", 4096, 2, kAnyCore},
+        {"telemetry", 4096, 1, kAnyCore},
+        {"ftp_task", 6144, 1, kProtocolCore},
+    },
+    {
+        {"network_task", 8192, 5, kProtocolCore},
+        {"display_task", 6144, 3, kAppCore},
+        {"input_task", 4096, 4, kAppCore},
+        {"cam_decode", 6144, 2, kAppCore},
+        {"proxy_worker", 8192, 1, kAppCore},
+        {"cam_http", 3072, 1, kProtocolCore},
+        {"cam_http_cli", 4096, 1, kProtocolCore},
+        {"cam_rec", 4096, 1, kProtocolCore},
+        {"asset_preload", 6144, 2, kAppCore},
+        {"boot_fs", 4096, 2, kAnyCore},
+        {"telemetry", 4096, 1, kAnyCore},
+        {"ftp_task", 6144, 1, kProtocolCore},
+    },
+};
+
+static_assert(MASTER_TASK_TOPOLOGY >= 0 && MASTER_TASK_TOPOLOGY < PlanCount, "MASTER_TASK_TOPOLOGY names no plan");
+
+constexpr const TaskSpec& spec(Task task, uint8_t plan = MASTER_TASK_TOPOLOGY) {
+  return kPlans[plan][static_cast<size_t>(task)];
+}
+
+inline BaseType_t createTask(Task task, TaskFunction_t function, void* arg, TaskHandle_t* handle) {
+  const TaskSpec& entry = spec(task);
+  return xTaskCreatePinnedToCore(function, entry.name, entry.stackBytes, arg, entry.priority, handle, entry.core);
+}
+
+}  // namespace core::topology
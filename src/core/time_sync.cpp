@@ -0,0 +1,415 @@
+#include "time_sync.h"
+
+#include <AsyncUDP.h>
+#include <app_config.h>
+#include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <lwip/dns.h>
+#include <lwip/tcpip.h>
+#include <sys/time.h>
+#include <time.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace core::time_sync {
+
+namespace {
+
+static constexpr const char* TAG = "time_sync";
+static constexpr const char* kServers[] = {"pool.ntp.org", "time.google.com", "time.cloudflare.com"};
+static constexpr size_t kServerCount = sizeof(kServers) / sizeof(kServers[0]);
+static constexpr size_t kFilterSamples = 8;
+static constexpr uint16_t NTP_PORT = 123;
+static constexpr size_t NTP_PACKET_BYTES = 48;
+static constexpr uint64_t NTP_UNIX_OFFSET_S = 2208988800ULL;
+static constexpr uint32_t ROUND_POLL_MS = 100;
+// Frequency tolerance the error estimate assumes, as in RFC 5905.
+static constexpr uint32_t DRIFT_PPM = 15;
+
+struct Sample {
+  bool valid = false;
+  uint8_t stratum = 0;
+  int64_t offsetUs = 0;
+  uint32_t delayUs = 0;
+  // Root delay / 2 + root dispersion reported by the server, plus delay / 2.
+  uint32_t distanceUs = 0;
+  uint32_t takenMs = 0;
+};
+
+struct Server {
+  uint32_t address = 0;  // IPv4, network order; 0 until resolved
+  bool resolveFailed = false;
+  bool sent = false;
+  bool answered = false;
+  int64_t sentUs = 0;
+  uint8_t cookie[8] = {0};  // transmit timestamp, echoed back as originate
+  Sample filter[kFilterSamples];
+  size_t next = 0;
+};
+
+struct Candidate {
+  size_t index = 0;
+  Sample sample;
+  uint32_t distanceUs = 0;
+};
+
+// Servers are written by the lwIP thread (DNS) and the UDP task (replies).
+portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+AsyncUDP udp;
+bool listening = false;
+bool inRound = false;
+uint32_t roundStartMs = 0;
+uint32_t nextRoundMs = 0;
+Server servers[kServerCount];
+
+Status status;
+uint32_t baseErrorUs = 0;
+uint32_t lastSyncMs = 0;
+
+int64_t localUs() {
+  timeval now = {};
+  gettimeofday(&now, nullptr);
+  return static_cast<int64_t>(now.tv_sec) * 1000000LL + now.tv_usec;
+}
+
+uint32_t readU32(const uint8_t* in) {
+  return (static_cast<uint32_t>(in[0]) << 24) | (static_cast<uint32_t>(in[1]) << 16) |
+         (static_cast<uint32_t>(in[2]) << 8) | in[3];
+}
+
+void writeU32(uint8_t* out, uint32_t value) {
+  out[0] = static_cast<uint8_t>(value >> 24);
+  out[1] = static_cast<uint8_t>(value >> 16);
+  out[2] = static_cast<uint8_t>(value >> 8);
+  out[3] = static_cast<uint8_t>(value);
+}
+
+void writeTimestamp(uint8_t* out, int64_t unixUs) {
+  const uint64_t seconds = static_cast<uint64_t>(unixUs / 1000000LL) + NTP_UNIX_OFFSET_S;
+  const uint64_t fraction = (static_cast<uint64_t>(unixUs % 1000000LL) << 32) / 1000000ULL;
+  writeU32(out, static_cast<uint32_t>(seconds));
+  writeU32(out + 4, static_cast<uint32_t>(fraction));
+}
+
+int64_t readTimestamp(const uint8_t* in) {
+  const int64_t seconds = static_cast<int64_t>(readU32(in)) - static_cast<int64_t>(NTP_UNIX_OFFSET_S);
+  const uint64_t fraction = readU32(in + 4);
+  return seconds * 1000000LL + static_cast<int64_t>((fraction * 1000000ULL) >> 32);
+}
+
+// NTP short format, 16.16 seconds.
+uint32_t readShortUs(const uint8_t* in) {
+  return static_cast<uint32_t>((static_cast<uint64_t>(readU32(in)) * 1000000ULL) >> 16);
+}
+
+uint32_t agedDistanceUs(const Sample& sample, uint32_t nowMs) {
+  return sample.distanceUs + (nowMs - sample.takenMs) * DRIFT_PPM / 1000;
+}
+
+void onResolved(const char*, const ip_addr_t* address, void* arg) {
+  Server& server = servers[reinterpret_cast<size_t>(arg)];
+  portENTER_CRITICAL(&lock);
+  if (address != nullptr && IP_IS_V4(address)) {
+    server.address = ip4_addr_get_u32(ip_2_ip4(address));
+  } else {
+    server.resolveFailed = true;
+  }
+  portEXIT_CRITICAL(&lock);
+}
+
+// Runs on the lwIP thread; answers from the DNS cache come back inline.
+void resolveOnTcpip(void* arg) {
+  const size_t index = reinterpret_cast<size_t>(arg);
+  ip_addr_t address = {};
+  const err_t err = dns_gethostbyname(kServers[index], &address, onResolved, arg);
+  if (err == ERR_OK) {
+    onResolved(nullptr, &address, arg);
+  } else if (err != ERR_INPROGRESS) {
+    onResolved(nullptr, nullptr, arg);
+  }
+}
+
+void onPacket(AsyncUDPPacket& packet) {
+  const int64_t receivedUs = localUs();
+  if (packet.length() < NTP_PACKET_BYTES || packet.remotePort() != NTP_PORT) {
+    return;
+  }
+
+  const uint8_t* data = packet.data();
+  const uint8_t leap = data[0] >> 6;
+  const uint8_t mode = data[0] & 0x07;
+  const uint8_t stratum = data[1];
+  // Stratum 0 is a kiss-o'-death; leap 3 means the server is unsynchronized.
+  if (mode != 4 || leap == 3 || stratum == 0 || stratum > 15) {
+    return;
+  }
+
+  const IPAddress from = packet.remoteIP();
+  const int64_t serverRxUs = readTimestamp(data + 32);
+  const int64_t serverTxUs = readTimestamp(data + 40);
+  const uint32_t rootUs = readShortUs(data + 4) / 2 + readShortUs(data + 8);
+  const uint32_t nowMs = millis();
+
+  portENTER_CRITICAL(&lock);
+  for (Server& server : servers) {
+    if (!server.sent || server.answered || !(IPAddress(server.address) == from) ||
+        memcmp(data + 24, server.cookie, sizeof(server.cookie)) != 0) {
+      continue;
+    }
+
+    const int64_t delayUs = (receivedUs - server.sentUs) - (serverTxUs - serverRxUs);
+    Sample& sample = server.filter[server.next];
+    sample.valid = true;
+    sample.stratum = stratum;
+    sample.offsetUs = ((serverRxUs - server.sentUs) + (serverTxUs - receivedUs)) / 2;
+    sample.delayUs = delayUs > 0 ? static_cast<uint32_t>(delayUs) : 0;
+    sample.distanceUs = rootUs + sample.delayUs / 2;
+    sample.takenMs = nowMs;
+    server.next = (server.next + 1) % kFilterSamples;
+    server.answered = true;
+    break;
+  }
+  portEXIT_CRITICAL(&lock);
+}
+
+void startRound(uint32_t nowMs) {
+  portENTER_CRITICAL(&lock);
+  for (Server& server : servers) {
+    server.address = 0;
+    server.resolveFailed = false;
+    server.sent = false;
+    server.answered = false;
+  }
+  portEXIT_CRITICAL(&lock);
+
+  for (size_t index = 0; index < kServerCount; ++index) {
+    if (tcpip_callback(resolveOnTcpip, reinterpret_cast<void*>(index)) != ERR_OK) {
+      portENTER_CRITICAL(&lock);
+      servers[index].resolveFailed = true;
+      portEXIT_CRITICAL(&lock);
+    }
+  }
+
+  inRound = true;
+  roundStartMs = nowMs;
+}
+
+void sendRequests() {
+  for (Server& server : servers) {
+    uint8_t request[NTP_PACKET_BYTES] = {0};
+    request[0] = 0x23;  // LI 0, version 4, client
+    const int64_t sentUs = localUs();
+
+    portENTER_CRITICAL(&lock);
+    const uint32_t address = server.sent ? 0 : server.address;
+    if (address != 0) {
+      // Marked before the write: the reply can beat writeTo() back.
+      server.sentUs = sentUs;
+      writeTimestamp(server.cookie, sentUs);
+      memcpy(request + 40, server.cookie, sizeof(server.cookie));
+      server.sent = true;
+    }
+    portEXIT_CRITICAL(&lock);
+
+    if (address != 0) {
+      udp.writeTo(request, sizeof(request), IPAddress(address), NTP_PORT);
+    }
+  }
+}
+
+bool roundSettled() {
+  bool settled = true;
+  portENTER_CRITICAL(&lock);
+  for (const Server& server : servers) {
+    settled &= server.answered || server.resolveFailed;
+  }
+  portEXIT_CRITICAL(&lock);
+  return settled;
+}
+
+// Each server's clock filter picks its sample with the smallest aged
+// distance; candidates whose offset +/- distance misses the median offset
+// are falsetickers.
+size_t collectSurvivors(uint32_t nowMs, Candidate* out, uint8_t& responders) {
+  size_t count = 0;
+  responders = 0;
+  portENTER_CRITICAL(&lock);
+  for (size_t index = 0; index < kServerCount; ++index) {
+    const Server& server = servers[index];
+    if (!server.answered) {
+      continue;
+    }
+    responders++;
+
+    Candidate& candidate = out[count];
+    candidate.index = index;
+    candidate.distanceUs = UINT32_MAX;
+    for (const Sample& sample : server.filter) {
+      const uint32_t distanceUs = sample.valid ? agedDistanceUs(sample, nowMs) : UINT32_MAX;
+      if (distanceUs < candidate.distanceUs) {
+        candidate.sample = sample;
+        candidate.distanceUs = distanceUs;
+      }
+    }
+    count++;
+  }
+  portEXIT_CRITICAL(&lock);
+
+  if (count <= 2) {
+    return count;
+  }
+
+  int64_t offsets[kServerCount];
+  for (size_t i = 0; i < count; ++i) {
+    offsets[i] = out[i].sample.offsetUs;
+  }
+  std::sort(offsets, offsets + count);
+  const int64_t medianUs = (count % 2 == 1) ? offsets[count / 2] : (offsets[count / 2 - 1] + offsets[count / 2]) / 2;
+
+  size_t survivors = 0;
+  for (size_t i = 0; i < count; ++i) {
+    if (std::llabs(out[i].sample.offsetUs - medianUs) <= static_cast<int64_t>(out[i].distanceUs)) {
+      out[survivors++] = out[i];
+    }
+  }
+  return survivors == 0 ? count : survivors;
+}
+
+// Steps on first sync or a large offset, otherwise slews.
+bool applyOffset(int64_t offsetUs) {
+  bool step = !status.synced || std::llabs(offsetUs) > static_cast<int64_t>(MASTER_NTP_STEP_THRESHOLD_MS) * 1000LL;
+  if (!step) {
+    timeval delta = {};
+    delta.tv_sec = static_cast<time_t>(offsetUs / 1000000LL);
+    delta.tv_usec = static_cast<suseconds_t>(offsetUs % 1000000LL);
+    step = adjtime(&delta, nullptr) != 0;
+  }
+
+  if (step) {
+    const int64_t targetUs = localUs() + offsetUs;
+    timeval target = {};
+    target.tv_sec = static_cast<time_t>(targetUs / 1000000LL);
+    target.tv_usec = static_cast<suseconds_t>(targetUs % 1000000LL);
+    settimeofday(&target, nullptr);
+  }
+
+  // Samples already taken were measured against the old clock.
+  portENTER_CRITICAL(&lock);
+  for (Server& server : servers) {
+    for (Sample& sample : server.filter) {
+      sample.offsetUs -= offsetUs;
+    }
+  }
+  portEXIT_CRITICAL(&lock);
+  return step;
+}
+
+void finishRound(uint32_t nowMs) {
+  inRound = false;
+
+  Candidate candidates[kServerCount];
+  uint8_t responders = 0;
+  const size_t survivors = collectSurvivors(nowMs, candidates, responders);
+  if (survivors == 0) {
+    portENTER_CRITICAL(&lock);
+    status.failedRounds++;
+    status.responders = 0;
+    portEXIT_CRITICAL(&lock);
+    ESP_LOGW(TAG, "No NTP server answered, retrying in %lu ms", static_cast<unsigned long>(MASTER_NTP_RETRY_MS));
+    nextRoundMs = nowMs + MASTER_NTP_RETRY_MS;
+    return;
+  }
+
+  const Candidate* chosen = &candidates[0];
+  for (size_t i = 1; i < survivors; ++i) {
+    if (candidates[i].distanceUs < chosen->distanceUs) {
+      chosen = &candidates[i];
+    }
+  }
+
+  uint32_t jitterUs = 0;
+  for (size_t i = 0; i < survivors; ++i) {
+    const uint32_t spreadUs = static_cast<uint32_t>(std::llabs(candidates[i].sample.offsetUs - chosen->sample.offsetUs));
+    jitterUs = std::max(jitterUs, spreadUs);
+  }
+
+  const Candidate selected = *chosen;
+  const bool stepped = applyOffset(selected.sample.offsetUs);
+  const int64_t clampedUs = std::max<int64_t>(INT32_MIN, std::min<int64_t>(INT32_MAX, selected.sample.offsetUs));
+
+  portENTER_CRITICAL(&lock);
+  status.synced = true;
+  status.syncs++;
+  status.steps += stepped ? 1 : 0;
+  status.lastOffsetUs = static_cast<int32_t>(clampedUs);
+  status.delayUs = selected.sample.delayUs;
+  status.stratum = selected.sample.stratum;
+  status.responders = responders;
+  status.server = kServers[selected.index];
+  baseErrorUs = selected.distanceUs + jitterUs;
+  lastSyncMs = nowMs;
+  portEXIT_CRITICAL(&lock);
+
+  ESP_LOGI(TAG, "%s %lld us from %s (stratum %u, %u/%u answered, rtt %lu us, error %lu us)",
+           stepped ? "Stepped" : "Slewing", static_cast<long long>(selected.sample.offsetUs), kServers[selected.index],
+           selected.sample.stratum, responders, static_cast<unsigned>(kServerCount),
+           static_cast<unsigned long>(selected.sample.delayUs), static_cast<unsigned long>(baseErrorUs));
+  nextRoundMs = nowMs + MASTER_NTP_POLL_MS;
+}
+
+}  // namespace
+
+void begin() {
+  setenv("TZ", MASTER_TIME_ZONE, 1);
+  tzset();
+}
+
+uint32_t tick(uint32_t nowMs) {
+  if (!listening) {
+    // Port 0: one ephemeral socket carries every server's exchange.
+    if (!udp.listen(0)) {
+      ESP_LOGW(TAG, "UDP listen failed");
+      return MASTER_NTP_RETRY_MS;
+    }
+    udp.onPacket([](AsyncUDPPacket& packet) { onPacket(packet); });
+    listening = true;
+    nextRoundMs = nowMs;
+  }
+
+  if (!inRound) {
+    const int32_t untilMs = static_cast<int32_t>(nextRoundMs - nowMs);
+    if (untilMs > 0) {
+      return static_cast<uint32_t>(untilMs);
+    }
+    startRound(nowMs);
+  }
+
+  sendRequests();
+  if (roundSettled() || nowMs - roundStartMs >= MASTER_NTP_ROUND_TIMEOUT_MS) {
+    finishRound(nowMs);
+    return static_cast<uint32_t>(nextRoundMs - nowMs);
+  }
+  return ROUND_POLL_MS;
+}
+
+void stop() {
+  if (listening) {
+    udp.close();
+    listening = false;
+  }
+  inRound = false;
+}
+
+void getStatus(Status& out) {
+  const uint32_t nowMs = millis();
+  portENTER_CRITICAL(&lock);
+  out = status;
+  if (status.synced) {
+    out.lastSyncAgeMs = nowMs - lastSyncMs;
+    out.errorUs = baseErrorUs + out.lastSyncAgeMs * DRIFT_PPM / 1000;
+  }
+  portEXIT_CRITICAL(&lock);
+}
+
+}  // namespace core::time_sync
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Non-blocking SNTP client for the network task. One UDP socket queries
+// every configured server per round; each server keeps a short clock
+// filter (lowest-RTT sample wins), servers whose offset interval misses
+// the round's median are discarded, and the survivor with the smallest
+// root distance corrects the clock: a step on first sync or past
+// MASTER_NTP_STEP_THRESHOLD_MS, otherwise an adjtime() slew.
+namespace core::time_sync {
+
+struct Status {
+  bool synced = false;
+  uint32_t syncs = 0;
+  uint32_t failedRounds = 0;
+  uint32_t steps = 0;
+  uint32_t lastSyncAgeMs = 0;
+  int32_t lastOffsetUs = 0;  // correction applied by the last sync
+  uint32_t delayUs = 0;      // RTT to the selected server
+  // Estimated clock error: root distance of the selected server plus the
+  // spread of the surviving servers, growing 15 ppm with age.
+  uint32_t errorUs = 0;
+  uint8_t stratum = 0;
+  uint8_t responders = 0;  // servers that answered the last round
+  const char* server = "";
+};
+
+// Sets the local time zone; the clock stays unset until the first sync.
+void begin();
+
+// Runs the poll round state machine; returns ms until it needs to run
+// again. Never blocks on DNS or the network.
+uint32_t tick(uint32_t nowMs);
+
+// Drops the socket and any round in flight, e.g. when the STA link goes down.
+void stop();
+
+void getStatus(Status& out);
+
+}  // namespace core::time_sync
@@ -1,7 +1,8 @@
 #include <Arduino.h>
 #include <core/wdt.h>
 #include "core/nvs.h"
-#include <LittleFS.h>
+#include "core/boot.h"
+#include "core/task_telemetry.h"
 #include <nvs_flash.h>
 #include <User_Setups/Setup24_ST7789_ESP32.h>
 #include "app/tasks/displayTask.h"
@@ -15,7 +16,8 @@ void init(){
 }
 
 void setup() {
-	LittleFS.begin(true);
+	// LittleFS mounts on its own task; ESP-NOW comes up before WiFi connects.
+	core::boot::begin();
 
 	#if BOARD_HAS_PSRAM
 	heap_caps_malloc_extmem_enable(0);
@@ -32,6 +34,10 @@ void setup() {
 	if (!app::tasks::startInputTask()) {
 		ESP_LOGE("MAIN", "Input task failed to start");
 	}
+
+	if (!core::telemetry::start()) {
+		ESP_LOGE("MAIN", "Telemetry task failed to start");
+	}
 }
 
 void loop() {
@@ -0,0 +1,200 @@
+// Host harness for camera chunk FEC: encodes synthetic frames with
+// camera_fec::buildParity, drops chunks with several loss patterns, runs
+// camera_fec::recover and checks rebuilt frames byte-for-byte. Build and run
+// from the repo root:
+//
+//   g++ -std=gnu++17 -O2 -Itools/bench/host -Isrc tools/bench/camera_fec_bench.cpp -o /tmp/fec_bench
+//   /tmp/fec_bench
+//
+// Prints frame completion with and without parity for each pattern and exits
+// non-zero if a chunk reported as recovered differs from the original.
+
+#include "app/espnow/camera_fec.h"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+using namespace app::espnow;
+
+static constexpr uint32_t FRAME_BYTES = 190 * camera_fec::kChunkBytes - 37;
+static constexpr int FRAMES_PER_PATTERN = 2000;
+
+enum class Pattern {
+  Uniform,
+  Burst,
+  Gilbert,
+};
+
+const char* patternName(Pattern pattern) {
+  switch (pattern) {
+    case Pattern::Uniform:
+      return "uniform";
+    case Pattern::Burst:
+      return "burst";
+    case Pattern::Gilbert:
+      return "gilbert";
+  }
+  return "?";
+}
+
+// Returns true if the packet is lost. `bad` carries Gilbert-Elliott state.
+bool dropPacket(Pattern pattern, double lossRate, std::mt19937& rng, bool& bad, int& burstLeft) {
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  switch (pattern) {
+    case Pattern::Uniform:
+      return uniform(rng) < lossRate;
+    case Pattern::Burst:
+      if (burstLeft > 0) {
+        --burstLeft;
+        return true;
+      }
+      if (uniform(rng) < lossRate / 3.0) {
+        burstLeft = 2;
+        return true;
+      }
+      return false;
+    case Pattern::Gilbert:
+      bad = bad ? uniform(rng) > 0.3 : uniform(rng) < lossRate * 0.3 / (1.0 - lossRate);
+      return bad ? uniform(rng) < 0.9 : false;
+  }
+  return false;
+}
+
+struct PatternResult {
+  uint32_t completeWithout = 0;
+  uint32_t completeWith = 0;
+  uint32_t recoveredChunks = 0;
+  uint32_t lostChunks = 0;
+  uint32_t mismatches = 0;
+};
+
+PatternResult runPattern(Pattern pattern, double lossRate, const camera_fec::Layout& layout, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::vector<uint8_t> original(FRAME_BYTES);
+  std::vector<uint8_t> received(FRAME_BYTES);
+  const uint16_t dataChunks = static_cast<uint16_t>((FRAME_BYTES + camera_fec::kChunkBytes - 1) / camera_fec::kChunkBytes);
+  const size_t paritySlots = camera_fec::parityChunkCount(layout, dataChunks);
+  std::vector<uint8_t> parity(paritySlots * camera_fec::kChunkBytes);
+  std::vector<uint8_t> paritySeen(paritySlots);
+  std::vector<uint8_t> seen(dataChunks + 1);
+
+  PatternResult result;
+  for (int frame = 0; frame < FRAMES_PER_PATTERN; ++frame) {
+    for (auto& byte : original) {
+      byte = static_cast<uint8_t>(rng());
+    }
+    std::fill(received.begin(), received.end(), 0);
+    std::fill(seen.begin(), seen.end(), 0);
+    std::fill(paritySeen.begin(), paritySeen.end(), 0);
+
+    bool bad = false;
+    int burstLeft = 0;
+    uint16_t receivedChunks = 0;
+    // Transmission order matches the camera: each group's data, then its parity.
+    for (uint16_t group = 0; group < camera_fec::groupCount(layout, dataChunks); ++group) {
+      for (uint16_t member = 0; member < layout.dataPerGroup; ++member) {
+        const uint16_t position = static_cast<uint16_t>(group * layout.dataPerGroup + member);
+        if (position >= dataChunks) {
+          break;
+        }
+        if (dropPacket(pattern, lossRate, rng, bad, burstLeft)) {
+          continue;
+        }
+        const size_t offset = static_cast<size_t>(position) * camera_fec::kChunkBytes;
+        memcpy(received.data() + offset, original.data() + offset, camera_fec::dataChunkLength(FRAME_BYTES, position));
+        seen[position + 1] = 1;
+        ++receivedChunks;
+      }
+      for (uint8_t index = 0; index < layout.parityPerGroup; ++index) {
+        const camera_fec::ParityId id{group, index};
+        const size_t slot = camera_fec::paritySlot(layout, id);
+        if (dropPacket(pattern, lossRate, rng, bad, burstLeft)) {
+          continue;
+        }
+        camera_fec::buildParity(original.data(), FRAME_BYTES, layout, id, parity.data() + slot * camera_fec::kChunkBytes);
+        paritySeen[slot] = 1;
+      }
+    }
+
+    if (receivedChunks == dataChunks) {
+      ++result.completeWithout;
+      ++result.completeWith;
+      continue;
+    }
+
+    const camera_fec::RecoveryResult recovery = camera_fec::recover(
+        received.data(), FRAME_BYTES, dataChunks, seen.data(), layout, parity.data(), paritySeen.data(), paritySlots);
+    result.recoveredChunks += recovery.recovered;
+    result.lostChunks += recovery.lost;
+    if (recovery.lost == 0) {
+      ++result.completeWith;
+    }
+
+    for (uint16_t position = 0; position < dataChunks; ++position) {
+      const size_t offset = static_cast<size_t>(position) * camera_fec::kChunkBytes;
+      if (seen[position + 1] != 0 &&
+          memcmp(received.data() + offset, original.data() + offset, camera_fec::dataChunkLength(FRAME_BYTES, position)) != 0) {
+        ++result.mismatches;
+      }
+    }
+  }
+  return result;
+}
+
+bool checkParityAddressing() {
+  const camera_fec::Layout layout{16, 3};
+  const camera_fec::ParityId id{1234, 2};
+  camera_fec::Layout parsedLayout;
+  camera_fec::ParityId parsedId;
+  return camera_fec::parseParityChunk(camera_fec::parityChunkIdx(id), camera_fec::parityChunkTotal(layout), parsedLayout, parsedId) &&
+         parsedLayout.dataPerGroup == 16 && parsedLayout.parityPerGroup == 3 && parsedId.group == 1234 && parsedId.index == 2 &&
+         !camera_fec::isParityIdx(190);
+}
+
+}  // namespace
+
+int main() {
+  if (!checkParityAddressing()) {
+    printf("parity idx/total round trip FAILED\n");
+    return 1;
+  }
+
+  const camera_fec::Layout layouts[] = {{8, 1}, {16, 2}, {10, 2}};
+  const Pattern patterns[] = {Pattern::Uniform, Pattern::Burst, Pattern::Gilbert};
+  const double lossRates[] = {0.005, 0.01, 0.03};
+
+  printf("frame=%u bytes (%u chunks), %d frames per row\n",
+         static_cast<unsigned>(FRAME_BYTES),
+         static_cast<unsigned>((FRAME_BYTES + camera_fec::kChunkBytes - 1) / camera_fec::kChunkBytes),
+         FRAMES_PER_PATTERN);
+  printf("%-8s %5s %6s %9s %9s %10s %8s\n", "pattern", "loss", "N+K", "plain%", "fec%", "recovered", "lost");
+
+  uint32_t mismatches = 0;
+  uint32_t seed = 1;
+  for (const auto& layout : layouts) {
+    for (const Pattern pattern : patterns) {
+      for (const double lossRate : lossRates) {
+        const PatternResult result = runPattern(pattern, lossRate, layout, seed++);
+        mismatches += result.mismatches;
+        printf("%-8s %4.1f%% %3u+%-2u %8.1f%% %8.1f%% %10u %8u\n",
+               patternName(pattern),
+               lossRate * 100.0,
+               static_cast<unsigned>(layout.dataPerGroup),
+               static_cast<unsigned>(layout.parityPerGroup),
+               100.0 * result.completeWithout / FRAMES_PER_PATTERN,
+               100.0 * result.completeWith / FRAMES_PER_PATTERN,
+               static_cast<unsigned>(result.recoveredChunks),
+               static_cast<unsigned>(result.lostChunks));
+      }
+    }
+  }
+
+  if (mismatches != 0) {
+    printf("FAILED: %u recovered chunks differ from the original\n", static_cast<unsigned>(mismatches));
+    return 1;
+  }
+  return 0;
+}
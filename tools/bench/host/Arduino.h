@@ -0,0 +1,151 @@
+#pragma once
+
+// Minimal host stand-in for the parts of Arduino.h used by modules under
+// src/ (String, millis/micros/delay, min/max/constrain), so they can be
+// benchmarked natively and built by the `native` and `sim` PlatformIO envs.
+// String keeps Arduino's heap-per-instance behaviour.
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <strings.h>
+
+// Simulations drive time themselves: with virtualTime set, micros()/millis()
+// read nowUs and delay() advances it instead of spinning.
+struct HostClock {
+  bool virtualTime = false;
+  uint64_t nowUs = 0;
+};
+
+inline HostClock hostClock;
+
+inline uint64_t hostMicros64() {
+  if (hostClock.virtualTime) {
+    return hostClock.nowUs;
+  }
+  using namespace std::chrono;
+  static const auto start = steady_clock::now();
+  return static_cast<uint64_t>(duration_cast<microseconds>(steady_clock::now() - start).count());
+}
+
+inline uint32_t micros() {
+  return static_cast<uint32_t>(hostMicros64());
+}
+
+inline uint32_t millis() {
+  return micros() / 1000;
+}
+
+inline void delay(uint32_t ms) {
+  if (hostClock.virtualTime) {
+    hostClock.nowUs += static_cast<uint64_t>(ms) * 1000;
+    return;
+  }
+  const uint32_t start = millis();
+  while (millis() - start < ms) {
+  }
+}
+
+#if !defined(__APPLE__) && !(defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 38))
+inline size_t strlcpy(char* dst, const char* src, size_t size) {
+  const size_t length = strlen(src);
+  if (size > 0) {
+    const size_t copied = length < size - 1 ? length : size - 1;
+    memcpy(dst, src, copied);
+    dst[copied] = '\0';
+  }
+  return length;
+}
+#endif
+
+using std::max;
+using std::min;
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+class String {
+ public:
+  String() = default;
+  String(const char* text) : value(text == nullptr ? "" : text) {}
+  String(const char* text, unsigned int length) : value(text, length) {}
+  String(const std::string& text) : value(text) {}
+  String(char c) : value(1, c) {}
+  String(int number) : value(std::to_string(number)) {}
+  String(unsigned int number) : value(std::to_string(number)) {}
+  String(long number) : value(std::to_string(number)) {}
+  String(unsigned long number) : value(std::to_string(number)) {}
+  String(float number, unsigned int decimals = 2) {
+    char text[32];
+    snprintf(text, sizeof(text), "%.*f", static_cast<int>(decimals), static_cast<double>(number));
+    value = text;
+  }
+
+  const char* c_str() const { return value.c_str(); }
+  unsigned int length() const { return static_cast<unsigned int>(value.size()); }
+  bool isEmpty() const { return value.empty(); }
+
+  bool operator==(const String& other) const { return value == other.value; }
+  bool operator!=(const String& other) const { return value != other.value; }
+  bool operator==(const char* other) const { return value == other; }
+  bool operator!=(const char* other) const { return value != other; }
+  bool equalsIgnoreCase(const String& other) const { return strcasecmp(c_str(), other.c_str()) == 0; }
+
+  String& operator+=(const String& other) {
+    value += other.value;
+    return *this;
+  }
+  String& operator+=(const char* other) {
+    value += other;
+    return *this;
+  }
+  String& operator+=(char c) {
+    value += c;
+    return *this;
+  }
+  friend String operator+(String lhs, const String& rhs) { return lhs += rhs; }
+  friend String operator+(String lhs, const char* rhs) { return lhs += rhs; }
+
+  int indexOf(char c, unsigned int from = 0) const { return position(value.find(c, from)); }
+  int indexOf(const char* text, unsigned int from = 0) const { return position(value.find(text, from)); }
+  int indexOf(const String& text, unsigned int from = 0) const { return position(value.find(text.value, from)); }
+
+  String substring(unsigned int begin) const { return substring(begin, length()); }
+  String substring(unsigned int begin, unsigned int end) const {
+    if (begin > value.size()) {
+      return String();
+    }
+    return String(value.substr(begin, end > begin ? end - begin : 0));
+  }
+
+  void trim() {
+    const size_t first = value.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos) {
+      value.clear();
+      return;
+    }
+    value = value.substr(first, value.find_last_not_of(" \t\r\n") - first + 1);
+  }
+
+  void toLowerCase() {
+    for (char& c : value) {
+      c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    }
+  }
+
+  char operator[](unsigned int index) const { return index < value.size() ? value[index] : '\0'; }
+  char charAt(unsigned int index) const { return (*this)[index]; }
+
+  long toInt() const { return atol(c_str()); }
+  float toFloat() const { return strtof(c_str(), nullptr); }
+
+ private:
+  static int position(size_t found) { return found == std::string::npos ? -1 : static_cast<int>(found); }
+
+  std::string value;
+};
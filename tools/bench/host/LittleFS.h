@@ -0,0 +1,173 @@
+#pragma once
+
+// Host stand-in for the LittleFS/File API used under src/, backed by a
+// temporary directory (or $ESPNOW_HOST_FS when set). File handles are
+// shared like Arduino's, so copies refer to the same open file.
+
+#include <Arduino.h>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+class File {
+ public:
+  File() = default;
+
+  static File openPath(const std::string& hostPath, const std::string& name, const char* mode) {
+    File file;
+    struct stat info = {};
+    if (stat(hostPath.c_str(), &info) == 0 && S_ISDIR(info.st_mode)) {
+      DIR* dir = opendir(hostPath.c_str());
+      if (dir == nullptr) {
+        return file;
+      }
+      file.handle_ = std::make_shared<Handle>();
+      file.handle_->dir = dir;
+    } else {
+      const char* stdioMode = mode[0] == 'w' ? "w+b" : (mode[0] == 'a' ? "a+b" : "rb");
+      FILE* fp = fopen(hostPath.c_str(), stdioMode);
+      if (fp == nullptr) {
+        return file;
+      }
+      file.handle_ = std::make_shared<Handle>();
+      file.handle_->fp = fp;
+    }
+    file.handle_->hostPath = hostPath;
+    file.handle_->path = name;
+    const size_t slash = name.find_last_of('/');
+    file.handle_->name = slash == std::string::npos ? name : name.substr(slash + 1);
+    return file;
+  }
+
+  explicit operator bool() const { return handle_ != nullptr && (handle_->fp != nullptr || handle_->dir != nullptr); }
+
+  size_t write(const uint8_t* data, size_t length) { return fp() ? fwrite(data, 1, length, fp()) : 0; }
+  size_t write(uint8_t value) { return write(&value, 1); }
+  size_t print(const char* text) { return write(reinterpret_cast<const uint8_t*>(text), strlen(text)); }
+
+  size_t read(uint8_t* data, size_t length) { return fp() ? fread(data, 1, length, fp()) : 0; }
+  int read() {
+    uint8_t value = 0;
+    return read(&value, 1) == 1 ? value : -1;
+  }
+
+  int available() { return fp() ? static_cast<int>(size() - position()) : 0; }
+  size_t position() { return fp() ? static_cast<size_t>(ftell(fp())) : 0; }
+  bool seek(uint32_t offset) { return fp() && fseek(fp(), static_cast<long>(offset), SEEK_SET) == 0; }
+  void flush() {
+    if (fp()) {
+      fflush(fp());
+    }
+  }
+
+  size_t size() {
+    if (!fp()) {
+      return 0;
+    }
+    const long current = ftell(fp());
+    fseek(fp(), 0, SEEK_END);
+    const long end = ftell(fp());
+    fseek(fp(), current, SEEK_SET);
+    return static_cast<size_t>(end);
+  }
+
+  String readStringUntil(char terminator) {
+    String line;
+    int value = 0;
+    while ((value = read()) >= 0 && value != terminator) {
+      line += static_cast<char>(value);
+    }
+    return line;
+  }
+
+  bool isDirectory() const { return handle_ != nullptr && handle_->dir != nullptr; }
+  const char* name() const { return handle_ ? handle_->name.c_str() : ""; }
+  const char* path() const { return handle_ ? handle_->path.c_str() : ""; }
+
+  File openNextFile() {
+    if (!isDirectory()) {
+      return File();
+    }
+    while (dirent* entry = readdir(handle_->dir)) {
+      if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+        continue;
+      }
+      const std::string childName = handle_->path == "/" ? "/" + std::string(entry->d_name) : handle_->path + "/" + entry->d_name;
+      return openPath(handle_->hostPath + "/" + entry->d_name, childName, "r");
+    }
+    return File();
+  }
+
+  void close() { handle_.reset(); }
+
+ private:
+  struct Handle {
+    FILE* fp = nullptr;
+    DIR* dir = nullptr;
+    std::string hostPath;
+    std::string path;
+    std::string name;
+    ~Handle() {
+      if (fp != nullptr) {
+        fclose(fp);
+      }
+      if (dir != nullptr) {
+        closedir(dir);
+      }
+    }
+  };
+
+  FILE* fp() const { return handle_ ? handle_->fp : nullptr; }
+
+  std::shared_ptr<Handle> handle_;
+};
+
+class HostFS {
+ public:
+  bool begin(bool = false) { return !root().empty(); }
+  void end() {}
+
+  File open(const char* path, const char* mode = "r") { return File::openPath(hostPath(path), path, mode); }
+  bool exists(const char* path) {
+    struct stat info = {};
+    return stat(hostPath(path).c_str(), &info) == 0;
+  }
+  bool remove(const char* path) { return ::remove(hostPath(path).c_str()) == 0; }
+  bool rename(const char* from, const char* to) { return ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0; }
+  bool mkdir(const char* path) { return ::mkdir(hostPath(path).c_str(), 0755) == 0; }
+  bool rmdir(const char* path) { return ::rmdir(hostPath(path).c_str()) == 0; }
+  size_t totalBytes() { return 8u * 1024u * 1024u; }
+  size_t usedBytes() { return 0; }
+
+  const std::string& root() {
+    if (root_.empty()) {
+      const char* configured = getenv("ESPNOW_HOST_FS");
+      if (configured != nullptr && configured[0] != '\0') {
+        root_ = configured;
+        ::mkdir(root_.c_str(), 0755);
+      } else {
+        char pattern[] = "/tmp/espnow_host_fs_XXXXXX";
+        if (mkdtemp(pattern) != nullptr) {
+          root_ = pattern;
+        }
+      }
+    }
+    return root_;
+  }
+
+ private:
+  std::string hostPath(const char* path) { return root() + (path[0] == '/' ? "" : "/") + path; }
+
+  std::string root_;
+};
+
+inline HostFS LittleFS;
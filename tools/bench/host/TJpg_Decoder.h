@@ -0,0 +1,22 @@
+#pragma once
+
+// Host stand-in: every frame decodes to a blank image (see JPEGDEC.h).
+
+#include <cstdint>
+
+enum JRESULT {
+  JDR_OK = 0,
+  JDR_INP = 2,
+};
+
+class TJpg_Decoder {
+ public:
+  using Callback = bool (*)(int16_t, int16_t, uint16_t, uint16_t, uint16_t*);
+
+  void setCallback(Callback) {}
+  void setJpgScale(uint8_t) {}
+  void setSwapBytes(bool) {}
+  JRESULT drawJpg(int32_t, int32_t, const uint8_t*, uint32_t) { return JDR_OK; }
+};
+
+inline TJpg_Decoder TJpgDec;
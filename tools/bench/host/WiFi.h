@@ -0,0 +1,33 @@
+#pragma once
+
+// Host stand-in for the Arduino WiFi object: never associated to an AP,
+// mode/channel backed by the esp_wifi stand-in.
+
+#include <Arduino.h>
+#include <esp_wifi.h>
+
+#define WIFI_STA WIFI_MODE_STA
+#define WIFI_AP WIFI_MODE_AP
+#define WIFI_AP_STA WIFI_MODE_APSTA
+
+enum wl_status_t {
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL = 1,
+  WL_CONNECTED = 3,
+  WL_CONNECT_FAILED = 4,
+  WL_DISCONNECTED = 6,
+};
+
+class HostWiFiClass {
+ public:
+  wifi_mode_t getMode() const { return hostWifiRadio.mode; }
+  bool mode(wifi_mode_t mode) {
+    hostWifiRadio.mode = mode;
+    return true;
+  }
+  wl_status_t status() const { return WL_DISCONNECTED; }
+  bool isConnected() const { return false; }
+  uint8_t channel() const { return hostWifiRadio.channel; }
+};
+
+inline HostWiFiClass WiFi;
@@ -0,0 +1,62 @@
+#pragma once
+
+// Host stand-in for the esp_err_t codes returned by the WiFi/ESP-NOW
+// stand-ins.
+
+#include <cstdint>
+
+using esp_err_t = int;
+
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_NO_MEM 0x101
+#define ESP_ERR_INVALID_ARG 0x102
+#define ESP_ERR_INVALID_STATE 0x103
+
+#define ESP_ERR_WIFI_BASE 0x3000
+#define ESP_ERR_WIFI_NOT_INIT (ESP_ERR_WIFI_BASE + 1)
+#define ESP_ERR_WIFI_NOT_STARTED (ESP_ERR_WIFI_BASE + 2)
+#define ESP_ERR_WIFI_CONN (ESP_ERR_WIFI_BASE + 7)
+
+#define ESP_ERR_ESPNOW_BASE (ESP_ERR_WIFI_BASE + 100)
+#define ESP_ERR_ESPNOW_NOT_INIT (ESP_ERR_ESPNOW_BASE + 1)
+#define ESP_ERR_ESPNOW_ARG (ESP_ERR_ESPNOW_BASE + 2)
+#define ESP_ERR_ESPNOW_NO_MEM (ESP_ERR_ESPNOW_BASE + 3)
+#define ESP_ERR_ESPNOW_FULL (ESP_ERR_ESPNOW_BASE + 4)
+#define ESP_ERR_ESPNOW_NOT_FOUND (ESP_ERR_ESPNOW_BASE + 5)
+#define ESP_ERR_ESPNOW_EXIST (ESP_ERR_ESPNOW_BASE + 7)
+
+inline const char* esp_err_to_name(esp_err_t err) {
+  switch (err) {
+    case ESP_OK:
+      return "ESP_OK";
+    case ESP_FAIL:
+      return "ESP_FAIL";
+    case ESP_ERR_NO_MEM:
+      return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG:
+      return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE:
+      return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_WIFI_NOT_INIT:
+      return "ESP_ERR_WIFI_NOT_INIT";
+    case ESP_ERR_WIFI_NOT_STARTED:
+      return "ESP_ERR_WIFI_NOT_STARTED";
+    case ESP_ERR_WIFI_CONN:
+      return "ESP_ERR_WIFI_CONN";
+    case ESP_ERR_ESPNOW_NOT_INIT:
+      return "ESP_ERR_ESPNOW_NOT_INIT";
+    case ESP_ERR_ESPNOW_ARG:
+      return "ESP_ERR_ESPNOW_ARG";
+    case ESP_ERR_ESPNOW_NO_MEM:
+      return "ESP_ERR_ESPNOW_NO_MEM";
+    case ESP_ERR_ESPNOW_FULL:
+      return "ESP_ERR_ESPNOW_FULL";
+    case ESP_ERR_ESPNOW_NOT_FOUND:
+      return "ESP_ERR_ESPNOW_NOT_FOUND";
+    case ESP_ERR_ESPNOW_EXIST:
+      return "ESP_ERR_ESPNOW_EXIST";
+    default:
+      return "UNKNOWN_ERROR";
+  }
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+// Host stand-in: every capability maps to the process heap.
+
+#include <cstdlib>
+
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_SPIRAM (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+
+inline void* heap_caps_malloc(size_t size, unsigned) {
+  return malloc(size);
+}
+
+inline void* heap_caps_calloc(size_t count, size_t size, unsigned) {
+  return calloc(count, size);
+}
+
+inline size_t heap_caps_get_free_size(unsigned) {
+  return 0;
+}
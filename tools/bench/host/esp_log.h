@@ -0,0 +1,29 @@
+#pragma once
+
+// Host stand-in: messages at or below ESP_HOST_LOG_LEVEL (default: warnings)
+// go to stderr. Arguments are always evaluated, as on target.
+
+#include <cstdarg>
+#include <cstdio>
+
+#ifndef ESP_HOST_LOG_LEVEL
+#define ESP_HOST_LOG_LEVEL 2
+#endif
+
+inline void espHostLog(int level, char letter, const char* tag, const char* format, ...) {
+  if (level > ESP_HOST_LOG_LEVEL) {
+    return;
+  }
+  fprintf(stderr, "%c (%s) ", letter, tag);
+  va_list args;
+  va_start(args, format);
+  vfprintf(stderr, format, args);
+  va_end(args);
+  fputc('\n', stderr);
+}
+
+#define ESP_LOGE(tag, format, ...) espHostLog(1, 'E', tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) espHostLog(2, 'W', tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) espHostLog(3, 'I', tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) espHostLog(4, 'D', tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...) espHostLog(5, 'V', tag, format, ##__VA_ARGS__)
@@ -0,0 +1,171 @@
+#pragma once
+
+// Host stand-in for the ESP-NOW driver boundary. The peer table enforces
+// ESP_NOW_MAX_TOTAL_PEER_NUM and unicast sends need a registered peer, as
+// on target. Frames accepted by esp_now_send go to hostEspNow.transmit;
+// a simulator hands received frames to the registered callback with
+// hostEspNowReceive() and reports delivery with hostEspNowSendDone().
+
+#include <esp_err.h>
+#include <esp_wifi.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#define ESP_NOW_ETH_ALEN 6
+#define ESP_NOW_KEY_LEN 16
+#define ESP_NOW_MAX_TOTAL_PEER_NUM 20
+#define ESP_NOW_MAX_DATA_LEN 250
+
+enum esp_now_send_status_t {
+  ESP_NOW_SEND_SUCCESS = 0,
+  ESP_NOW_SEND_FAIL,
+};
+
+struct wifi_pkt_rx_ctrl_t {
+  int8_t rssi;
+  uint8_t channel;
+};
+
+struct esp_now_recv_info_t {
+  uint8_t* src_addr;
+  uint8_t* des_addr;
+  wifi_pkt_rx_ctrl_t* rx_ctrl;
+};
+
+struct esp_now_send_info_t {
+  const uint8_t* des_addr;
+  const uint8_t* src_addr;
+};
+
+struct esp_now_peer_info_t {
+  uint8_t peer_addr[ESP_NOW_ETH_ALEN];
+  uint8_t lmk[ESP_NOW_KEY_LEN];
+  uint8_t channel;
+  wifi_interface_t ifidx;
+  bool encrypt;
+  void* priv;
+};
+
+using esp_now_send_cb_t = void (*)(const esp_now_send_info_t* tx_info, esp_now_send_status_t status);
+using esp_now_recv_cb_t = void (*)(const esp_now_recv_info_t* recv_info, const uint8_t* data, int len);
+
+struct HostEspNow {
+  bool initialized = false;
+  esp_now_send_cb_t sendCb = nullptr;
+  esp_now_recv_cb_t recvCb = nullptr;
+  uint8_t ownMac[ESP_NOW_ETH_ALEN] = {0x24, 0x0A, 0xC4, 0xAA, 0x00, 0x01};
+  uint8_t peers[ESP_NOW_MAX_TOTAL_PEER_NUM][ESP_NOW_ETH_ALEN] = {};
+  size_t peerCount = 0;
+  uint32_t addPeerFailures = 0;
+  uint32_t sendRejected = 0;
+  // Returns false when the frame cannot be queued (reported as NO_MEM).
+  bool (*transmit)(const uint8_t dest[ESP_NOW_ETH_ALEN], const uint8_t* data, size_t len) = nullptr;
+};
+
+inline HostEspNow hostEspNow;
+
+inline int hostEspNowFindPeer(const uint8_t* mac) {
+  for (size_t i = 0; i < hostEspNow.peerCount; ++i) {
+    if (memcmp(hostEspNow.peers[i], mac, ESP_NOW_ETH_ALEN) == 0) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+inline esp_err_t esp_now_init() {
+  hostEspNow.initialized = true;
+  return ESP_OK;
+}
+
+inline esp_err_t esp_now_deinit() {
+  hostEspNow = HostEspNow{};
+  return ESP_OK;
+}
+
+inline esp_err_t esp_now_register_send_cb(esp_now_send_cb_t cb) {
+  hostEspNow.sendCb = cb;
+  return ESP_OK;
+}
+
+inline esp_err_t esp_now_register_recv_cb(esp_now_recv_cb_t cb) {
+  hostEspNow.recvCb = cb;
+  return ESP_OK;
+}
+
+inline bool esp_now_is_peer_exist(const uint8_t* peer_addr) {
+  return peer_addr != nullptr && hostEspNowFindPeer(peer_addr) >= 0;
+}
+
+inline esp_err_t esp_now_add_peer(const esp_now_peer_info_t* peer) {
+  if (!hostEspNow.initialized) {
+    return ESP_ERR_ESPNOW_NOT_INIT;
+  }
+  if (peer == nullptr) {
+    return ESP_ERR_ESPNOW_ARG;
+  }
+  if (hostEspNowFindPeer(peer->peer_addr) >= 0) {
+    return ESP_ERR_ESPNOW_EXIST;
+  }
+  if (hostEspNow.peerCount >= ESP_NOW_MAX_TOTAL_PEER_NUM) {
+    hostEspNow.addPeerFailures++;
+    return ESP_ERR_ESPNOW_FULL;
+  }
+  memcpy(hostEspNow.peers[hostEspNow.peerCount++], peer->peer_addr, ESP_NOW_ETH_ALEN);
+  return ESP_OK;
+}
+
+inline esp_err_t esp_now_del_peer(const uint8_t* peer_addr) {
+  const int index = peer_addr == nullptr ? -1 : hostEspNowFindPeer(peer_addr);
+  if (index < 0) {
+    return ESP_ERR_ESPNOW_NOT_FOUND;
+  }
+  hostEspNow.peerCount--;
+  memmove(hostEspNow.peers[index], hostEspNow.peers[index + 1], (hostEspNow.peerCount - index) * ESP_NOW_ETH_ALEN);
+  return ESP_OK;
+}
+
+inline esp_err_t esp_now_send(const uint8_t* peer_addr, const uint8_t* data, size_t len) {
+  if (!hostEspNow.initialized) {
+    return ESP_ERR_ESPNOW_NOT_INIT;
+  }
+  if (peer_addr == nullptr || data == nullptr || len == 0 || len > ESP_NOW_MAX_DATA_LEN) {
+    return ESP_ERR_ESPNOW_ARG;
+  }
+  if (hostEspNowFindPeer(peer_addr) < 0) {
+    hostEspNow.sendRejected++;
+    return ESP_ERR_ESPNOW_NOT_FOUND;
+  }
+  if (hostEspNow.transmit != nullptr && !hostEspNow.transmit(peer_addr, data, len)) {
+    hostEspNow.sendRejected++;
+    return ESP_ERR_ESPNOW_NO_MEM;
+  }
+  return ESP_OK;
+}
+
+inline void hostEspNowReceive(const uint8_t src[ESP_NOW_ETH_ALEN],
+                              const uint8_t dest[ESP_NOW_ETH_ALEN],
+                              const uint8_t* data,
+                              int len,
+                              int8_t rssi = -50) {
+  if (!hostEspNow.initialized || hostEspNow.recvCb == nullptr) {
+    return;
+  }
+  uint8_t srcAddr[ESP_NOW_ETH_ALEN];
+  uint8_t desAddr[ESP_NOW_ETH_ALEN];
+  memcpy(srcAddr, src, sizeof(srcAddr));
+  memcpy(desAddr, dest, sizeof(desAddr));
+  wifi_pkt_rx_ctrl_t rxCtrl = {rssi, hostWifiRadio.channel};
+  const esp_now_recv_info_t info = {srcAddr, desAddr, &rxCtrl};
+  hostEspNow.recvCb(&info, data, len);
+}
+
+inline void hostEspNowSendDone(const uint8_t dest[ESP_NOW_ETH_ALEN], bool delivered) {
+  if (hostEspNow.sendCb == nullptr) {
+    return;
+  }
+  const esp_now_send_info_t info = {dest, hostEspNow.ownMac};
+  hostEspNow.sendCb(&info, delivered ? ESP_NOW_SEND_SUCCESS : ESP_NOW_SEND_FAIL);
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+// Host stand-in: esp_timer_get_time follows the host clock (virtual in
+// simulations); timers themselves are not emulated.
+
+#include <Arduino.h>
+
+using esp_timer_handle_t = struct esp_timer*;
+
+inline int64_t esp_timer_get_time() {
+  return static_cast<int64_t>(hostMicros64());
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+// Host stand-in for the esp_wifi calls used under src/: a single radio
+// whose mode and channel the WiFi/ESP-NOW stand-ins share.
+
+#include <esp_err.h>
+
+#include <cstdint>
+
+enum wifi_mode_t {
+  WIFI_MODE_NULL = 0,
+  WIFI_MODE_STA,
+  WIFI_MODE_AP,
+  WIFI_MODE_APSTA,
+};
+
+enum wifi_interface_t {
+  WIFI_IF_STA = 0,
+  WIFI_IF_AP,
+};
+
+enum wifi_second_chan_t {
+  WIFI_SECOND_CHAN_NONE = 0,
+  WIFI_SECOND_CHAN_ABOVE,
+  WIFI_SECOND_CHAN_BELOW,
+};
+
+struct HostWifiRadio {
+  wifi_mode_t mode = WIFI_MODE_NULL;
+  bool started = false;
+  uint8_t channel = 1;
+};
+
+inline HostWifiRadio hostWifiRadio;
+
+inline esp_err_t esp_wifi_start() {
+  if (hostWifiRadio.mode == WIFI_MODE_NULL) {
+    return ESP_ERR_WIFI_NOT_INIT;
+  }
+  hostWifiRadio.started = true;
+  return ESP_OK;
+}
+
+inline esp_err_t esp_wifi_set_channel(uint8_t primary, wifi_second_chan_t) {
+  if (primary < 1 || primary > 14) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  hostWifiRadio.channel = primary;
+  return ESP_OK;
+}
+
+inline esp_err_t esp_wifi_get_channel(uint8_t* primary, wifi_second_chan_t* second) {
+  if (primary == nullptr || second == nullptr) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  *primary = hostWifiRadio.channel;
+  *second = WIFI_SECOND_CHAN_NONE;
+  return ESP_OK;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+// Host stand-in for the FreeRTOS types and macros used under src/. Native
+// runs are single threaded: critical sections and mutexes are no-ops and
+// task creation fails, so modules fall back to their synchronous paths.
+
+#include <Arduino.h>
+
+#include <cstdint>
+
+using BaseType_t = int;
+using UBaseType_t = unsigned;
+using TickType_t = uint32_t;
+using EventBits_t = uint32_t;
+using TaskHandle_t = void*;
+using TaskFunction_t = void (*)(void*);
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdFAIL 0
+#define pdPASS 1
+#define portMAX_DELAY 0xFFFFFFFFu
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) (static_cast<TickType_t>(ms))
+#define tskNO_AFFINITY 0x7FFFFFFF
+
+#ifndef BIT0
+#define BIT0 (1u << 0)
+#define BIT1 (1u << 1)
+#define BIT2 (1u << 2)
+#define BIT3 (1u << 3)
+#define BIT4 (1u << 4)
+#define BIT5 (1u << 5)
+#define BIT6 (1u << 6)
+#define BIT7 (1u << 7)
+#endif
+
+struct portMUX_TYPE {
+  int owner;
+};
+
+#define portMUX_INITIALIZER_UNLOCKED {0}
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+
+inline TickType_t xTaskGetTickCount() {
+  return millis();
+}
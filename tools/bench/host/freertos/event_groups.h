@@ -0,0 +1,5 @@
+#pragma once
+
+#include "FreeRTOS.h"
+
+using EventGroupHandle_t = void*;
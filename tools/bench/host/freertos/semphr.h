@@ -0,0 +1,33 @@
+#pragma once
+
+#include "FreeRTOS.h"
+
+using SemaphoreHandle_t = void*;
+
+inline SemaphoreHandle_t xSemaphoreCreateMutex() {
+  static int token;
+  return &token;
+}
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t, TickType_t) {
+  return pdTRUE;
+}
+
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t) {
+  return pdTRUE;
+}
+
+inline void vSemaphoreDelete(SemaphoreHandle_t) {}
+
+inline SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() {
+  static int token;
+  return &token;
+}
+
+inline BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t, TickType_t) {
+  return pdTRUE;
+}
+
+inline BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t) {
+  return pdTRUE;
+}
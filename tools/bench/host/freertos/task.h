@@ -0,0 +1,23 @@
+#pragma once
+
+#include "FreeRTOS.h"
+
+#include <Arduino.h>
+
+inline void vTaskDelay(TickType_t ticks) {
+  delay(ticks);
+}
+
+inline void vTaskDelete(TaskHandle_t) {}
+
+inline uint32_t ulTaskNotifyTake(BaseType_t, TickType_t) {
+  return 0;
+}
+
+inline BaseType_t xTaskNotifyGive(TaskHandle_t) {
+  return pdPASS;
+}
+
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t, const char*, uint32_t, void*, UBaseType_t, TaskHandle_t*, BaseType_t) {
+  return pdFAIL;
+}
@@ -0,0 +1,191 @@
+#include "native_checks.h"
+
+#include "app/espnow/camera_fec.h"
+#include "app/espnow/camera_frame_pool.h"
+#include "app/espnow/camera_stream_buffer.h"
+#include "core/crc32.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace native {
+
+using namespace app::espnow;
+
+namespace {
+
+constexpr uint8_t kCameraMac[6] = {0x24, 0x0A, 0xC4, 0x00, 0x00, 0x01};
+constexpr size_t kChunkBytes = state_binary::kCameraChunkDataBytes;
+
+enum class Integrity {
+  Crc32,
+  Checksum16,
+  CorruptCrc32,
+};
+
+struct SendOptions {
+  Integrity integrity = Integrity::Crc32;
+  camera_fec::Layout fec;  // dataPerGroup == 0: no parity
+  std::vector<uint16_t> dropped;  // 1-based data chunk idx
+  bool reversed = false;
+};
+
+// SOI, DQT, SOF0, SOS, entropy bytes without 0xFF, EOI.
+std::vector<uint8_t> makeJpeg(size_t entropyBytes, uint32_t seed) {
+  std::vector<uint8_t> jpeg = {0xFF, 0xD8, 0xFF, 0xDB, 0x00, 0x43, 0x00};
+  jpeg.resize(jpeg.size() + 64, 0x10);
+  const uint8_t sof[] = {0xFF, 0xC0, 0x00, 0x11, 0x08, 0x00, 0xF0, 0x01, 0x40, 0x03,
+                         0x01, 0x21, 0x00, 0x02, 0x11, 0x01, 0x03, 0x11, 0x01};
+  const uint8_t sos[] = {0xFF, 0xDA, 0x00, 0x0C, 0x03, 0x01, 0x00, 0x02, 0x11, 0x03, 0x11, 0x00, 0x3F, 0x00};
+  jpeg.insert(jpeg.end(), sof, sof + sizeof(sof));
+  jpeg.insert(jpeg.end(), sos, sos + sizeof(sos));
+
+  std::mt19937 rng(seed);
+  for (size_t i = 0; i < entropyBytes; ++i) {
+    jpeg.push_back(static_cast<uint8_t>(rng() % 0xFF));
+  }
+  jpeg.push_back(0xFF);
+  jpeg.push_back(0xD9);
+  return jpeg;
+}
+
+uint16_t checksum16(const std::vector<uint8_t>& data) {
+  uint32_t sum = 0;
+  for (const uint8_t byte : data) {
+    sum += byte;
+  }
+  return static_cast<uint16_t>(sum & 0xFFFF);
+}
+
+void sendFrame(uint32_t frameId, const std::vector<uint8_t>& jpeg, const SendOptions& options) {
+  const uint16_t dataChunks = static_cast<uint16_t>((jpeg.size() + kChunkBytes - 1) / kChunkBytes);
+  const bool fec = camera_fec::isValid(options.fec);
+
+  state_binary::CameraMetaState meta = {};
+  state_binary::initHeader(meta.header, state_binary::Type::CameraMeta);
+  meta.frameId = frameId;
+  meta.totalBytes = static_cast<uint32_t>(jpeg.size());
+  meta.totalChunks = dataChunks;
+  meta.width = 320;
+  meta.height = 240;
+  meta.format = fec ? camera_fec::kFormatFecFlag : 0;
+  meta.quality = 12;
+  camera_stream::ingestMeta(kCameraMac, meta);
+
+  std::vector<uint16_t> order(dataChunks);
+  for (uint16_t i = 0; i < dataChunks; ++i) {
+    order[i] = static_cast<uint16_t>(i + 1);
+  }
+  if (options.reversed) {
+    std::reverse(order.begin(), order.end());
+  }
+
+  for (const uint16_t idx : order) {
+    if (std::find(options.dropped.begin(), options.dropped.end(), idx) != options.dropped.end()) {
+      continue;
+    }
+    state_binary::CameraChunkState chunk = {};
+    state_binary::initHeader(chunk.header, state_binary::Type::CameraChunk);
+    chunk.frameId = frameId;
+    chunk.idx = idx;
+    chunk.total = dataChunks;
+    chunk.dataLen = static_cast<uint8_t>(camera_fec::dataChunkLength(static_cast<uint32_t>(jpeg.size()), idx - 1));
+    memcpy(chunk.data, jpeg.data() + (idx - 1) * kChunkBytes, chunk.dataLen);
+    camera_stream::ingestChunk(kCameraMac, chunk);
+  }
+
+  if (fec) {
+    for (uint16_t group = 0; group < camera_fec::groupCount(options.fec, dataChunks); ++group) {
+      for (uint8_t index = 0; index < options.fec.parityPerGroup; ++index) {
+        state_binary::CameraChunkState parity = {};
+        state_binary::initHeader(parity.header, state_binary::Type::CameraChunk);
+        const camera_fec::ParityId id{group, index};
+        parity.frameId = frameId;
+        parity.idx = camera_fec::parityChunkIdx(id);
+        parity.total = camera_fec::parityChunkTotal(options.fec);
+        parity.dataLen = static_cast<uint8_t>(kChunkBytes);
+        camera_fec::buildParity(jpeg.data(), static_cast<uint32_t>(jpeg.size()), options.fec, id, parity.data);
+        camera_stream::ingestChunk(kCameraMac, parity);
+      }
+    }
+  }
+
+  state_binary::CameraFrameEndState frameEnd = {};
+  state_binary::initHeader(frameEnd.header, state_binary::Type::CameraFrameEnd);
+  frameEnd.frameId = frameId;
+  frameEnd.totalBytes = static_cast<uint32_t>(jpeg.size());
+  frameEnd.totalChunks = dataChunks;
+  switch (options.integrity) {
+    case Integrity::Crc32:
+      frameEnd.crc32 = core::crc32(jpeg.data(), jpeg.size());
+      camera_stream::ingestFrameEnd(kCameraMac, frameEnd, true);
+      break;
+    case Integrity::CorruptCrc32:
+      frameEnd.crc32 = core::crc32(jpeg.data(), jpeg.size()) ^ 1u;
+      camera_stream::ingestFrameEnd(kCameraMac, frameEnd, true);
+      break;
+    case Integrity::Checksum16:
+      frameEnd.reserved = checksum16(jpeg);
+      camera_stream::ingestFrameEnd(kCameraMac, frameEnd, false);
+      break;
+  }
+}
+
+bool latestMatches(uint32_t frameId, const std::vector<uint8_t>& jpeg) {
+  camera_frames::FrameRef frame = camera_frames::acquireLatest(kCameraMac);
+  return frame && frame->frameId == frameId && frame->bytes == jpeg.size() && memcmp(frame->jpeg, jpeg.data(), jpeg.size()) == 0;
+}
+
+}  // namespace
+
+void checkCameraReassembly(Context& context) {
+  const std::vector<uint8_t> jpeg = makeJpeg(10000, 1);
+  uint32_t frameId = 100;
+
+  sendFrame(++frameId, jpeg, {});
+  context.expect(latestMatches(frameId, jpeg), "in-order frame with CRC-32 published");
+
+  SendOptions reversed;
+  reversed.reversed = true;
+  sendFrame(++frameId, jpeg, reversed);
+  context.expect(latestMatches(frameId, jpeg), "reversed chunk order published");
+
+  SendOptions legacy;
+  legacy.integrity = Integrity::Checksum16;
+  sendFrame(++frameId, jpeg, legacy);
+  context.expect(latestMatches(frameId, jpeg), "v1 checksum16 frame published");
+
+  const uint32_t goodFrameId = frameId;
+  SendOptions corrupt;
+  corrupt.integrity = Integrity::CorruptCrc32;
+  sendFrame(++frameId, jpeg, corrupt);
+  context.expect(latestMatches(goodFrameId, jpeg), "CRC mismatch not published");
+
+  SendOptions lossy;
+  lossy.dropped = {5, 20};
+  sendFrame(++frameId, jpeg, lossy);
+  context.expect(latestMatches(goodFrameId, jpeg), "lossy frame without FEC not published");
+
+  camera_stream::FecStats before;
+  camera_stream::getFecStats(before);
+  SendOptions protectedFrame = lossy;
+  protectedFrame.fec = {8, 1};
+  sendFrame(++frameId, jpeg, protectedFrame);
+  camera_stream::FecStats after;
+  camera_stream::getFecStats(after);
+  context.expect(latestMatches(frameId, jpeg), "FEC 8+1 rebuilds two dropped chunks");
+  context.expect(after.recoveredChunks - before.recoveredChunks == 2, "FEC stats count recovered chunks");
+
+  const std::vector<uint8_t> noTrailingChunk = makeJpeg(kChunkBytes * 40 - makeJpeg(0, 0).size(), 2);
+  sendFrame(++frameId, noTrailingChunk, {});
+  context.expect(latestMatches(frameId, noTrailingChunk), "frame ending on a chunk boundary published");
+
+  context.bench("reassemble 10 KB frame (63 chunks)", 2000, [&] { sendFrame(++frameId, jpeg, {}); });
+  SendOptions benchFec;
+  benchFec.fec = {8, 1};
+  benchFec.dropped = {5, 20, 33};
+  context.bench("reassemble 10 KB frame, FEC 8+1, 3 lost", 2000, [&] { sendFrame(++frameId, jpeg, benchFec); });
+}
+
+}  // namespace native
@@ -0,0 +1,109 @@
+#include "native_checks.h"
+
+#include "app/espnow/camera_rate_controller.h"
+#include "app/espnow/master.h"
+#include "app/espnow/state_binary.h"
+
+#include <app_config.h>
+
+namespace {
+
+using namespace app::espnow;
+
+constexpr uint8_t kRateCameraMac[6] = {0x24, 0x0A, 0xC4, 0x00, 0x00, 0x02};
+constexpr uint16_t kWidths[] = {160, 240, 320, 400, 640};
+constexpr uint16_t kHeights[] = {120, 176, 240, 296, 480};
+constexpr uint32_t kDecodeUsAt320 = 5000;
+
+struct FakeCamera {
+  uint8_t fps = 5;
+  uint8_t quality = 12;
+  uint8_t sizeLevel = 2;
+  uint32_t frameId = 0;
+  uint32_t commands = 0;
+};
+
+FakeCamera camera;
+
+// One rate window of frames; `completePct` of them arrive whole.
+void runWindow(MasterNode& master, uint32_t completePct) {
+  const uint32_t frames = static_cast<uint32_t>(camera.fps) * MASTER_CAMERA_RATE_WINDOW_MS / 1000;
+  const uint32_t pixels = static_cast<uint32_t>(kWidths[camera.sizeLevel]) * kHeights[camera.sizeLevel];
+  const uint32_t decodeUs = static_cast<uint32_t>(static_cast<uint64_t>(kDecodeUsAt320) * pixels / (320 * 240));
+  const uint64_t stepUs = static_cast<uint64_t>(MASTER_CAMERA_RATE_WINDOW_MS) * 1000 / frames;
+  for (uint32_t i = 0; i < frames; ++i) {
+    hostClock.nowUs += stepUs;
+    const bool complete = i * 100 < frames * completePct;
+    camera_rate::onFrameStarted(kRateCameraMac, ++camera.frameId, camera.quality, kWidths[camera.sizeLevel], kHeights[camera.sizeLevel]);
+    camera_rate::onFrameFinished(kRateCameraMac, complete, complete ? 40 : 30, 40, complete ? decodeUs : 0);
+  }
+  camera_rate::tick(master, millis());
+}
+
+}  // namespace
+
+namespace app::espnow {
+
+// The native build has no master.cpp: camera controls go straight to the
+// fake camera.
+bool MasterNode::send(const uint8_t mac[6], PacketType, const void* payload, size_t payloadSize) {
+  if (memcmp(mac, kRateCameraMac, sizeof(kRateCameraMac)) != 0 || payloadSize < sizeof(state_binary::CameraControlCommand)) {
+    return false;
+  }
+
+  const auto* command = static_cast<const state_binary::CameraControlCommand*>(payload);
+  switch (static_cast<state_binary::CameraControlAction>(command->action)) {
+    case state_binary::CameraControlAction::SetTargetFps:
+      camera.fps = command->value;
+      break;
+    case state_binary::CameraControlAction::SetQuality:
+      camera.quality = command->value;
+      break;
+    case state_binary::CameraControlAction::SetFrameSize:
+      camera.sizeLevel = command->value;
+      break;
+    default:
+      return false;
+  }
+  camera.commands++;
+  return true;
+}
+
+}  // namespace app::espnow
+
+namespace native {
+
+void checkCameraRate(Context& context) {
+  const HostClock savedClock = hostClock;
+  hostClock.virtualTime = true;
+  hostClock.nowUs = static_cast<uint64_t>(MASTER_CAMERA_RATE_WINDOW_MS) * 1000;
+
+  MasterNode master;
+  camera = FakeCamera{};
+  const uint8_t startSize = camera.sizeLevel;
+
+  for (int window = 0; window < 40 && camera.sizeLevel == startSize; ++window) {
+    runWindow(master, 50);
+  }
+  context.expect(camera.sizeLevel == startSize - 1, "sustained loss steps the frame size down");
+  context.expect(camera.fps == 1, "sustained loss drops to 1 fps first");
+  context.expect(camera.quality > 12, "sustained loss lowers quality before frame size");
+
+  bool overshoot = false;
+  for (int window = 0; window < 80 && camera.sizeLevel != startSize; ++window) {
+    runWindow(master, 100);
+  }
+  for (int window = 0; window < 5; ++window) {
+    runWindow(master, 100);
+    overshoot = overshoot || camera.sizeLevel > startSize;
+  }
+  context.expect(camera.sizeLevel == startSize, "clean windows step the frame size back up");
+  context.expect(!overshoot, "frame size never exceeds the starting size");
+  context.expect(camera.fps == MASTER_CAMERA_MAX_FPS, "clean windows restore fps to the cap");
+  context.expect(camera.quality == 10, "clean windows restore the best quality");
+  printf("  down and back up with %lu control commands\n", static_cast<unsigned long>(camera.commands));
+
+  hostClock = savedClock;
+}
+
+}  // namespace native
@@ -0,0 +1,24 @@
+// Link-time stand-ins for modules the native build does not compile: the
+// filesystem is always mounted, and the recorder hook called by the
+// reassembler is a no-op.
+
+#include "app/espnow/camera_recorder.h"
+#include "core/boot.h"
+
+namespace core::boot {
+
+bool isFsReady() {
+  return true;
+}
+
+bool isFsMounted() {
+  return true;
+}
+
+}  // namespace core::boot
+
+namespace app::espnow::camera_recorder {
+
+void onFrameComplete(const uint8_t[6], const uint8_t*, uint32_t, uint32_t, uint16_t, uint16_t) {}
+
+}  // namespace app::espnow::camera_recorder
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+
+namespace native {
+
+struct Context {
+  int failures = 0;
+
+  void expect(bool condition, const char* what) {
+    if (!condition) {
+      ++failures;
+      printf("  FAIL %s\n", what);
+    }
+  }
+
+  template <typename Fn>
+  void bench(const char* name, int iterations, Fn&& fn) {
+    fn();
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+      fn();
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    const double nsPerOp = std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+    printf("  %-40s %12.1f ns/op\n", name, nsPerOp);
+  }
+};
+
+void checkPayloadCodec(Context& context);
+void checkStateSchema(Context& context);
+void checkKvStore(Context& context);
+void checkCameraReassembly(Context& context);
+void checkCameraRate(Context& context);
+void checkProxyChunker(Context& context);
+
+}  // namespace native
@@ -0,0 +1,47 @@
+// Host self-checks and microbenchmarks for the ESP-NOW master core, built by
+// the `native` PlatformIO env against the stand-ins in tools/bench/host:
+//
+//   platformio run -e native && .pio/build/native/program
+//
+// Each section prints ns/op for its hot paths and exits non-zero if any
+// check fails. LittleFS is a temp directory ($ESPNOW_HOST_FS to pin it).
+
+#include "native_checks.h"
+
+#include <LittleFS.h>
+
+namespace {
+
+struct Section {
+  const char* name;
+  void (*run)(native::Context&);
+};
+
+constexpr Section kSections[] = {
+    {"payload_codec", native::checkPayloadCodec},
+    {"state_schema", native::checkStateSchema},
+    {"state_kv_store", native::checkKvStore},
+    {"camera_reassembly", native::checkCameraReassembly},
+    {"camera_rate", native::checkCameraRate},
+    {"proxy_chunker", native::checkProxyChunker},
+};
+
+}  // namespace
+
+int main() {
+  printf("host fs: %s\n", LittleFS.root().c_str());
+
+  native::Context context;
+  for (const auto& section : kSections) {
+    const int failuresBefore = context.failures;
+    printf("[%s]\n", section.name);
+    section.run(context);
+    printf("  %s\n", context.failures == failuresBefore ? "ok" : "FAILED");
+  }
+
+  if (context.failures != 0) {
+    printf("%d check(s) failed\n", context.failures);
+    return 1;
+  }
+  return 0;
+}
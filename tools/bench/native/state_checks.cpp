@@ -0,0 +1,184 @@
+#include "native_checks.h"
+
+#include "app/espnow/master_state_kv_store.h"
+#include "app/espnow/proxy_chunker.h"
+#include "app/espnow/state_schema.h"
+
+#include <string>
+
+namespace native {
+
+using namespace app::espnow;
+
+void checkPayloadCodec(Context& context) {
+  static constexpr const char* kPayloads[] = {
+      "state=sensor|---|temp=27.4C|---|hum=61.0%",
+      "state=weather|---|ok=1|---|code=3|---|time=2026-10-18T09:00|---|temperature=29.1|---|windspeed=11.2|---|winddirection=240",
+      "state=camera|---|frame=18233|---|bytes=14211|---|chunks=89|---|w=320|---|h=240",
+      "state=proxy_req|---|method=GET|---|url=https://api.open-meteo.com/v1/forecast?latitude=-6.2&longitude=106.8&current_weather=true|---|payload={}",
+  };
+  static constexpr const char* kLookupKeys[] = {"state", "temp", "code", "bytes", "url", "missing"};
+
+  bool viewMatchesGetField = true;
+  for (const char* payload : kPayloads) {
+    const String text(payload);
+    const codec::PayloadView view(text);
+    for (const char* key : kLookupKeys) {
+      String expected;
+      const bool expectedFound = codec::getField(text, key, expected);
+      codec::Span actual;
+      const bool actualFound = view.get(key, actual);
+      viewMatchesGetField = viewMatchesGetField && expectedFound == actualFound &&
+                            (!expectedFound || actual.equals(expected.c_str()));
+    }
+  }
+  context.expect(viewMatchesGetField, "PayloadView lookups match getField");
+
+  const codec::PayloadView padded(" state = sensor |---|temp= 21.5 |---|novalue|---|=orphan");
+  codec::Span value;
+  context.expect(padded.size() == 2, "fields without a key are skipped");
+  context.expect(padded.get("state", value) && value.equals("sensor"), "keys and values are trimmed");
+  float number = 0.0f;
+  context.expect(padded.get("temp", value) && value.toFloat(number) && number == 21.5f, "Span::toFloat");
+  context.expect(!padded.get("hum", value), "missing key not found");
+
+  char buffer[64];
+  codec::PayloadWriter writer(buffer, sizeof(buffer));
+  writer.add("state", "sensor").addTenths("temp", 274, "C").addTenths("hum", 610, "%").add("skip", "");
+  const String built = codec::buildPayload({{"state", "sensor"}, {"temp", "27.4C"}, {"hum", "61.0%"}, {"skip", ""}});
+  context.expect(built == writer.c_str(), "PayloadWriter matches buildPayload");
+
+  char small[24];
+  codec::PayloadWriter truncated(small, sizeof(small));
+  truncated.add("state", "sensor").add("temp", "27.4C");
+  context.expect(!truncated.ok() && strcmp(small, "state=sensor") == 0, "overflow truncates at a field boundary");
+
+  static constexpr size_t kPayloadCount = sizeof(kPayloads) / sizeof(kPayloads[0]);
+  String texts[kPayloadCount];
+  for (size_t i = 0; i < kPayloadCount; ++i) {
+    texts[i] = kPayloads[i];
+  }
+
+  volatile size_t sink = 0;
+  size_t next = 0;
+  context.bench("PayloadView parse + get x6", 200000, [&] {
+    const codec::PayloadView view(texts[next++ % kPayloadCount]);
+    for (const char* key : kLookupKeys) {
+      codec::Span found;
+      sink = sink + (view.get(key, found) ? found.size : 0);
+    }
+  });
+  context.bench("PayloadWriter (sensor)", 200000, [&] {
+    char out[64];
+    codec::PayloadWriter benchWriter(out, sizeof(out));
+    benchWriter.add("state", "sensor").addTenths("temp", 200 + static_cast<long>(next++ % 100), "C").addTenths("hum", 610, "%");
+    sink = sink + benchWriter.size();
+  });
+}
+
+void checkStateSchema(Context& context) {
+  state_binary::SensorState sensor = {};
+  state_binary::initHeader(sensor.header, state_binary::Type::Sensor);
+  sensor.temperature10 = 215;
+  sensor.humidity10 = 404;
+  const auto* bytes = reinterpret_cast<const uint8_t*>(&sensor);
+
+  const state_schema::Schema* schema = state_schema::validate(bytes, sizeof(sensor));
+  context.expect(schema != nullptr && schema->type == state_binary::Type::Sensor, "sensor payload validates");
+  context.expect(state_schema::validate(bytes, sizeof(sensor) - 1) == nullptr, "short sensor payload rejected");
+
+  state_binary::SensorState badMagic = sensor;
+  badMagic.header.magic ^= 0xFF;
+  context.expect(state_schema::validate(reinterpret_cast<const uint8_t*>(&badMagic), sizeof(badMagic)) == nullptr,
+                 "bad magic rejected");
+
+  state_binary::CameraFrameEndState frameEnd = {};
+  state_binary::initHeader(frameEnd.header, state_binary::Type::CameraFrameEnd);
+  const auto* frameEndBytes = reinterpret_cast<const uint8_t*>(&frameEnd);
+  context.expect(state_schema::validate(frameEndBytes, sizeof(frameEnd)) != nullptr, "frame end v2 validates");
+  context.expect(state_schema::validate(frameEndBytes, state_binary::kCameraFrameEndV1Size) != nullptr, "frame end v1 validates");
+  context.expect(state_schema::validate(frameEndBytes, state_binary::kCameraFrameEndV1Size - 1) == nullptr,
+                 "frame end below v1 rejected");
+
+  state_binary::CameraControlCommand control = {};
+  state_binary::initHeader(control.header, state_binary::Type::CameraControl);
+  context.expect(state_schema::validate(reinterpret_cast<const uint8_t*>(&control), sizeof(control)) == nullptr,
+                 "master-to-slave type rejected inbound");
+
+  char text[MAX_PAYLOAD_SIZE + 1] = {0};
+  codec::PayloadWriter writer(text, sizeof(text));
+  state_schema::renderText(*schema, bytes, writer);
+  context.expect(std::string(text).find("temp=21.5C") != std::string::npos, "sensor renders temp=21.5C");
+
+  // Volatile size and sink keep validate() from being hoisted out of the loop.
+  const void* volatile sink = nullptr;
+  volatile size_t sensorSize = sizeof(sensor);
+  context.bench("validate(sensor)", 1000000, [&] { sink = state_schema::validate(bytes, sensorSize); });
+  context.bench("renderText(sensor)", 200000, [&] {
+    codec::PayloadWriter benchWriter(text, sizeof(text));
+    state_schema::renderText(*schema, bytes, benchWriter);
+  });
+  (void)sink;
+}
+
+void checkKvStore(Context& context) {
+  const String first = "state=sensor|---|temp=21.5|---|hum=40.4";
+  context.expect(state_store::upsertFromStatePayload(first), "first upsert");
+
+  String value;
+  context.expect(state_store::getLatestValue("sensor", "temp", value) && value == "21.5", "temp readback");
+  context.expect(state_store::getLatestValue("sensor", "hum", value) && value == "40.4", "hum readback");
+
+  context.expect(state_store::upsertFromStatePayload("state=sensor|---|temp=22.0"), "second upsert");
+  context.expect(state_store::getLatestValue("sensor", "temp", value) && value == "22.0", "temp updated");
+
+  context.expect(state_store::upsertFromStatePayload("state=weather|---|ok=0|---|code=99"), "failed status accepted");
+  context.expect(!state_store::getLatestValue("weather", "code", value), "failed status not stored");
+
+  uint32_t lastUpdateMs = 0;
+  context.expect(state_store::getLastUpdateMs("sensor", lastUpdateMs), "sensor timestamp tracked");
+
+  char payload[64];
+  int counter = 0;
+  context.bench("upsert unchanged value", 100000, [&] { state_store::upsertFromStatePayload(first); });
+  context.bench("upsert changed value (journal append)", 5000, [&] {
+    snprintf(payload, sizeof(payload), "state=bench|---|counter=%d", counter++);
+    state_store::upsertFromStatePayload(payload);
+  });
+  context.bench("getLatestValue", 200000, [&] { state_store::getLatestValue("sensor", "temp", value); });
+}
+
+void checkProxyChunker(Context& context) {
+  for (const size_t length : {size_t{0}, size_t{1}, size_t{160}, size_t{161}, size_t{1000}}) {
+    std::string body(length, '\0');
+    for (size_t i = 0; i < length; ++i) {
+      body[i] = static_cast<char>('a' + i % 26);
+    }
+
+    const size_t total = proxy_chunks::count(length);
+    std::string rebuilt;
+    bool headersOk = true;
+    for (size_t index = 0; index < total; ++index) {
+      state_binary::ProxyRespChunkCommand command;
+      proxy_chunks::fill(command, 7, index, total, 1, 200, body.data(), body.size());
+      headersOk = headersOk && command.idx == index + 1 && command.total == total && command.requestId == 7 &&
+                  command.code == 200 && state_binary::hasValidHeader(reinterpret_cast<const uint8_t*>(&command), sizeof(command));
+      rebuilt.append(reinterpret_cast<const char*>(command.data), command.dataLen);
+    }
+
+    char what[64];
+    snprintf(what, sizeof(what), "%u-byte body round trips", static_cast<unsigned>(length));
+    context.expect(headersOk && rebuilt == body, what);
+  }
+
+  const std::string body(4096, 'x');
+  state_binary::ProxyRespChunkCommand command;
+  context.bench("chunk 4 KB body", 100000, [&] {
+    const size_t total = proxy_chunks::count(body.size());
+    for (size_t index = 0; index < total; ++index) {
+      proxy_chunks::fill(command, 1, index, total, 1, 200, body.data(), body.size());
+    }
+  });
+}
+
+}  // namespace native
@@ -0,0 +1,143 @@
+// Host microbenchmark: String-based codec::getField/buildPayload versus
+// PayloadView/PayloadWriter. Build and run from the repo root:
+//
+//   g++ -std=gnu++17 -O2 -Itools/bench/host -Isrc tools/bench/payload_codec_bench.cpp -o /tmp/codec_bench
+//   /tmp/codec_bench
+//
+// Besides ns/op it reports heap allocations per op, and exits non-zero if the
+// two implementations disagree on any lookup.
+
+#include "app/espnow/payload_codec.h"
+
+#include <chrono>
+#include <cstdio>
+#include <new>
+
+namespace {
+
+size_t allocationCount = 0;
+
+}  // namespace
+
+void* operator new(size_t size) {
+  ++allocationCount;
+  if (void* ptr = malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+  free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  free(ptr);
+}
+
+namespace {
+
+using namespace app::espnow::codec;
+
+static constexpr const char* kPayloads[] = {
+    "state=sensor|---|temp=27.4C|---|hum=61.0%",
+    "state=weather|---|ok=1|---|code=3|---|time=2026-10-18T09:00|---|temperature=29.1|---|windspeed=11.2|---|winddirection=240",
+    "state=camera|---|frame=18233|---|bytes=14211|---|chunks=89|---|w=320|---|h=240",
+    "state=proxy_req|---|method=GET|---|url=https://api.open-meteo.com/v1/forecast?latitude=-6.2&longitude=106.8&current_weather=true|---|payload={}",
+};
+
+static constexpr const char* kLookupKeys[] = {"state", "temp", "code", "bytes", "url", "missing"};
+
+template <typename Fn>
+void run(const char* name, size_t iterations, Fn&& fn) {
+  const size_t allocationsBefore = allocationCount;
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; ++i) {
+    fn(i);
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  const double ns = std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+  const double allocs = static_cast<double>(allocationCount - allocationsBefore) / iterations;
+  printf("%-28s %9.1f ns/op %7.2f allocs/op\n", name, ns, allocs);
+}
+
+bool checkEquivalence() {
+  bool ok = true;
+  for (const char* payload : kPayloads) {
+    const String text(payload);
+    const PayloadView view(text);
+    for (const char* key : kLookupKeys) {
+      String expected;
+      const bool expectedFound = getField(text, key, expected);
+      Span actual;
+      const bool actualFound = view.get(key, actual);
+      if (expectedFound != actualFound || (expectedFound && !actual.equals(expected.c_str()))) {
+        printf("MISMATCH key=%s payload=%s\n", key, payload);
+        ok = false;
+      }
+    }
+  }
+
+  char buffer[256];
+  PayloadWriter writer(buffer, sizeof(buffer));
+  writer.add("state", "sensor").addTenths("temp", 274, "C").addTenths("hum", 610, "%").add("skip", "");
+  const String built = buildPayload({{"state", "sensor"}, {"temp", "27.4C"}, {"hum", "61.0%"}, {"skip", ""}});
+  if (built != writer.c_str()) {
+    printf("MISMATCH writer=%s build=%s\n", writer.c_str(), built.c_str());
+    ok = false;
+  }
+  return ok;
+}
+
+}  // namespace
+
+int main() {
+  if (!checkEquivalence()) {
+    return 1;
+  }
+
+  static constexpr size_t kIterations = 200000;
+  static constexpr size_t kPayloadCount = sizeof(kPayloads) / sizeof(kPayloads[0]);
+  static constexpr size_t kKeyCount = sizeof(kLookupKeys) / sizeof(kLookupKeys[0]);
+  volatile size_t sink = 0;
+
+  String texts[kPayloadCount];
+  for (size_t i = 0; i < kPayloadCount; ++i) {
+    texts[i] = kPayloads[i];
+  }
+
+  run("getField x6", kIterations, [&](size_t i) {
+    const String& text = texts[i % kPayloadCount];
+    for (size_t k = 0; k < kKeyCount; ++k) {
+      String value;
+      sink += getField(text, kLookupKeys[k], value) ? value.length() : 0;
+    }
+  });
+
+  run("PayloadView parse + get x6", kIterations, [&](size_t i) {
+    const PayloadView view(texts[i % kPayloadCount]);
+    for (size_t k = 0; k < kKeyCount; ++k) {
+      Span value;
+      sink += view.get(kLookupKeys[k], value) ? value.size : 0;
+    }
+  });
+
+  run("buildPayload (sensor)", kIterations, [&](size_t i) {
+    const int16_t temp10 = static_cast<int16_t>(200 + (i % 100));
+    const String payload = buildPayload({
+        {"state", "sensor"},
+        {"temp", String(temp10 / 10.0f, 1) + "C"},
+        {"hum", String(61.0f, 1) + "%"},
+    });
+    sink += payload.length();
+  });
+
+  run("PayloadWriter (sensor)", kIterations, [&](size_t i) {
+    char buffer[64];
+    PayloadWriter writer(buffer, sizeof(buffer));
+    writer.add("state", "sensor").addTenths("temp", 200 + static_cast<long>(i % 100), "C").addTenths("hum", 610, "%");
+    sink += writer.size();
+  });
+
+  return sink == 0 ? 1 : 0;
+}
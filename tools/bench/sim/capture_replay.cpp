@@ -0,0 +1,214 @@
+// Deterministic replay of a master packet capture (.encp, written by
+// /capture/dump on the device): RX records go through the real receive
+// callback on the virtual clock, loop() runs every loopMs in between, and
+// every master transmission is acknowledged as delivered once the handler
+// that sent it has returned.
+
+#include "espnow_sim.h"
+#include "sim_metrics.h"
+
+#include "app/espnow/master.h"
+#include "app/espnow/packet_capture.h"
+
+#include <esp_now.h>
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace sim {
+
+namespace {
+
+using namespace app::espnow;
+
+constexpr uint64_t kStartUs = 1000000;
+
+struct Replay {
+  ReplayResults* out = nullptr;
+  std::vector<std::array<uint8_t, 6>> pendingDone;
+  std::vector<std::array<uint8_t, 6>> sources;
+};
+
+Replay* activeReplay = nullptr;
+
+bool readFile(const char* path, std::vector<uint8_t>& bytes) {
+  FILE* file = fopen(path, "rb");
+  if (file == nullptr) {
+    return false;
+  }
+  fseek(file, 0, SEEK_END);
+  const long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  bytes.resize(size > 0 ? static_cast<size_t>(size) : 0);
+  const bool ok = fread(bytes.data(), 1, bytes.size(), file) == bytes.size();
+  fclose(file);
+  return ok;
+}
+
+bool onTransmit(const uint8_t dest[6], const uint8_t*, size_t) {
+  activeReplay->out->master.txFrames++;
+  std::array<uint8_t, 6> mac;
+  memcpy(mac.data(), dest, mac.size());
+  activeReplay->pendingDone.push_back(mac);
+  return true;
+}
+
+void onFrameCompleted(const uint8_t*, uint32_t) {
+  activeReplay->out->master.framesCompleted++;
+}
+
+void flushSendDone() {
+  // Callbacks may send again; swap so those land in the next flush.
+  std::vector<std::array<uint8_t, 6>> done;
+  done.swap(activeReplay->pendingDone);
+  for (const auto& mac : done) {
+    hostEspNowSendDone(mac.data(), true);
+  }
+}
+
+void noteSource(const uint8_t mac[6]) {
+  for (const auto& known : activeReplay->sources) {
+    if (memcmp(known.data(), mac, 6) == 0) {
+      return;
+    }
+  }
+  std::array<uint8_t, 6> entry;
+  memcpy(entry.data(), mac, entry.size());
+  activeReplay->sources.push_back(entry);
+}
+
+}  // namespace
+
+bool replay(const ReplayConfig& config, ReplayResults& out) {
+  out = ReplayResults{};
+  std::vector<uint8_t> bytes;
+  if (config.path == nullptr || !readFile(config.path, bytes)) {
+    fprintf(stderr, "cannot read capture %s\n", config.path != nullptr ? config.path : "(null)");
+    return false;
+  }
+
+  capture::FileHeader fileHeader;
+  if (bytes.size() < sizeof(fileHeader)) {
+    fprintf(stderr, "capture too short\n");
+    return false;
+  }
+  memcpy(&fileHeader, bytes.data(), sizeof(fileHeader));
+  if (memcmp(fileHeader.magic, capture::kMagic, sizeof(fileHeader.magic)) != 0 ||
+      fileHeader.version != capture::kVersion || fileHeader.recordHeaderBytes < sizeof(capture::RecordHeader)) {
+    fprintf(stderr, "not a version %u capture\n", capture::kVersion);
+    return false;
+  }
+  out.overwritten = fileHeader.overwritten;
+  out.dumpEpochSec = fileHeader.dumpEpochSec;
+
+  Replay state;
+  state.out = &out;
+  activeReplay = &state;
+  hostClock.virtualTime = true;
+  hostClock.nowUs = kStartUs;
+  hostEspNow.transmit = &onTransmit;
+  setFrameListener(&onFrameCompleted);
+  espnowMaster.begin(1);
+  flushSendDone();
+
+  const double speed = config.speed > 0 ? config.speed : 1.0;
+  const uint64_t loopUs = static_cast<uint64_t>(config.loopMs) * 1000ULL;
+  const auto wallStart = std::chrono::steady_clock::now();
+  const size_t heapBaseline = heapInUse();
+  CpuHistogram rxCpu;
+  uint64_t loopCpuNs = 0;
+  uint64_t loopCount = 0;
+  uint64_t capturedUs = 0;
+  uint64_t nextLoopUs = kStartUs;
+
+  auto sampleHeap = [&]() {
+    const size_t inUse = heapInUse();
+    if (inUse > heapBaseline) {
+      out.master.heapPeakBytes = std::max(out.master.heapPeakBytes, inUse - heapBaseline);
+    }
+  };
+  auto advanceTo = [&](uint64_t atUs) {
+    while (nextLoopUs <= atUs) {
+      hostClock.nowUs = nextLoopUs;
+      const uint64_t before = threadCpuNs();
+      espnowMaster.loop();
+      loopCpuNs += threadCpuNs() - before;
+      loopCount++;
+      flushSendDone();
+      sampleHeap();
+      nextLoopUs += loopUs;
+    }
+    hostClock.nowUs = atUs;
+    if (config.realtime) {
+      std::this_thread::sleep_until(wallStart + std::chrono::microseconds(atUs - kStartUs));
+    }
+  };
+
+  bool ok = true;
+  size_t offset = sizeof(fileHeader);
+  while (offset < bytes.size()) {
+    capture::RecordHeader record;
+    if (bytes.size() - offset < fileHeader.recordHeaderBytes) {
+      ok = false;
+      break;
+    }
+    memcpy(&record, bytes.data() + offset, sizeof(record));
+    offset += fileHeader.recordHeaderBytes;
+    if (bytes.size() - offset < record.length) {
+      ok = false;
+      break;
+    }
+    const uint8_t* frame = bytes.data() + offset;
+    offset += record.length;
+
+    capturedUs += record.deltaUs;
+    advanceTo(kStartUs + static_cast<uint64_t>(capturedUs / speed));
+    if (record.direction == static_cast<uint8_t>(capture::Direction::Tx)) {
+      out.txRecords++;
+      continue;
+    }
+
+    out.rxRecords++;
+    noteSource(record.mac);
+    const uint64_t before = threadCpuNs();
+    hostEspNowReceive(record.mac, hostEspNow.ownMac, frame, record.length, record.rssi);
+    rxCpu.add(threadCpuNs() - before);
+    out.master.rxFrames++;
+    out.master.rxBytes += record.length;
+    flushSendDone();
+    sampleHeap();
+  }
+  advanceTo(hostClock.nowUs + loopUs);
+  if (!ok) {
+    fprintf(stderr, "capture truncated at byte %zu\n", offset);
+  }
+
+  out.sources = static_cast<uint16_t>(state.sources.size());
+  out.capturedSeconds = capturedUs / 1e6;
+  Results& master = out.master;
+  master.peers = out.sources;
+  master.tracked = static_cast<uint16_t>(getTrackedDeviceSnapshotCount());
+  for (const auto& mac : state.sources) {
+    master.verified += isTrackedDeviceVerified(mac.data()) ? 1 : 0;
+  }
+  master.txRejected = hostEspNow.sendRejected;
+  master.addPeerFailures = hostEspNow.addPeerFailures;
+  master.cpuPerRxMeanUs = rxCpu.meanUs();
+  master.cpuPerRxP50Us = rxCpu.percentileUs(0.50);
+  master.cpuPerRxP99Us = rxCpu.percentileUs(0.99);
+  master.cpuPerRxMaxUs = rxCpu.maxUs();
+  master.cpuPerLoopMeanUs = loopCount == 0 ? 0 : loopCpuNs / 1000.0 / loopCount;
+  master.heapMeasured = heapSupported();
+  master.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+  setFrameListener(nullptr);
+  hostEspNow.transmit = nullptr;
+  activeReplay = nullptr;
+  return ok;
+}
+
+}  // namespace sim
@@ -0,0 +1,653 @@
+#include "espnow_sim.h"
+#include "sim_metrics.h"
+
+#include "app/espnow/batch_frame.h"
+#include "app/espnow/camera_frame_pool.h"
+#include "app/espnow/master.h"
+#include "app/espnow/packet_capture.h"
+#include "app/espnow/protocol.h"
+#include "app/espnow/state_binary.h"
+#include "core/crc32.h"
+
+#include <LittleFS.h>
+#include <esp_now.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace sim {
+
+namespace {
+
+using namespace app::espnow;
+
+constexpr uint8_t kBroadcastMac[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+constexpr char kSlaveBeacon[] = "PIO_SLAVE_SIM";
+constexpr uint64_t kStartUs = 1000000;
+constexpr uint32_t kBootSpreadUs = 2000000;
+constexpr uint32_t kVerifyPollUs = 100000;
+// 802.11b long preamble plus vendor action frame overhead, for phyKbps.
+constexpr uint32_t kPreambleUs = 192;
+constexpr uint32_t kFrameOverheadBytes = 43;
+constexpr size_t kQueueReserve = 1 << 15;
+
+// camera_rate_controller's frame size levels.
+struct FrameSize {
+  uint16_t width;
+  uint16_t height;
+};
+constexpr FrameSize kFrameSizes[] = {{160, 120}, {240, 176}, {320, 240}, {400, 296}, {640, 480}};
+constexpr uint8_t kFrameSizeCount = sizeof(kFrameSizes) / sizeof(kFrameSizes[0]);
+constexpr uint8_t kDefaultSizeLevel = 2;
+constexpr uint8_t kDefaultQuality = 12;
+constexpr uint32_t kMinFrameBytes = 600;
+constexpr uint32_t kMaxFrameBytes = camera_frames::kMaxJpegBytes - 512;
+
+enum class EventKind : uint8_t {
+  ToMaster,
+  ToSlave,
+  SendDone,
+  SlaveWake,
+  MasterLoop,
+};
+
+struct Event {
+  uint64_t atUs = 0;
+  uint64_t order = 0;
+  EventKind kind = EventKind::MasterLoop;
+  bool delivered = false;
+  uint16_t slave = 0;
+  uint16_t length = 0;
+  uint8_t bytes[ESP_NOW_MAX_DATA_LEN];
+};
+
+struct Later {
+  bool operator()(const Event& a, const Event& b) const {
+    return a.atUs != b.atUs ? a.atUs > b.atUs : a.order > b.order;
+  }
+};
+
+struct Slave {
+  uint8_t mac[6] = {0};
+  bool camera = false;
+  char id[24] = {0};
+  uint64_t bootUs = 0;
+  bool locked = false;
+  uint16_t sequence = 0;
+  uint64_t wakeUs = UINT64_MAX;
+
+  uint64_t nextSensorUs = 0;
+  uint64_t nextWeatherUs = 0;
+
+  uint8_t fps = 0;
+  uint8_t quality = kDefaultQuality;
+  uint8_t sizeLevel = kDefaultSizeLevel;
+  uint32_t frameId = 0;
+  uint64_t nextFrameUs = 0;
+  uint64_t frameStartUs = 0;
+  bool sending = false;
+  uint32_t step = 0;
+  uint16_t dataChunks = 0;
+  uint16_t parityChunks = 0;
+  uint32_t crc = 0;
+  std::vector<uint8_t> jpeg;
+};
+
+class Simulation;
+Simulation* activeSimulation = nullptr;
+
+class Simulation {
+ public:
+  Simulation(const Config& config, Results& results) : config_(config), results_(results), rng_(config.seed) {}
+
+  void run() {
+    const auto wallStart = std::chrono::steady_clock::now();
+    hostClock.virtualTime = true;
+    hostClock.nowUs = kStartUs;
+    activeSimulation = this;
+    hostEspNow.transmit = &Simulation::masterTransmit;
+    setFrameListener(&Simulation::onFrameCompleted);
+
+    setupSlaves();
+    queue_.reserve(kQueueReserve);
+    espnowMaster.begin(1);
+    if (config_.capture) {
+      capture::setEnabled(true);
+    }
+
+    schedule(kStartUs, EventKind::MasterLoop, 0);
+    const uint64_t endUs = kStartUs + static_cast<uint64_t>(config_.seconds) * 1000000ULL;
+    heapBaseline_ = heapInUse();
+
+    while (!queue_.empty() && queue_.front().atUs <= endUs) {
+      std::pop_heap(queue_.begin(), queue_.end(), Later());
+      const Event event = queue_.back();
+      queue_.pop_back();
+      hostClock.nowUs = event.atUs;
+      dispatch(event);
+    }
+    hostClock.nowUs = endUs;
+
+    char capturePath[48];
+    if (config_.capture && capture::dump(capturePath, sizeof(capturePath))) {
+      fprintf(stderr, "capture: %s%s\n", LittleFS.root().c_str(), capturePath);
+    }
+    finish(std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count());
+  }
+
+  static void onFrameCompleted(const uint8_t mac[6], uint32_t) {
+    activeSimulation->frameCompleted(mac);
+  }
+
+  void frameCompleted(const uint8_t mac[6]) {
+    const int index = slaveIndex(mac);
+    if (index >= 0 && slaves_[index].camera) {
+      results_.framesCompleted++;
+    }
+  }
+
+ private:
+  // Slave MACs encode their index so the air can route without a lookup.
+  static void slaveMac(uint16_t index, bool camera, uint8_t out[6]) {
+    out[0] = 0x24;
+    out[1] = 0x0A;
+    out[2] = 0xC4;
+    out[3] = camera ? 0xCA : 0x5E;
+    out[4] = static_cast<uint8_t>(index >> 8);
+    out[5] = static_cast<uint8_t>(index & 0xFF);
+  }
+
+  int slaveIndex(const uint8_t mac[6]) const {
+    const uint16_t index = static_cast<uint16_t>((mac[4] << 8) | mac[5]);
+    if (index >= slaves_.size() || memcmp(slaves_[index].mac, mac, 6) != 0) {
+      return -1;
+    }
+    return index;
+  }
+
+  double uniform() { return std::uniform_real_distribution<double>(0.0, 1.0)(rng_); }
+
+  uint32_t below(uint32_t bound) { return bound == 0 ? 0 : static_cast<uint32_t>(rng_() % bound); }
+
+  void setupSlaves() {
+    const uint16_t cameras = static_cast<uint16_t>(std::lround(config_.peers * config_.cameraShare));
+    results_.peers = config_.peers;
+    results_.cameras = std::min(cameras, config_.peers);
+
+    entropy_.resize(camera_frames::kMaxJpegBytes * 2);
+    for (auto& byte : entropy_) {
+      byte = static_cast<uint8_t>(rng_() % 0xFF);
+    }
+
+    slaves_.resize(config_.peers);
+    for (uint16_t index = 0; index < config_.peers; ++index) {
+      Slave& slave = slaves_[index];
+      // Spread cameras through the fleet rather than at one end.
+      slave.camera = results_.cameras > 0 && (index * results_.cameras) / config_.peers !=
+                                                  ((index + 1) * results_.cameras) / config_.peers;
+      slaveMac(index, slave.camera, slave.mac);
+      snprintf(slave.id, sizeof(slave.id), "%s-sim-%03u", slave.camera ? "cam" : "weather", index);
+      slave.bootUs = kStartUs + below(kBootSpreadUs);
+      slave.fps = config_.cameraFps;
+      if (slave.camera) {
+        slave.jpeg.reserve(camera_frames::kMaxJpegBytes);
+      }
+    }
+  }
+
+  void schedule(uint64_t atUs, EventKind kind, uint16_t slave, const uint8_t* data = nullptr, size_t length = 0,
+                bool delivered = false) {
+    queue_.emplace_back();
+    Event& event = queue_.back();
+    event.atUs = atUs;
+    event.order = nextOrder_++;
+    event.kind = kind;
+    event.delivered = delivered;
+    event.slave = slave;
+    event.length = static_cast<uint16_t>(length);
+    if (length > 0) {
+      memcpy(event.bytes, data, length);
+    }
+    std::push_heap(queue_.begin(), queue_.end(), Later());
+  }
+
+  // Returns when the transmission leaves the shared channel.
+  uint64_t occupyChannel(size_t length) {
+    const uint64_t now = hostClock.nowUs;
+    if (config_.link.phyKbps == 0) {
+      return now;
+    }
+    const uint64_t start = std::max(now, channelFreeUs_);
+    channelFreeUs_ = start + kPreambleUs + (length + kFrameOverheadBytes) * 8000ULL / config_.link.phyKbps;
+    return channelFreeUs_;
+  }
+
+  uint64_t linkDelayUs() {
+    uint64_t delay = config_.link.latencyUs + below(config_.link.jitterUs + 1);
+    if (uniform() < config_.link.reorder) {
+      delay += config_.link.reorderDelayUs;
+    }
+    return delay;
+  }
+
+  // Loss, latency, reorder and duplication for one receiver.
+  bool deliver(uint64_t sentUs, EventKind kind, uint16_t slave, const uint8_t* data, size_t length) {
+    if (uniform() < config_.link.loss) {
+      results_.airLost++;
+      return false;
+    }
+    schedule(sentUs + linkDelayUs(), kind, slave, data, length);
+    if (uniform() < config_.link.duplicate) {
+      results_.airDuplicated++;
+      schedule(sentUs + linkDelayUs(), kind, slave, data, length);
+    }
+    return true;
+  }
+
+  static bool masterTransmit(const uint8_t dest[6], const uint8_t* data, size_t length) {
+    return activeSimulation->onMasterTransmit(dest, data, length);
+  }
+
+  bool onMasterTransmit(const uint8_t dest[6], const uint8_t* data, size_t length) {
+    results_.txFrames++;
+    const uint64_t sentUs = occupyChannel(length);
+    if (memcmp(dest, kBroadcastMac, 6) == 0) {
+      for (uint16_t index = 0; index < slaves_.size(); ++index) {
+        deliver(sentUs, EventKind::ToSlave, index, data, length);
+      }
+      schedule(sentUs, EventKind::SendDone, 0, dest, 6, true);
+      return true;
+    }
+
+    const int index = slaveIndex(dest);
+    const bool delivered = index >= 0 && deliver(sentUs, EventKind::ToSlave, static_cast<uint16_t>(index), data, length);
+    schedule(sentUs, EventKind::SendDone, 0, dest, 6, delivered);
+    return true;
+  }
+
+  void sendToMaster(Slave& slave, PacketType type, const void* payload, size_t payloadSize) {
+    Frame frame = {};
+    frame.header.version = PROTOCOL_VERSION;
+    frame.header.type = static_cast<uint8_t>(type);
+    frame.header.sequence = slave.sequence++;
+    frame.header.timestampMs = millis();
+    frame.payloadSize = static_cast<uint8_t>(payloadSize);
+    memcpy(frame.payload, payload, payloadSize);
+
+    const size_t length = sizeof(frame.header) + sizeof(frame.payloadSize) + payloadSize;
+    const uint64_t sentUs = occupyChannel(length);
+    deliver(sentUs, EventKind::ToMaster, static_cast<uint16_t>(&slave - slaves_.data()), reinterpret_cast<const uint8_t*>(&frame), length);
+  }
+
+  void wakeAt(Slave& slave, uint64_t atUs) {
+    if (atUs >= slave.wakeUs) {
+      return;
+    }
+    slave.wakeUs = atUs;
+    schedule(atUs, EventKind::SlaveWake, static_cast<uint16_t>(&slave - slaves_.data()));
+  }
+
+  void dispatch(const Event& event) {
+    switch (event.kind) {
+      case EventKind::ToMaster: {
+        const uint64_t before = threadCpuNs();
+        hostEspNowReceive(slaves_[event.slave].mac, hostEspNow.ownMac, event.bytes, event.length);
+        rxCpu_.add(threadCpuNs() - before);
+        results_.rxFrames++;
+        results_.rxBytes += event.length;
+        sampleHeap();
+        break;
+      }
+      case EventKind::SendDone:
+        hostEspNowSendDone(event.bytes, event.delivered);
+        break;
+      case EventKind::ToSlave:
+        onSlaveReceive(slaves_[event.slave], event.bytes, event.length);
+        break;
+      case EventKind::SlaveWake: {
+        Slave& slave = slaves_[event.slave];
+        if (event.atUs == slave.wakeUs) {
+          slave.wakeUs = UINT64_MAX;
+          onSlaveWake(slave);
+        }
+        break;
+      }
+      case EventKind::MasterLoop: {
+        const uint64_t before = threadCpuNs();
+        espnowMaster.loop();
+        loopCpuNs_ += threadCpuNs() - before;
+        loopCount_++;
+        sampleHeap();
+        pollVerified();
+        schedule(hostClock.nowUs + config_.loopMs * 1000ULL, EventKind::MasterLoop, 0);
+        break;
+      }
+    }
+  }
+
+  void sampleHeap() {
+    const size_t inUse = heapInUse();
+    if (inUse > heapBaseline_) {
+      results_.heapPeakBytes = std::max(results_.heapPeakBytes, inUse - heapBaseline_);
+    }
+  }
+
+  uint16_t countVerified() const {
+    uint16_t verified = 0;
+    for (const auto& slave : slaves_) {
+      verified += isTrackedDeviceVerified(slave.mac) ? 1 : 0;
+    }
+    return verified;
+  }
+
+  void pollVerified() {
+    if (results_.allVerifiedMs != 0 || hostClock.nowUs < nextVerifyPollUs_) {
+      return;
+    }
+    nextVerifyPollUs_ = hostClock.nowUs + kVerifyPollUs;
+    if (countVerified() == slaves_.size()) {
+      results_.allVerifiedMs = static_cast<uint32_t>((hostClock.nowUs - kStartUs) / 1000);
+    }
+  }
+
+  // --- virtual slave, per docs/espnow_device_contract.md ---
+
+  void onSlaveReceive(Slave& slave, const uint8_t* data, size_t length) {
+    if (hostClock.nowUs < slave.bootUs || length < sizeof(PacketHeader) + 1) {
+      return;
+    }
+    const auto* header = reinterpret_cast<const PacketHeader*>(data);
+    const uint8_t payloadSize = data[sizeof(PacketHeader)];
+    const uint8_t* payload = data + sizeof(PacketHeader) + 1;
+    if (header->version != PROTOCOL_VERSION || sizeof(PacketHeader) + 1 + payloadSize > length) {
+      return;
+    }
+
+    const auto type = static_cast<PacketType>(header->type);
+    if (type != PacketType::BATCH) {
+      onSlavePacket(slave, type, payload, payloadSize);
+      return;
+    }
+
+    BatchReader reader(payload, payloadSize);
+    PacketType entryType;
+    const uint8_t* entry = nullptr;
+    uint8_t entrySize = 0;
+    while (reader.next(entryType, entry, entrySize)) {
+      onSlavePacket(slave, entryType, entry, entrySize);
+    }
+  }
+
+  void onSlavePacket(Slave& slave, PacketType type, const uint8_t* payload, uint8_t payloadSize) {
+    switch (type) {
+      case PacketType::HELLO:
+        if (!slave.locked) {
+          lock(slave);
+        }
+        break;
+      case PacketType::HEARTBEAT:
+        if (slave.locked) {
+          state_binary::SlaveAliveState alive = {};
+          state_binary::initHeader(alive.header, state_binary::Type::SlaveAlive);
+          sendToMaster(slave, PacketType::STATE, &alive, sizeof(alive));
+        }
+        break;
+      case PacketType::COMMAND:
+        if (state_binary::hasValidHeader(payload, payloadSize)) {
+          onSlaveCommand(slave, payload, payloadSize);
+        }
+        break;
+      default:
+        break;
+    }
+  }
+
+  void onSlaveCommand(Slave& slave, const uint8_t* payload, uint8_t payloadSize) {
+    const auto type = static_cast<state_binary::Type>(reinterpret_cast<const state_binary::Header*>(payload)->type);
+    if (type == state_binary::Type::IdentityReq) {
+      sendIdentity(slave, false);
+      return;
+    }
+    if (type != state_binary::Type::CameraControl || !slave.camera || payloadSize < sizeof(state_binary::CameraControlCommand)) {
+      return;
+    }
+
+    const auto* command = reinterpret_cast<const state_binary::CameraControlCommand*>(payload);
+    switch (static_cast<state_binary::CameraControlAction>(command->action)) {
+      case state_binary::CameraControlAction::SetTargetFps:
+        slave.fps = std::max<uint8_t>(1, command->value);
+        break;
+      case state_binary::CameraControlAction::SetQuality:
+        slave.quality = std::max<uint8_t>(4, command->value);
+        break;
+      case state_binary::CameraControlAction::SetFrameSize:
+        slave.sizeLevel = std::min<uint8_t>(kFrameSizeCount - 1, command->value);
+        break;
+      default:
+        break;
+    }
+  }
+
+  void lock(Slave& slave) {
+    slave.locked = true;
+    sendToMaster(slave, PacketType::HELLO, kSlaveBeacon, sizeof(kSlaveBeacon) - 1);
+    sendIdentity(slave, true);
+
+    const uint64_t now = hostClock.nowUs;
+    if (slave.camera) {
+      slave.nextFrameUs = now + below(1000000 / std::max<uint8_t>(1, slave.fps));
+      wakeAt(slave, slave.nextFrameUs);
+    } else {
+      slave.nextSensorUs = now + below(config_.sensorPeriodMs * 1000);
+      slave.nextWeatherUs = now + below(config_.weatherPeriodMs * 1000);
+      wakeAt(slave, std::min(slave.nextSensorUs, slave.nextWeatherUs));
+    }
+  }
+
+  void sendIdentity(Slave& slave, bool withFeatures) {
+    state_binary::IdentityState identity = {};
+    state_binary::initHeader(identity.header, state_binary::Type::Identity);
+    strncpy(identity.id, slave.id, sizeof(identity.id));
+    if (!withFeatures) {
+      sendToMaster(slave, PacketType::STATE, &identity, sizeof(identity));
+      return;
+    }
+
+    state_binary::FeaturesState features = {};
+    state_binary::initHeader(features.header, state_binary::Type::Features);
+    features.featureBits = state_binary::FeatureIdentity | state_binary::FeatureBatchFrames |
+                           (slave.camera ? state_binary::FeatureCameraJpeg | state_binary::FeatureCameraStream |
+                                               state_binary::FeatureControlBasic
+                                         : state_binary::FeatureSensor | state_binary::FeatureWeather);
+    features.contractVersion = 1;
+
+    BatchBuilder batch;
+    batch.add(PacketType::STATE, &identity, sizeof(identity));
+    batch.add(PacketType::STATE, &features, sizeof(features));
+    sendToMaster(slave, PacketType::BATCH, batch.data(), batch.size());
+  }
+
+  void onSlaveWake(Slave& slave) {
+    if (slave.camera) {
+      stepCamera(slave);
+      return;
+    }
+
+    const uint64_t now = hostClock.nowUs;
+    if (now >= slave.nextSensorUs) {
+      state_binary::SensorState sensor = {};
+      state_binary::initHeader(sensor.header, state_binary::Type::Sensor);
+      sensor.temperature10 = static_cast<int16_t>(200 + below(100));
+      sensor.humidity10 = static_cast<uint16_t>(400 + below(300));
+      sendToMaster(slave, PacketType::STATE, &sensor, sizeof(sensor));
+      slave.nextSensorUs = now + config_.sensorPeriodMs * 1000ULL;
+    }
+    if (now >= slave.nextWeatherUs) {
+      state_binary::WeatherState weather = {};
+      state_binary::initHeader(weather.header, state_binary::Type::Weather);
+      weather.ok = 1;
+      weather.code = 3;
+      snprintf(weather.time, sizeof(weather.time), "2026-10-18T%02u:00", static_cast<unsigned>((now / 3600000000ULL) % 24));
+      weather.temperature10 = 265;
+      weather.windspeed10 = 42;
+      weather.winddirection = 180;
+      sendToMaster(slave, PacketType::STATE, &weather, sizeof(weather));
+      slave.nextWeatherUs = now + config_.weatherPeriodMs * 1000ULL;
+    }
+    wakeAt(slave, std::min(slave.nextSensorUs, slave.nextWeatherUs));
+  }
+
+  // SOI, DQT, SOF0 at the current size, SOS, entropy without 0xFF, EOI.
+  void buildJpeg(Slave& slave) {
+    const FrameSize size = kFrameSizes[slave.sizeLevel];
+    const uint64_t scaled = static_cast<uint64_t>(config_.cameraFrameBytes) * size.width * size.height * kDefaultQuality /
+                            (320ULL * 240ULL * slave.quality);
+    const uint32_t target = static_cast<uint32_t>(std::min<uint64_t>(kMaxFrameBytes, std::max<uint64_t>(kMinFrameBytes, scaled)));
+
+    std::vector<uint8_t>& jpeg = slave.jpeg;
+    jpeg.assign({0xFF, 0xD8, 0xFF, 0xDB, 0x00, 0x43, 0x00});
+    jpeg.resize(jpeg.size() + 64, 0x10);
+    const uint8_t sof[] = {0xFF, 0xC0, 0x00, 0x11, 0x08,
+                           static_cast<uint8_t>(size.height >> 8), static_cast<uint8_t>(size.height),
+                           static_cast<uint8_t>(size.width >> 8), static_cast<uint8_t>(size.width),
+                           0x03, 0x01, 0x21, 0x00, 0x02, 0x11, 0x01, 0x03, 0x11, 0x01};
+    const uint8_t sos[] = {0xFF, 0xDA, 0x00, 0x0C, 0x03, 0x01, 0x00, 0x02, 0x11, 0x03, 0x11, 0x00, 0x3F, 0x00};
+    jpeg.insert(jpeg.end(), sof, sof + sizeof(sof));
+    jpeg.insert(jpeg.end(), sos, sos + sizeof(sos));
+
+    const size_t entropyBytes = target > jpeg.size() + 2 ? target - jpeg.size() - 2 : 0;
+    const size_t offset = (slave.frameId * 997u) % (entropy_.size() - entropyBytes);
+    jpeg.insert(jpeg.end(), entropy_.begin() + offset, entropy_.begin() + offset + entropyBytes);
+    jpeg.push_back(0xFF);
+    jpeg.push_back(0xD9);
+  }
+
+  void startFrame(Slave& slave) {
+    slave.frameId++;
+    buildJpeg(slave);
+    slave.sending = true;
+    slave.step = 0;
+    slave.frameStartUs = hostClock.nowUs;
+    slave.dataChunks = static_cast<uint16_t>((slave.jpeg.size() + state_binary::kCameraChunkDataBytes - 1) /
+                                             state_binary::kCameraChunkDataBytes);
+    slave.parityChunks = camera_fec::isValid(config_.fec)
+                             ? static_cast<uint16_t>(camera_fec::parityChunkCount(config_.fec, slave.dataChunks))
+                             : 0;
+    slave.crc = core::crc32(slave.jpeg.data(), slave.jpeg.size());
+    results_.framesSent++;
+  }
+
+  // One transmission per wake: meta, data chunks, parity chunks, frame end.
+  void stepCamera(Slave& slave) {
+    if (!slave.sending) {
+      startFrame(slave);
+    }
+
+    const uint32_t jpegBytes = static_cast<uint32_t>(slave.jpeg.size());
+    const bool fec = slave.parityChunks > 0;
+    const uint32_t step = slave.step++;
+    if (step == 0) {
+      const FrameSize size = kFrameSizes[slave.sizeLevel];
+      state_binary::CameraMetaState meta = {};
+      state_binary::initHeader(meta.header, state_binary::Type::CameraMeta);
+      meta.frameId = slave.frameId;
+      meta.totalBytes = jpegBytes;
+      meta.totalChunks = slave.dataChunks;
+      meta.width = size.width;
+      meta.height = size.height;
+      meta.format = fec ? camera_fec::kFormatFecFlag : 0;
+      meta.quality = slave.quality;
+      sendToMaster(slave, PacketType::STATE, &meta, sizeof(meta));
+    } else if (step <= slave.dataChunks) {
+      state_binary::CameraChunkState chunk = {};
+      state_binary::initHeader(chunk.header, state_binary::Type::CameraChunk);
+      chunk.frameId = slave.frameId;
+      chunk.idx = static_cast<uint16_t>(step);
+      chunk.total = slave.dataChunks;
+      chunk.dataLen = static_cast<uint8_t>(camera_fec::dataChunkLength(jpegBytes, step - 1));
+      memcpy(chunk.data, slave.jpeg.data() + (step - 1) * state_binary::kCameraChunkDataBytes, chunk.dataLen);
+      sendToMaster(slave, PacketType::STATE, &chunk, sizeof(chunk));
+    } else if (step <= slave.dataChunks + slave.parityChunks) {
+      const uint32_t parity = step - slave.dataChunks - 1;
+      const camera_fec::ParityId id{static_cast<uint16_t>(parity / config_.fec.parityPerGroup),
+                                    static_cast<uint8_t>(parity % config_.fec.parityPerGroup)};
+      state_binary::CameraChunkState chunk = {};
+      state_binary::initHeader(chunk.header, state_binary::Type::CameraChunk);
+      chunk.frameId = slave.frameId;
+      chunk.idx = camera_fec::parityChunkIdx(id);
+      chunk.total = camera_fec::parityChunkTotal(config_.fec);
+      chunk.dataLen = static_cast<uint8_t>(state_binary::kCameraChunkDataBytes);
+      camera_fec::buildParity(slave.jpeg.data(), jpegBytes, config_.fec, id, chunk.data);
+      sendToMaster(slave, PacketType::STATE, &chunk, sizeof(chunk));
+    } else {
+      state_binary::CameraFrameEndState frameEnd = {};
+      state_binary::initHeader(frameEnd.header, state_binary::Type::CameraFrameEnd);
+      frameEnd.frameId = slave.frameId;
+      frameEnd.totalBytes = jpegBytes;
+      frameEnd.totalChunks = slave.dataChunks;
+      frameEnd.crc32 = slave.crc;
+      sendToMaster(slave, PacketType::STATE, &frameEnd, sizeof(frameEnd));
+      slave.sending = false;
+      slave.nextFrameUs = std::max<uint64_t>(slave.frameStartUs + 1000000ULL / std::max<uint8_t>(1, slave.fps),
+                                   hostClock.nowUs + config_.chunkGapUs);
+      wakeAt(slave, slave.nextFrameUs);
+      return;
+    }
+    wakeAt(slave, hostClock.nowUs + config_.chunkGapUs);
+  }
+
+  void finish(double wallSeconds) {
+    results_.tracked = static_cast<uint16_t>(getTrackedDeviceSnapshotCount());
+    results_.verified = countVerified();
+    results_.txRejected = hostEspNow.sendRejected;
+    results_.addPeerFailures = hostEspNow.addPeerFailures;
+    results_.cpuPerRxMeanUs = rxCpu_.meanUs();
+    results_.cpuPerRxP50Us = rxCpu_.percentileUs(0.50);
+    results_.cpuPerRxP99Us = rxCpu_.percentileUs(0.99);
+    results_.cpuPerRxMaxUs = rxCpu_.maxUs();
+    results_.cpuPerLoopMeanUs = loopCount_ == 0 ? 0 : loopCpuNs_ / 1000.0 / loopCount_;
+    results_.heapMeasured = heapSupported();
+    results_.wallSeconds = wallSeconds;
+  }
+
+  const Config& config_;
+  Results& results_;
+  std::mt19937 rng_;
+  std::vector<Event> queue_;
+  uint64_t nextOrder_ = 0;
+  std::vector<Slave> slaves_;
+  std::vector<uint8_t> entropy_;
+  uint64_t channelFreeUs_ = 0;
+  uint64_t nextVerifyPollUs_ = 0;
+  CpuHistogram rxCpu_;
+  uint64_t loopCpuNs_ = 0;
+  uint64_t loopCount_ = 0;
+  size_t heapBaseline_ = 0;
+};
+
+FrameListener frameListener = nullptr;
+
+}  // namespace
+
+void run(const Config& config, Results& out) {
+  out = Results{};
+  Simulation simulation(config, out);
+  simulation.run();
+  activeSimulation = nullptr;
+  setFrameListener(nullptr);
+}
+
+void setFrameListener(FrameListener listener) {
+  frameListener = listener;
+}
+
+void noteFrameCompleted(const uint8_t mac[6], uint32_t frameId) {
+  if (frameListener != nullptr && mac != nullptr) {
+    frameListener(mac, frameId);
+  }
+}
+
+}  // namespace sim
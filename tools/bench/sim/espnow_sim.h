@@ -0,0 +1,103 @@
+#pragma once
+
+#include "app/espnow/camera_fec.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sim {
+
+// Applied independently to every transmission, in both directions.
+struct LinkModel {
+  double loss = 0.02;
+  uint32_t latencyUs = 2000;
+  uint32_t jitterUs = 1000;
+  double duplicate = 0.005;
+  // Held back by reorderDelayUs so frames sent after it overtake it.
+  double reorder = 0.01;
+  uint32_t reorderDelayUs = 10000;
+  // Shared-channel airtime; 0 = unlimited.
+  uint32_t phyKbps = 0;
+};
+
+struct Config {
+  uint16_t peers = 1;
+  double cameraShare = 0.1;
+  uint32_t seconds = 60;
+  uint32_t seed = 1;
+  LinkModel link;
+  uint32_t loopMs = 10;
+  uint32_t sensorPeriodMs = 5000;
+  uint32_t weatherPeriodMs = 60000;
+  uint8_t cameraFps = 5;
+  uint32_t cameraFrameBytes = 6000;
+  uint32_t chunkGapUs = 400;
+  app::espnow::camera_fec::Layout fec;
+  // Record the master's traffic with packet_capture and dump it at the end.
+  bool capture = false;
+};
+
+struct Results {
+  uint16_t peers = 0;
+  uint16_t cameras = 0;
+  uint16_t tracked = 0;
+  uint16_t verified = 0;
+  // Virtual time until every peer was verified; 0 if some never were.
+  uint32_t allVerifiedMs = 0;
+  uint64_t rxFrames = 0;
+  uint64_t rxBytes = 0;
+  uint64_t txFrames = 0;
+  uint32_t txRejected = 0;
+  uint32_t addPeerFailures = 0;
+  uint64_t airLost = 0;
+  uint64_t airDuplicated = 0;
+  uint32_t framesSent = 0;
+  uint32_t framesCompleted = 0;
+  double cpuPerRxMeanUs = 0;
+  double cpuPerRxP50Us = 0;
+  double cpuPerRxP99Us = 0;
+  double cpuPerRxMaxUs = 0;
+  double cpuPerLoopMeanUs = 0;
+  // Process heap in use above the post-setup baseline, sampled after
+  // every master callback/loop.
+  size_t heapPeakBytes = 0;
+  bool heapMeasured = false;
+  double wallSeconds = 0;
+};
+
+// Runs one scenario against the real MasterNode in this process; module
+// state is global, so call it once per process.
+void run(const Config& config, Results& out);
+
+struct ReplayConfig {
+  const char* path = nullptr;
+  // Capture time is divided by this; 10 replays ten times faster.
+  double speed = 1.0;
+  uint32_t loopMs = 10;
+  // Also sleep so the replay keeps pace with the wall clock.
+  bool realtime = false;
+};
+
+struct ReplayResults {
+  uint32_t rxRecords = 0;
+  uint32_t txRecords = 0;
+  uint32_t overwritten = 0;
+  uint16_t sources = 0;
+  uint32_t dumpEpochSec = 0;
+  double capturedSeconds = 0;
+  Results master;
+};
+
+// Feeds the RX records of a .encp capture (src/app/espnow/packet_capture.h)
+// back through MasterNode's receive callback at their recorded spacing;
+// TX records are only counted, to compare with what the master sends now.
+bool replay(const ReplayConfig& config, ReplayResults& out);
+
+using FrameListener = void (*)(const uint8_t mac[6], uint32_t frameId);
+void setFrameListener(FrameListener listener);
+
+// Called by the camera recorder stand-in for every frame the reassembler
+// completed.
+void noteFrameCompleted(const uint8_t mac[6], uint32_t frameId);
+
+}  // namespace sim
@@ -0,0 +1,69 @@
+// Link-time stand-ins for the modules the simulator does not build: no
+// display, HTTP proxy, weather sync or recorder task. The recorder hook
+// reports completed camera frames back to the simulator.
+
+#include "espnow_sim.h"
+
+#include "app/display/display_interface.h"
+#include "app/espnow/camera_recorder.h"
+#include "app/espnow/master_http_proxy.h"
+#include "core/boot.h"
+#include "core/weather_sync.h"
+
+namespace app::display {
+
+DisplayInterface displayInterface;
+
+void DisplayInterface::requestRender() {}
+
+bool DisplayInterface::applyStatePayload(const String&) {
+  return false;
+}
+
+}  // namespace app::display
+
+namespace app::espnow {
+
+bool beginProxyWorker() {
+  return true;
+}
+
+bool enqueueProxyRequest(const uint8_t[6], const char*) {
+  return false;
+}
+
+void processProxyResponses(MasterNode&) {}
+
+}  // namespace app::espnow
+
+namespace app::espnow::camera_recorder {
+
+bool begin() {
+  return true;
+}
+
+void onFrameComplete(const uint8_t mac[6], const uint8_t*, uint32_t, uint32_t frameId, uint16_t, uint16_t) {
+  sim::noteFrameCompleted(mac, frameId);
+}
+
+}  // namespace app::espnow::camera_recorder
+
+namespace core::boot {
+
+void mark(Milestone) {}
+
+bool isFsReady() {
+  return true;
+}
+
+bool isFsMounted() {
+  return true;
+}
+
+}  // namespace core::boot
+
+namespace core::weather_sync {
+
+void tick(app::espnow::MasterNode&) {}
+
+}  // namespace core::weather_sync
@@ -0,0 +1,229 @@
+// ESP-NOW network simulator: drives the real MasterNode (RX callback, loop,
+// state/camera ingest) through the esp_now stand-in with a fleet of virtual
+// weather and camera slaves speaking docs/espnow_device_contract.md, on a
+// virtual clock. Built by the `sim` PlatformIO env:
+//
+//   platformio run -e sim && .pio/build/sim/program --peers 1,10,50,100,200
+//
+// Each fleet size runs in its own process (master state is global) and
+// prints one row: master-side throughput, camera frame completion, thread
+// CPU per received packet and per loop() pass, and heap high-water above
+// the post-setup baseline. Options (defaults in brackets):
+//
+//   --peers LIST        fleet sizes [1,10,50,100,200]
+//   --seconds N         virtual seconds per run [60]
+//   --camera-share F    fraction of slaves that are cameras [0.1]
+//   --loss F            per-transmission loss [0.02]
+//   --latency-ms N      one-way latency [2]
+//   --jitter-ms N       uniform extra latency [1]
+//   --dup F             duplicated transmissions [0.005]
+//   --reorder F         transmissions held back 10 ms [0.01]
+//   --phy-kbps N        shared-channel airtime, 0 = unlimited [0]
+//   --fps N             initial camera fps [5]
+//   --frame-bytes N     JPEG bytes at 320x240 q12 [6000]
+//   --fec D+P           camera parity layout, e.g. 8+1 [off]
+//   --sensor-ms N       weather slave sensor period [5000]
+//   --seed N            [1]
+//   --capture 1         dump a packet capture of each run to the host FS
+//
+// Replay a capture dumped by the device (/capture/dump, fetched over FTP)
+// or by --capture through the same master handlers:
+//
+//   .pio/build/sim/program --replay cap_1760000000.encp [--speed 10] [--realtime 1]
+
+#include "espnow_sim.h"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+bool parseArgs(int argc, char** argv, sim::Config& config, std::vector<uint16_t>& peers, sim::ReplayConfig& replay) {
+  for (int i = 1; i < argc; ++i) {
+    const char* name = argv[i];
+    if (i + 1 >= argc) {
+      fprintf(stderr, "missing value for %s\n", name);
+      return false;
+    }
+    const char* value = argv[++i];
+
+    if (strcmp(name, "--peers") == 0) {
+      peers.clear();
+      for (const char* cursor = value; *cursor != '\0';) {
+        char* end = nullptr;
+        const unsigned long count = strtoul(cursor, &end, 10);
+        if (end == cursor || count == 0 || count > 0xFFFF) {
+          fprintf(stderr, "bad --peers list: %s\n", value);
+          return false;
+        }
+        peers.push_back(static_cast<uint16_t>(count));
+        cursor = *end == ',' ? end + 1 : end;
+      }
+    } else if (strcmp(name, "--seconds") == 0) {
+      config.seconds = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+    } else if (strcmp(name, "--camera-share") == 0) {
+      config.cameraShare = strtod(value, nullptr);
+    } else if (strcmp(name, "--loss") == 0) {
+      config.link.loss = strtod(value, nullptr);
+    } else if (strcmp(name, "--latency-ms") == 0) {
+      config.link.latencyUs = static_cast<uint32_t>(strtod(value, nullptr) * 1000);
+    } else if (strcmp(name, "--jitter-ms") == 0) {
+      config.link.jitterUs = static_cast<uint32_t>(strtod(value, nullptr) * 1000);
+    } else if (strcmp(name, "--dup") == 0) {
+      config.link.duplicate = strtod(value, nullptr);
+    } else if (strcmp(name, "--reorder") == 0) {
+      config.link.reorder = strtod(value, nullptr);
+    } else if (strcmp(name, "--phy-kbps") == 0) {
+      config.link.phyKbps = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+    } else if (strcmp(name, "--fps") == 0) {
+      config.cameraFps = static_cast<uint8_t>(strtoul(value, nullptr, 10));
+    } else if (strcmp(name, "--frame-bytes") == 0) {
+      config.cameraFrameBytes = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+    } else if (strcmp(name, "--fec") == 0) {
+      unsigned data = 0;
+      unsigned parity = 0;
+      if (sscanf(value, "%u+%u", &data, &parity) != 2) {
+        fprintf(stderr, "bad --fec layout: %s\n", value);
+        return false;
+      }
+      config.fec = {static_cast<uint8_t>(data), static_cast<uint8_t>(parity)};
+      if (!app::espnow::camera_fec::isValid(config.fec)) {
+        fprintf(stderr, "unsupported --fec layout: %s\n", value);
+        return false;
+      }
+    } else if (strcmp(name, "--sensor-ms") == 0) {
+      config.sensorPeriodMs = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+    } else if (strcmp(name, "--seed") == 0) {
+      config.seed = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+    } else if (strcmp(name, "--capture") == 0) {
+      config.capture = strtoul(value, nullptr, 10) != 0;
+    } else if (strcmp(name, "--replay") == 0) {
+      replay.path = value;
+    } else if (strcmp(name, "--speed") == 0) {
+      replay.speed = strtod(value, nullptr);
+    } else if (strcmp(name, "--realtime") == 0) {
+      replay.realtime = strtoul(value, nullptr, 10) != 0;
+    } else {
+      fprintf(stderr, "unknown option %s\n", name);
+      return false;
+    }
+  }
+  return !peers.empty() && config.seconds > 0 && config.cameraFps > 0;
+}
+
+bool runIsolated(const sim::Config& config, sim::Results& out) {
+  int fds[2];
+  if (pipe(fds) != 0) {
+    return false;
+  }
+  fflush(stdout);
+  const pid_t pid = fork();
+  if (pid < 0) {
+    return false;
+  }
+  if (pid == 0) {
+    close(fds[0]);
+    sim::Results results;
+    sim::run(config, results);
+    const bool written = write(fds[1], &results, sizeof(results)) == static_cast<ssize_t>(sizeof(results));
+    _exit(written ? 0 : 1);
+  }
+
+  close(fds[1]);
+  const bool readOk = read(fds[0], &out, sizeof(out)) == static_cast<ssize_t>(sizeof(out));
+  close(fds[0]);
+  int status = 0;
+  waitpid(pid, &status, 0);
+  return readOk && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+void printRow(const sim::Config& config, const sim::Results& r) {
+  char joined[16];
+  if (r.allVerifiedMs != 0) {
+    snprintf(joined, sizeof(joined), "%.1f", r.allVerifiedMs / 1000.0);
+  } else {
+    snprintf(joined, sizeof(joined), "-");
+  }
+  char completion[16];
+  if (r.framesSent != 0) {
+    snprintf(completion, sizeof(completion), "%.1f%%", 100.0 * r.framesCompleted / r.framesSent);
+  } else {
+    snprintf(completion, sizeof(completion), "-");
+  }
+  char heap[16];
+  if (r.heapMeasured) {
+    snprintf(heap, sizeof(heap), "%.1f", r.heapPeakBytes / 1024.0);
+  } else {
+    snprintf(heap, sizeof(heap), "n/a");
+  }
+
+  printf("%5u %4u %5u/%-5u %6s %8.1f %7.1f %7u %7s %7.2f %7.2f %8.2f %8.2f %8.2f %8s %7u %7u %6.1f\n",
+         r.peers, r.cameras, r.verified, r.tracked, joined,
+         r.rxFrames / static_cast<double>(config.seconds),
+         r.rxBytes / 1024.0 / config.seconds,
+         r.framesSent, completion,
+         r.cpuPerRxMeanUs, r.cpuPerRxP50Us, r.cpuPerRxP99Us, r.cpuPerRxMaxUs, r.cpuPerLoopMeanUs,
+         heap, r.addPeerFailures, r.txRejected, r.wallSeconds);
+}
+
+int runReplay(const sim::ReplayConfig& config) {
+  sim::ReplayResults r;
+  const bool ok = sim::replay(config, r);
+  const sim::Results& m = r.master;
+  printf("replay %s at %.2fx: %.1fs captured, %u sources, %u rx / %u tx records, %u overwritten before dump\n",
+         config.path, config.speed, r.capturedSeconds, r.sources, r.rxRecords, r.txRecords, r.overwritten);
+  printf("master: %u/%u verified/tracked, tx %llu (captured %u), frames completed %u\n",
+         m.verified, m.tracked, static_cast<unsigned long long>(m.txFrames), r.txRecords, m.framesCompleted);
+  char heap[16];
+  if (m.heapMeasured) {
+    snprintf(heap, sizeof(heap), "%.1f", m.heapPeakBytes / 1024.0);
+  } else {
+    snprintf(heap, sizeof(heap), "n/a");
+  }
+  printf("cpu per rx mean/p50/p99/max %.2f/%.2f/%.2f/%.2f us, per loop %.2f us, heap peak %s kB, wall %.2fs\n",
+         m.cpuPerRxMeanUs, m.cpuPerRxP50Us, m.cpuPerRxP99Us, m.cpuPerRxMaxUs, m.cpuPerLoopMeanUs, heap,
+         m.wallSeconds);
+  return ok ? 0 : 1;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  sim::Config config;
+  std::vector<uint16_t> peers = {1, 10, 50, 100, 200};
+  sim::ReplayConfig replay;
+  if (!parseArgs(argc, argv, config, peers, replay)) {
+    return 2;
+  }
+  if (replay.path != nullptr) {
+    replay.loopMs = config.loopMs;
+    return runReplay(replay);
+  }
+
+  printf("%us virtual per row, loss=%.3f latency=%.1f+%.1fms dup=%.3f reorder=%.3f phy=%ukbps fps=%u frame=%uB fec=%u+%u\n",
+         config.seconds, config.link.loss, config.link.latencyUs / 1000.0, config.link.jitterUs / 1000.0,
+         config.link.duplicate, config.link.reorder, config.link.phyKbps, config.cameraFps, config.cameraFrameBytes,
+         config.fec.dataPerGroup, config.fec.parityPerGroup);
+  printf("%5s %4s %11s %6s %8s %7s %7s %7s %7s %7s %8s %8s %8s %8s %7s %7s %6s\n",
+         "peers", "cams", "verif/trk", "join_s", "rx_pkt/s", "rx_kB/s", "frames", "done", "cpu_us", "p50_us",
+         "p99_us", "max_us", "loop_us", "heap_kB", "peerful", "tx_rej", "wall_s");
+
+  bool ok = true;
+  for (const uint16_t count : peers) {
+    sim::Config run = config;
+    run.peers = count;
+    sim::Results results;
+    if (!runIsolated(run, results)) {
+      fprintf(stderr, "run with %u peers failed\n", count);
+      ok = false;
+      continue;
+    }
+    printRow(run, results);
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+// Host-side cost probes shared by the simulator and the capture replayer.
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+#include <time.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace sim {
+
+// Thread CPU time in log2 buckets, 8 per octave.
+class CpuHistogram {
+ public:
+  void add(uint64_t ns) {
+    const size_t bucket = ns == 0 ? 0 : std::min(kBuckets - 1, static_cast<size_t>(std::log2(static_cast<double>(ns)) * 8));
+    buckets_[bucket]++;
+    count_++;
+    totalNs_ += ns;
+    maxNs_ = std::max(maxNs_, ns);
+  }
+
+  double meanUs() const { return count_ == 0 ? 0 : totalNs_ / 1000.0 / count_; }
+  double maxUs() const { return maxNs_ / 1000.0; }
+
+  // Upper bound of the bucket holding the percentile.
+  double percentileUs(double percentile) const {
+    const uint64_t rank = static_cast<uint64_t>(std::ceil(percentile * count_));
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < kBuckets; ++bucket) {
+      seen += buckets_[bucket];
+      if (seen >= rank && seen > 0) {
+        return std::min(std::exp2((bucket + 1) / 8.0), static_cast<double>(maxNs_)) / 1000.0;
+      }
+    }
+    return maxUs();
+  }
+
+ private:
+  static constexpr size_t kBuckets = 320;
+  std::array<uint64_t, kBuckets> buckets_{};
+  uint64_t count_ = 0;
+  uint64_t totalNs_ = 0;
+  uint64_t maxNs_ = 0;
+};
+
+inline uint64_t threadCpuNs() {
+  timespec ts = {};
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+inline bool heapSupported() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+  return true;
+#else
+  return false;
+#endif
+}
+
+inline size_t heapInUse() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+  return mallinfo2().uordblks;
+#else
+  return 0;
+#endif
+}
+
+}  // namespace sim
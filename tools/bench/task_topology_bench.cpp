@@ -0,0 +1,507 @@
+// Host scheduling model for the task plans in src/core/task_topology.h. Runs
+// camera streaming, a periodic proxy fetch and UI navigation at once on a
+// two-core fixed-priority scheduler (FreeRTOS SMP rules: highest ready task
+// that may run on a core gets it, equal priorities share 1 ms slices) and
+// reports camera frame drops and button-to-render latency for every plan,
+// with JPEG decode inline in the receive callback (as before the decode
+// worker) and on the cam_decode task. Build and run from the repo root:
+//
+//   g++ -std=gnu++17 -O2 -Itools/bench/host -Iinclude -Isrc tools/bench/task_topology_bench.cpp -o /tmp/topology_bench
+//   /tmp/topology_bench
+//
+// Task costs are estimates for an ESP32-S3 at 240 MHz, not measurements;
+// take real ones from the telemetry log (cpu_pm) and pass them in. Options
+// (defaults in brackets):
+//
+//   --seconds N       simulated seconds per row [30]
+//   --fps N           camera frames per second [10]
+//   --chunks N        ESP-NOW chunks per frame [60]
+//   --chunk-gap-us N  spacing of a frame's chunks on air, 0 = spread over
+//                     the frame period [0]
+//   --rx-us N         WiFi task + receive callback per chunk [60]
+//   --rx-queue N      driver receive queue depth in packets [32]
+//   --decode-us N     JPEG decode + scale to preview [38000]
+//   --preview-us N    preview blit on display_task [6000]
+//   --render-us N     screen render after a button press [18000]
+//   --nav-ms N        mean gap between button presses [250]
+//   --proxy-ms N      gap between proxy fetches [1000]
+//   --tls-us N        TLS handshake CPU on proxy_worker [120000]
+//   --rtt-ms N        proxy server round trip, blocked [80]
+//   --body-us N       proxy response parse + chunking CPU [15000]
+//   --seed N          [1]
+
+#include "core/task_topology.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <queue>
+#include <random>
+#include <vector>
+
+namespace {
+
+using namespace core::topology;
+
+static constexpr int64_t TICK_US = 10;
+static constexpr int64_t SLICE_US = 1000;
+static constexpr int64_t NETWORK_LOOP_PERIOD_US = 10000;
+static constexpr int64_t NETWORK_LOOP_US = 400;
+static constexpr int64_t INPUT_POLL_PERIOD_US = 20000;
+static constexpr int64_t INPUT_POLL_US = 200;
+static constexpr int64_t LWIP_PER_FETCH_US = 3000;
+static constexpr UBaseType_t WIFI_PRIORITY = 23;
+static constexpr UBaseType_t LWIP_PRIORITY = 18;
+
+struct Config {
+  uint32_t seconds = 30;
+  uint32_t fps = 10;
+  uint32_t chunks = 60;
+  int64_t chunkGapUs = 0;
+  int64_t rxUs = 60;
+  size_t rxQueue = 32;
+  int64_t decodeUs = 38000;
+  int64_t previewUs = 6000;
+  int64_t renderUs = 18000;
+  uint32_t navMs = 250;
+  uint32_t proxyMs = 1000;
+  int64_t tlsUs = 120000;
+  uint32_t rttMs = 80;
+  int64_t bodyUs = 15000;
+  uint32_t seed = 1;
+};
+
+enum class Kind : uint8_t {
+  RxChunk,
+  Decode,
+  Preview,
+  NetworkLoop,
+  InputPoll,
+  Render,
+  Proxy,
+  Lwip,
+};
+
+// A run of CPU work, optionally preceded by a blocking wait.
+struct Phase {
+  int64_t blockUs;
+  int64_t cpuUs;
+};
+
+struct Job {
+  Kind kind;
+  std::vector<Phase> phases;
+  size_t phase = 0;
+  bool waiting = false;
+  int64_t startUs = 0;
+  uint32_t frame = 0;
+  bool lastChunk = false;
+  std::vector<int64_t> pressesUs;
+};
+
+struct SimTask {
+  const char* name;
+  UBaseType_t priority;
+  BaseType_t core;
+  std::deque<Job> jobs;
+  int64_t blockedUntilUs = 0;
+  int64_t sliceStartUs = 0;
+  int64_t lastRunUs = 0;
+  int runningOn = -1;
+};
+
+struct FrameState {
+  uint32_t received = 0;
+  bool lost = false;
+};
+
+struct Result {
+  uint32_t sent = 0;
+  uint32_t rxLost = 0;
+  uint32_t skipped = 0;
+  uint32_t decoded = 0;
+  std::vector<int64_t> uiLatencyUs;
+  std::vector<int64_t> proxyLatencyUs;
+  int64_t coreBusyUs[2] = {0, 0};
+};
+
+class Model {
+ public:
+  Model(const Config& config, uint8_t plan, bool inlineDecode)
+      : config_(config), inlineDecode_(inlineDecode), rng_(config.seed) {
+    wifi_ = addTask("wifi", WIFI_PRIORITY, kProtocolCore);
+    lwip_ = addTask("tiT", LWIP_PRIORITY, kProtocolCore);
+    network_ = addTask(spec(Task::Network, plan));
+    display_ = addTask(spec(Task::Display, plan));
+    input_ = addTask(spec(Task::Input, plan));
+    decode_ = addTask(spec(Task::CameraDecode, plan));
+    proxy_ = addTask(spec(Task::Proxy, plan));
+  }
+
+  Result run() {
+    const int64_t endUs = static_cast<int64_t>(config_.seconds) * 1000000;
+    scheduleCamera(0);
+    schedulePeriodic(0, NETWORK_LOOP_PERIOD_US, [this]() { push(network_, makeJob(Kind::NetworkLoop, {{0, NETWORK_LOOP_US}})); });
+    schedulePeriodic(5000, INPUT_POLL_PERIOD_US, [this]() { push(input_, makeJob(Kind::InputPoll, {{0, INPUT_POLL_US}})); });
+    schedulePeriodic(static_cast<int64_t>(config_.proxyMs) * 500, static_cast<int64_t>(config_.proxyMs) * 1000, [this]() {
+      push(proxy_, makeJob(Kind::Proxy, {{0, config_.tlsUs}, {static_cast<int64_t>(config_.rttMs) * 1000, config_.bodyUs}}));
+      at(nowUs_ + static_cast<int64_t>(config_.rttMs) * 1000, [this]() { push(lwip_, makeJob(Kind::Lwip, {{0, LWIP_PER_FETCH_US}})); });
+    });
+    scheduleNav();
+
+    for (nowUs_ = 0; nowUs_ < endUs; nowUs_ += TICK_US) {
+      while (!events_.empty() && events_.top().atUs <= nowUs_) {
+        auto action = events_.top().action;
+        events_.pop();
+        action();
+      }
+      dispatch();
+      for (int core = 0; core < 2; ++core) {
+        if (running_[core] != nullptr) {
+          advance(*running_[core], core);
+        }
+      }
+    }
+    return result_;
+  }
+
+ private:
+  struct Event {
+    int64_t atUs;
+    uint64_t order;
+    std::function<void()> action;
+    bool operator>(const Event& other) const {
+      return atUs != other.atUs ? atUs > other.atUs : order > other.order;
+    }
+  };
+
+  SimTask* addTask(const char* name, UBaseType_t priority, BaseType_t core) {
+    tasks_.push_back(SimTask{name, priority, core, {}});
+    return &tasks_.back();
+  }
+
+  SimTask* addTask(const TaskSpec& entry) {
+    return addTask(entry.name, entry.priority, entry.core);
+  }
+
+  Job makeJob(Kind kind, std::vector<Phase> phases) {
+    Job job;
+    job.kind = kind;
+    job.phases = std::move(phases);
+    job.startUs = nowUs_;
+    return job;
+  }
+
+  void push(SimTask* task, Job job) {
+    task->jobs.push_back(std::move(job));
+  }
+
+  void at(int64_t atUs, std::function<void()> action) {
+    events_.push(Event{atUs, eventOrder_++, std::move(action)});
+  }
+
+  void schedulePeriodic(int64_t firstUs, int64_t periodUs, std::function<void()> action) {
+    at(firstUs, [this, firstUs, periodUs, action]() {
+      action();
+      schedulePeriodic(firstUs + periodUs, periodUs, action);
+    });
+  }
+
+  void scheduleCamera(int64_t frameStartUs) {
+    const uint32_t frame = result_.sent++;
+    frames_.push_back(FrameState{});
+    const int64_t gapUs = config_.chunkGapUs > 0 ? config_.chunkGapUs : 1000000 / config_.fps / config_.chunks;
+    for (uint32_t chunk = 0; chunk < config_.chunks; ++chunk) {
+      at(frameStartUs + chunk * gapUs, [this, frame, chunk]() { receiveChunk(frame, chunk + 1 == config_.chunks); });
+    }
+    at(frameStartUs + 1000000 / config_.fps, [this, frameStartUs]() { scheduleCamera(frameStartUs + 1000000 / config_.fps); });
+  }
+
+  void scheduleNav() {
+    std::exponential_distribution<double> gap(1.0 / (config_.navMs * 1000.0));
+    at(nowUs_ + static_cast<int64_t>(gap(rng_)), [this]() {
+      pressesUs_.push_back(nowUs_);
+      scheduleNav();
+    });
+  }
+
+  void receiveChunk(uint32_t frame, bool lastChunk) {
+    if (wifi_->jobs.size() >= config_.rxQueue) {
+      frames_[frame].lost = true;
+      return;
+    }
+    Job job = makeJob(Kind::RxChunk, {{0, config_.rxUs}});
+    job.frame = frame;
+    job.lastChunk = lastChunk;
+    push(wifi_, std::move(job));
+  }
+
+  bool ready(const SimTask& task) const {
+    return !task.jobs.empty() && nowUs_ >= task.blockedUntilUs;
+  }
+
+  bool allowed(const SimTask& task, int core) const {
+    return task.core == kAnyCore || task.core == core;
+  }
+
+  // Ties go to the task that has not used up its slice, then the one that
+  // waited longest.
+  bool before(const SimTask& a, const SimTask& b) const {
+    if (a.priority != b.priority) {
+      return a.priority > b.priority;
+    }
+    const bool aKeeps = a.runningOn >= 0 && nowUs_ - a.sliceStartUs < SLICE_US;
+    const bool bKeeps = b.runningOn >= 0 && nowUs_ - b.sliceStartUs < SLICE_US;
+    if (aKeeps != bKeeps) {
+      return aKeeps;
+    }
+    return a.lastRunUs < b.lastRunUs;
+  }
+
+  void dispatch() {
+    std::vector<SimTask*> candidates;
+    for (SimTask& task : tasks_) {
+      if (ready(task)) {
+        candidates.push_back(&task);
+      }
+    }
+    std::sort(candidates.begin(), candidates.end(), [this](const SimTask* a, const SimTask* b) { return before(*a, *b); });
+
+    SimTask* next[2] = {nullptr, nullptr};
+    for (SimTask* task : candidates) {
+      int core = -1;
+      if (task->core != kAnyCore) {
+        core = next[task->core] == nullptr ? static_cast<int>(task->core) : -1;
+      } else if (task->runningOn >= 0 && next[task->runningOn] == nullptr) {
+        core = task->runningOn;
+      } else {
+        core = next[0] == nullptr ? 0 : (next[1] == nullptr ? 1 : -1);
+      }
+      if (core >= 0 && allowed(*task, core)) {
+        next[core] = task;
+      }
+    }
+
+    for (SimTask& task : tasks_) {
+      const bool stays = (next[0] == &task || next[1] == &task);
+      if (task.runningOn >= 0 && !stays) {
+        task.lastRunUs = nowUs_;
+        task.runningOn = -1;
+      }
+    }
+    for (int core = 0; core < 2; ++core) {
+      SimTask* task = next[core];
+      if (task != nullptr && task->runningOn != core) {
+        task->runningOn = core;
+        task->sliceStartUs = nowUs_;
+      } else if (task != nullptr && nowUs_ - task->sliceStartUs >= SLICE_US) {
+        task->sliceStartUs = nowUs_;
+        task->lastRunUs = nowUs_;
+      }
+      running_[core] = task;
+    }
+  }
+
+  void advance(SimTask& task, int core) {
+    Job& job = task.jobs.front();
+    Phase& phase = job.phases[job.phase];
+    if (phase.blockUs > 0 && !job.waiting) {
+      job.waiting = true;
+      task.blockedUntilUs = nowUs_ + phase.blockUs;
+      return;
+    }
+
+    result_.coreBusyUs[core] += TICK_US;
+    phase.cpuUs -= TICK_US;
+    if (phase.cpuUs > 0) {
+      return;
+    }
+
+    job.waiting = false;
+    if (++job.phase < job.phases.size()) {
+      return;
+    }
+    Job done = std::move(task.jobs.front());
+    task.jobs.pop_front();
+    finish(done);
+  }
+
+  void finish(Job& job) {
+    switch (job.kind) {
+      case Kind::RxChunk:
+        finishChunk(job);
+        break;
+      case Kind::Decode:
+        decodeBusy_ = false;
+        result_.decoded++;
+        push(display_, makeJob(Kind::Preview, {{0, config_.previewUs}}));
+        break;
+      case Kind::InputPoll:
+        if (!pressesUs_.empty()) {
+          Job render = makeJob(Kind::Render, {{0, config_.renderUs}});
+          render.pressesUs.swap(pressesUs_);
+          push(display_, std::move(render));
+        }
+        break;
+      case Kind::Render:
+        for (int64_t pressUs : job.pressesUs) {
+          result_.uiLatencyUs.push_back(nowUs_ - pressUs);
+        }
+        break;
+      case Kind::Proxy:
+        result_.proxyLatencyUs.push_back(nowUs_ - job.startUs);
+        break;
+      case Kind::Preview:
+      case Kind::NetworkLoop:
+      case Kind::Lwip:
+        break;
+    }
+  }
+
+  void finishChunk(const Job& job) {
+    FrameState& frame = frames_[job.frame];
+    frame.received++;
+    if (!job.lastChunk) {
+      return;
+    }
+    if (frame.lost) {
+      result_.rxLost++;
+      return;
+    }
+    if (inlineDecode_) {
+      // Decoded in the receive callback: the WiFi task is busy until done.
+      Job decode = makeJob(Kind::Decode, {{0, config_.decodeUs}});
+      wifi_->jobs.push_front(std::move(decode));
+      return;
+    }
+    if (decodeBusy_) {
+      result_.skipped++;
+      return;
+    }
+    decodeBusy_ = true;
+    push(decode_, makeJob(Kind::Decode, {{0, config_.decodeUs}}));
+  }
+
+  const Config& config_;
+  bool inlineDecode_;
+  std::mt19937 rng_;
+  std::deque<SimTask> tasks_;
+  SimTask* wifi_ = nullptr;
+  SimTask* lwip_ = nullptr;
+  SimTask* network_ = nullptr;
+  SimTask* display_ = nullptr;
+  SimTask* input_ = nullptr;
+  SimTask* decode_ = nullptr;
+  SimTask* proxy_ = nullptr;
+  SimTask* running_[2] = {nullptr, nullptr};
+  std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events_;
+  uint64_t eventOrder_ = 0;
+  int64_t nowUs_ = 0;
+  bool decodeBusy_ = false;
+  std::vector<FrameState> frames_;
+  std::vector<int64_t> pressesUs_;
+  Result result_;
+};
+
+double percentileMs(std::vector<int64_t> values, double p) {
+  if (values.empty()) {
+    return 0.0;
+  }
+  std::sort(values.begin(), values.end());
+  const size_t index = std::min(values.size() - 1, static_cast<size_t>(p * (values.size() - 1) + 0.5));
+  return values[index] / 1000.0;
+}
+
+double meanMs(const std::vector<int64_t>& values) {
+  if (values.empty()) {
+    return 0.0;
+  }
+  int64_t sum = 0;
+  for (int64_t value : values) {
+    sum += value;
+  }
+  return static_cast<double>(sum) / values.size() / 1000.0;
+}
+
+bool parseArgs(int argc, char** argv, Config& config) {
+  for (int i = 1; i < argc; ++i) {
+    const char* name = argv[i];
+    if (i + 1 >= argc) {
+      fprintf(stderr, "missing value for %s\n", name);
+      return false;
+    }
+    const long long value = strtoll(argv[++i], nullptr, 10);
+    if (strcmp(name, "--seconds") == 0) {
+      config.seconds = static_cast<uint32_t>(value);
+    } else if (strcmp(name, "--fps") == 0) {
+      config.fps = static_cast<uint32_t>(value);
+    } else if (strcmp(name, "--chunks") == 0) {
+      config.chunks = static_cast<uint32_t>(value);
+    } else if (strcmp(name, "--chunk-gap-us") == 0) {
+      config.chunkGapUs = value;
+    } else if (strcmp(name, "--rx-us") == 0) {
+      config.rxUs = value;
+    } else if (strcmp(name, "--rx-queue") == 0) {
+      config.rxQueue = static_cast<size_t>(value);
+    } else if (strcmp(name, "--decode-us") == 0) {
+      config.decodeUs = value;
+    } else if (strcmp(name, "--preview-us") == 0) {
+      config.previewUs = value;
+    } else if (strcmp(name, "--render-us") == 0) {
+      config.renderUs = value;
+    } else if (strcmp(name, "--nav-ms") == 0) {
+      config.navMs = static_cast<uint32_t>(value);
+    } else if (strcmp(name, "--proxy-ms") == 0) {
+      config.proxyMs = static_cast<uint32_t>(value);
+    } else if (strcmp(name, "--tls-us") == 0) {
+      config.tlsUs = value;
+    } else if (strcmp(name, "--rtt-ms") == 0) {
+      config.rttMs = static_cast<uint32_t>(value);
+    } else if (strcmp(name, "--body-us") == 0) {
+      config.bodyUs = value;
+    } else if (strcmp(name, "--seed") == 0) {
+      config.seed = static_cast<uint32_t>(value);
+    } else {
+      fprintf(stderr, "unknown option %s\n", name);
+      return false;
+    }
+  }
+  if (config.fps == 0 || config.chunks == 0 || config.navMs == 0 || config.proxyMs == 0 || config.seconds == 0) {
+    fprintf(stderr, "--seconds, --fps, --chunks, --nav-ms and --proxy-ms must be > 0\n");
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Config config;
+  if (!parseArgs(argc, argv, config)) {
+    return 2;
+  }
+
+  printf("%us, camera %u fps x %u chunks, decode %.1f ms, render %.1f ms, nav every %u ms, proxy every %u ms (firmware plan: %s)\n",
+         config.seconds, config.fps, config.chunks, config.decodeUs / 1000.0, config.renderUs / 1000.0, config.navMs,
+         config.proxyMs, kPlanNames[MASTER_TASK_TOPOLOGY]);
+  printf("%-16s %-7s %6s %7s %7s %7s %6s %7s %7s %7s %8s %6s %6s\n", "plan", "decode", "sent", "rxlost", "skipped",
+         "decoded", "drop%", "ui_p50", "ui_p95", "ui_max", "proxy_ms", "core0%", "core1%");
+
+  for (uint8_t plan = 0; plan < PlanCount; ++plan) {
+    for (int inlineDecode = 1; inlineDecode >= 0; --inlineDecode) {
+      Model model(config, plan, inlineDecode != 0);
+      const Result result = model.run();
+      const double runUs = config.seconds * 1e6;
+      const uint32_t dropped = result.sent - result.decoded;
+      printf("%-16s %-7s %6u %7u %7u %7u %5.1f%% %7.1f %7.1f %7.1f %8.1f %5.1f%% %5.1f%%\n", kPlanNames[plan],
+             inlineDecode ? "inline" : "worker", result.sent, result.rxLost, result.skipped, result.decoded,
+             result.sent == 0 ? 0.0 : 100.0 * dropped / result.sent, percentileMs(result.uiLatencyUs, 0.5),
+             percentileMs(result.uiLatencyUs, 0.95), percentileMs(result.uiLatencyUs, 1.0), meanMs(result.proxyLatencyUs),
+             100.0 * result.coreBusyUs[0] / runUs, 100.0 * result.coreBusyUs[1] / runUs);
+    }
+  }
+  return 0;
+}
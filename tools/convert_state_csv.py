@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+"""Convert a legacy state_latest.csv into the binary state store snapshot.
+
+The firmware also imports the CSV on first boot; this tool is for preparing
+LittleFS images offline and for inspecting .bin snapshots/journals.
+"""
+import argparse
+import csv
+import struct
+import sys
+import zlib
+from pathlib import Path
+
+FILE_MAGIC = b'SKVB'
+FORMAT_VERSION = 1
+KIND_INTERN = 1
+KIND_VALUE = 2
+MAX_NAME_LEN = 255
+MAX_VALUE_LEN = 1024
+
+
+def encode_record(kind: int, payload: bytes) -> bytes:
+    header = struct.pack('<BBH', kind, 0, len(payload))
+    crc = zlib.crc32(header + payload) & 0xFFFFFFFF
+    return header + struct.pack('<I', crc) + payload
+
+
+def build_snapshot(rows: list[tuple[str, str, str]]) -> bytes:
+    names: dict[str, int] = {}
+    out = bytearray(FILE_MAGIC + bytes([FORMAT_VERSION, 0, 0, 0]))
+
+    def intern(name: str) -> int:
+        if name not in names:
+            raw = name.encode('utf-8')[:MAX_NAME_LEN]
+            names[name] = len(names)
+            out.extend(encode_record(KIND_INTERN, struct.pack('<HB', names[name], len(raw)) + raw))
+        return names[name]
+
+    latest: dict[tuple[int, int], str] = {}
+    for state, key, value in rows:
+        latest[(intern(state), intern(key))] = value
+
+    for (state_id, key_id), value in latest.items():
+        raw = value.encode('utf-8')[:MAX_VALUE_LEN]
+        out.extend(encode_record(KIND_VALUE, struct.pack('<HHH', state_id, key_id, len(raw)) + raw))
+
+    return bytes(out)
+
+
+def read_csv(source: Path) -> list[tuple[str, str, str]]:
+    rows = []
+    with source.open(newline='', encoding='utf-8') as handle:
+        for columns in csv.reader(handle):
+            if len(columns) != 3 or columns == ['state', 'key', 'value']:
+                continue
+            rows.append((columns[0], columns[1], columns[2]))
+    return rows
+
+
+def decode_store(data: bytes, names: dict[int, str], values: dict[tuple[int, int], str]) -> int:
+    if len(data) < 8 or data[:4] != FILE_MAGIC:
+        raise ValueError('not a state store file')
+
+    offset = 8
+    while offset + 8 <= len(data):
+        kind, _, length, crc = struct.unpack_from('<BBHI', data, offset)
+        payload = data[offset + 8:offset + 8 + length]
+        if len(payload) != length or zlib.crc32(data[offset:offset + 4] + payload) & 0xFFFFFFFF != crc:
+            break
+        if kind == KIND_INTERN:
+            name_id, name_len = struct.unpack_from('<HB', payload)
+            names[name_id] = payload[3:3 + name_len].decode('utf-8', 'replace')
+        elif kind == KIND_VALUE:
+            state_id, key_id, value_len = struct.unpack_from('<HHH', payload)
+            values[(state_id, key_id)] = payload[6:6 + value_len].decode('utf-8', 'replace')
+        else:
+            break
+        offset += 8 + length
+    return offset
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description='Convert state_latest.csv to the binary state store format')
+    sub = parser.add_subparsers(dest='command', required=True)
+
+    convert = sub.add_parser('convert', help='CSV -> state_latest.bin')
+    convert.add_argument('source', type=Path)
+    convert.add_argument('target', type=Path, nargs='?')
+
+    dump = sub.add_parser('dump', help='print snapshot (+ optional journal) as CSV')
+    dump.add_argument('snapshot', type=Path)
+    dump.add_argument('journal', type=Path, nargs='?')
+
+    args = parser.parse_args()
+
+    if args.command == 'convert':
+        target = args.target or args.source.with_suffix('.bin')
+        rows = read_csv(args.source)
+        image = build_snapshot(rows)
+        target.write_bytes(image)
+        print(f'{args.source} -> {target}: {len(rows)} rows, {len(image)} bytes')
+        return
+
+    names: dict[int, str] = {}
+    values: dict[tuple[int, int], str] = {}
+    for path in (args.snapshot, args.journal):
+        if path is None:
+            continue
+        data = path.read_bytes()
+        consumed = decode_store(data, names, values)
+        if consumed != len(data):
+            print(f'# {path}: corrupt tail at {consumed}/{len(data)}')
+
+    writer = csv.writer(sys.stdout, quoting=csv.QUOTE_ALL)
+    writer.writerow(['state', 'key', 'value'])
+    for (state_id, key_id), value in values.items():
+        writer.writerow([names.get(state_id, '?'), names.get(key_id, '?'), value])
+
+
+if __name__ == '__main__':
+    main()
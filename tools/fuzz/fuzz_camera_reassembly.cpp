@@ -0,0 +1,158 @@
+// Fuzz target: camera_stream reassembly (chunk offsets, running CRC, FEC
+// recovery, incremental JPEG marker index and the DHT headroom splice).
+//
+// Byte 0 bit 7 selects the mode:
+//  - structured (clear): the rest of the input is a JPEG body the harness
+//    sends the way a camera would (meta, chunks, parity, frame end), so
+//    arbitrary marker layouts reach the splice path. Byte 0 bit 0 enables
+//    FEC with the layout in byte 1 (data per group, parity per group in the
+//    low/high nibble), bit 1 sends a v1 frame end; bytes 2-5 are width and
+//    height, byte 6 drops data chunk i when (i * byte6) & 0x30 == 0x30.
+//    A frame that completes with a v2 CRC must match the body exactly.
+//  - raw (set): records of {kind, len, len bytes} copied over a zeroed
+//    CameraMeta / CameraChunk / CameraFrameEnd struct, for hostile offsets.
+
+#include "fuzz_support.h"
+
+#include "app/espnow/camera_fec.h"
+#include "app/espnow/camera_frame_pool.h"
+#include "app/espnow/camera_stream_buffer.h"
+#include "core/crc32.h"
+
+namespace {
+
+using namespace app::espnow;
+
+constexpr uint8_t kCameraMac[6] = {0x30, 0xAE, 0xA4, 0x00, 0x00, 0x20};
+constexpr uint8_t kRawMode = 0x80;
+constexpr uint8_t kFecFlag = 0x01;
+constexpr uint8_t kV1FrameEnd = 0x02;
+
+uint32_t nextFrameId = 1;
+
+void sendChunk(uint32_t frameId, uint16_t idx, uint16_t total, const uint8_t* data, size_t length) {
+  state_binary::CameraChunkState chunk = {};
+  state_binary::initHeader(chunk.header, state_binary::Type::CameraChunk);
+  chunk.frameId = frameId;
+  chunk.idx = idx;
+  chunk.total = total;
+  chunk.dataLen = static_cast<uint8_t>(length);
+  memcpy(chunk.data, data, length);
+  camera_stream::ingestChunk(kCameraMac, chunk);
+}
+
+void runStructured(fuzz::Reader& input, uint8_t flags) {
+  const uint8_t layoutByte = input.u8();
+  const uint16_t width = input.u16();
+  const uint16_t height = input.u16();
+  const uint8_t dropStride = input.u8();
+  size_t jpegBytes = 0;
+  const uint8_t* jpeg = input.take(camera_frames::kMaxJpegBytes, jpegBytes);
+  if (jpegBytes == 0) {
+    return;
+  }
+
+  camera_fec::Layout layout;
+  if ((flags & kFecFlag) != 0) {
+    layout = {static_cast<uint8_t>(layoutByte & 0x0F), static_cast<uint8_t>(layoutByte >> 4)};
+  }
+  const bool fec = camera_fec::isValid(layout);
+  const uint32_t frameId = nextFrameId++;
+  const auto dataChunks =
+      static_cast<uint16_t>((jpegBytes + state_binary::kCameraChunkDataBytes - 1) / state_binary::kCameraChunkDataBytes);
+
+  state_binary::CameraMetaState meta = {};
+  state_binary::initHeader(meta.header, state_binary::Type::CameraMeta);
+  meta.frameId = frameId;
+  meta.totalBytes = static_cast<uint32_t>(jpegBytes);
+  meta.totalChunks = dataChunks;
+  meta.width = width;
+  meta.height = height;
+  meta.format = fec ? camera_fec::kFormatFecFlag : 0;
+  camera_stream::ingestMeta(kCameraMac, meta);
+
+  bool dropped = false;
+  for (uint16_t position = 0; position < dataChunks; ++position) {
+    if (((position * dropStride) & 0x30) == 0x30) {
+      dropped = true;
+      continue;
+    }
+    sendChunk(frameId, static_cast<uint16_t>(position + 1), dataChunks,
+              jpeg + position * state_binary::kCameraChunkDataBytes,
+              camera_fec::dataChunkLength(static_cast<uint32_t>(jpegBytes), position));
+  }
+
+  if (fec) {
+    const size_t parityChunks = camera_fec::parityChunkCount(layout, dataChunks);
+    for (size_t parity = 0; parity < parityChunks; ++parity) {
+      const camera_fec::ParityId id{static_cast<uint16_t>(parity / layout.parityPerGroup),
+                                    static_cast<uint8_t>(parity % layout.parityPerGroup)};
+      uint8_t bytes[camera_fec::kChunkBytes];
+      camera_fec::buildParity(jpeg, static_cast<uint32_t>(jpegBytes), layout, id, bytes);
+      sendChunk(frameId, camera_fec::parityChunkIdx(id), camera_fec::parityChunkTotal(layout), bytes, sizeof(bytes));
+    }
+  }
+
+  const bool v2 = (flags & kV1FrameEnd) == 0;
+  state_binary::CameraFrameEndState frameEnd = {};
+  state_binary::initHeader(frameEnd.header, state_binary::Type::CameraFrameEnd);
+  frameEnd.frameId = frameId;
+  frameEnd.totalBytes = static_cast<uint32_t>(jpegBytes);
+  frameEnd.totalChunks = dataChunks;
+  frameEnd.crc32 = v2 ? core::crc32(jpeg, jpegBytes) : 0;
+
+  fuzz::lastCompleted.valid = false;
+  camera_stream::ingestFrameEnd(kCameraMac, frameEnd, v2);
+
+  if (!dropped) {
+    fuzz::require(fuzz::lastCompleted.valid && fuzz::lastCompleted.frameId == frameId, "lossless frame not completed");
+  }
+  if (v2 && fuzz::lastCompleted.valid) {
+    fuzz::require(fuzz::lastCompleted.bytes.size() == jpegBytes &&
+                      memcmp(fuzz::lastCompleted.bytes.data(), jpeg, jpegBytes) == 0,
+                  "completed frame differs from the sent body");
+  }
+}
+
+void runRaw(fuzz::Reader& input) {
+  while (input.remaining() >= 2) {
+    const uint8_t kind = input.u8();
+    const uint8_t wanted = input.u8();
+    size_t length = 0;
+    const uint8_t* bytes = input.take(wanted, length);
+
+    switch (kind % 3) {
+      case 0: {
+        state_binary::CameraMetaState meta = {};
+        memcpy(&meta, bytes, length < sizeof(meta) ? length : sizeof(meta));
+        camera_stream::ingestMeta(kCameraMac, meta);
+        break;
+      }
+      case 1: {
+        state_binary::CameraChunkState chunk = {};
+        memcpy(&chunk, bytes, length < sizeof(chunk) ? length : sizeof(chunk));
+        camera_stream::ingestChunk(kCameraMac, chunk);
+        break;
+      }
+      default: {
+        state_binary::CameraFrameEndState frameEnd = {};
+        memcpy(&frameEnd, bytes, length < sizeof(frameEnd) ? length : sizeof(frameEnd));
+        camera_stream::ingestFrameEnd(kCameraMac, frameEnd, length >= sizeof(frameEnd));
+        break;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  fuzz::Reader input(data, size);
+  const uint8_t flags = input.u8();
+  if ((flags & kRawMode) != 0) {
+    runRaw(input);
+  } else {
+    runStructured(input, flags);
+  }
+  return 0;
+}
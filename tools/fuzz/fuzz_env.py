@@ -0,0 +1,15 @@
+Import('env')
+import os
+
+# libFuzzer needs clang; FUZZ_CC/FUZZ_CXX=afl-clang-fast/afl-clang-fast++
+# build the same targets for AFL++. FUZZ_STANDALONE=1 keeps the default
+# compiler and links tools/fuzz/standalone_main.cpp instead of libFuzzer.
+sanitizers = '-fsanitize=address,undefined'
+if os.environ.get('FUZZ_STANDALONE'):
+    env.Append(CPPDEFINES=['FUZZ_STANDALONE'])
+else:
+    env.Replace(CC=os.environ.get('FUZZ_CC', 'clang'), CXX=os.environ.get('FUZZ_CXX', 'clang++'))
+    sanitizers += ',fuzzer'
+
+flags = [sanitizers, '-fno-sanitize-recover=undefined', '-fno-omit-frame-pointer']
+env.Append(CCFLAGS=flags, LINKFLAGS=flags)
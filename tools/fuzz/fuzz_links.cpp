@@ -0,0 +1,93 @@
+// Link-time stand-ins for the modules the fuzz targets do not build (no
+// display, HTTP proxy, weather sync or recorder task) and the shared setup
+// from fuzz_support.h.
+
+#include "fuzz_support.h"
+
+#include "app/display/display_interface.h"
+#include "app/espnow/camera_recorder.h"
+#include "app/espnow/master.h"
+#include "app/espnow/master_http_proxy.h"
+#include "core/boot.h"
+#include "core/weather_sync.h"
+
+namespace app::display {
+
+DisplayInterface displayInterface;
+
+void DisplayInterface::requestRender() {}
+
+bool DisplayInterface::applyStatePayload(const String&) {
+  return false;
+}
+
+}  // namespace app::display
+
+namespace app::espnow {
+
+bool beginProxyWorker() {
+  return true;
+}
+
+bool enqueueProxyRequest(const uint8_t[6], const char*) {
+  return false;
+}
+
+void processProxyResponses(MasterNode&) {}
+
+}  // namespace app::espnow
+
+namespace app::espnow::camera_recorder {
+
+bool begin() {
+  return true;
+}
+
+void onFrameComplete(const uint8_t[6], const uint8_t* jpeg, uint32_t length, uint32_t frameId, uint16_t, uint16_t) {
+  fuzz::lastCompleted.valid = true;
+  fuzz::lastCompleted.frameId = frameId;
+  fuzz::lastCompleted.bytes.assign(jpeg, jpeg + length);
+}
+
+}  // namespace app::espnow::camera_recorder
+
+namespace core::boot {
+
+void mark(Milestone) {}
+
+bool isFsReady() {
+  return true;
+}
+
+bool isFsMounted() {
+  return true;
+}
+
+}  // namespace core::boot
+
+namespace core::weather_sync {
+
+void tick(app::espnow::MasterNode&) {}
+
+}  // namespace core::weather_sync
+
+namespace fuzz {
+
+CompletedFrame lastCompleted;
+
+void ensureMaster() {
+  static bool started = false;
+  if (started) {
+    return;
+  }
+  started = true;
+  hostClock.virtualTime = true;
+  hostClock.nowUs = 1000000;
+  app::espnow::espnowMaster.begin(1);
+}
+
+void advanceMs(uint32_t ms) {
+  hostClock.nowUs += static_cast<uint64_t>(ms) * 1000ULL;
+}
+
+}  // namespace fuzz
@@ -0,0 +1,38 @@
+// Fuzz target: proxy_chunks splitting of a proxy response body. The chunks
+// must carry idx 1..total, stay within kProxyChunkDataBytes and concatenate
+// back to the body. Byte 0-1 are the request id, byte 2 the ok flag, the
+// rest is the body.
+
+#include "fuzz_support.h"
+
+#include "app/espnow/proxy_chunker.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  using namespace app::espnow;
+
+  fuzz::Reader input(data, size);
+  const uint16_t requestId = input.u16();
+  const uint8_t ok = input.u8() & 0x01;
+  size_t bodyLength = 0;
+  const uint8_t* bodyBytes = input.take(input.remaining(), bodyLength);
+  // Own allocation so ASan sees reads past the body.
+  std::vector<char> body(bodyBytes, bodyBytes + bodyLength);
+
+  const size_t total = proxy_chunks::count(bodyLength);
+  fuzz::require(total >= 1, "no chunk for body");
+  std::vector<char> joined;
+  joined.reserve(bodyLength);
+  for (size_t index = 0; index < total; ++index) {
+    state_binary::ProxyRespChunkCommand command;
+    proxy_chunks::fill(command, requestId, index, total, ok, 200, body.data(), body.size());
+    fuzz::require(state_binary::hasValidHeader(reinterpret_cast<const uint8_t*>(&command), sizeof(command)),
+                  "chunk header");
+    fuzz::require(command.requestId == requestId && command.idx == index + 1 && command.total == total,
+                  "chunk numbering");
+    fuzz::require(command.dataLen <= state_binary::kProxyChunkDataBytes, "chunk length");
+    fuzz::require(index + 1 == total || command.dataLen == state_binary::kProxyChunkDataBytes, "short middle chunk");
+    joined.insert(joined.end(), command.data, command.data + command.dataLen);
+  }
+  fuzz::require(joined == body, "chunks do not rebuild the body");
+  return 0;
+}
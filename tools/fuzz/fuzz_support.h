@@ -0,0 +1,67 @@
+#pragma once
+
+// Shared pieces of the fuzz targets in this directory: a byte reader over
+// the fuzzer input, the one-time MasterNode setup on the virtual clock, and
+// the last frame the camera reassembler handed to the recorder hook.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+namespace fuzz {
+
+class Reader {
+ public:
+  Reader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+  size_t remaining() const { return size_ - offset_; }
+
+  uint8_t u8() { return remaining() > 0 ? data_[offset_++] : 0; }
+
+  uint16_t u16() {
+    const uint16_t low = u8();
+    return static_cast<uint16_t>(low | (u8() << 8));
+  }
+
+  // Up to `count` bytes, fewer at the end of the input.
+  const uint8_t* take(size_t count, size_t& taken) {
+    taken = count < remaining() ? count : remaining();
+    const uint8_t* out = data_ + offset_;
+    offset_ += taken;
+    return out;
+  }
+
+ private:
+  const uint8_t* data_;
+  size_t size_;
+  size_t offset_ = 0;
+};
+
+struct CompletedFrame {
+  bool valid = false;
+  uint32_t frameId = 0;
+  std::vector<uint8_t> bytes;
+};
+
+// Filled by the camera_recorder::onFrameComplete stand-in.
+extern CompletedFrame lastCompleted;
+
+// Starts espnowMaster on the virtual clock the first time it is called.
+void ensureMaster();
+
+// Advances the virtual clock; the master's timers follow it.
+void advanceMs(uint32_t ms);
+
+// Aborts with `what` so the fuzzer records the input as a crash.
+inline void require(bool condition, const char* what) {
+  if (!condition) {
+    __builtin_printf("fuzz check failed: %s\n", what);
+    abort();
+  }
+}
+
+}  // namespace fuzz
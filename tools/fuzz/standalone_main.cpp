@@ -0,0 +1,114 @@
+// Driver for compilers without libFuzzer (built with -DFUZZ_STANDALONE):
+// runs every file or directory given on the command line through the
+// target, then `-mutate=N` random byte-level variants of each. Pair it with
+// -fsanitize=address,undefined to replay a corpus or a crash file.
+
+#if defined(FUZZ_STANDALONE)
+
+#include "fuzz_support.h"
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <cstdio>
+#include <string>
+
+namespace {
+
+uint64_t rngState = 0x9E3779B97F4A7C15ULL;
+
+uint32_t nextRandom() {
+  rngState ^= rngState << 13;
+  rngState ^= rngState >> 7;
+  rngState ^= rngState << 17;
+  return static_cast<uint32_t>(rngState);
+}
+
+void mutate(std::vector<uint8_t>& bytes) {
+  const uint32_t edits = 1 + nextRandom() % 8;
+  for (uint32_t edit = 0; edit < edits; ++edit) {
+    const uint32_t op = nextRandom() % 4;
+    if (bytes.empty() || op == 0) {
+      bytes.insert(bytes.begin() + (bytes.empty() ? 0 : nextRandom() % bytes.size()), static_cast<uint8_t>(nextRandom()));
+    } else if (op == 1) {
+      bytes[nextRandom() % bytes.size()] ^= static_cast<uint8_t>(1u << (nextRandom() % 8));
+    } else if (op == 2) {
+      bytes[nextRandom() % bytes.size()] = static_cast<uint8_t>(nextRandom());
+    } else {
+      bytes.erase(bytes.begin() + nextRandom() % bytes.size());
+    }
+  }
+}
+
+bool readFile(const std::string& path, std::vector<uint8_t>& bytes) {
+  FILE* file = fopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    return false;
+  }
+  bytes.clear();
+  uint8_t buffer[4096];
+  size_t read = 0;
+  while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    bytes.insert(bytes.end(), buffer, buffer + read);
+  }
+  fclose(file);
+  return true;
+}
+
+void collect(const std::string& path, std::vector<std::string>& files) {
+  struct stat info = {};
+  if (stat(path.c_str(), &info) != 0) {
+    fprintf(stderr, "missing %s\n", path.c_str());
+    return;
+  }
+  if (!S_ISDIR(info.st_mode)) {
+    files.push_back(path);
+    return;
+  }
+  DIR* dir = opendir(path.c_str());
+  while (dirent* entry = dir != nullptr ? readdir(dir) : nullptr) {
+    if (entry->d_name[0] != '.') {
+      collect(path + "/" + entry->d_name, files);
+    }
+  }
+  if (dir != nullptr) {
+    closedir(dir);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  unsigned long mutations = 0;
+  std::vector<std::string> files;
+  for (int i = 1; i < argc; ++i) {
+    if (strncmp(argv[i], "-mutate=", 8) == 0) {
+      mutations = strtoul(argv[i] + 8, nullptr, 10);
+    } else if (argv[i][0] != '-') {
+      collect(argv[i], files);
+    }
+  }
+
+  unsigned long runs = 0;
+  std::vector<uint8_t> bytes;
+  for (const auto& path : files) {
+    if (!readFile(path, bytes)) {
+      continue;
+    }
+    LLVMFuzzerTestOneInput(bytes.data(), bytes.size());
+    runs++;
+    std::vector<uint8_t> variant;
+    for (unsigned long i = 0; i < mutations; ++i) {
+      if (i % 16 == 0) {
+        variant = bytes;
+      }
+      mutate(variant);
+      LLVMFuzzerTestOneInput(variant.data(), variant.size());
+      runs++;
+    }
+  }
+  printf("%zu inputs, %lu runs, no crash\n", files.size(), runs);
+  return 0;
+}
+
+#endif  // FUZZ_STANDALONE
@@ -0,0 +1,291 @@
+#!/usr/bin/env python3
+"""Generate seed corpora for the fuzz targets in tools/fuzz.
+
+Every seed is built from the wire contract (docs/espnow_device_contract.md,
+src/app/espnow/state_binary.h): valid frames for each state Type, BATCH
+frames, v1/v2 camera frame ends, FEC parity streams and JPEG bodies with and
+without a DHT segment, plus a few truncated/oversized edge cases. Output is
+one directory per target, ready for `program <dir>` (libFuzzer) or the
+standalone driver.
+"""
+import argparse
+import struct
+import zlib
+from pathlib import Path
+
+PROTOCOL_VERSION = 1
+HELLO, HEARTBEAT, COMMAND, STATE, BATCH = 1, 2, 3, 4, 5
+MAX_PAYLOAD_SIZE = 200
+ESP_NOW_MAX_DATA_LEN = 250
+
+STATE_MAGIC = 0xB1
+STATE_VERSION = 1
+T_IDENTITY, T_SENSOR, T_PROXY_REQ, T_WEATHER = 1, 2, 3, 4
+T_SLAVE_ALIVE, T_FEATURES = 6, 9
+T_CAMERA_META, T_CAMERA_CHUNK, T_CAMERA_FRAME_END = 20, 21, 23
+
+FEATURE_IDENTITY = 1 << 0
+FEATURE_SENSOR = 1 << 1
+FEATURE_WEATHER = 1 << 2
+FEATURE_PROXY_CLIENT = 1 << 3
+FEATURE_CAMERA_JPEG = 1 << 4
+FEATURE_CAMERA_STREAM = 1 << 5
+FEATURE_BATCH_FRAMES = 1 << 7
+
+CHUNK_BYTES = 160
+FEC_FORMAT_FLAG = 0x80
+FEC_PARITY_IDX_FLAG = 0x8000
+MAX_JPEG_BYTES = 32768
+
+# fuzz_master_rx: ctl bits 0-1 sender, bit 2 loop(), bits 3-7 50 ms steps.
+SENDER_A, SENDER_B, SENDER_BROADCAST = 0, 1, 3
+LOOP = 0x04
+
+
+def state_header(state_type: int) -> bytes:
+    return struct.pack('<BBBB', STATE_MAGIC, STATE_VERSION, state_type, 0)
+
+
+def fixed(text: str, size: int) -> bytes:
+    return text.encode('ascii')[:size].ljust(size, b'\0')
+
+
+def identity(device_id: str) -> bytes:
+    return state_header(T_IDENTITY) + fixed(device_id, 24)
+
+
+def features(bits: int, contract: int = 1) -> bytes:
+    return state_header(T_FEATURES) + struct.pack('<IHH', bits, contract, 0)
+
+
+def sensor(temperature: float, humidity: float) -> bytes:
+    return state_header(T_SENSOR) + struct.pack('<hH', round(temperature * 10), round(humidity * 10))
+
+
+def weather(ok: int, code: int, time: str, temperature: float, wind: float, direction: int) -> bytes:
+    return (state_header(T_WEATHER) + struct.pack('<Bh', ok, code) + fixed(time, 20) +
+            struct.pack('<hhH', round(temperature * 10), round(wind * 10), direction))
+
+
+def proxy_req(method: int, url: str) -> bytes:
+    return state_header(T_PROXY_REQ) + struct.pack('<B', method) + fixed(url, 140)
+
+
+def slave_alive() -> bytes:
+    return state_header(T_SLAVE_ALIVE)
+
+
+def camera_meta(frame_id: int, total_bytes: int, total_chunks: int, width: int, height: int,
+                fmt: int = 0, quality: int = 12) -> bytes:
+    return state_header(T_CAMERA_META) + struct.pack('<IIHHHBB', frame_id, total_bytes, total_chunks,
+                                                     width, height, fmt, quality)
+
+
+def camera_chunk(frame_id: int, idx: int, total: int, data: bytes) -> bytes:
+    return (state_header(T_CAMERA_CHUNK) + struct.pack('<IHHB', frame_id, idx, total, len(data)) +
+            data.ljust(CHUNK_BYTES, b'\0'))
+
+
+def camera_frame_end(frame_id: int, body: bytes, chunks: int, v2: bool = True) -> bytes:
+    checksum16 = sum(body) & 0xFFFF
+    end = state_header(T_CAMERA_FRAME_END) + struct.pack('<IIHH', frame_id, len(body), chunks, checksum16)
+    return end + struct.pack('<I', zlib.crc32(body) & 0xFFFFFFFF) if v2 else end
+
+
+def frame(packet_type: int, payload: bytes, sequence: int = 0, timestamp_ms: int = 0) -> bytes:
+    return struct.pack('<BBHIB', PROTOCOL_VERSION, packet_type, sequence, timestamp_ms, len(payload)) + payload
+
+
+def batch(entries: list[tuple[int, bytes]]) -> bytes:
+    return b''.join(struct.pack('<BB', packet_type, len(data)) + data for packet_type, data in entries)
+
+
+def parity_chunks(body: bytes, data_per_group: int, parity_per_group: int) -> list[tuple[int, int, bytes]]:
+    chunks = [body[i:i + CHUNK_BYTES].ljust(CHUNK_BYTES, b'\0') for i in range(0, len(body), CHUNK_BYTES)]
+    out = []
+    groups = (len(chunks) + data_per_group - 1) // data_per_group
+    total = (parity_per_group << 8) | data_per_group
+    for group in range(groups):
+        members = chunks[group * data_per_group:(group + 1) * data_per_group]
+        for index in range(parity_per_group):
+            parity = bytearray(CHUNK_BYTES)
+            for member in members[index::parity_per_group]:
+                for i, byte in enumerate(member):
+                    parity[i] ^= byte
+            out.append((FEC_PARITY_IDX_FLAG | (index << 12) | group, total, bytes(parity)))
+    return out
+
+
+def segment(marker: int, payload: bytes) -> bytes:
+    return struct.pack('>BBH', 0xFF, marker, len(payload) + 2) + payload
+
+
+def jpeg(width: int, height: int, scan_bytes: int, with_dht: bool, seed: int = 1) -> bytes:
+    """Structurally valid baseline JPEG headers around a pseudo-random scan."""
+    soi = b'\xFF\xD8'
+    app0 = segment(0xE0, b'JFIF\0\x01\x01\0\0\x01\0\x01\0\0')
+    dqt = segment(0xDB, b'\0' + bytes(range(1, 65)))
+    sof0 = segment(0xC0, struct.pack('>BHHB', 8, height, width, 1) + b'\x01\x11\x00')
+    dht = segment(0xC4, b'\x00' + bytes([0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0]) + bytes(range(12)))
+    sos = segment(0xDA, b'\x01\x01\x00\x00\x3F\x00')
+    scan = bytearray()
+    state = seed
+    while len(scan) < scan_bytes:
+        state = (state * 1103515245 + 12345) & 0x7FFFFFFF
+        byte = (state >> 16) & 0xFF
+        scan.append(byte)
+        if byte == 0xFF:
+            scan.append(0x00)
+    return soi + app0 + dqt + sof0 + (dht if with_dht else b'') + sos + bytes(scan[:scan_bytes]) + b'\xFF\xD9'
+
+
+def camera_stream(frame_id: int, body: bytes, width: int, height: int, fec: tuple[int, int] | None,
+                  v2: bool = True) -> list[bytes]:
+    chunks = (len(body) + CHUNK_BYTES - 1) // CHUNK_BYTES
+    payloads = [camera_meta(frame_id, len(body), chunks, width, height, FEC_FORMAT_FLAG if fec else 0)]
+    for index in range(chunks):
+        payloads.append(camera_chunk(frame_id, index + 1, chunks, body[index * CHUNK_BYTES:(index + 1) * CHUNK_BYTES]))
+    if fec:
+        for idx, total, data in parity_chunks(body, *fec):
+            payloads.append(camera_chunk(frame_id, idx, total, data))
+    payloads.append(camera_frame_end(frame_id, body, chunks, v2))
+    return payloads
+
+
+def rx_record(ctl: int, wire: bytes) -> bytes:
+    wire = wire[:ESP_NOW_MAX_DATA_LEN]
+    return struct.pack('<BB', ctl, len(wire)) + wire
+
+
+def join_slave(sender: int, device_id: str, feature_bits: int) -> bytes:
+    return (rx_record(sender, frame(HELLO, b'PIO_SLAVE')) +
+            rx_record(sender, frame(STATE, identity(device_id), 1)) +
+            rx_record(sender | LOOP, frame(STATE, features(feature_bits), 2)))
+
+
+def master_rx_seeds() -> dict[str, bytes]:
+    weather_bits = FEATURE_IDENTITY | FEATURE_SENSOR | FEATURE_WEATHER | FEATURE_PROXY_CLIENT
+    camera_bits = FEATURE_IDENTITY | FEATURE_CAMERA_JPEG | FEATURE_CAMERA_STREAM | FEATURE_BATCH_FRAMES
+    seeds = {
+        'hello': rx_record(SENDER_A, frame(HELLO, b'PIO_SLAVE')),
+        'heartbeat': rx_record(SENDER_A, frame(HEARTBEAT, b'PIO_SLAVE')),
+        'command': rx_record(SENDER_A, frame(COMMAND, state_header(7) + bytes(8))),
+        'state_empty': rx_record(SENDER_A, frame(STATE, b'')),
+        'too_short': rx_record(SENDER_A, frame(STATE, identity('x'))[:5]),
+        'size_over_length': rx_record(SENDER_A, frame(STATE, identity('weather-1'))[:-4]),
+        'payload_over_max': rx_record(SENDER_A, struct.pack('<BBHIB', PROTOCOL_VERSION, STATE, 0, 0, 240) + bytes(240)),
+        'bad_magic': rx_record(SENDER_A, frame(STATE, b'\x00' + identity('x')[1:])),
+        'unknown_type': rx_record(SENDER_A, frame(STATE, state_header(0x7F) + bytes(16))),
+        'outbound_type': rx_record(SENDER_A, frame(STATE, state_header(5) + b'\x01\x06')),
+        'broadcast_sender': rx_record(SENDER_BROADCAST, frame(STATE, identity('spoof'))),
+        'identity_empty_id': rx_record(SENDER_A, frame(STATE, identity(''))),
+        'proxy_req_unverified': rx_record(SENDER_A, frame(STATE, proxy_req(1, 'http://example.com/'))),
+    }
+
+    weather_slave = join_slave(SENDER_A, 'weather-1', weather_bits)
+    seeds['weather_slave'] = (weather_slave +
+                              rx_record(SENDER_A, frame(STATE, sensor(24.5, 61.0), 3)) +
+                              rx_record(SENDER_A, frame(STATE, weather(1, 200, '2026-01-01T00:00', 29.1, 3.4, 270), 4)) +
+                              rx_record(SENDER_A | (31 << 3) | LOOP, frame(STATE, slave_alive(), 5)) +
+                              rx_record(SENDER_A, frame(STATE, proxy_req(2, 'https://api.example.com/v1'), 6)))
+    seeds['unverified_sensor'] = rx_record(SENDER_B, frame(STATE, sensor(20.0, 50.0)))
+    seeds['batch_join'] = rx_record(SENDER_A, frame(BATCH, batch([
+        (HELLO, b'PIO_SLAVE'), (STATE, identity('cam-1')), (STATE, features(camera_bits))])))
+    seeds['batch_truncated'] = rx_record(SENDER_A, frame(BATCH, batch([(STATE, identity('cam-1'))])[:-3]))
+    seeds['batch_nested'] = rx_record(SENDER_A, frame(BATCH, batch([(BATCH, batch([(HELLO, b'x')]))])))
+
+    body = jpeg(96, 64, 900, with_dht=False)
+    stream = join_slave(SENDER_B, 'cam-1', camera_bits)
+    for payload in camera_stream(1, body, 96, 64, None):
+        stream += rx_record(SENDER_B, frame(STATE, payload))
+    seeds['camera_frame'] = stream
+
+    fec_stream = join_slave(SENDER_B, 'cam-1', camera_bits)
+    for index, payload in enumerate(camera_stream(2, jpeg(160, 120, 1500, with_dht=True), 160, 120, (4, 1))):
+        if index != 3:  # lose one data chunk; parity rebuilds it
+            fec_stream += rx_record(SENDER_B, frame(STATE, payload))
+    seeds['camera_fec_loss'] = fec_stream
+
+    v1 = join_slave(SENDER_B, 'cam-1', camera_bits)
+    for payload in camera_stream(3, body, 96, 64, None, v2=False):
+        v1 += rx_record(SENDER_B, frame(STATE, payload))
+    seeds['camera_frame_v1_end'] = v1
+    return seeds
+
+
+def camera_seeds() -> dict[str, bytes]:
+    def structured(flags: int, layout: int, width: int, height: int, drop: int, body: bytes) -> bytes:
+        return struct.pack('<BBHHB', flags, layout, width, height, drop) + body
+
+    def raw(records: list[tuple[int, bytes]]) -> bytes:
+        return bytes([0x80]) + b''.join(struct.pack('<BB', kind, len(data)) + data for kind, data in records)
+
+    no_dht = jpeg(96, 64, 900, with_dht=False)
+    with_dht = jpeg(320, 240, 5000, with_dht=True, seed=7)
+    return {
+        'no_dht': structured(0, 0, 96, 64, 0, no_dht),
+        'with_dht': structured(0, 0, 320, 240, 0, with_dht),
+        'v1_end': structured(0x02, 0, 96, 64, 0, no_dht),
+        'fec_8_1_loss': structured(0x01, (1 << 4) | 8, 320, 240, 0x13, with_dht),
+        'fec_4_2': structured(0x01, (2 << 4) | 4, 320, 240, 0, with_dht),
+        'not_jpeg': structured(0, 0, 16, 16, 0, bytes(range(256)) * 3),
+        'no_eoi': structured(0, 0, 96, 64, 0, no_dht[:-2]),
+        'single_chunk': structured(0, 0, 8, 8, 0, jpeg(8, 8, 40, with_dht=False)),
+        'huge_dims': structured(0, 0, 0xFFFF, 0xFFFF, 0, no_dht),
+        'max_body': structured(0, 0, 640, 480, 0, jpeg(640, 480, MAX_JPEG_BYTES - 200, with_dht=True, seed=3)),
+        'raw_offsets': raw([
+            (0, camera_meta(9, 400, 3, 96, 64)),
+            (1, camera_chunk(9, 0xFFFF, 3, bytes(CHUNK_BYTES))),
+            (1, camera_chunk(9, 205, 0, bytes(CHUNK_BYTES))),
+            (1, state_header(T_CAMERA_CHUNK) + struct.pack('<IHHB', 9, 1, 3, 0xFF) + bytes(CHUNK_BYTES)),
+            (2, camera_frame_end(9, bytes(400), 3)),
+        ]),
+        'raw_parity': raw([
+            (0, camera_meta(10, 640, 4, 96, 64, FEC_FORMAT_FLAG)),
+            (1, camera_chunk(10, FEC_PARITY_IDX_FLAG | 0x0FFF, (4 << 8) | 32, bytes(CHUNK_BYTES))),
+            (1, camera_chunk(10, 2, 4, bytes(CHUNK_BYTES))),
+            (2, camera_frame_end(10, bytes(640), 4)[:18]),
+        ]),
+    }
+
+
+def proxy_chunker_seeds() -> dict[str, bytes]:
+    def seed(request_id: int, ok: int, body: bytes) -> bytes:
+        return struct.pack('<HB', request_id, ok) + body
+
+    return {
+        'empty': seed(1, 1, b''),
+        'one_byte': seed(2, 1, b'{'),
+        'one_chunk': seed(3, 1, b'x' * CHUNK_BYTES),
+        'one_over': seed(4, 0, b'y' * (CHUNK_BYTES + 1)),
+        'json': seed(0xFFFF, 1, b'{"current_weather":{"temperature":29.1,"windspeed":3.4}}' * 20),
+    }
+
+
+TARGETS = {
+    'master_rx': master_rx_seeds,
+    'camera_reassembly': camera_seeds,
+    'proxy_chunker': proxy_chunker_seeds,
+}
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('-o', '--out', type=Path, default=Path(__file__).parent / 'fuzz' / 'corpus')
+    parser.add_argument('targets', nargs='*', help=f'any of {", ".join(TARGETS)} (default: all)')
+    args = parser.parse_args()
+    unknown = [target for target in args.targets if target not in TARGETS]
+    if unknown:
+        parser.error(f'unknown target: {", ".join(unknown)}')
+
+    for target in args.targets or TARGETS:
+        directory = args.out / target
+        directory.mkdir(parents=True, exist_ok=True)
+        seeds = TARGETS[target]()
+        for name, data in seeds.items():
+            (directory / name).write_bytes(data)
+        print(f'{directory}: {len(seeds)} seeds')
+
+
+if __name__ == '__main__':
+    main()